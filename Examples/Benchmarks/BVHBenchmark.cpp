@@ -0,0 +1,195 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+#include "../../../SecondEngine/Mesh/SEMeshLoader.h"
+#include "../../../SecondEngine/Mesh/SEBVH.h"
+#include "../../../SecondEngine/Math/RNG.h"
+
+#include "Benchmarks.h"
+
+//Rays per measurement of the BVH queries
+#define BVH_BENCHMARK_NUM_RAYS (1 << 18)
+
+//Rays of the brute force reference, it tests every triangle for every ray
+#define BVH_BENCHMARK_NUM_BRUTE_FORCE_RAYS 1024
+
+struct BVHBenchmark
+{
+	const BVH* bvh;
+	const Vertex* vertices;
+	const uint32_t* indices;
+	uint32_t numTriangles;
+
+	//The rays start on a sphere around the mesh and end at a point inside its box.
+	//A ray hits the end point at t = 1.
+	vec3* origins;
+	vec3* directions;
+	uint32_t numRays;
+
+	RayHit* hits;
+	uint32_t numOccluded;
+};
+
+void BuildAndDestroyBVH(void* data)
+{
+	BVHBenchmark* benchmark = (BVHBenchmark*)data;
+
+	BVH bvh{};
+	BuildBVH(benchmark->vertices, benchmark->indices, benchmark->numTriangles, &bvh);
+	DestroyBVH(&bvh);
+}
+
+void IntersectRays(void* data)
+{
+	BVHBenchmark* benchmark = (BVHBenchmark*)data;
+	for (uint32_t i = 0; i < benchmark->numRays; ++i)
+		IntersectBVH(benchmark->bvh, benchmark->origins[i], benchmark->directions[i], FLT_MAX, &benchmark->hits[i]);
+}
+
+void OccludeRays(void* data)
+{
+	BVHBenchmark* benchmark = (BVHBenchmark*)data;
+
+	uint32_t numOccluded = 0;
+	for (uint32_t i = 0; i < benchmark->numRays; ++i)
+		numOccluded += OccludedBVH(benchmark->bvh, benchmark->origins[i], benchmark->directions[i], 1.0f) ? 1 : 0;
+
+	benchmark->numOccluded = numOccluded;
+}
+
+//Moller-Trumbore against every triangle, both sides are hit like in IntersectBVH
+void IntersectRaysBruteForce(void* data)
+{
+	BVHBenchmark* benchmark = (BVHBenchmark*)data;
+	for (uint32_t i = 0; i < benchmark->numRays; ++i)
+	{
+		vec3 origin = benchmark->origins[i];
+		vec3 direction = benchmark->directions[i];
+
+		RayHit hit{ FLT_MAX, 0.0f, 0.0f, BVH_INVALID_TRIANGLE };
+		for (uint32_t j = 0; j < benchmark->numTriangles; ++j)
+		{
+			vec4 p0 = benchmark->vertices[benchmark->indices[j * 3]].position;
+			vec4 p1 = benchmark->vertices[benchmark->indices[j * 3 + 1]].position;
+			vec4 p2 = benchmark->vertices[benchmark->indices[j * 3 + 2]].position;
+			vec3 e0(p1.GetX() - p0.GetX(), p1.GetY() - p0.GetY(), p1.GetZ() - p0.GetZ());
+			vec3 e1(p2.GetX() - p0.GetX(), p2.GetY() - p0.GetY(), p2.GetZ() - p0.GetZ());
+
+			vec3 p = CrossProduct(direction, e1);
+			float determinant = DotProduct(e0, p);
+			if (determinant == 0.0f)
+				continue;
+
+			float invDeterminant = 1.0f / determinant;
+			vec3 s(origin.GetX() - p0.GetX(), origin.GetY() - p0.GetY(), origin.GetZ() - p0.GetZ());
+			float u = DotProduct(s, p) * invDeterminant;
+			if (u < 0.0f || u > 1.0f)
+				continue;
+
+			vec3 q = CrossProduct(s, e0);
+			float v = DotProduct(direction, q) * invDeterminant;
+			if (v < 0.0f || u + v > 1.0f)
+				continue;
+
+			float t = DotProduct(e1, q) * invDeterminant;
+			if (t > 0.0f && t < hit.t)
+				hit = RayHit{ t, u, v, j };
+		}
+
+		benchmark->hits[i] = hit;
+	}
+}
+
+void RunBVHBenchmark()
+{
+	printf("BVH ray queries, millions of rays per second on one thread (fastest of %u runs)\n", BENCHMARK_NUM_RUNS);
+	printf("%-22s %10s %10s %12s %12s %12s %10s\n", "mesh", "triangles", "build ms", "closest", "occluded", "brute force", "mismatch");
+
+	vec3* origins = (vec3*)_mm_malloc(BVH_BENCHMARK_NUM_RAYS * sizeof(vec3), 16);
+	vec3* directions = (vec3*)_mm_malloc(BVH_BENCHMARK_NUM_RAYS * sizeof(vec3), 16);
+	RayHit* hits = (RayHit*)malloc(BVH_BENCHMARK_NUM_RAYS * sizeof(RayHit));
+	RayHit* bruteForceHits = (RayHit*)malloc(BVH_BENCHMARK_NUM_BRUTE_FORCE_RAYS * sizeof(RayHit));
+
+	for (uint32_t i = 0; i < BENCHMARK_NUM_MESHES; ++i)
+	{
+		Vertex* vertices = nullptr;
+		uint32_t* indices = nullptr;
+		uint32_t numVertices = 0;
+		uint32_t numIndices = 0;
+		MeshBounds bounds{};
+		ParseOBJ(gBenchmarkMeshes[i], &vertices, &indices, &numVertices, &numIndices, OBJ_PARSE_FLAGS_NONE, &bounds);
+		uint32_t numTriangles = numIndices / 3;
+
+		uint32_t seed = 1;
+		for (uint32_t j = 0; j < BVH_BENCHMARK_NUM_RAYS; ++j)
+		{
+			//A direction uniform on the sphere, Marsaglia's method
+			float x = 0.0f;
+			float y = 0.0f;
+			float lengthSq = 1.0f;
+			do
+			{
+				x = RandomFloat(seed, -1.0f, 1.0f);
+				y = RandomFloat(seed, -1.0f, 1.0f);
+				lengthSq = x * x + y * y;
+			} while (lengthSq >= 1.0f);
+
+			float distance = bounds.radius * 2.0f;
+			float scale = 2.0f * sqrtf(1.0f - lengthSq);
+			float origin[3] =
+			{
+				bounds.center[0] + x * scale * distance,
+				bounds.center[1] + y * scale * distance,
+				bounds.center[2] + (1.0f - 2.0f * lengthSq) * distance
+			};
+
+			float target[3];
+			for (uint32_t k = 0; k < 3; ++k)
+				target[k] = RandomFloat(seed, bounds.boundsMin[k], bounds.boundsMax[k]);
+
+			origins[j] = vec3(origin[0], origin[1], origin[2]);
+			directions[j] = vec3(target[0] - origin[0], target[1] - origin[1], target[2] - origin[2]);
+		}
+
+		BVHBenchmark benchmark{ nullptr, vertices, indices, numTriangles, origins, directions, BVH_BENCHMARK_NUM_RAYS, hits, 0 };
+		double buildSeconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, BuildAndDestroyBVH, &benchmark);
+
+		BVH bvh{};
+		BuildBVH(vertices, indices, numTriangles, &bvh);
+		benchmark.bvh = &bvh;
+
+		double closestSeconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, IntersectRays, &benchmark);
+		double occludedSeconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, OccludeRays, &benchmark);
+
+		//The first rays again through every triangle. The hits have to match the BVH.
+		BVHBenchmark bruteForce = benchmark;
+		bruteForce.numRays = BVH_BENCHMARK_NUM_BRUTE_FORCE_RAYS;
+		bruteForce.hits = bruteForceHits;
+		double bruteForceSeconds = MeasureFastestRun(3, IntersectRaysBruteForce, &bruteForce);
+
+		uint32_t numMismatches = 0;
+		for (uint32_t j = 0; j < BVH_BENCHMARK_NUM_BRUTE_FORCE_RAYS; ++j)
+		{
+			bool bvhHit = hits[j].triangle != BVH_INVALID_TRIANGLE;
+			bool bruteForceHit = bruteForceHits[j].triangle != BVH_INVALID_TRIANGLE;
+			if (bvhHit != bruteForceHit || (bvhHit == true && fabsf(hits[j].t - bruteForceHits[j].t) > 1e-4f * bruteForceHits[j].t))
+				++numMismatches;
+		}
+
+		printf("%-22s %10u %10.2f %12.2f %12.2f %12.4f %10u\n", gBenchmarkMeshes[i], numTriangles, buildSeconds * 1000.0,
+			BVH_BENCHMARK_NUM_RAYS / closestSeconds / 1e6, BVH_BENCHMARK_NUM_RAYS / occludedSeconds / 1e6,
+			BVH_BENCHMARK_NUM_BRUTE_FORCE_RAYS / bruteForceSeconds / 1e6, numMismatches);
+
+		DestroyBVH(&bvh);
+		arrfree(vertices);
+		arrfree(indices);
+	}
+
+	_mm_free(origins);
+	_mm_free(directions);
+	free(hits);
+	free(bruteForceHits);
+
+	printf("\n");
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+//Console benchmarks of the engine's CPU paths against the code they replaced.
+//Every measurement runs BENCHMARK_NUM_RUNS times and reports the fastest run, which is the least disturbed by the OS.
+//Build and run the Release configuration, Debug timings are meaningless.
+
+#define BENCHMARK_NUM_RUNS 10
+
+//The meshes of the Meshes example. The pre-build event copies them to Meshes\ next to the executable.
+#define BENCHMARK_NUM_MESHES 3
+extern const char* gBenchmarkMeshes[BENCHMARK_NUM_MESHES];
+
+typedef void (*BenchmarkFunction)(void* data);
+
+//Calls function(data) numRuns times and returns the duration of the fastest call in seconds.
+double MeasureFastestRun(uint32_t numRuns, BenchmarkFunction function, void* data);
+
+//Parses the meshes with the old line by line parser, the memory-mapped tokenizer and ParseOBJ and prints MB/s.
+void RunOBJParseBenchmark();
+
+//Builds a BVH over each mesh, casts random rays through it with IntersectBVH and OccludedBVH and prints millions of rays/s.
+//The first rays are also tested against every triangle, the hits have to match.
+void RunBVHBenchmark();
+
+//Parses OBJ style numbers with ParseFloat, ParseDouble, strtof, strtod and the old StringToFloat and StringToDouble and prints GB/s.
+//Then checks that ParseFloat and ParseDouble give the same bits as strtof and strtod on random numbers of every kind.
+void RunFloatParseBenchmark();
+
+//The conversions StringToFloat and StringToDouble did before the correctly rounded parser.
+float BaselineStringToFloat(char* str);
+double BaselineStringToDouble(char* str);
+
+//mat4 products and inverses of MATH_BENCHMARK_NUM_MATRICES matrices, MATH_BENCHMARK_NUM_PASSES times over
+#define MATH_BENCHMARK_NUM_MATRICES 1024
+#define MATH_BENCHMARK_NUM_PASSES 64
+
+//Matrices of one math implementation
+struct MathBenchmark
+{
+	void* matricesA;
+	void* matricesB;
+	void* results;
+	uint32_t numMatrices;
+};
+
+//Multiplies and inverts matrices with the old SSE mat4 code, mat4 and the scalar Matrix4x4 of SEMath.h and prints ns per operation.
+//The results of every path are compared with the old code.
+void RunMathBenchmark();
+
+//The scalar Matrix4x4 of SEMath.h, in MathScalarBenchmark.cpp. matricesA and matricesB are numMatrices row-major matrices of 16 floats.
+void InitScalarMathBenchmark(MathBenchmark* benchmark, const float* matricesA, const float* matricesB, uint32_t numMatrices);
+void ExitScalarMathBenchmark(MathBenchmark* benchmark);
+void GetScalarMathResult(const MathBenchmark* benchmark, uint32_t index, float* outMatrix);
+void MultiplyMatricesScalar(void* data);
+void InvertMatricesScalar(void* data);
+void AffineInvertMatricesScalar(void* data);
+void OrthonormalInvertMatricesScalar(void* data);
@@ -0,0 +1,368 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../../../SecondEngine/Mesh/SEMeshLoader.h"
+#include "../../../SecondEngine/Math/RNG.h"
+
+#include "Benchmarks.h"
+
+//Numbers in the throughput corpus
+#define FLOAT_BENCHMARK_NUM_VALUES (1 << 20)
+
+//Strings of every kind in the equivalence check
+#define FLOAT_EQUIVALENCE_NUM_STRINGS (1 << 16)
+
+//The conversions StringToFloat and StringToDouble did before they called ParseFloat and ParseDouble:
+//the digits are accumulated in a float or double and divided by pow(10, number of decimals).
+//Exponents aren't supported and the result isn't correctly rounded.
+
+float BaselineStringToFloat(char* str)
+{
+	uint32_t index = 0;
+	bool negative = false;
+	if (str[index] == '-')
+	{
+		negative = true;
+		++index;
+	}
+
+	char* dot = strchr(str, '.');
+	uint32_t dotIndex = (uint32_t)(dot - str);
+
+	uint32_t n = 0;
+	float value = 0.0f;
+	while (str[index] != '\0')
+	{
+		if (str[index] != '.')
+			value = value * 10.0f + (str[index] - '0');
+
+		if (index > dotIndex)
+			++n;
+
+		++index;
+	}
+
+	value = value / (float)pow(10, n);
+
+	if (negative)
+		value = -value;
+
+	return value;
+}
+
+double BaselineStringToDouble(char* str)
+{
+	uint32_t index = 0;
+	bool negative = false;
+	if (str[index] == '-')
+	{
+		negative = true;
+		++index;
+	}
+
+	char* dot = strchr(str, '.');
+	uint32_t dotIndex = (uint32_t)(dot - str);
+
+	uint32_t n = 0;
+	double value = 0.0;
+	while (str[index] != '\0')
+	{
+		if (str[index] != '.')
+			value = value * 10.0 + (str[index] - '0');
+
+		if (index > dotIndex)
+			++n;
+
+		++index;
+	}
+
+	value = value / pow(10, n);
+
+	if (negative)
+		value = -value;
+
+	return value;
+}
+
+struct FloatParseBenchmark
+{
+	//The numbers separated by spaces like in an OBJ file, null-terminated
+	char* text;
+	size_t textSize;
+
+	//The same numbers each null-terminated, for the baseline routines
+	char* tokens;
+
+	//Sum of the parsed values, so the parsing isn't optimized away
+	double sum;
+};
+
+void ParseFloats(void* data)
+{
+	FloatParseBenchmark* benchmark = (FloatParseBenchmark*)data;
+
+	const char* cur = benchmark->text;
+	const char* end = benchmark->text + benchmark->textSize;
+	double sum = 0.0;
+	while (cur < end)
+	{
+		float value = 0.0f;
+		cur = ParseFloat(cur, end, &value) + 1;
+		sum += value;
+	}
+
+	benchmark->sum = sum;
+}
+
+void ParseDoubles(void* data)
+{
+	FloatParseBenchmark* benchmark = (FloatParseBenchmark*)data;
+
+	const char* cur = benchmark->text;
+	const char* end = benchmark->text + benchmark->textSize;
+	double sum = 0.0;
+	while (cur < end)
+	{
+		double value = 0.0;
+		cur = ParseDouble(cur, end, &value) + 1;
+		sum += value;
+	}
+
+	benchmark->sum = sum;
+}
+
+void ParseFloatsStrtof(void* data)
+{
+	FloatParseBenchmark* benchmark = (FloatParseBenchmark*)data;
+
+	char* cur = benchmark->text;
+	const char* end = benchmark->text + benchmark->textSize;
+	double sum = 0.0;
+	while (cur < end)
+	{
+		sum += strtof(cur, &cur);
+		++cur;
+	}
+
+	benchmark->sum = sum;
+}
+
+void ParseDoublesStrtod(void* data)
+{
+	FloatParseBenchmark* benchmark = (FloatParseBenchmark*)data;
+
+	char* cur = benchmark->text;
+	const char* end = benchmark->text + benchmark->textSize;
+	double sum = 0.0;
+	while (cur < end)
+	{
+		sum += strtod(cur, &cur);
+		++cur;
+	}
+
+	benchmark->sum = sum;
+}
+
+void ParseFloatsBaseline(void* data)
+{
+	FloatParseBenchmark* benchmark = (FloatParseBenchmark*)data;
+
+	char* cur = benchmark->tokens;
+	const char* end = benchmark->tokens + benchmark->textSize;
+	double sum = 0.0;
+	while (cur < end)
+	{
+		sum += BaselineStringToFloat(cur);
+		cur += strlen(cur) + 1;
+	}
+
+	benchmark->sum = sum;
+}
+
+void ParseDoublesBaseline(void* data)
+{
+	FloatParseBenchmark* benchmark = (FloatParseBenchmark*)data;
+
+	char* cur = benchmark->tokens;
+	const char* end = benchmark->tokens + benchmark->textSize;
+	double sum = 0.0;
+	while (cur < end)
+	{
+		sum += BaselineStringToDouble(cur);
+		cur += strlen(cur) + 1;
+	}
+
+	benchmark->sum = sum;
+}
+
+//Writes a random number of the kind into str. Every kind stresses another part of the parser.
+void WriteRandomNumber(uint32_t kind, uint32_t* seed, char* str, size_t strSize)
+{
+	switch (kind)
+	{
+	case 0:
+	{
+		//OBJ style, 6 decimals
+		snprintf(str, strSize, "%.6f", RandomFloat(*seed, -1000.0f, 1000.0f));
+		break;
+	}
+	case 1:
+	{
+		//Any finite double, shortest round trip length. An all ones exponent would be infinity or NaN
+		uint64_t bits = ((uint64_t)RandomUInt(*seed) << 32) | RandomUInt(*seed);
+		if ((bits & 0x7FF0000000000000ull) == 0x7FF0000000000000ull)
+			bits &= 0xBFFFFFFFFFFFFFFFull;
+		double value = 0.0;
+		memcpy(&value, &bits, sizeof(double));
+		snprintf(str, strSize, "%.17g", value);
+		break;
+	}
+	case 2:
+	{
+		//Any finite float, shortest round trip length
+		uint32_t bits = RandomUInt(*seed);
+		if ((bits & 0x7F800000) == 0x7F800000)
+			bits &= 0xBFFFFFFF;
+		float value = 0.0f;
+		memcpy(&value, &bits, sizeof(float));
+		snprintf(str, strSize, "%.9g", value);
+		break;
+	}
+	case 3:
+	{
+		//Exactly halfway between two floats, which a double rounded to float gets wrong
+		uint32_t bits = RandomUInt(*seed) & 0x7F7FFFFF;
+		float low = 0.0f;
+		memcpy(&low, &bits, sizeof(float));
+		double halfway = ((double)low + (double)nextafterf(low, FLT_MAX)) * 0.5;
+		snprintf(str, strSize, "%.60e", halfway);
+		break;
+	}
+	default:
+	{
+		//1 to 30 random digits with a random decimal point and exponent, including overflow and underflow
+		uint32_t numDigits = RandomUInt(*seed, 1, 30);
+		uint32_t dot = RandomUInt(*seed, 0, numDigits);
+		size_t length = 0;
+		str[length++] = (RandomUInt(*seed) & 1) ? '-' : '+';
+		for (uint32_t i = 0; i < numDigits; ++i)
+		{
+			if (i == dot)
+				str[length++] = '.';
+
+			str[length++] = (char)('0' + RandomUInt(*seed, 0, 9));
+		}
+		snprintf(str + length, strSize - length, "e%d", RandomInt(*seed, -360, 360));
+		break;
+	}
+	}
+}
+
+//Checks that ParseFloat and ParseDouble give the same bits as strtof and strtod. Returns the number of mismatches.
+uint32_t CheckFloatParseEquivalence(uint32_t* outNumStrings)
+{
+	uint32_t numMismatches = 0;
+	uint32_t numStrings = 0;
+	uint32_t seed = 7;
+	for (uint32_t kind = 0; kind < 5; ++kind)
+	{
+		for (uint32_t i = 0; i < FLOAT_EQUIVALENCE_NUM_STRINGS; ++i)
+		{
+			char str[128]{};
+			WriteRandomNumber(kind, &seed, str, sizeof(str));
+			const char* end = str + strlen(str);
+
+			float parsedFloat = 0.0f;
+			double parsedDouble = 0.0;
+			const char* floatEnd = ParseFloat(str, end, &parsedFloat);
+			const char* doubleEnd = ParseDouble(str, end, &parsedDouble);
+			float expectedFloat = strtof(str, nullptr);
+			double expectedDouble = strtod(str, nullptr);
+
+			bool match = floatEnd == end && doubleEnd == end &&
+				memcmp(&parsedFloat, &expectedFloat, sizeof(float)) == 0 &&
+				memcmp(&parsedDouble, &expectedDouble, sizeof(double)) == 0;
+			if (match == false)
+			{
+				if (numMismatches < 8)
+					printf("  mismatch: %s -> %.9g %.17g, expected %.9g %.17g\n", str, parsedFloat, parsedDouble, expectedFloat, expectedDouble);
+
+				++numMismatches;
+			}
+
+			++numStrings;
+		}
+	}
+
+	*outNumStrings = numStrings;
+
+	return numMismatches;
+}
+
+void RunFloatParseBenchmark()
+{
+	FloatParseBenchmark benchmark{};
+
+	//Like the coordinates of an OBJ file: 6 decimals, separated by spaces
+	size_t capacity = (size_t)FLOAT_BENCHMARK_NUM_VALUES * 16;
+	benchmark.text = (char*)malloc(capacity + 1);
+	benchmark.tokens = (char*)malloc(capacity + 1);
+
+	uint32_t seed = 1;
+	size_t size = 0;
+	for (uint32_t i = 0; i < FLOAT_BENCHMARK_NUM_VALUES; ++i)
+	{
+		char str[32]{};
+		WriteRandomNumber(0, &seed, str, sizeof(str));
+
+		size_t length = strlen(str);
+		memcpy(benchmark.text + size, str, length);
+		benchmark.text[size + length] = ' ';
+		size += length + 1;
+	}
+	benchmark.text[size] = '\0';
+	benchmark.textSize = size;
+
+	memcpy(benchmark.tokens, benchmark.text, size + 1);
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (benchmark.tokens[i] == ' ')
+			benchmark.tokens[i] = '\0';
+	}
+
+	struct FloatParsePath
+	{
+		const char* name;
+		BenchmarkFunction function;
+	};
+
+	FloatParsePath paths[] =
+	{
+		{ "ParseFloat", ParseFloats },
+		{ "ParseDouble", ParseDoubles },
+		{ "strtof", ParseFloatsStrtof },
+		{ "strtod", ParseDoublesStrtod },
+		{ "old StringToFloat", ParseFloatsBaseline },
+		{ "old StringToDouble", ParseDoublesBaseline }
+	};
+
+	printf("Float parsing of %u OBJ style numbers, %.1f MB (fastest of %u runs)\n", FLOAT_BENCHMARK_NUM_VALUES,
+		(double)size / (1024.0 * 1024.0), BENCHMARK_NUM_RUNS);
+	printf("%-22s %10s %12s\n", "routine", "GB/s", "ns/number");
+
+	for (uint32_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i)
+	{
+		double seconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, paths[i].function, &benchmark);
+		printf("%-22s %10.3f %12.2f\n", paths[i].name, (double)size / seconds / 1e9, seconds * 1e9 / FLOAT_BENCHMARK_NUM_VALUES);
+	}
+
+	uint32_t numStrings = 0;
+	uint32_t numMismatches = CheckFloatParseEquivalence(&numStrings);
+	printf("Equivalence with strtof and strtod: %u of %u strings differ\n\n", numMismatches, numStrings);
+
+	free(benchmark.text);
+	free(benchmark.tokens);
+}
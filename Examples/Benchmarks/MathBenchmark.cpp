@@ -0,0 +1,425 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "../../../SecondEngine/Math/SEMath_Header.h"
+#include "../../../SecondEngine/Math/RNG.h"
+
+#include "Benchmarks.h"
+
+//The mat4 product and inverse before they were vectorized: 16 dot products for the product,
+//16 scalar 3x3 cofactors for the inverse. Same layout as mat4, whose rows are private.
+struct BaselineMatrix4x4
+{
+	union
+	{
+		__m128 mat[4];
+		float matA[4][4];
+	};
+};
+
+BaselineMatrix4x4 BaselineMultiply(const BaselineMatrix4x4& matA, const BaselineMatrix4x4& matB)
+{
+	BaselineMatrix4x4 result{};
+
+	__m128 b0 = matB.mat[0];
+	__m128 b1 = matB.mat[1];
+	__m128 b2 = matB.mat[2];
+	__m128 b3 = matB.mat[3];
+
+	_MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+	result.mat[0] = _mm_set_ps(
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b3, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b2, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b1, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b0, 0xf1))
+	);
+
+	result.mat[1] = _mm_set_ps(
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b3, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b2, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b1, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b0, 0xf1))
+	);
+
+	result.mat[2] = _mm_set_ps(
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b3, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b2, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b1, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b0, 0xf1))
+	);
+
+	result.mat[3] = _mm_set_ps(
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b3, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b2, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b1, 0xf1)),
+		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b0, 0xf1))
+	);
+
+	return result;
+}
+
+float BaselineDeterminant(const BaselineMatrix4x4& mat)
+{
+	float c0 = mat.matA[0][0] * Determinant(Matrix3x3_Intrinsics(mat.matA[1][1], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[2][1], mat.matA[2][2], mat.matA[2][3],
+		mat.matA[3][1], mat.matA[3][2], mat.matA[3][3]));
+
+	float c1 = -mat.matA[0][1] * Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[2][0], mat.matA[2][2], mat.matA[2][3],
+		mat.matA[3][0], mat.matA[3][2], mat.matA[3][3]));
+
+	float c2 = mat.matA[0][2] * Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][1], mat.matA[1][3],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][3],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][3]));
+
+	float c3 = -mat.matA[0][3] * Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][1], mat.matA[1][2],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][2],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][2]));
+
+	return c0 + c1 + c2 + c3;
+}
+
+BaselineMatrix4x4 BaselineInverse(const BaselineMatrix4x4& mat)
+{
+	float det = BaselineDeterminant(mat);
+	if (CompareFloats(det, 0.0f))
+		return BaselineMatrix4x4{};
+
+	BaselineMatrix4x4 cofactors{};
+
+	//0th row
+	cofactors.matA[0][0] = Determinant(Matrix3x3_Intrinsics(mat.matA[1][1], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[2][1], mat.matA[2][2], mat.matA[2][3],
+		mat.matA[3][1], mat.matA[3][2], mat.matA[3][3]));
+
+	cofactors.matA[0][1] = -Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[2][0], mat.matA[2][2], mat.matA[2][3],
+		mat.matA[3][0], mat.matA[3][2], mat.matA[3][3]));
+
+	cofactors.matA[0][2] = Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][1], mat.matA[1][3],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][3],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][3]));
+
+	cofactors.matA[0][3] = -Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][1], mat.matA[1][2],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][2],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][2]));
+
+	//1st row
+	cofactors.matA[1][0] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][1], mat.matA[0][2], mat.matA[0][3],
+		mat.matA[2][1], mat.matA[2][2], mat.matA[2][3],
+		mat.matA[3][1], mat.matA[3][2], mat.matA[3][3]));
+
+	cofactors.matA[1][1] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][2], mat.matA[0][3],
+		mat.matA[2][0], mat.matA[2][2], mat.matA[2][3],
+		mat.matA[3][0], mat.matA[3][2], mat.matA[3][3]));
+
+	cofactors.matA[1][2] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][3],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][3],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][3]));
+
+	cofactors.matA[1][3] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][2],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][2],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][2]));
+
+	//2nd row
+	cofactors.matA[2][0] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][1], mat.matA[0][2], mat.matA[0][3],
+		mat.matA[1][1], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[3][1], mat.matA[3][2], mat.matA[3][3]));
+
+	cofactors.matA[2][1] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][2], mat.matA[0][3],
+		mat.matA[1][0], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[3][0], mat.matA[3][2], mat.matA[3][3]));
+
+	cofactors.matA[2][2] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][3],
+		mat.matA[1][0], mat.matA[1][1], mat.matA[1][3],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][3]));
+
+	cofactors.matA[2][3] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][2],
+		mat.matA[1][0], mat.matA[1][1], mat.matA[1][2],
+		mat.matA[3][0], mat.matA[3][1], mat.matA[3][2]));
+
+	//3rd row
+	cofactors.matA[3][0] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][1], mat.matA[0][2], mat.matA[0][3],
+		mat.matA[1][1], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[2][1], mat.matA[2][2], mat.matA[2][3]));
+
+	cofactors.matA[3][1] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][2], mat.matA[0][3],
+		mat.matA[1][0], mat.matA[1][2], mat.matA[1][3],
+		mat.matA[2][0], mat.matA[2][2], mat.matA[2][3]));
+
+	cofactors.matA[3][2] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][3],
+		mat.matA[1][0], mat.matA[1][1], mat.matA[1][3],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][3]));
+
+	cofactors.matA[3][3] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][2],
+		mat.matA[1][0], mat.matA[1][1], mat.matA[1][2],
+		mat.matA[2][0], mat.matA[2][1], mat.matA[2][2]));
+
+	//(1.0f / det) * Transpose(cofactors)
+	_MM_TRANSPOSE4_PS(cofactors.mat[0], cofactors.mat[1], cofactors.mat[2], cofactors.mat[3]);
+
+	__m128 scalar = _mm_set_ps1(1.0f / det);
+	cofactors.mat[0] = _mm_mul_ps(scalar, cofactors.mat[0]);
+	cofactors.mat[1] = _mm_mul_ps(scalar, cofactors.mat[1]);
+	cofactors.mat[2] = _mm_mul_ps(scalar, cofactors.mat[2]);
+	cofactors.mat[3] = _mm_mul_ps(scalar, cofactors.mat[3]);
+
+	return cofactors;
+}
+
+void InitBaselineMathBenchmark(MathBenchmark* benchmark, const float* matricesA, const float* matricesB, uint32_t numMatrices)
+{
+	BaselineMatrix4x4* a = (BaselineMatrix4x4*)_mm_malloc(numMatrices * sizeof(BaselineMatrix4x4), 16);
+	BaselineMatrix4x4* b = (BaselineMatrix4x4*)_mm_malloc(numMatrices * sizeof(BaselineMatrix4x4), 16);
+	BaselineMatrix4x4* results = (BaselineMatrix4x4*)_mm_malloc(numMatrices * sizeof(BaselineMatrix4x4), 16);
+
+	memcpy(a, matricesA, numMatrices * sizeof(BaselineMatrix4x4));
+	memcpy(b, matricesB, numMatrices * sizeof(BaselineMatrix4x4));
+	memset(results, 0, numMatrices * sizeof(BaselineMatrix4x4));
+
+	benchmark->matricesA = a;
+	benchmark->matricesB = b;
+	benchmark->results = results;
+	benchmark->numMatrices = numMatrices;
+}
+
+void GetBaselineMathResult(const MathBenchmark* benchmark, uint32_t index, float* outMatrix)
+{
+	const BaselineMatrix4x4* results = (const BaselineMatrix4x4*)benchmark->results;
+	memcpy(outMatrix, results[index].matA, sizeof(float) * 16);
+}
+
+void MultiplyMatricesBaseline(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const BaselineMatrix4x4* a = (const BaselineMatrix4x4*)benchmark->matricesA;
+	const BaselineMatrix4x4* b = (const BaselineMatrix4x4*)benchmark->matricesB;
+	BaselineMatrix4x4* results = (BaselineMatrix4x4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = BaselineMultiply(a[i], b[i]);
+	}
+}
+
+void InvertMatricesBaseline(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const BaselineMatrix4x4* a = (const BaselineMatrix4x4*)benchmark->matricesA;
+	BaselineMatrix4x4* results = (BaselineMatrix4x4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = BaselineInverse(a[i]);
+	}
+}
+
+void InitMathBenchmark(MathBenchmark* benchmark, const float* matricesA, const float* matricesB, uint32_t numMatrices)
+{
+	mat4* a = (mat4*)_mm_malloc(numMatrices * sizeof(mat4), 16);
+	mat4* b = (mat4*)_mm_malloc(numMatrices * sizeof(mat4), 16);
+	mat4* results = (mat4*)_mm_malloc(numMatrices * sizeof(mat4), 16);
+
+	for (uint32_t i = 0; i < numMatrices; ++i)
+	{
+		const float* m = matricesA + i * 16;
+		a[i] = mat4(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+
+		m = matricesB + i * 16;
+		b[i] = mat4(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+
+		results[i] = mat4();
+	}
+
+	benchmark->matricesA = a;
+	benchmark->matricesB = b;
+	benchmark->results = results;
+	benchmark->numMatrices = numMatrices;
+}
+
+void GetMathResult(const MathBenchmark* benchmark, uint32_t index, float* outMatrix)
+{
+	const mat4* results = (const mat4*)benchmark->results;
+	for (uint32_t i = 0; i < 16; ++i)
+		outMatrix[i] = results[index].GetElement(i / 4, i % 4);
+}
+
+void MultiplyMatrices(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const mat4* a = (const mat4*)benchmark->matricesA;
+	const mat4* b = (const mat4*)benchmark->matricesB;
+	mat4* results = (mat4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = a[i] * b[i];
+	}
+}
+
+void InvertMatrices(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const mat4* a = (const mat4*)benchmark->matricesA;
+	mat4* results = (mat4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = Inverse(a[i]);
+	}
+}
+
+void AffineInvertMatrices(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const mat4* a = (const mat4*)benchmark->matricesA;
+	mat4* results = (mat4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = AffineInverse(a[i]);
+	}
+}
+
+void OrthonormalInvertMatrices(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const mat4* a = (const mat4*)benchmark->matricesA;
+	mat4* results = (mat4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = OrthonormalInverse(a[i]);
+	}
+}
+
+void ExitMathBenchmark(MathBenchmark* benchmark)
+{
+	_mm_free(benchmark->matricesA);
+	_mm_free(benchmark->matricesB);
+	_mm_free(benchmark->results);
+	*benchmark = MathBenchmark{};
+}
+
+typedef void (*GetMathResultFunction)(const MathBenchmark* benchmark, uint32_t index, float* outMatrix);
+
+//Returns the largest difference of an element of the results of a and b.
+float MaxMathResultDifference(const MathBenchmark* a, GetMathResultFunction getResultA, const MathBenchmark* b, GetMathResultFunction getResultB)
+{
+	float maxDifference = 0.0f;
+	for (uint32_t i = 0; i < a->numMatrices; ++i)
+	{
+		float resultA[16]{};
+		float resultB[16]{};
+		getResultA(a, i, resultA);
+		getResultB(b, i, resultB);
+
+		for (uint32_t j = 0; j < 16; ++j)
+		{
+			float difference = fabsf(resultA[j] - resultB[j]);
+			if (difference > maxDifference)
+				maxDifference = difference;
+		}
+	}
+
+	return maxDifference;
+}
+
+void RunMathBenchmark()
+{
+	//General matrices with a dominant diagonal so they're invertible, and rotations followed by a translation
+	//for AffineInverse and OrthonormalInverse
+	float* general = (float*)malloc(MATH_BENCHMARK_NUM_MATRICES * 2 * 16 * sizeof(float));
+	float* rigid = (float*)malloc(MATH_BENCHMARK_NUM_MATRICES * 16 * sizeof(float));
+
+	uint32_t seed = 3;
+	for (uint32_t i = 0; i < MATH_BENCHMARK_NUM_MATRICES * 2; ++i)
+	{
+		for (uint32_t j = 0; j < 16; ++j)
+			general[i * 16 + j] = RandomFloat(seed, -1.0f, 1.0f) + ((j % 5 == 0) ? 4.0f : 0.0f);
+	}
+
+	for (uint32_t i = 0; i < MATH_BENCHMARK_NUM_MATRICES; ++i)
+	{
+		mat4 transform = mat4::RotX(RandomFloat(seed, 0.0f, 360.0f)) * mat4::RotY(RandomFloat(seed, 0.0f, 360.0f)) *
+			mat4::RotZ(RandomFloat(seed, 0.0f, 360.0f)) *
+			mat4::Translate(RandomFloat(seed, -100.0f, 100.0f), RandomFloat(seed, -100.0f, 100.0f), RandomFloat(seed, -100.0f, 100.0f));
+
+		for (uint32_t j = 0; j < 16; ++j)
+			rigid[i * 16 + j] = transform.GetElement(j / 4, j % 4);
+	}
+
+	const float* generalB = general + MATH_BENCHMARK_NUM_MATRICES * 16;
+
+	MathBenchmark baseline[2]{};
+	MathBenchmark current[2]{};
+	MathBenchmark scalar[2]{};
+	InitBaselineMathBenchmark(&baseline[0], general, generalB, MATH_BENCHMARK_NUM_MATRICES);
+	InitBaselineMathBenchmark(&baseline[1], rigid, rigid, MATH_BENCHMARK_NUM_MATRICES);
+	InitMathBenchmark(&current[0], general, generalB, MATH_BENCHMARK_NUM_MATRICES);
+	InitMathBenchmark(&current[1], rigid, rigid, MATH_BENCHMARK_NUM_MATRICES);
+	InitScalarMathBenchmark(&scalar[0], general, generalB, MATH_BENCHMARK_NUM_MATRICES);
+	InitScalarMathBenchmark(&scalar[1], rigid, rigid, MATH_BENCHMARK_NUM_MATRICES);
+
+	//The old code had no affine or orthonormal inverse, callers used Inverse
+	struct MathBenchmarkOperation
+	{
+		const char* name;
+		uint32_t input;
+		BenchmarkFunction baseline;
+		BenchmarkFunction current;
+		BenchmarkFunction scalar;
+	};
+
+	MathBenchmarkOperation operations[] =
+	{
+		{ "product", 0, MultiplyMatricesBaseline, MultiplyMatrices, MultiplyMatricesScalar },
+		{ "Inverse", 0, InvertMatricesBaseline, InvertMatrices, InvertMatricesScalar },
+		{ "AffineInverse", 1, InvertMatricesBaseline, AffineInvertMatrices, AffineInvertMatricesScalar },
+		{ "OrthonormalInverse", 1, InvertMatricesBaseline, OrthonormalInvertMatrices, OrthonormalInvertMatricesScalar }
+	};
+
+	double numOperations = (double)MATH_BENCHMARK_NUM_MATRICES * MATH_BENCHMARK_NUM_PASSES;
+
+	printf("mat4 products and inverses, ns per operation (fastest of %u runs, USE_FMA %d)\n", BENCHMARK_NUM_RUNS, USE_FMA);
+	printf("%-20s %10s %10s %10s %10s %14s\n", "operation", "old SSE", "mat4", "SEMath.h", "speedup", "max difference");
+
+	for (uint32_t i = 0; i < sizeof(operations) / sizeof(operations[0]); ++i)
+	{
+		MathBenchmarkOperation* operation = &operations[i];
+		uint32_t input = operation->input;
+
+		double baselineTime = MeasureFastestRun(BENCHMARK_NUM_RUNS, operation->baseline, &baseline[input]);
+		double currentTime = MeasureFastestRun(BENCHMARK_NUM_RUNS, operation->current, &current[input]);
+		double scalarTime = MeasureFastestRun(BENCHMARK_NUM_RUNS, operation->scalar, &scalar[input]);
+
+		//Every path has to agree with the old code
+		float difference = MaxMathResultDifference(&current[input], GetMathResult, &baseline[input], GetBaselineMathResult);
+		float scalarDifference = MaxMathResultDifference(&scalar[input], GetScalarMathResult, &baseline[input], GetBaselineMathResult);
+		if (scalarDifference > difference)
+			difference = scalarDifference;
+
+		printf("%-20s %10.2f %10.2f %10.2f %9.1fx %14.2g\n", operation->name, baselineTime * 1e9 / numOperations,
+			currentTime * 1e9 / numOperations, scalarTime * 1e9 / numOperations, baselineTime / currentTime, difference);
+	}
+
+	printf("\n");
+
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		ExitMathBenchmark(&baseline[i]);
+		ExitMathBenchmark(&current[i]);
+		ExitScalarMathBenchmark(&scalar[i]);
+	}
+
+	free(general);
+	free(rigid);
+}
@@ -0,0 +1,100 @@
+#include <cstdlib>
+#include <xmmintrin.h>
+
+#include "../../../SecondEngine/Math/SEMath.h"
+
+#include "Benchmarks.h"
+
+//The scalar Matrix4x4 of SEMath.h, what mat4 is when USE_SIMD is 0.
+//SEMath.h and SEMath_Intrinsics.h both define vec4 and mat4, so it gets its own translation unit.
+
+void InitScalarMathBenchmark(MathBenchmark* benchmark, const float* matricesA, const float* matricesB, uint32_t numMatrices)
+{
+	Matrix4x4* a = (Matrix4x4*)_mm_malloc(numMatrices * sizeof(Matrix4x4), 16);
+	Matrix4x4* b = (Matrix4x4*)_mm_malloc(numMatrices * sizeof(Matrix4x4), 16);
+	Matrix4x4* results = (Matrix4x4*)_mm_malloc(numMatrices * sizeof(Matrix4x4), 16);
+
+	for (uint32_t i = 0; i < numMatrices; ++i)
+	{
+		const float* m = matricesA + i * 16;
+		a[i] = Matrix4x4(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+
+		m = matricesB + i * 16;
+		b[i] = Matrix4x4(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+
+		results[i] = Matrix4x4();
+	}
+
+	benchmark->matricesA = a;
+	benchmark->matricesB = b;
+	benchmark->results = results;
+	benchmark->numMatrices = numMatrices;
+}
+
+void ExitScalarMathBenchmark(MathBenchmark* benchmark)
+{
+	_mm_free(benchmark->matricesA);
+	_mm_free(benchmark->matricesB);
+	_mm_free(benchmark->results);
+	*benchmark = MathBenchmark{};
+}
+
+void GetScalarMathResult(const MathBenchmark* benchmark, uint32_t index, float* outMatrix)
+{
+	const Matrix4x4* results = (const Matrix4x4*)benchmark->results;
+	for (uint32_t i = 0; i < 16; ++i)
+		outMatrix[i] = results[index].GetElement(i / 4, i % 4);
+}
+
+void MultiplyMatricesScalar(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const Matrix4x4* a = (const Matrix4x4*)benchmark->matricesA;
+	const Matrix4x4* b = (const Matrix4x4*)benchmark->matricesB;
+	Matrix4x4* results = (Matrix4x4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = a[i] * b[i];
+	}
+}
+
+void InvertMatricesScalar(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const Matrix4x4* a = (const Matrix4x4*)benchmark->matricesA;
+	Matrix4x4* results = (Matrix4x4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = Inverse(a[i]);
+	}
+}
+
+void AffineInvertMatricesScalar(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const Matrix4x4* a = (const Matrix4x4*)benchmark->matricesA;
+	Matrix4x4* results = (Matrix4x4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = AffineInverse(a[i]);
+	}
+}
+
+void OrthonormalInvertMatricesScalar(void* data)
+{
+	MathBenchmark* benchmark = (MathBenchmark*)data;
+	const Matrix4x4* a = (const Matrix4x4*)benchmark->matricesA;
+	Matrix4x4* results = (Matrix4x4*)benchmark->results;
+
+	for (uint32_t pass = 0; pass < MATH_BENCHMARK_NUM_PASSES; ++pass)
+	{
+		for (uint32_t i = 0; i < benchmark->numMatrices; ++i)
+			results[i] = OrthonormalInverse(a[i]);
+	}
+}
@@ -0,0 +1,220 @@
+#include <cstdio>
+#include <cstring>
+#include <Windows.h>
+
+#include "../../../SecondEngine/Mesh/SEMeshLoader.h"
+#include "../../../SecondEngine/FileSystem/SEFileSystem.h"
+
+#include "Benchmarks.h"
+
+//The tokenizer ParseOBJ had before it parsed a memory-mapped view: fgets into a 128 byte line,
+//a character at a time into a token with strncat_s, then the old StringToDouble or StringToInt32.
+//Only the tokenizing is kept, it is what the memory-mapped parser replaced.
+
+void BaselineOBJParseVertex(char* buf, OBJVertexData* vData)
+{
+	uint32_t index = 0;
+	uint32_t numIterations = 3;
+
+	++index;
+	char ch = buf[index];
+	if (ch == 'n' || ch == 't')
+	{
+		if (ch == 't')
+			numIterations = 2;
+
+		index = index + 2;
+	}
+	else //ch == ' '
+	{
+		index = index + 1;
+	}
+
+	double value[3]{};
+
+	for (uint32_t i = 0; i < numIterations; ++i)
+	{
+		char valueStr[32]{};
+		while (buf[index] != ' ' && buf[index] != '\n')
+		{
+			strncat_s(valueStr, 32, &buf[index], 1);
+			++index;
+		}
+		value[i] = BaselineStringToDouble(valueStr);
+		++index;
+	}
+
+	if (ch == 'n')
+	{
+		vec3 vn((float)value[0], (float)value[1], (float)value[2]);
+		arrpush(vData->vn, vn);
+	}
+	else if (ch == 't')
+	{
+		vec2 vt((float)value[0], (float)value[1]);
+		arrpush(vData->vt, vt);
+	}
+	else //ch == ' '
+	{
+		vec3 v((float)value[0], (float)value[1], (float)value[2]);
+		arrpush(vData->v, v);
+	}
+}
+
+//Parses the index after buf[*index] up to one of the stop characters
+int32_t BaselineOBJParseIndex(char* buf, uint32_t* index, bool stopAtSlash)
+{
+	char valueStr[16]{};
+	while (buf[*index] != ' ' && buf[*index] != '\n' && (stopAtSlash == false || buf[*index] != '/'))
+	{
+		strncat_s(valueStr, 16, &buf[*index], 1);
+		++(*index);
+	}
+
+	return StringToInt32(valueStr);
+}
+
+void BaselineOBJParseFace(char* buf, OBJFace** faces)
+{
+	uint32_t index = 2;
+	while (buf[index] != '\n' && buf[index] != '\0')
+	{
+		OBJFace face{};
+		face.vIndex = BaselineOBJParseIndex(buf, &index, true);
+
+		if (buf[index] == '/')
+		{
+			if (buf[index + 1] == '/')
+			{
+				index = index + 2;
+				face.vnIndex = BaselineOBJParseIndex(buf, &index, false);
+			}
+			else
+			{
+				++index;
+				face.vtIndex = BaselineOBJParseIndex(buf, &index, true);
+
+				if (buf[index] == '/')
+				{
+					++index;
+					face.vnIndex = BaselineOBJParseIndex(buf, &index, false);
+				}
+			}
+		}
+		++index;
+		arrpush(*faces, face);
+	}
+}
+
+void BaselineOBJTokenize(void* data)
+{
+	const char* filename = (const char*)data;
+
+	FILE* file = nullptr;
+	fopen_s(&file, filename, "r");
+	if (file == nullptr)
+		return;
+
+	OBJVertexData vData;
+	OBJFace* faces = nullptr; //a stb_ds array
+
+	char buf[128]{};
+	while (fgets(buf, 128, file) != nullptr)
+	{
+		if (buf[0] == 'v')
+		{
+			uint32_t index = (buf[1] == 'n' || buf[1] == 't') ? 3 : 2;
+			if (buf[index] == '-' || (buf[index] >= '0' && buf[index] <= '9'))
+				BaselineOBJParseVertex(buf, &vData);
+		}
+		else if (buf[0] == 'f')
+		{
+			if (buf[2] >= '0' && buf[2] <= '9')
+				BaselineOBJParseFace(buf, &faces);
+		}
+	}
+	fclose(file);
+
+	arrfree(vData.v);
+	arrfree(vData.vt);
+	arrfree(vData.vn);
+	arrfree(faces);
+}
+
+//The memory-mapped single pass tokenizer ParseOBJ runs on every chunk
+void MappedOBJTokenize(void* data)
+{
+	const char* filename = (const char*)data;
+
+	SEMappedFile file{};
+	MapFile(filename, &file);
+
+	OBJChunk chunk{};
+	chunk.begin = file.data;
+	chunk.end = chunk.begin + file.size;
+	OBJParseChunk(&chunk);
+
+	arrfree(chunk.vData.v);
+	arrfree(chunk.vData.vt);
+	arrfree(chunk.vData.vn);
+	arrfree(chunk.faces);
+	arrfree(chunk.relativeIndices);
+	arrfree(chunk.faceSizes);
+	arrfree(chunk.statements);
+	UnmapFile(&file);
+}
+
+struct ParseOBJBenchmark
+{
+	const char* filename;
+	uint32_t flags;
+};
+
+//The whole ParseOBJ without the cache: tokenizing, welding, triangulation, tangent frames and optimization
+void FullParseOBJ(void* data)
+{
+	ParseOBJBenchmark* benchmark = (ParseOBJBenchmark*)data;
+
+	Vertex* vertices = nullptr;
+	uint32_t* indices = nullptr;
+	uint32_t numVertices = 0;
+	uint32_t numIndices = 0;
+	ParseOBJ(benchmark->filename, &vertices, &indices, &numVertices, &numIndices, benchmark->flags);
+
+	arrfree(vertices);
+	arrfree(indices);
+}
+
+void RunOBJParseBenchmark()
+{
+	printf("OBJ parsing, MB/s of the file (fastest of %u runs)\n", BENCHMARK_NUM_RUNS);
+	printf("%-22s %10s %12s %12s %14s %14s\n", "mesh", "size (KB)", "old tokens", "new tokens", "ParseOBJ", "ParseOBJ MT");
+
+	for (uint32_t i = 0; i < BENCHMARK_NUM_MESHES; ++i)
+	{
+		const char* filename = gBenchmarkMeshes[i];
+
+		SEFileStats stats{};
+		if (GetFileStats(filename, &stats) == false)
+		{
+			printf("%-22s not found\n", filename);
+			continue;
+		}
+
+		double megabytes = (double)stats.size / (1024.0 * 1024.0);
+
+		double oldSeconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, BaselineOBJTokenize, (void*)filename);
+		double newSeconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, MappedOBJTokenize, (void*)filename);
+
+		ParseOBJBenchmark serial{ filename, OBJ_PARSE_FLAGS_NONE };
+		double serialSeconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, FullParseOBJ, &serial);
+
+		ParseOBJBenchmark multithreaded{ filename, OBJ_PARSE_FLAGS_MULTITHREADED };
+		double multithreadedSeconds = MeasureFastestRun(BENCHMARK_NUM_RUNS, FullParseOBJ, &multithreaded);
+
+		printf("%-22s %10.1f %12.1f %12.1f %14.1f %14.1f\n", filename, (double)stats.size / 1024.0,
+			megabytes / oldSeconds, megabytes / newSeconds, megabytes / serialSeconds, megabytes / multithreadedSeconds);
+	}
+
+	printf("\n");
+}
@@ -0,0 +1,41 @@
+#include <cstdio>
+
+#include "../../../SecondEngine/Time/SETimer.h"
+
+#include "Benchmarks.h"
+
+const char* gBenchmarkMeshes[BENCHMARK_NUM_MESHES] =
+{
+	"Meshes/cow.obj",
+	"Meshes/teapot.obj",
+	"Meshes/capsule.obj"
+};
+
+double MeasureFastestRun(uint32_t numRuns, BenchmarkFunction function, void* data)
+{
+	Timer timer{};
+	InitTimer(&timer);
+
+	double fastest = 0.0;
+	for (uint32_t i = 0; i < numRuns; ++i)
+	{
+		Tick(&timer);
+		function(data);
+		Tick(&timer);
+
+		if (i == 0 || timer.deltaTime < fastest)
+			fastest = timer.deltaTime;
+	}
+
+	return fastest;
+}
+
+int main()
+{
+	RunOBJParseBenchmark();
+	RunBVHBenchmark();
+	RunFloatParseBenchmark();
+	RunMathBenchmark();
+
+	return 0;
+}
@@ -9,8 +9,9 @@ layout(location = 3) in vec2 inTexCoords;
 
 void main() 
 {
-    mat4 mvp = perFrameBuffer.projection * perFrameBuffer.view * perObjectBuffer.model;
-    vec4 posH = mvp * inPos;
+    ShapeInstance instance = lightSourceInstances[constants.firstInstance + gl_InstanceIndex];
+    vec4 posW = TransformByInstance(instance, inPos);
+    vec4 posH = perFrameBuffer.projection * perFrameBuffer.view * posW;
 
     gl_Position = posH;
     gl_Position.y = -gl_Position.y;
@@ -19,11 +19,12 @@ void main()
     vec4 posH = mvp * inPos;
     vec4 posW = perObjectBuffer.model * inPos;
     vec4 normal = perObjectBuffer.transposeInverseModel * inNormal;
-    vec4 tangent = normalize(inTangent * perObjectBuffer.transposeInverseModel);
+    vec4 tangent = normalize(vec4(inTangent.xyz, 0.0f) * perObjectBuffer.transposeInverseModel);
 
     //re-orthogonalize using the gram-schmdit method.
+    //w of the input tangent is the handedness of the tangent frame.
     tangent = normalize(tangent - dot(tangent, normal) * normal);
-    vec4 bitangent = vec4(cross(tangent.xyz, normal.xyz), 0.0f);
+    vec4 bitangent = vec4(cross(tangent.xyz, normal.xyz) * inTangent.w, 0.0f);
 
     gl_Position = posH;
     gl_Position.y = -gl_Position.y;
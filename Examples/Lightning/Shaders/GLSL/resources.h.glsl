@@ -1,5 +1,6 @@
 #include "../ShaderLibrary/GLSL/phong.h.glsl"
 #include "../ShaderLibrary/GLSL/pbr.h.glsl"
+#include "../ShaderLibrary/GLSL/instance.h.glsl"
 
 #define MATERIAL 0
 #define TEXTURE 1
@@ -49,8 +50,15 @@ layout(push_constant) uniform RootConstants
     uint numDirectionalLights;
     uint numSpotlights;
     float normalScale;
+    uint firstInstance;
 }constants;
 
+//The transforms of the light sources, indexed by constants.firstInstance + gl_InstanceIndex
+layout(std430, set = 1, binding = 7) readonly buffer LightSourceInstanceBuffer
+{
+    ShapeInstance lightSourceInstances[];
+};
+
 layout(set = 0, binding = 0) uniform texture2D gBricksColor;
 layout(set = 0, binding = 1) uniform texture2D gBricksAO;
 layout(set = 0, binding = 2) uniform texture2D gBricksRoughness;
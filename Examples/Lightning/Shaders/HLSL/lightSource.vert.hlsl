@@ -6,6 +6,7 @@ struct VertexInput
     float4 inNormal : NORMAL;
     float4 inTangent : TANGENT;
     float2 inTexCoords : TEXCOORD;
+    uint instanceId : SV_InstanceID;
 };
 
 struct VertexOutput
@@ -17,8 +18,9 @@ VertexOutput vsMain(VertexInput vin)
 {
     VertexOutput vout;
 	
-    float4x4 mvp = mul(model, mul(view, projection));
-    float4 posH = mul(vin.inPos, mvp);
+    ShapeInstance instance = lightSourceInstances[constants.firstInstance + vin.instanceId];
+    float4 posW = TransformByInstance(instance, vin.inPos);
+    float4 posH = mul(posW, mul(view, projection));
     
     vout.outPosH = posH;
     
@@ -27,11 +27,12 @@ VertexOutput vsMain(VertexInput vin)
     float4 posH = mul(vin.inPos, mvp);
     float4 posW = mul(vin.inPos, model);
     float4 normal = mul(vin.inNormal, transposeInverseModel);
-    float4 tangent = normalize(mul(vin.inTangent, transposeInverseModel));
+    float4 tangent = normalize(mul(float4(vin.inTangent.xyz, 0.0f), transposeInverseModel));
     
     //re-orthogonalize using the gram-schmdit method.
+    //w of the input tangent is the handedness of the tangent frame.
     tangent = normalize(tangent - dot(tangent, normal) * normal);
-    float4 bitangent = float4(cross(tangent.xyz, normal.xyz), 0.0f);
+    float4 bitangent = float4(cross(tangent.xyz, normal.xyz) * vin.inTangent.w, 0.0f);
     
     vout.outPosH = posH;
     vout.outPosW = posW;
@@ -1,5 +1,6 @@
 #include "../ShaderLibrary/HLSL/phong.h.hlsl"
 #include "../ShaderLibrary/HLSL/pbr.h.hlsl"
+#include "../ShaderLibrary/HLSL/instance.h.hlsl"
 
 #define MATERIAL 0
 #define TEXTURE 1
@@ -49,6 +50,7 @@ struct RootConstants
     uint numDirectionalLights;
     uint numSpotlights;
     float normalScale;
+    uint firstInstance;
 };
 
 ConstantBuffer<RootConstants> constants : register(b7);
@@ -58,4 +60,7 @@ Texture2D gBricksAO : register(t1);
 Texture2D gBricksRoughness : register(t2);
 Texture2D gBricksNormal : register(t3);
 TextureCube gTextureCube : register(t4);
-SamplerState gSampler : register(s0);
\ No newline at end of file
+SamplerState gSampler : register(s0);
+
+//The transforms of the light sources, indexed by constants.firstInstance + SV_InstanceID
+StructuredBuffer<ShapeInstance> lightSourceInstances : register(t5);
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "../../../SecondEngine/Renderer/SECamera.h"
 #include "../../../SecondEngine/Time/SETimer.h"
 #include "../../../SecondEngine/Shapes/SEShapes.h"
+#include "../../../SecondEngine/Shapes/SEShapeBatch.h"
 #include "../../../SecondEngine/UI/SEUI.h"
 #include "../../Renderer/ShaderLibrary/lightSource.h"
 #include "../../../SecondEngine/Mesh/SEMeshLoader.h"
@@ -154,8 +155,10 @@ Buffer gPerFrameBuffer[gNumFrames];
 PerObjectUniformData gShapesUniformData;
 Buffer gShapesUniformBuffers[gNumFrames];
 
-PerObjectUniformData gLightSourceUniformData[MAX_LIGHT_SOURCES];
-Buffer gLightSourceUniformBuffer[gNumFrames * MAX_LIGHT_SOURCES];
+//The light sources in the order of the enum, drawn as instances. The directional light and the spotlight are both cones,
+//so they are adjacent and drawn with one draw.
+ShapeBatch gLightSourceShapes;
+Buffer gLightSourceInstanceBuffer[gNumFrames];
 
 PerObjectUniformData gSkyBoxUniformData;
 Buffer gSkyboxUniformBuffer[gNumFrames];
@@ -228,6 +231,9 @@ struct RootConstants
 	uint32_t numDirectionalLights;
 	uint32_t numSpotlights;
 	float normalScale;
+
+	//The instance of the first light source of a draw in gLightSourceInstanceBuffer
+	uint32_t firstInstance;
 };
 
 RootConstants gConstants;
@@ -349,7 +355,7 @@ public:
 
 		vertexInputInfo.numVertexAttributes = 4;
 
-		RootParameterInfo rootParameterInfos[13]{};
+		RootParameterInfo rootParameterInfos[14]{};
 
 		//PerFrame
 		rootParameterInfos[0].binding = 0;
@@ -468,8 +474,17 @@ public:
 		rootParameterInfos[12].type = DESCRIPTOR_TYPE_SAMPLER;
 		rootParameterInfos[12].updateFrequency = UPDATE_FREQUENCY_PER_NONE;
 
+		//Light source instances
+		rootParameterInfos[13].binding = 7;
+		rootParameterInfos[13].baseRegister = 5;
+		rootParameterInfos[13].registerSpace = 0;
+		rootParameterInfos[13].numDescriptors = 1;
+		rootParameterInfos[13].stages = STAGE_VERTEX;
+		rootParameterInfos[13].type = DESCRIPTOR_TYPE_BUFFER;
+		rootParameterInfos[13].updateFrequency = UPDATE_FREQUENCY_PER_FRAME;
+
 		RootConstantsInfo rootConstantInfo{};
-		rootConstantInfo.numValues = 5;
+		rootConstantInfo.numValues = 6;
 		rootConstantInfo.baseRegister = 7;
 		rootConstantInfo.registerSpace = 0;
 		rootConstantInfo.stride = sizeof(RootConstants);
@@ -477,7 +492,7 @@ public:
 
 		RootSignatureInfo graphicsRootSignatureInfo{};
 		graphicsRootSignatureInfo.pRootParameterInfos = rootParameterInfos;
-		graphicsRootSignatureInfo.numRootParameterInfos = 13;
+		graphicsRootSignatureInfo.numRootParameterInfos = 14;
 		graphicsRootSignatureInfo.useRootConstants = true;
 		graphicsRootSignatureInfo.rootConstantsInfo = rootConstantInfo;
 		graphicsRootSignatureInfo.useInputLayout = true;
@@ -605,13 +620,23 @@ public:
 			ubInfo.size = sizeof(PBRMaterial);
 			CreateBuffer(&gRenderer, &ubInfo, &gPbrMaterialUniformBuffer[i]);
 
-			for (uint32_t j = 0; j < MAX_LIGHT_SOURCES; ++j)
-			{
-				ubInfo.size = sizeof(PerObjectUniformData);
-				CreateBuffer(&gRenderer, &ubInfo, &gLightSourceUniformBuffer[i * MAX_LIGHT_SOURCES + j]);
-			}
+			BufferInfo instanceInfo{};
+			instanceInfo.size = MAX_LIGHT_SOURCES * sizeof(ShapeInstance);
+			instanceInfo.type = BUFFER_TYPE_BUFFER;
+			instanceInfo.usage = MEMORY_USAGE_CPU_TO_GPU;
+			instanceInfo.firstElement = 0;
+			instanceInfo.numElements = MAX_LIGHT_SOURCES;
+			instanceInfo.stride = sizeof(ShapeInstance);
+			instanceInfo.data = nullptr;
+			CreateBuffer(&gRenderer, &instanceInfo, &gLightSourceInstanceBuffer[i]);
 		}
 
+		//The transforms are set in Update
+		CreateShapeBatch(&gLightSourceShapes, MAX_LIGHT_SOURCES);
+		Shape lightSourceShape{};
+		for (uint32_t i = 0; i < MAX_LIGHT_SOURCES; ++i)
+			AddShapeToBatch(&gLightSourceShapes, &lightSourceShape);
+
 		TextureInfo texInfo{};
 		texInfo.filename = "Textures/bricksColor.dds";
 		CreateTexture(&gRenderer, &texInfo, &gBricksColor);
@@ -643,7 +668,7 @@ public:
 
 		DescriptorSetInfo uniformSetInfo{};
 		uniformSetInfo.pRootSignature = &gGraphicsRootSignature;
-		uniformSetInfo.numSets = 10;
+		uniformSetInfo.numSets = 4;
 		uniformSetInfo.updateFrequency = UPDATE_FREQUENCY_PER_FRAME;
 		CreateDescriptorSet(&gRenderer, &uniformSetInfo, &gDescriptorSetPerFrame);
 
@@ -655,7 +680,7 @@ public:
 
 		for (uint32_t i = 0; i < gNumFrames; ++i)
 		{
-			UpdateDescriptorSetInfo updatePerFrame[7]{};
+			UpdateDescriptorSetInfo updatePerFrame[8]{};
 			updatePerFrame[0].binding = 0;
 			updatePerFrame[0].type = UPDATE_TYPE_UNIFORM_BUFFER;
 			updatePerFrame[0].pBuffer = &gPerFrameBuffer[i];
@@ -684,16 +709,11 @@ public:
 			updatePerFrame[6].type = UPDATE_TYPE_UNIFORM_BUFFER;
 			updatePerFrame[6].pBuffer = &gPbrMaterialUniformBuffer[i];
 
-			UpdateDescriptorSet(&gRenderer, &gDescriptorSetPerFrame, i, 7, updatePerFrame);
+			updatePerFrame[7].binding = 7;
+			updatePerFrame[7].type = UPDATE_TYPE_BUFFER;
+			updatePerFrame[7].pBuffer = &gLightSourceInstanceBuffer[i];
 
-			for (uint32_t j = 0; j < MAX_LIGHT_SOURCES; ++j)
-			{
-				updatePerFrame[1].binding = 1;
-				updatePerFrame[1].type = UPDATE_TYPE_UNIFORM_BUFFER;
-				updatePerFrame[1].pBuffer = &gLightSourceUniformBuffer[i * MAX_LIGHT_SOURCES + j];
-
-				UpdateDescriptorSet(&gRenderer, &gDescriptorSetPerFrame, i * MAX_LIGHT_SOURCES + 2 + j, 7, updatePerFrame);
-			}
+			UpdateDescriptorSet(&gRenderer, &gDescriptorSetPerFrame, i, 8, updatePerFrame);
 
 			updatePerFrame[0].binding = 0;
 			updatePerFrame[0].type = UPDATE_TYPE_UNIFORM_BUFFER;
@@ -703,7 +723,7 @@ public:
 			updatePerFrame[1].type = UPDATE_TYPE_UNIFORM_BUFFER;
 			updatePerFrame[1].pBuffer = &gSkyboxUniformBuffer[i];
 
-			UpdateDescriptorSet(&gRenderer, &gDescriptorSetPerFrame, i + 8, 7, updatePerFrame);
+			UpdateDescriptorSet(&gRenderer, &gDescriptorSetPerFrame, i + 2, 8, updatePerFrame);
 
 		}
 
@@ -957,15 +977,13 @@ public:
 			DestroyBuffer(&gRenderer, &gSpotlightUniformBuffer[i]);
 			DestroyBuffer(&gRenderer, &gPhongMaterialUniformBuffer[i]);
 			DestroyBuffer(&gRenderer, &gPbrMaterialUniformBuffer[i]);
+			DestroyBuffer(&gRenderer, &gLightSourceInstanceBuffer[i]);
 			DestroySemaphore(&gRenderer, &gImageAvailableSemaphores[i]);
 			DestroyCommandBuffer(&gRenderer, &gGraphicsCommandBuffers[i]);
-
-			for (uint32_t j = 0; j < MAX_LIGHT_SOURCES; ++j)
-			{
-				DestroyBuffer(&gRenderer, &gLightSourceUniformBuffer[i * MAX_LIGHT_SOURCES + j]);
-			}
 		}
 
+		DestroyShapeBatch(&gLightSourceShapes);
+
 		DestroyPipeline(&gRenderer, &gSkyboxPipeline);
 		DestroyPipeline(&gRenderer, &gPbrPipeline);
 		DestroyPipeline(&gRenderer, &gPhongPipeline);
@@ -1103,18 +1121,15 @@ public:
 		//Point light
 		gPointLight.position = vec4(0.0f, 0.0f, -1.5f, 1.0f);
 		gPointLight.color = lightColor;
-		model = mat4::Scale(0.1f, 0.1f, 0.1f) * 
-			mat4::Translate(gPointLight.position.GetX(), gPointLight.position.GetY(), gPointLight.position.GetZ());
-
-		gLightSourceUniformData[POINT_LIGHT].model = Transpose(model);
+		SetShapeBatchTransform(&gLightSourceShapes, POINT_LIGHT,
+			vec3(gPointLight.position.GetX(), gPointLight.position.GetY(), gPointLight.position.GetZ()), quat::MakeIdentity(), vec3(0.1f, 0.1f, 0.1f));
 
 		//Directional light
 		gDirectionalLight.direction = vec4(0.0f, 0.0f, -1.0f, 0.0f);
 		gDirectionalLight.color = lightColor;
-		model = mat4::Scale(0.1f, 0.1f, 0.1f) * mat4::RotX(-90.0f) *
-			mat4::Translate(-gDirectionalLight.direction.GetX(), -gDirectionalLight.direction.GetY(), -gDirectionalLight.direction.GetZ() + 2.0f);
-
-		gLightSourceUniformData[DIRECTIONAL_LIGHT].model = Transpose(model);
+		SetShapeBatchTransform(&gLightSourceShapes, DIRECTIONAL_LIGHT,
+			vec3(-gDirectionalLight.direction.GetX(), -gDirectionalLight.direction.GetY(), -gDirectionalLight.direction.GetZ() + 2.0f),
+			quat::MakeRotation(-90.0f, vec3(1.0f, 0.0f, 0.0f)), vec3(0.1f, 0.1f, 0.1f));
 
 		//Spotlight
 		gSpotlight.position = vec4(-2.0f, 0.0f, 0.0f, 1.0f);
@@ -1126,10 +1141,9 @@ public:
 		gSpotlight.color = lightColor;
 		gSpotlight.innerCutoff = cos(gInnerCutoffAngle * PI / 180.0f);
 		gSpotlight.outerCutoff = cos(gOuterCutoffAngle * PI / 180.0f);
-		model = mat4::Scale(0.2f, 0.2f, 0.2f) * mat4::RotZ(90.0f) *
-			mat4::Translate(gSpotlight.position.GetX(), gSpotlight.position.GetY(), gSpotlight.position.GetZ());
-
-		gLightSourceUniformData[SPOTLIGHT].model = Transpose(model);
+		SetShapeBatchTransform(&gLightSourceShapes, SPOTLIGHT,
+			vec3(gSpotlight.position.GetX(), gSpotlight.position.GetY(), gSpotlight.position.GetZ()),
+			quat::MakeRotation(90.0f, vec3(0.0f, 0.0f, 1.0f)), vec3(0.2f, 0.2f, 0.2f));
 
 		for (uint32_t i = 0; i < MAX_MATERIALS; ++i)
 		{
@@ -1264,12 +1278,9 @@ public:
 		memcpy(data, &gSkyboxPerFrameUniformData, sizeof(PerFrameUniformData));
 		UnmapMemory(&gRenderer, &gSkyboxPerFrameBuffer[gCurrentFrame]);
 
-		for (uint32_t i = 0; i < MAX_LIGHT_SOURCES; ++i)
-		{
-			MapMemory(&gRenderer, &gLightSourceUniformBuffer[gCurrentFrame * MAX_LIGHT_SOURCES + i], &data);
-			memcpy(data, &gLightSourceUniformData[i], sizeof(PerObjectUniformData));
-			UnmapMemory(&gRenderer, &gLightSourceUniformBuffer[gCurrentFrame * MAX_LIGHT_SOURCES + i]);
-		}
+		MapMemory(&gRenderer, &gLightSourceInstanceBuffer[gCurrentFrame], &data);
+		WriteShapeInstances(&gLightSourceShapes, 0, gLightSourceShapes.numShapes, (ShapeInstance*)data);
+		UnmapMemory(&gRenderer, &gLightSourceInstanceBuffer[gCurrentFrame]);
 
 		uint32_t imageIndex = 0;
 		AcquireNextImage(&gRenderer, &gSwapChain, &gImageAvailableSemaphores[gCurrentFrame], &imageIndex);
@@ -1328,28 +1339,30 @@ public:
 		}
 		BindDescriptorSet(pCommandBuffer, 0, 0, &gDescriptorSetPerNone);
 		BindDescriptorSet(pCommandBuffer, gCurrentFrame, 1, &gDescriptorSetPerFrame);
-		BindRootConstants(pCommandBuffer, 5, sizeof(RootConstants), &gConstants, 0);
+		BindRootConstants(pCommandBuffer, 6, sizeof(RootConstants), &gConstants, 0);
 		DrawIndexedInstanced(pCommandBuffer, gIndexCounts[gCurrentShape], 1, gIndexOffsets[gCurrentShape], gVertexOffsets[gCurrentShape], 0);
 
 		if (gShowLightSources)
 		{
 			//Draw Light Source
 			BindPipeline(pCommandBuffer, &gLightSourcePipeline);
+			BindDescriptorSet(pCommandBuffer, gCurrentFrame, 1, &gDescriptorSetPerFrame);
 
 			if (gCurrentLightSource == MAX_LIGHT_SOURCES)
 			{
-				BindDescriptorSet(pCommandBuffer, gCurrentFrame * MAX_LIGHT_SOURCES + 2 + POINT_LIGHT, 1, &gDescriptorSetPerFrame);
+				gConstants.firstInstance = POINT_LIGHT;
+				BindRootConstants(pCommandBuffer, 6, sizeof(RootConstants), &gConstants, 0);
 				DrawIndexedInstanced(pCommandBuffer, gIndexCounts[SPHERE], 1, gIndexOffsets[SPHERE], gVertexOffsets[SPHERE], 0);
 
-				BindDescriptorSet(pCommandBuffer, gCurrentFrame * MAX_LIGHT_SOURCES + 2 + DIRECTIONAL_LIGHT, 1, &gDescriptorSetPerFrame);
-				DrawIndexedInstanced(pCommandBuffer, gIndexCounts[CONE], 1, gIndexOffsets[CONE], gVertexOffsets[CONE], 0);
-
-				BindDescriptorSet(pCommandBuffer, gCurrentFrame * MAX_LIGHT_SOURCES + 2 + SPOTLIGHT, 1, &gDescriptorSetPerFrame);
-				DrawIndexedInstanced(pCommandBuffer, gIndexCounts[CONE], 1, gIndexOffsets[CONE], gVertexOffsets[CONE], 0);
+				//The directional light and the spotlight
+				gConstants.firstInstance = DIRECTIONAL_LIGHT;
+				BindRootConstants(pCommandBuffer, 6, sizeof(RootConstants), &gConstants, 0);
+				DrawIndexedInstanced(pCommandBuffer, gIndexCounts[CONE], 2, gIndexOffsets[CONE], gVertexOffsets[CONE], 0);
 			}
 			else
 			{
-				BindDescriptorSet(pCommandBuffer, gCurrentFrame * MAX_LIGHT_SOURCES + 2 + gCurrentLightSource, 1, &gDescriptorSetPerFrame);
+				gConstants.firstInstance = gCurrentLightSource;
+				BindRootConstants(pCommandBuffer, 6, sizeof(RootConstants), &gConstants, 0);
 				if (gCurrentLightSource == POINT_LIGHT)
 				{
 					DrawIndexedInstanced(pCommandBuffer, gIndexCounts[SPHERE], 1, gIndexOffsets[SPHERE], gVertexOffsets[SPHERE], 0);
@@ -1364,7 +1377,7 @@ public:
 		//Draw Skybox
 		BindPipeline(pCommandBuffer, &gSkyboxPipeline);
 		BindDescriptorSet(pCommandBuffer, 1, 0, &gDescriptorSetPerNone);
-		BindDescriptorSet(pCommandBuffer, gCurrentFrame + 8, 1, &gDescriptorSetPerFrame);
+		BindDescriptorSet(pCommandBuffer, gCurrentFrame + 2, 1, &gDescriptorSetPerFrame);
 		DrawIndexedInstanced(pCommandBuffer, gIndexCounts[BOX], 1,
 			gIndexOffsets[BOX], gVertexOffsets[BOX], 0);
 
@@ -417,7 +417,8 @@ public:
 
 		gVertexOffsets[DRAGON] = arrlenu(gVertices);
 		gIndexOffsets[DRAGON] = arrlenu(gIndices);
-		ParseOBJ("Meshes/dragon.obj", &gVertices, &gIndices, &gVertexCounts[DRAGON], &gIndexCounts[DRAGON]);
+		ParseOBJ("Meshes/dragon.obj", &gVertices, &gIndices, &gVertexCounts[DRAGON], &gIndexCounts[DRAGON],
+			OBJ_PARSE_FLAGS_MULTITHREADED | OBJ_PARSE_FLAGS_CACHE);
 
 		gVertexOffsets[COW] = arrlenu(gVertices);
 		gIndexOffsets[COW] = arrlenu(gIndices);
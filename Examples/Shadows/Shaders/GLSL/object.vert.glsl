@@ -45,7 +45,7 @@ void main()
     uint objectIndex = constants.objectIndex;
     uint lightIndex = 0;
 
-    vec4 posW = objectBuffer.objectModel[objectIndex] * inPos;
+    vec4 posW = vec4(TransformPointByMatrix3x4(objectBuffer.objectModel[objectIndex], inPos.xyz), 1.0f);
     if(constants.currentLightSource == POINT_LIGHT)
     {
         vec3 lightToFrag = posW.xyz - pointLightBuffer.pointLight.position.xyz;
@@ -59,19 +59,19 @@ void main()
         lightIndex = 7;
     }
 
-    mat4 mvp = cameraBuffer.cameraProjection * cameraBuffer.cameraView * objectBuffer.objectModel[objectIndex];
-    vec4 posH = mvp * inPos;
+    vec4 posH = cameraBuffer.cameraProjection * cameraBuffer.cameraView * posW;
 
     mat4 shadowMatrix = lightSourceBuffer.lightSourceProjection[constants.lightIndex] * 
-    lightSourceBuffer.lightSourceView[constants.lightIndex] * objectBuffer.objectModel[objectIndex];
+    lightSourceBuffer.lightSourceView[constants.lightIndex];
 
-    vec4 posL = shadowMatrix * inPos;
-    vec4 normal = normalize(objectBuffer.objectInverseModel[objectIndex] * inNormal);
-    vec4 tangent = normalize(objectBuffer.objectInverseModel[objectIndex] * inTangent);
+    vec4 posL = shadowMatrix * posW;
+    vec4 normal = vec4(normalize(TransformNormalByMatrix3x4(objectBuffer.objectModel[objectIndex], inNormal.xyz)), 0.0f);
+    vec4 tangent = vec4(normalize(TransformVectorByMatrix3x4(objectBuffer.objectModel[objectIndex], inTangent.xyz)), 0.0f);
 
     //re-orthogonalize using the gram-schmdit method.
+    //w of the input tangent is the handedness of the tangent frame.
     tangent = normalize(tangent - dot(tangent, normal) * normal);
-    vec4 bitangent = vec4(cross(tangent.xyz, normal.xyz), 0.0f);
+    vec4 bitangent = vec4(cross(tangent.xyz, normal.xyz) * inTangent.w, 0.0f);
     
     gl_Position = posH;
     gl_Position.y = -gl_Position.y;
@@ -1,4 +1,5 @@
 #include "../ShaderLibrary/GLSL/pbr.h.glsl"
+#include "../ShaderLibrary/GLSL/transform.h.glsl"
 
 #define NUM_OBJECTS 7
 #define NUM_LIGHT_DATA 8
@@ -15,8 +16,7 @@ layout(row_major, set = 1, binding = 0) uniform CameraUniformBuffer
 
 layout(row_major, set = 1, binding = 1) uniform ObjectUniformBuffer
 {
-    mat4 objectModel[NUM_OBJECTS];
-    mat4 objectInverseModel[NUM_OBJECTS];
+    Matrix3x4 objectModel[NUM_OBJECTS];
     PBRMaterial material[NUM_OBJECTS];
 } objectBuffer;
 
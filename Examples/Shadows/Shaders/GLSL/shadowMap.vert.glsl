@@ -12,9 +12,8 @@ void main()
 {
     uint objectIndex = constants.objectIndex;
     uint lightIndex = constants.lightIndex;
-    mat4 mvp = lightSourceBuffer.lightSourceProjection[lightIndex] * lightSourceBuffer.lightSourceView[lightIndex] * objectBuffer.objectModel[objectIndex];
-    vec4 posH = mvp * inPos;
-    vec4 posW = objectBuffer.objectModel[objectIndex] * inPos;
+    vec4 posW = vec4(TransformPointByMatrix3x4(objectBuffer.objectModel[objectIndex], inPos.xyz), 1.0f);
+    vec4 posH = lightSourceBuffer.lightSourceProjection[lightIndex] * lightSourceBuffer.lightSourceView[lightIndex] * posW;
     
     outPosW = posW;
     gl_Position = posH;
@@ -53,7 +53,7 @@ VertexOutput vsMain(VertexInput vin)
     uint objectIndex = constants.objectIndex;
     uint lightIndex = 0;
 
-    float4 posW = mul(vin.inPos, objectModel[objectIndex]);
+    float4 posW = float4(TransformPointByMatrix3x4(objectModel[objectIndex], vin.inPos.xyz), 1.0f);
     if(constants.currentLightSource == POINT_LIGHT)
     {
         float3 lightToFrag = posW.xyz - pointLight.position.xyz;
@@ -67,16 +67,15 @@ VertexOutput vsMain(VertexInput vin)
         lightIndex = 7;
     }
     
-    float4x4 mvp = mul(objectModel[objectIndex], mul(cameraView, cameraProjection));
-    float4 posH = mul(vin.inPos, mvp);
-    float4x4 shadowMatrix = mul(objectModel[objectIndex], mul(lightSourceView[lightIndex], lightSourceProjection[lightIndex]));
-    float4 posL = mul(vin.inPos, shadowMatrix);
-    float4 normal = mul(vin.inNormal, objectInverseModel[objectIndex]);
-    float4 tangent = normalize(mul(vin.inTangent, objectInverseModel[objectIndex]));
+    float4 posH = mul(posW, mul(cameraView, cameraProjection));
+    float4 posL = mul(posW, mul(lightSourceView[lightIndex], lightSourceProjection[lightIndex]));
+    float4 normal = float4(normalize(TransformNormalByMatrix3x4(objectModel[objectIndex], vin.inNormal.xyz)), 0.0f);
+    float4 tangent = float4(normalize(TransformVectorByMatrix3x4(objectModel[objectIndex], vin.inTangent.xyz)), 0.0f);
     
     //re-orthogonalize using the gram-schmdit method.
+    //w of the input tangent is the handedness of the tangent frame.
     tangent = normalize(tangent - dot(tangent, normal) * normal);
-    float4 bitangent = float4(cross(tangent.xyz, normal.xyz), 0.0f);
+    float4 bitangent = float4(cross(tangent.xyz, normal.xyz) * vin.inTangent.w, 0.0f);
     
     vout.outPosH = posH;
     vout.outPosW = posW;
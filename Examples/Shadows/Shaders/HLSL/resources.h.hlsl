@@ -1,4 +1,5 @@
 #include "../ShaderLibrary/HLSL/pbr.h.hlsl"
+#include "../ShaderLibrary/HLSL/transform.h.hlsl"
 
 #define NUM_OBJECTS 7
 #define NUM_LIGHT_DATA 8
@@ -16,8 +17,7 @@ cbuffer CameraUniformBuffer : register(b0)
 
 cbuffer ObjectUniformBuffer : register(b1)
 {
-    float4x4 objectModel[NUM_OBJECTS];
-    float4x4 objectInverseModel[NUM_OBJECTS];
+    Matrix3x4 objectModel[NUM_OBJECTS];
     PBRMaterial material[NUM_OBJECTS];
 };
 
@@ -21,9 +21,8 @@ VertexOutput vsMain(VertexInput vin)
     uint objectIndex = constants.objectIndex;
     uint lightIndex = constants.lightIndex;
     
-    float4x4 shadowMatrix = mul(objectModel[objectIndex], mul(lightSourceView[lightIndex], lightSourceProjection[lightIndex]));
-    float4 posH = mul(vin.inPos, shadowMatrix);
-    float4 posW = mul(vin.inPos, objectModel[objectIndex]);
+    float4 posW = float4(TransformPointByMatrix3x4(objectModel[objectIndex], vin.inPos.xyz), 1.0f);
+    float4 posH = mul(posW, mul(lightSourceView[lightIndex], lightSourceProjection[lightIndex]));
     
     vout.outPosH = posH;
     vout.outPosW = posW;
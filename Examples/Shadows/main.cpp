@@ -103,8 +103,8 @@ enum
 #define NUM_OBJECTS 7
 struct ObjectData
 {
-	mat4 objectModel[NUM_OBJECTS];
-	mat4 objectInverseModel[NUM_OBJECTS];
+	//The shaders transform the normals with the cofactors of the 3x3 part, so no inverse model matrices
+	mat3x4 objectModel[NUM_OBJECTS];
 	PBRMaterial material[NUM_OBJECTS];
 };
 
@@ -878,37 +878,25 @@ public:
 		}
 		
 		//Right wall
-		gObjectData.objectModel[0] = mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotY(90.0f) * mat4::Translate(5.0f, 0.0f, 0.0f);
-		gObjectData.objectInverseModel[0] = Inverse(gObjectData.objectModel[0]);
+		gObjectData.objectModel[0] = mat3x4(mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotY(90.0f) * mat4::Translate(5.0f, 0.0f, 0.0f));
 
 		//Left wall
-		gObjectData.objectModel[1] = mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotY(-90.0f) * mat4::Translate(-5.0f, 0.0f, 0.0f);
-		gObjectData.objectInverseModel[1] = Inverse(gObjectData.objectModel[1]);
+		gObjectData.objectModel[1] = mat3x4(mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotY(-90.0f) * mat4::Translate(-5.0f, 0.0f, 0.0f));
 
 		//Top wall
-		gObjectData.objectModel[2] = mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotX(-90.0f) * mat4::Translate(0.0f, 5.0f, 0.0f);
-		gObjectData.objectInverseModel[2] = Inverse(gObjectData.objectModel[2]);
+		gObjectData.objectModel[2] = mat3x4(mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotX(-90.0f) * mat4::Translate(0.0f, 5.0f, 0.0f));
 
 		//Bottom wall
-		gObjectData.objectModel[3] = mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotX(90.0f) * mat4::Translate(0.0f, -5.0f, 0.0f);
-		gObjectData.objectInverseModel[3] = Inverse(gObjectData.objectModel[3]);
+		gObjectData.objectModel[3] = mat3x4(mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::RotX(90.0f) * mat4::Translate(0.0f, -5.0f, 0.0f));
 
 		//Back wall
-		gObjectData.objectModel[4] = mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::Translate(0.0f, 0.0f, 5.0f);
-		gObjectData.objectInverseModel[4] = Inverse(gObjectData.objectModel[4]);
+		gObjectData.objectModel[4] = mat3x4(mat4::Scale(10.0f, 10.0f, 1.0f) * mat4::Translate(0.0f, 0.0f, 5.0f));
 
 		//Sphere
-		gObjectData.objectModel[5] = mat4::Scale(1.0f, 1.0f, 1.0f) * mat4::Translate(-3.0f, -4.0f, 0.0f);
-		gObjectData.objectInverseModel[5] = Inverse(gObjectData.objectModel[5]);
+		gObjectData.objectModel[5] = mat3x4(mat4::Scale(1.0f, 1.0f, 1.0f) * mat4::Translate(-3.0f, -4.0f, 0.0f));
 
 		//Cylinder
-		gObjectData.objectModel[6] = mat4::Scale(1.0f, 3.0f, 1.0f) * mat4::Translate(3.0f, -3.2f, 2.0f);
-		gObjectData.objectInverseModel[6] = Inverse(gObjectData.objectModel[6]);
-
-		for (uint32_t i = 0; i < NUM_OBJECTS; ++i)
-		{
-			gObjectData.objectModel[i] = Transpose(gObjectData.objectModel[i]);
-		}
+		gObjectData.objectModel[6] = mat3x4(mat4::Scale(1.0f, 3.0f, 1.0f) * mat4::Translate(3.0f, -3.2f, 2.0f));
 
 		vec4 lightColor = vec4(gLightColor.GetX(), gLightColor.GetY(), gLightColor.GetZ(), 1.0f);
 
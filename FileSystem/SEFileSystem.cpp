@@ -68,7 +68,8 @@ void ReadFile(const char* filename, SEFile* outFile, FileType type)
 	}
 
 	fclose(file.file);
-	
+	file.file = nullptr;
+
 	file.buffer = buf;
 	file.size = size;
 
@@ -82,7 +83,68 @@ void FreeSEFile(SEFile* file)
 	else //type == BINARY
 		free(file->buffer);
 
-	fclose(file->file);
+	if (file->file != nullptr)
+		fclose(file->file);
+}
+
+void MapFile(const char* filename, SEMappedFile* outFile)
+{
+	SEMappedFile file{};
+
+	char errorMsg[256]{};
+	HANDLE fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		strcat_s(errorMsg, "Failed to open file ");
+		strcat_s(errorMsg, filename);
+		strcat_s(errorMsg, ". Exiting prorgam.");
+		MessageBoxA(nullptr, errorMsg, "File open error.", MB_OK);
+		exit(-1);
+	}
+
+	LARGE_INTEGER size{};
+	GetFileSizeEx(fileHandle, &size);
+
+	file.file = fileHandle;
+	file.size = size.QuadPart;
+
+	//A mapping can't be created for an empty file
+	if (file.size == 0)
+	{
+		*outFile = file;
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* data = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (data == nullptr)
+	{
+		strcat_s(errorMsg, "Failed to map file ");
+		strcat_s(errorMsg, filename);
+		strcat_s(errorMsg, ". Exiting prorgam.");
+		MessageBoxA(nullptr, errorMsg, "File map error.", MB_OK);
+		exit(-1);
+	}
+
+	file.mapping = mapping;
+	file.data = (const char*)data;
+
+	*outFile = file;
+}
+
+void UnmapFile(SEMappedFile* file)
+{
+	if (file->data != nullptr)
+		UnmapViewOfFile(file->data);
+
+	if (file->mapping != nullptr)
+		CloseHandle(file->mapping);
+
+	if (file->file != nullptr)
+		CloseHandle(file->file);
+
+	*file = SEMappedFile{};
 }
 
 void WriteFile(const char* filename, char* buffer, uint32_t numChars, FileType type)
@@ -122,6 +184,24 @@ void WriteFile(const char* filename, char* buffer, uint32_t numChars, FileType t
 	fclose(file);
 }
 
+bool GetFileStats(const char* filename, SEFileStats* outStats)
+{
+	HANDLE fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size{};
+	FILETIME writeTime{};
+	GetFileSizeEx(fileHandle, &size);
+	GetFileTime(fileHandle, nullptr, nullptr, &writeTime);
+	CloseHandle(fileHandle);
+
+	outStats->size = size.QuadPart;
+	outStats->writeTime = ((uint64_t)writeTime.dwHighDateTime << 32) | writeTime.dwLowDateTime;
+
+	return true;
+}
+
 void GetCurrentPath(char* dir)
 {
 	char currentDirectory[MAX_FILE_PATH]{};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdio>
 
 #define MAX_FILE_PATH 256
 
@@ -18,6 +19,32 @@ struct SEFile
 	FileType type;
 };
 
+//A read-only view of a file mapped into the address space of the process.
+//The contents are paged in on demand by the OS, so no copy of the file is made.
+struct SEMappedFile
+{
+	void* file = nullptr; //HANDLE
+	void* mapping = nullptr; //HANDLE
+	const char* data = nullptr;
+	uint64_t size = 0;
+};
+
+struct SEFileStats
+{
+	uint64_t size = 0;
+	uint64_t writeTime = 0; //FILETIME, 100-nanosecond intervals since January 1, 1601
+};
+
 void ReadFile(const char* filename, SEFile* outFile, FileType type);
 void FreeSEFile(SEFile* file);
+
+//Maps the whole file as read-only memory.
+//An empty file gives data = nullptr and size = 0.
+void MapFile(const char* filename, SEMappedFile* outFile);
+void UnmapFile(SEMappedFile* file);
+
+//Gets the size and last write time of a file.
+//Returns false if the file can't be opened.
+bool GetFileStats(const char* filename, SEFileStats* outStats);
+
 void GetCurrentPath(char* dir);
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include <Windows.h>
+#include <cstdlib>
+#include <cstring>
+
+#include "SEAsyncLoader.h"
+#include "../Thread/SEThread.h"
+
+struct AssetLoadJob
+{
+	//Link of the completion queue
+	AssetLoadJob* next;
+
+	AssetLoadHandle handle;
+	AssetLoadInfo info;
+	Asset asset;
+
+	//Set with the lock held. The workers read it without the lock, a late read only costs a load that is dropped.
+	volatile LONG cancelled;
+};
+
+struct AssetLoadJobEntry
+{
+	AssetLoadHandle key;
+	AssetLoadJob* value;
+};
+
+struct AsyncLoader
+{
+	Thread threads[ASYNC_LOADER_MAX_THREADS];
+	uint32_t numThreads;
+
+	//Protects the queues, the job map, nextHandle and quit
+	SRWLOCK lock;
+	CONDITION_VARIABLE jobAvailable;
+
+	//One FIFO per priority. queueHeads[i] is the first job of queues[i] that hasn't started.
+	AssetLoadJob** queues[ASSET_LOAD_PRIORITY_COUNT]; //stb_ds arrays
+	uint32_t queueHeads[ASSET_LOAD_PRIORITY_COUNT];
+
+	//The loads whose callback hasn't run and that aren't cancelled
+	AssetLoadJobEntry* jobs; //a stb_ds hash map
+	AssetLoadHandle nextHandle;
+	bool quit;
+
+	//Lock-free multi-producer single-consumer stack. The workers push finished jobs,
+	//the main thread takes the whole stack at once, so there is no ABA problem.
+	AssetLoadJob* volatile completed;
+
+	//Finished jobs taken from completed whose callbacks haven't run yet, in the order they finished.
+	//Only used by the main thread.
+	AssetLoadJob** ready; //a stb_ds array
+	uint32_t readyHead;
+
+	bool initialized;
+};
+
+AsyncLoader gAsyncLoader;
+
+//Must be called with the lock held. Returns nullptr if every queue is empty.
+AssetLoadJob* PopAssetLoadJob()
+{
+	for (uint32_t i = 0; i < ASSET_LOAD_PRIORITY_COUNT; ++i)
+	{
+		AssetLoadJob** queue = gAsyncLoader.queues[i];
+		uint32_t* head = &gAsyncLoader.queueHeads[i];
+		if (*head < arrlenu(queue))
+		{
+			AssetLoadJob* job = queue[(*head)++];
+			if (*head == arrlenu(queue))
+			{
+				arrsetlen(gAsyncLoader.queues[i], 0);
+				*head = 0;
+			}
+
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void LoadAsset(AssetLoadJob* job)
+{
+	Asset* asset = &job->asset;
+	switch (asset->type)
+	{
+	case ASSET_TYPE_MESH:
+		ParseOBJ(asset->filename, &asset->mesh.vertices, &asset->mesh.indices, &asset->mesh.numVertices, &asset->mesh.numIndices,
+			job->info.meshFlags, &asset->mesh.bounds, &asset->mesh.submeshes, &asset->mesh.materials);
+		break;
+	case ASSET_TYPE_TEXTURE:
+		ReadDDSFile(asset->filename, &asset->texture.bitData, &asset->texture.numBytes, &asset->texture.header, &asset->texture.header10);
+		break;
+	case ASSET_TYPE_FILE:
+		ReadFile(asset->filename, &asset->file, job->info.fileType);
+		break;
+	}
+}
+
+void AsyncLoaderThread(void* data)
+{
+	while (true)
+	{
+		AssetLoadJob* job = nullptr;
+
+		AcquireSRWLockExclusive(&gAsyncLoader.lock);
+		while (gAsyncLoader.quit == false && (job = PopAssetLoadJob()) == nullptr)
+			SleepConditionVariableSRW(&gAsyncLoader.jobAvailable, &gAsyncLoader.lock, INFINITE, 0);
+		ReleaseSRWLockExclusive(&gAsyncLoader.lock);
+
+		if (job == nullptr)
+			return;
+
+		//A cancelled job is still pushed so the main thread frees it
+		if (job->cancelled == 0)
+			LoadAsset(job);
+
+		AssetLoadJob* head = gAsyncLoader.completed;
+		do
+		{
+			job->next = head;
+		} while ((head = (AssetLoadJob*)InterlockedCompareExchangePointer((PVOID volatile*)&gAsyncLoader.completed, job, head)) != job->next);
+	}
+}
+
+void InitAsyncLoader()
+{
+	if (gAsyncLoader.initialized == true)
+		return;
+
+	InitializeSRWLock(&gAsyncLoader.lock);
+	InitializeConditionVariable(&gAsyncLoader.jobAvailable);
+	gAsyncLoader.nextHandle = 1;
+	gAsyncLoader.quit = false;
+
+	//The main thread keeps one core
+	uint32_t numThreads = GetNumLogicalCores();
+	numThreads = (numThreads > 1) ? numThreads - 1 : 1;
+	gAsyncLoader.numThreads = (numThreads < ASYNC_LOADER_MAX_THREADS) ? numThreads : ASYNC_LOADER_MAX_THREADS;
+
+	for (uint32_t i = 0; i < gAsyncLoader.numThreads; ++i)
+		StartThread(&gAsyncLoader.threads[i], AsyncLoaderThread, nullptr);
+
+	gAsyncLoader.initialized = true;
+}
+
+void FreeAssetLoadJob(AssetLoadJob* job)
+{
+	FreeAsset(&job->asset);
+	free(job);
+}
+
+void ExitAsyncLoader()
+{
+	if (gAsyncLoader.initialized == false)
+		return;
+
+	CancelAllAssetLoads();
+
+	AcquireSRWLockExclusive(&gAsyncLoader.lock);
+	gAsyncLoader.quit = true;
+	ReleaseSRWLockExclusive(&gAsyncLoader.lock);
+	WakeAllConditionVariable(&gAsyncLoader.jobAvailable);
+
+	for (uint32_t i = 0; i < gAsyncLoader.numThreads; ++i)
+		JoinThread(&gAsyncLoader.threads[i]);
+
+	for (uint32_t i = 0; i < ASSET_LOAD_PRIORITY_COUNT; ++i)
+	{
+		for (uint32_t j = gAsyncLoader.queueHeads[i]; j < arrlenu(gAsyncLoader.queues[i]); ++j)
+			FreeAssetLoadJob(gAsyncLoader.queues[i][j]);
+
+		arrfree(gAsyncLoader.queues[i]);
+	}
+
+	for (uint32_t i = gAsyncLoader.readyHead; i < arrlenu(gAsyncLoader.ready); ++i)
+		FreeAssetLoadJob(gAsyncLoader.ready[i]);
+
+	AssetLoadJob* job = gAsyncLoader.completed;
+	while (job != nullptr)
+	{
+		AssetLoadJob* next = job->next;
+		FreeAssetLoadJob(job);
+		job = next;
+	}
+
+	arrfree(gAsyncLoader.ready);
+	hmfree(gAsyncLoader.jobs);
+
+	gAsyncLoader = AsyncLoader{};
+}
+
+AssetLoadHandle LoadAssetAsync(const AssetLoadInfo* pInfo)
+{
+	AssetLoadJob* job = (AssetLoadJob*)calloc(1, sizeof(AssetLoadJob));
+	job->info = *pInfo;
+	job->asset.type = pInfo->type;
+	strcpy_s(job->asset.filename, pInfo->filename);
+	job->info.filename = job->asset.filename;
+
+	uint32_t priority = (pInfo->priority < ASSET_LOAD_PRIORITY_COUNT) ? pInfo->priority : ASSET_LOAD_PRIORITY_NORMAL;
+
+	AcquireSRWLockExclusive(&gAsyncLoader.lock);
+	job->handle = gAsyncLoader.nextHandle++;
+	hmput(gAsyncLoader.jobs, job->handle, job);
+	arrpush(gAsyncLoader.queues[priority], job);
+	ReleaseSRWLockExclusive(&gAsyncLoader.lock);
+
+	WakeConditionVariable(&gAsyncLoader.jobAvailable);
+
+	return job->handle;
+}
+
+bool CancelAssetLoad(AssetLoadHandle handle)
+{
+	AcquireSRWLockExclusive(&gAsyncLoader.lock);
+	ptrdiff_t index = hmgeti(gAsyncLoader.jobs, handle);
+	if (index >= 0)
+	{
+		gAsyncLoader.jobs[index].value->cancelled = 1;
+		hmdel(gAsyncLoader.jobs, handle);
+	}
+	ReleaseSRWLockExclusive(&gAsyncLoader.lock);
+
+	return index >= 0;
+}
+
+void CancelAllAssetLoads()
+{
+	AcquireSRWLockExclusive(&gAsyncLoader.lock);
+	for (ptrdiff_t i = 0; i < hmlen(gAsyncLoader.jobs); ++i)
+		gAsyncLoader.jobs[i].value->cancelled = 1;
+
+	hmfree(gAsyncLoader.jobs);
+	ReleaseSRWLockExclusive(&gAsyncLoader.lock);
+}
+
+void DispatchAssetLoadCallbacks(uint32_t maxCallbacks)
+{
+	//The stack is in reverse order of completion
+	AssetLoadJob* job = (AssetLoadJob*)InterlockedExchangePointer((PVOID volatile*)&gAsyncLoader.completed, nullptr);
+	uint32_t numTaken = 0;
+	for (AssetLoadJob* cur = job; cur != nullptr; cur = cur->next)
+		++numTaken;
+
+	size_t offset = arrlenu(gAsyncLoader.ready);
+	arrsetlen(gAsyncLoader.ready, offset + numTaken);
+	for (uint32_t i = numTaken; i > 0; --i)
+	{
+		gAsyncLoader.ready[offset + i - 1] = job;
+		job = job->next;
+	}
+
+	uint32_t numCallbacks = 0;
+	while (numCallbacks < maxCallbacks && gAsyncLoader.readyHead < arrlenu(gAsyncLoader.ready))
+	{
+		job = gAsyncLoader.ready[gAsyncLoader.readyHead++];
+
+		AcquireSRWLockExclusive(&gAsyncLoader.lock);
+		bool cancelled = job->cancelled != 0;
+		if (cancelled == false)
+			hmdel(gAsyncLoader.jobs, job->handle);
+		ReleaseSRWLockExclusive(&gAsyncLoader.lock);
+
+		if (cancelled == true || job->info.callback == nullptr)
+		{
+			FreeAssetLoadJob(job);
+			continue;
+		}
+
+		//The callback owns the data of the asset now
+		job->info.callback(&job->asset, job->info.userData);
+		free(job);
+		++numCallbacks;
+	}
+
+	if (gAsyncLoader.readyHead == arrlenu(gAsyncLoader.ready))
+	{
+		arrsetlen(gAsyncLoader.ready, 0);
+		gAsyncLoader.readyHead = 0;
+	}
+}
+
+uint32_t GetNumPendingAssetLoads()
+{
+	AcquireSRWLockShared(&gAsyncLoader.lock);
+	uint32_t numLoads = (uint32_t)hmlenu(gAsyncLoader.jobs);
+	ReleaseSRWLockShared(&gAsyncLoader.lock);
+
+	return numLoads;
+}
+
+void FreeAsset(Asset* asset)
+{
+	arrfree(asset->mesh.vertices);
+	arrfree(asset->mesh.indices);
+	arrfree(asset->mesh.submeshes);
+	arrfree(asset->mesh.materials);
+
+	free(asset->texture.bitData);
+	asset->texture.bitData = nullptr;
+
+	FreeSEFile(&asset->file);
+	asset->file = SEFile{};
+}
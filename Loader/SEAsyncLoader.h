@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../FileSystem/SEFileSystem.h"
+#include "../Mesh/SEMeshLoader.h"
+#include "../Renderer/SEDDSLoader.h"
+
+//Loads assets on a pool of worker threads.
+//The files are read and decoded on the workers. When a load finishes it is pushed onto a lock-free completion queue
+//that WindowsMain drains once per frame, so the callbacks run on the main thread and can create GPU resources.
+
+//Maximum number of worker threads
+#define ASYNC_LOADER_MAX_THREADS 8
+
+//Maximum number of callbacks WindowsMain runs per frame. The rest are run in the next frames.
+#define ASYNC_LOADER_MAX_CALLBACKS_PER_FRAME 8
+
+enum AssetType
+{
+	//ParseOBJ
+	ASSET_TYPE_MESH,
+
+	//ReadDDSFile, the result can be passed to CreateTexture in TextureInfo::fileData
+	ASSET_TYPE_TEXTURE,
+
+	//ReadFile
+	ASSET_TYPE_FILE
+};
+
+//Higher priority loads start first. Loads of the same priority start in the order they were requested.
+enum AssetLoadPriority
+{
+	ASSET_LOAD_PRIORITY_HIGH = 0,
+	ASSET_LOAD_PRIORITY_NORMAL = 1,
+	ASSET_LOAD_PRIORITY_LOW = 2,
+	ASSET_LOAD_PRIORITY_COUNT
+};
+
+//The output of ParseOBJ. Every pointer is a stb_ds array.
+struct MeshAsset
+{
+	Vertex* vertices;
+	uint32_t* indices;
+	uint32_t numVertices;
+	uint32_t numIndices;
+	MeshBounds bounds;
+	MeshSubmesh* submeshes;
+	MeshMaterial* materials;
+};
+
+struct Asset
+{
+	AssetType type;
+	char filename[MAX_FILE_PATH];
+
+	//Only the member of the type is valid
+	MeshAsset mesh;
+	DDSFileData texture;
+	SEFile file;
+};
+
+//Called on the main thread when the asset is loaded. The Asset struct is only valid during the call,
+//but the callback owns the data it points to. To keep the data, copy the struct and free it with FreeAsset later.
+//A load without a callback is freed when it finishes.
+typedef void (*AssetLoadCallback)(Asset* asset, void* userData);
+
+struct AssetLoadInfo
+{
+	const char* filename;
+	AssetType type;
+	AssetLoadPriority priority;
+
+	//OBJParseFlags for ASSET_TYPE_MESH
+	uint32_t meshFlags;
+
+	//FileType for ASSET_TYPE_FILE
+	FileType fileType;
+
+	AssetLoadCallback callback;
+	void* userData;
+};
+
+//Identifies a load, 0 is never a valid handle.
+typedef uint64_t AssetLoadHandle;
+
+//Starts the worker threads. WindowsMain calls it before App::Init.
+void InitAsyncLoader();
+
+//Cancels every load and stops the worker threads. WindowsMain calls it after App::Exit.
+void ExitAsyncLoader();
+
+//Queues the load of a file. The filename is copied.
+AssetLoadHandle LoadAssetAsync(const AssetLoadInfo* pInfo);
+
+//Cancels the load. The callback isn't called and the loaded data is freed.
+//A load that has already started runs to the end on its worker, the result is dropped.
+//Returns false if the handle doesn't belong to a load whose callback hasn't run yet.
+bool CancelAssetLoad(AssetLoadHandle handle);
+
+//Cancels every load whose callback hasn't run yet, for example before the renderer is destroyed.
+void CancelAllAssetLoads();
+
+//Runs the callbacks of up to maxCallbacks finished loads in the order they finished.
+//Must be called from the main thread. WindowsMain calls it once per frame before App::Update.
+void DispatchAssetLoadCallbacks(uint32_t maxCallbacks);
+
+//Returns the number of loads whose callback hasn't run yet.
+uint32_t GetNumPendingAssetLoads();
+
+void FreeAsset(Asset* asset);
@@ -0,0 +1,46 @@
+#include <intrin.h>
+#include <immintrin.h>
+
+#include "SECPUFeatures.h"
+
+uint32_t DetectCPUFeatures()
+{
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse42 = (info[2] & (1 << 20)) != 0;
+	bool fma = (info[2] & (1 << 12)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+
+	uint32_t features = sse42 ? CPU_FEATURE_FLAGS_SSE42 : CPU_FEATURE_FLAGS_NONE;
+	if (osxsave == false || avx == false || maxLeaf < 7)
+		return features;
+
+	//The XMM and YMM registers are saved by the OS
+	uint64_t xcr0 = _xgetbv(0);
+	if ((xcr0 & 0x6) != 0x6)
+		return features;
+
+	__cpuidex(info, 7, 0);
+	bool avx2 = (info[1] & (1 << 5)) != 0;
+	bool avx512f = (info[1] & (1 << 16)) != 0;
+
+	if (avx2 == true && fma == true)
+		features |= CPU_FEATURE_FLAGS_AVX2;
+
+	//The opmask registers and all 32 ZMM registers are saved as well
+	if (avx512f == true && (features & CPU_FEATURE_FLAGS_AVX2) != 0 && (xcr0 & 0xe6) == 0xe6)
+		features |= CPU_FEATURE_FLAGS_AVX512;
+
+	return features;
+}
+
+uint32_t GetCPUFeatures()
+{
+	static uint32_t features = DetectCPUFeatures();
+
+	return features;
+}
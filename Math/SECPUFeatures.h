@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+enum CPUFeatureFlags
+{
+	CPU_FEATURE_FLAGS_NONE = 0,
+	CPU_FEATURE_FLAGS_SSE42 = 0x1,
+
+	//AVX2 and FMA
+	CPU_FEATURE_FLAGS_AVX2 = 0x2,
+
+	//AVX-512 Foundation
+	CPU_FEATURE_FLAGS_AVX512 = 0x4
+};
+
+//Returns the CPUFeatureFlags of the processor. cpuid is only queried on the first call.
+//An instruction set is only reported if the OS also saves its registers on context switches.
+uint32_t GetCPUFeatures();
@@ -727,7 +727,7 @@ class Matrix2x2
 {
 public:
 
-	//Creates an identity matrix
+	//Creates a zero matrix
 	Matrix2x2();
 
 	//Creates a matrix with the specified rows.
@@ -796,7 +796,7 @@ public:
 	friend float Determinant(const Matrix2x2& mat);
 
 	//Returns the inverse of the matrix.
-	//Returns the identity matrix if mat is noninvertible (singular)
+	//Returns the zero matrix if mat is noninvertible (singular)
 	friend Matrix2x2 Inverse(const Matrix2x2& mat);
 
 	//Returns a rotation matrix about the z-axis with the specified angle.
@@ -1149,7 +1149,7 @@ class Matrix3x3
 {
 public:
 
-	//Creates an identity matrix
+	//Creates a zero matrix
 	Matrix3x3();
 
 	//Creates a matrix with the specified rows.
@@ -1231,7 +1231,7 @@ public:
 	friend float Determinant(const Matrix3x3& mat);
 
 	//Returns the inverse of the matrix.
-	//Returns the identity matrix if mat is noninvertible (singular)
+	//Returns the zero matrix if mat is noninvertible (singular)
 	friend Matrix3x3 Inverse(const Matrix3x3& mat);
 
 	//Returns a rotation matrix about the z-axis with the specified angle.
@@ -1721,7 +1721,7 @@ class Matrix4x4
 {
 public:
 
-	//Creates an identity matrix
+	//Creates a zero matrix
 	Matrix4x4();
 
 	//Creates a matrix with the specified rows.
@@ -1803,9 +1803,17 @@ public:
 	friend float Determinant(const Matrix4x4& mat);
 
 	//Returns the inverse of the matrix.
-	//Returns the identity matrix if mat is noninvertible (singular)
+	//Returns the zero matrix if mat is noninvertible (singular)
 	friend Matrix4x4 Inverse(const Matrix4x4& mat);
 
+	//Returns the inverse of an affine matrix, one whose last column is (0, 0, 0, 1).
+	//Cheaper than Inverse. Returns the zero matrix if mat is noninvertible (singular)
+	friend Matrix4x4 AffineInverse(const Matrix4x4& mat);
+
+	//Returns the inverse of a rotation followed by a translation, the 3x3 part must be orthonormal.
+	//The cheapest inverse, the 3x3 part is transposed.
+	friend Matrix4x4 OrthonormalInverse(const Matrix4x4& mat);
+
 	//Returns a rotation matrix about the z-axis with the specified angle.
 	//Returns the result of matA + matB.
 	friend Matrix4x4 operator+(const Matrix4x4& matA, const Matrix4x4& matB);
@@ -2215,7 +2223,7 @@ inline float Determinant(const Matrix4x4& mat)
 		+ mat.mat[1][3] * (mat.mat[2][0] * mat.mat[3][1] - mat.mat[2][1] * mat.mat[3][0]));
 
 	float c03 = mat.mat[0][3] * (mat.mat[1][0] * (mat.mat[2][1] * mat.mat[3][2] - mat.mat[2][2] * mat.mat[3][1])
-		+ mat.mat[1][1] * (mat.mat[2][2] * mat.mat[3][0] - mat.mat[3][0] * mat.mat[3][2])
+		+ mat.mat[1][1] * (mat.mat[2][2] * mat.mat[3][0] - mat.mat[2][0] * mat.mat[3][2])
 		+ mat.mat[1][2] * (mat.mat[2][0] * mat.mat[3][1] - mat.mat[2][1] * mat.mat[3][0]));
 
 	return c00 - c01 + c02 - c03;
@@ -2301,6 +2309,60 @@ inline Matrix4x4 Inverse(const Matrix4x4& mat)
 	return (1.0f / det) * Transpose(cofactors);
 }
 
+inline Matrix4x4 AffineInverse(const Matrix4x4& mat)
+{
+	//The inverse of the 3x3 part has the columns (row1 x row2, row2 x row0, row0 x row1) / det
+	float inverse[3][3];
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		const float* a = mat.mat[(i + 1) % 3];
+		const float* b = mat.mat[(i + 2) % 3];
+		inverse[0][i] = a[1] * b[2] - a[2] * b[1];
+		inverse[1][i] = a[2] * b[0] - a[0] * b[2];
+		inverse[2][i] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	float det = mat.mat[0][0] * inverse[0][0] + mat.mat[0][1] * inverse[1][0] + mat.mat[0][2] * inverse[2][0];
+	if (CompareFloats(det, 0.0f))
+		return Matrix4x4();
+
+	float invDet = 1.0f / det;
+
+	Matrix4x4 result;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		result.mat[i][0] = inverse[i][0] * invDet;
+		result.mat[i][1] = inverse[i][1] * invDet;
+		result.mat[i][2] = inverse[i][2] * invDet;
+		result.mat[i][3] = 0.0f;
+	}
+
+	//-translation * inverse of the 3x3 part
+	for (uint32_t i = 0; i < 3; ++i)
+		result.mat[3][i] = -(mat.mat[3][0] * result.mat[0][i] + mat.mat[3][1] * result.mat[1][i] + mat.mat[3][2] * result.mat[2][i]);
+	result.mat[3][3] = 1.0f;
+
+	return result;
+}
+
+inline Matrix4x4 OrthonormalInverse(const Matrix4x4& mat)
+{
+	Matrix4x4 result;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		result.mat[i][0] = mat.mat[0][i];
+		result.mat[i][1] = mat.mat[1][i];
+		result.mat[i][2] = mat.mat[2][i];
+		result.mat[i][3] = 0.0f;
+	}
+
+	for (uint32_t i = 0; i < 3; ++i)
+		result.mat[3][i] = -(mat.mat[3][0] * result.mat[0][i] + mat.mat[3][1] * result.mat[1][i] + mat.mat[3][2] * result.mat[2][i]);
+	result.mat[3][3] = 1.0f;
+
+	return result;
+}
+
 inline Matrix4x4 operator+(const Matrix4x4& matA, const Matrix4x4& matB)
 {
 	Matrix4x4 result;
@@ -2594,6 +2656,14 @@ public:
 	//Returns the matrix representation of quaterion q.
 	friend Matrix4x4 QuaternionToMatrix(const Quaternion& q);
 
+	//Returns the normalized linear interpolation from a to b, t = 0 gives a.
+	//If dot(a, b) < 0, b is negated first. -b is the same rotation and closer to a, so this takes the shortest path.
+	friend Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float t);
+
+	//Returns the spherical linear interpolation from a to b, t = 0 gives a. a and b must be unit quaternions.
+	//Takes the shortest path like Nlerp, and uses Nlerp if a and b are almost the same rotation.
+	friend Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t);
+
 private:
 	float x;
 	float y;
@@ -2785,7 +2855,7 @@ inline Quaternion operator/(const Quaternion& a, float k)
 
 inline float DotProduct(const Quaternion& a, const Quaternion& b)
 {
-	return a.x * b.x + a.y * b.y + a.z * b.z * a.scalar * b.scalar;
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.scalar * b.scalar;
 }
 
 inline float Length(const Quaternion& a)
@@ -2861,6 +2931,471 @@ inline Matrix4x4 QuaternionToMatrix(const Quaternion& q)
 		m20, m21, m22, m23,
 		m30, m31, m32, m33);
 }
+
+inline Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float t)
+{
+	float sign = (DotProduct(a, b) < 0.0f) ? -1.0f : 1.0f;
+
+	return Normalize(a * (1.0f - t) + b * (sign * t));
+}
+
+inline Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t)
+{
+	float cosAngle = DotProduct(a, b);
+	float sign = 1.0f;
+	if (cosAngle < 0.0f)
+	{
+		cosAngle = -cosAngle;
+		sign = -1.0f;
+	}
+
+	//sin(angle) goes to 0 and the arc is almost a straight line
+	if (cosAngle > 0.9995f)
+		return Nlerp(a, b, t);
+
+	float angle = acosf(cosAngle);
+	float invSinAngle = 1.0f / sinf(angle);
+
+	return a * (sinf((1.0f - t) * angle) * invSinAngle) + b * (sign * sinf(t * angle) * invSinAngle);
+}
+//------------------------------------------------------------------------------------------------------------
+
+typedef Quaternion quat;
+
+//COMPACT TRANSFORMS
 //------------------------------------------------------------------------------------------------------------
+//Smaller than a mat4 for uniform and instance buffers, and cheaper to compose and invert on the CPU.
+//They transform row vectors like mat4, a * b applies a, then b.
+//The shader library decodes them in transform.h.hlsl and transform.h.glsl, with the same member layout.
+
+//An affine transform, a mat4 whose last column is (0, 0, 0, 1), in 48 bytes.
+//Row j is column j of the mat4 (a transposed model matrix without its last row, the layout of ShapeInstance),
+//so transforming a point is three dot products with (p, 1).
+class alignas(16) Matrix3x4
+{
+public:
+	//Creates an identity matrix
+	Matrix3x4();
+
+	//Creates a matrix with the specified rows, row j is column j of the mat4.
+	Matrix3x4(const Vector4& row0, const Vector4& row1, const Vector4& row2);
+
+	//Creates a matrix from the first three columns of mat, the last column is dropped.
+	explicit Matrix3x4(const Matrix4x4& mat);
+
+	//Returns row j, column j of the mat4.
+	Vector4 GetRow(uint32_t row) const;
+
+	//Returns the mat4, its last column is (0, 0, 0, 1).
+	friend Matrix4x4 Matrix3x4ToMatrix(const Matrix3x4& mat);
+
+	//Returns the transform that applies a, then b.
+	friend Matrix3x4 operator*(const Matrix3x4& a, const Matrix3x4& b);
+
+	//Returns the inverse of mat. Returns the zero matrix if mat is noninvertible (singular), like Inverse of a mat4.
+	friend Matrix3x4 Inverse(const Matrix3x4& mat);
+
+	//Returns (p, 1) * mat
+	friend Vector3 TransformPoint(const Matrix3x4& mat, const Vector3& p);
+
+	//Returns (v, 0) * mat
+	friend Vector3 TransformVector(const Matrix3x4& mat, const Vector3& v);
+
+	//Returns n * transpose(inverse(mat)) for normals, without the inverse: the cofactors of the 3x3 part are the
+	//inverse transpose times the determinant. The result has to be normalized, and points the other way if the
+	//determinant is negative.
+	friend Vector3 TransformNormal(const Matrix3x4& mat, const Vector3& n);
+
+private:
+	float mat[3][4];
+};
+
+inline Matrix3x4::Matrix3x4()
+{
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		for (uint32_t j = 0; j < 4; ++j)
+			mat[i][j] = (i == j) ? 1.0f : 0.0f;
+	}
+}
 
-typedef Quaternion quat;
\ No newline at end of file
+inline Matrix3x4::Matrix3x4(const Vector4& row0, const Vector4& row1, const Vector4& row2)
+{
+	const Vector4* rows[3] = { &row0, &row1, &row2 };
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		mat[i][0] = rows[i]->GetX();
+		mat[i][1] = rows[i]->GetY();
+		mat[i][2] = rows[i]->GetZ();
+		mat[i][3] = rows[i]->GetW();
+	}
+}
+
+inline Matrix3x4::Matrix3x4(const Matrix4x4& mat)
+{
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		for (uint32_t j = 0; j < 4; ++j)
+			this->mat[i][j] = mat.GetElement(j, i);
+	}
+}
+
+inline Vector4 Matrix3x4::GetRow(uint32_t row) const
+{
+	assert(row < 3 && "Matrix3x4 has 3 rows.");
+
+	return Vector4(mat[row][0], mat[row][1], mat[row][2], mat[row][3]);
+}
+
+inline Matrix4x4 Matrix3x4ToMatrix(const Matrix3x4& mat)
+{
+	return Matrix4x4(mat.mat[0][0], mat.mat[1][0], mat.mat[2][0], 0.0f,
+		mat.mat[0][1], mat.mat[1][1], mat.mat[2][1], 0.0f,
+		mat.mat[0][2], mat.mat[1][2], mat.mat[2][2], 0.0f,
+		mat.mat[0][3], mat.mat[1][3], mat.mat[2][3], 1.0f);
+}
+
+inline Matrix3x4 operator*(const Matrix3x4& a, const Matrix3x4& b)
+{
+	//The rows are transposed, so this is b * a with a fourth row of (0, 0, 0, 1) under a
+	Matrix3x4 result;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		for (uint32_t j = 0; j < 4; ++j)
+			result.mat[i][j] = b.mat[i][0] * a.mat[0][j] + b.mat[i][1] * a.mat[1][j] + b.mat[i][2] * a.mat[2][j];
+		result.mat[i][3] += b.mat[i][3];
+	}
+
+	return result;
+}
+
+inline Matrix3x4 Inverse(const Matrix3x4& mat)
+{
+	//The rows are the transposed 3x3 part L and the translation t, the inverse is L^-1 and -L^-1 * t.
+	//L^-1 has the columns (row1 x row2, row2 x row0, row0 x row1) / det
+	float inverse[3][3];
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		const float* a = mat.mat[(i + 1) % 3];
+		const float* b = mat.mat[(i + 2) % 3];
+		inverse[0][i] = a[1] * b[2] - a[2] * b[1];
+		inverse[1][i] = a[2] * b[0] - a[0] * b[2];
+		inverse[2][i] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	float det = mat.mat[0][0] * inverse[0][0] + mat.mat[0][1] * inverse[1][0] + mat.mat[0][2] * inverse[2][0];
+	if (CompareFloats(det, 0.0f))
+		return Matrix3x4(Vector4(), Vector4(), Vector4());
+
+	float invDet = 1.0f / det;
+
+	Matrix3x4 result;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		result.mat[i][0] = inverse[i][0] * invDet;
+		result.mat[i][1] = inverse[i][1] * invDet;
+		result.mat[i][2] = inverse[i][2] * invDet;
+		result.mat[i][3] = -(inverse[i][0] * mat.mat[0][3] + inverse[i][1] * mat.mat[1][3] + inverse[i][2] * mat.mat[2][3]) * invDet;
+	}
+
+	return result;
+}
+
+inline Vector3 TransformPoint(const Matrix3x4& mat, const Vector3& p)
+{
+	float result[3];
+	for (uint32_t i = 0; i < 3; ++i)
+		result[i] = mat.mat[i][0] * p.GetX() + mat.mat[i][1] * p.GetY() + mat.mat[i][2] * p.GetZ() + mat.mat[i][3];
+
+	return Vector3(result[0], result[1], result[2]);
+}
+
+inline Vector3 TransformVector(const Matrix3x4& mat, const Vector3& v)
+{
+	float result[3];
+	for (uint32_t i = 0; i < 3; ++i)
+		result[i] = mat.mat[i][0] * v.GetX() + mat.mat[i][1] * v.GetY() + mat.mat[i][2] * v.GetZ();
+
+	return Vector3(result[0], result[1], result[2]);
+}
+
+inline Vector3 TransformNormal(const Matrix3x4& mat, const Vector3& n)
+{
+	//Component i is dot(row(i + 1) x row(i + 2), n), the rows of the cofactor matrix of the transposed 3x3 part
+	float result[3];
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		const float* a = mat.mat[(i + 1) % 3];
+		const float* b = mat.mat[(i + 2) % 3];
+		result[i] = (a[1] * b[2] - a[2] * b[1]) * n.GetX() + (a[2] * b[0] - a[0] * b[2]) * n.GetY() + (a[0] * b[1] - a[1] * b[0]) * n.GetZ();
+	}
+
+	return Vector3(result[0], result[1], result[2]);
+}
+
+typedef Matrix3x4 mat3x4;
+
+//A rotation, a uniform scale and a translation in 32 bytes, p * Scale(scale) * QuaternionToMatrix(rotation) * Translate(translation).
+//The cheapest transform to compose and invert, and normals only need the rotation. rotation must be a unit quaternion.
+class alignas(16) TransformTRS
+{
+public:
+	//Creates an identity transform
+	TransformTRS();
+	TransformTRS(const Quaternion& rotation, const Vector3& translation, float scale);
+
+	Quaternion GetRotation() const;
+	Vector3 GetTranslation() const;
+	float GetScale() const;
+
+	void SetRotation(const Quaternion& rotation);
+	void SetTranslation(const Vector3& translation);
+	void SetScale(float scale);
+
+	//Returns Scale(scale) * QuaternionToMatrix(rotation) * Translate(translation)
+	friend Matrix4x4 TransformTRSToMatrix(const TransformTRS& transform);
+
+	//Returns the transform as a Matrix3x4, for objects that are drawn with one
+	friend Matrix3x4 TransformTRSToMatrix3x4(const TransformTRS& transform);
+
+	//Returns the transform that applies a, then b.
+	friend TransformTRS operator*(const TransformTRS& a, const TransformTRS& b);
+
+	//Returns the inverse of transform, the scale must not be 0.
+	friend TransformTRS Inverse(const TransformTRS& transform);
+
+	//Returns (p, 1) * TransformTRSToMatrix(transform)
+	friend Vector3 TransformPoint(const TransformTRS& transform, const Vector3& p);
+
+	//Returns (v, 0) * TransformTRSToMatrix(transform)
+	friend Vector3 TransformVector(const TransformTRS& transform, const Vector3& v);
+
+private:
+	Quaternion rotation;
+	float translation[3];
+	float scale;
+};
+
+inline TransformTRS::TransformTRS() : rotation(0.0f, 0.0f, 0.0f, 1.0f), translation{ 0.0f, 0.0f, 0.0f }, scale(1.0f)
+{}
+
+inline TransformTRS::TransformTRS(const Quaternion& rotation, const Vector3& translation, float scale) :
+	rotation(rotation), translation{ translation.GetX(), translation.GetY(), translation.GetZ() }, scale(scale)
+{}
+
+inline Quaternion TransformTRS::GetRotation() const
+{
+	return rotation;
+}
+
+inline Vector3 TransformTRS::GetTranslation() const
+{
+	return Vector3(translation[0], translation[1], translation[2]);
+}
+
+inline float TransformTRS::GetScale() const
+{
+	return scale;
+}
+
+inline void TransformTRS::SetRotation(const Quaternion& rotation)
+{
+	this->rotation = rotation;
+}
+
+inline void TransformTRS::SetTranslation(const Vector3& translation)
+{
+	this->translation[0] = translation.GetX();
+	this->translation[1] = translation.GetY();
+	this->translation[2] = translation.GetZ();
+}
+
+inline void TransformTRS::SetScale(float scale)
+{
+	this->scale = scale;
+}
+
+inline Matrix4x4 TransformTRSToMatrix(const TransformTRS& transform)
+{
+	return Matrix3x4ToMatrix(TransformTRSToMatrix3x4(transform));
+}
+
+inline Matrix3x4 TransformTRSToMatrix3x4(const TransformTRS& transform)
+{
+	//Column j of the scaled rotation matrix, then the translation
+	Matrix4x4 rotation = QuaternionToMatrix(transform.rotation);
+	Vector4 rows[3];
+	for (uint32_t j = 0; j < 3; ++j)
+	{
+		rows[j] = Vector4(rotation.GetElement(0, j) * transform.scale, rotation.GetElement(1, j) * transform.scale,
+			rotation.GetElement(2, j) * transform.scale, transform.translation[j]);
+	}
+
+	return Matrix3x4(rows[0], rows[1], rows[2]);
+}
+
+inline TransformTRS operator*(const TransformTRS& a, const TransformTRS& b)
+{
+	Vector3 translation = Rotate(b.rotation, a.GetTranslation() * b.scale) + b.GetTranslation();
+
+	return TransformTRS(b.rotation * a.rotation, translation, a.scale * b.scale);
+}
+
+inline TransformTRS Inverse(const TransformTRS& transform)
+{
+	Quaternion rotation = Conjugate(transform.rotation);
+	float scale = 1.0f / transform.scale;
+
+	return TransformTRS(rotation, Rotate(rotation, transform.GetTranslation()) * -scale, scale);
+}
+
+inline Vector3 TransformPoint(const TransformTRS& transform, const Vector3& p)
+{
+	return Rotate(transform.rotation, p * transform.scale) + transform.GetTranslation();
+}
+
+inline Vector3 TransformVector(const TransformTRS& transform, const Vector3& v)
+{
+	return Rotate(transform.rotation, v * transform.scale);
+}
+
+typedef TransformTRS trs;
+
+//A rotation and a translation in 32 bytes, real + dual * e with e * e = 0.
+//real is the rotation and dual is 0.5 * (translation, 0) * real. The weighted sum of dual quaternions, normalized,
+//is still a rotation and a translation, so skinning with them keeps the volume around twisted joints that blended
+//matrices lose. real must be a unit quaternion.
+class alignas(16) DualQuaternion
+{
+public:
+	//Creates an identity transform
+	DualQuaternion();
+
+	//Creates the transform that rotates, then translates.
+	DualQuaternion(const Quaternion& rotation, const Vector3& translation);
+
+	Quaternion GetReal() const;
+	Quaternion GetDual() const;
+
+	//Returns 2 * dual * Conjugate(real)
+	Vector3 GetTranslation() const;
+
+	//Returns the weighted sum a + b, for blends
+	friend DualQuaternion operator+(const DualQuaternion& a, const DualQuaternion& b);
+
+	//Returns the weighted a * k, for blends
+	friend DualQuaternion operator*(const DualQuaternion& a, float k);
+
+	//Returns the transform that applies a, then b.
+	friend DualQuaternion operator*(const DualQuaternion& a, const DualQuaternion& b);
+
+	//Returns a blend back as a unit dual quaternion: both parts divided by the length of real, and the part of dual
+	//along real removed.
+	friend DualQuaternion Normalize(const DualQuaternion& a);
+
+	//Returns the inverse of a unit dual quaternion, the conjugates of both parts.
+	friend DualQuaternion Inverse(const DualQuaternion& a);
+
+	//Returns p rotated, then translated
+	friend Vector3 TransformPoint(const DualQuaternion& a, const Vector3& p);
+
+	//Returns v rotated
+	friend Vector3 TransformVector(const DualQuaternion& a, const Vector3& v);
+
+	//Returns QuaternionToMatrix(real) * Translate(translation) as a Matrix3x4
+	friend Matrix3x4 DualQuaternionToMatrix3x4(const DualQuaternion& a);
+
+private:
+	Quaternion real;
+	Quaternion dual;
+};
+
+inline DualQuaternion::DualQuaternion() : real(0.0f, 0.0f, 0.0f, 1.0f), dual(0.0f, 0.0f, 0.0f, 0.0f)
+{}
+
+inline DualQuaternion::DualQuaternion(const Quaternion& rotation, const Vector3& translation) :
+	real(rotation), dual(Quaternion(translation.GetX(), translation.GetY(), translation.GetZ(), 0.0f) * rotation * 0.5f)
+{}
+
+inline Quaternion DualQuaternion::GetReal() const
+{
+	return real;
+}
+
+inline Quaternion DualQuaternion::GetDual() const
+{
+	return dual;
+}
+
+inline Vector3 DualQuaternion::GetTranslation() const
+{
+	Quaternion translation = dual * Conjugate(real) * 2.0f;
+
+	return Vector3(translation.GetX(), translation.GetY(), translation.GetZ());
+}
+
+inline DualQuaternion operator+(const DualQuaternion& a, const DualQuaternion& b)
+{
+	DualQuaternion result;
+	result.real = a.real + b.real;
+	result.dual = a.dual + b.dual;
+
+	return result;
+}
+
+inline DualQuaternion operator*(const DualQuaternion& a, float k)
+{
+	DualQuaternion result;
+	result.real = a.real * k;
+	result.dual = a.dual * k;
+
+	return result;
+}
+
+inline DualQuaternion operator*(const DualQuaternion& a, const DualQuaternion& b)
+{
+	DualQuaternion result;
+	result.real = b.real * a.real;
+	result.dual = b.real * a.dual + b.dual * a.real;
+
+	return result;
+}
+
+inline DualQuaternion Normalize(const DualQuaternion& a)
+{
+	float invLength = 1.0f / Length(a.real);
+
+	DualQuaternion result;
+	result.real = a.real * invLength;
+	result.dual = a.dual * invLength;
+	result.dual -= result.real * DotProduct(result.real, result.dual);
+
+	return result;
+}
+
+inline DualQuaternion Inverse(const DualQuaternion& a)
+{
+	DualQuaternion result;
+	result.real = Conjugate(a.real);
+	result.dual = Conjugate(a.dual);
+
+	return result;
+}
+
+inline Vector3 TransformPoint(const DualQuaternion& a, const Vector3& p)
+{
+	return Rotate(a.real, p) + a.GetTranslation();
+}
+
+inline Vector3 TransformVector(const DualQuaternion& a, const Vector3& v)
+{
+	return Rotate(a.real, v);
+}
+
+inline Matrix3x4 DualQuaternionToMatrix3x4(const DualQuaternion& a)
+{
+	return TransformTRSToMatrix3x4(TransformTRS(a.real, a.GetTranslation(), 1.0f));
+}
+
+typedef DualQuaternion dualquat;
+//------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,447 @@
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+
+#include "SEMathBatch.h"
+#include "SECPUFeatures.h"
+#include "RNG.h"
+
+//The scalar kernels, the fallback for processors without SSE 4.2 and the reference for CrossCheckBatchMathKernels
+
+void TransformPointsReference(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	TransformPointsScalar(mat, in, out, 0, count);
+}
+
+void TransformVectorsReference(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	TransformVectorsScalar(mat, in, out, 0, count);
+}
+
+void TransformFloat4sReference(const float* mat, Float4Stream in, Float4Stream out, uint32_t count)
+{
+	TransformFloat4sScalar(mat, in, out, 0, count);
+}
+
+void MultiplyMatricesReference(const float* matsA, const float* matsB, float* outMats, uint32_t count)
+{
+	MultiplyMatricesScalar(matsA, matsB, outMats, 0, count);
+}
+
+void InvertMatricesReference(const float* mats, float* outMats, uint32_t count)
+{
+	InvertMatricesScalar(mats, outMats, 0, count);
+}
+
+void NormalizeReference(Float3Stream in, Float3Stream out, uint32_t count)
+{
+	NormalizeScalar(in, out, 0, count);
+}
+
+void DotReference(Float3Stream a, Float3Stream b, float* out, uint32_t count)
+{
+	DotScalar(a, b, out, 0, count);
+}
+
+void NlerpQuatsReference(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	NlerpQuatsScalar(a, b, t, out, 0, count);
+}
+
+void SlerpQuatsReference(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	SlerpQuatsScalar(a, b, t, out, 0, count);
+}
+
+void RenormalizeQuatsReference(Float4Stream in, Float4Stream out, uint32_t count)
+{
+	RenormalizeQuatsScalar(in, out, 0, count);
+}
+
+void QuatsToMatrices3x4Reference(Float4Stream quats, float* outRows, uint32_t count)
+{
+	QuatsToMatrices3x4Scalar(quats, outRows, 0, count);
+}
+
+void GetBatchMathKernelsScalar(BatchMathKernels* kernels)
+{
+	kernels->transformPoints = TransformPointsReference;
+	kernels->transformVectors = TransformVectorsReference;
+	kernels->transformFloat4s = TransformFloat4sReference;
+	kernels->multiplyMatrices = MultiplyMatricesReference;
+	kernels->invertMatrices = InvertMatricesReference;
+	kernels->normalize = NormalizeReference;
+	kernels->dot = DotReference;
+	kernels->nlerpQuats = NlerpQuatsReference;
+	kernels->slerpQuats = SlerpQuatsReference;
+	kernels->renormalizeQuats = RenormalizeQuatsReference;
+	kernels->quatsToMatrices3x4 = QuatsToMatrices3x4Reference;
+}
+
+struct BatchMath
+{
+	BatchMathKernels kernels[BATCH_MATH_INSTRUCTION_SET_COUNT];
+	BatchMathInstructionSet bestInstructionSet;
+	BatchMathInstructionSet instructionSet;
+
+	//nullptr until InitBatchMath is called
+	const BatchMathKernels* boundKernels;
+};
+
+BatchMath gBatchMath;
+
+void InitBatchMath()
+{
+	GetBatchMathKernelsScalar(&gBatchMath.kernels[BATCH_MATH_INSTRUCTION_SET_SCALAR]);
+	GetBatchMathKernelsSSE42(&gBatchMath.kernels[BATCH_MATH_INSTRUCTION_SET_SSE42]);
+	GetBatchMathKernelsAVX2(&gBatchMath.kernels[BATCH_MATH_INSTRUCTION_SET_AVX2]);
+	GetBatchMathKernelsAVX512(&gBatchMath.kernels[BATCH_MATH_INSTRUCTION_SET_AVX512]);
+
+	uint32_t features = GetCPUFeatures();
+	if ((features & CPU_FEATURE_FLAGS_AVX512) != 0)
+		gBatchMath.bestInstructionSet = BATCH_MATH_INSTRUCTION_SET_AVX512;
+	else if ((features & CPU_FEATURE_FLAGS_AVX2) != 0)
+		gBatchMath.bestInstructionSet = BATCH_MATH_INSTRUCTION_SET_AVX2;
+	else if ((features & CPU_FEATURE_FLAGS_SSE42) != 0)
+		gBatchMath.bestInstructionSet = BATCH_MATH_INSTRUCTION_SET_SSE42;
+	else
+		gBatchMath.bestInstructionSet = BATCH_MATH_INSTRUCTION_SET_SCALAR;
+
+	gBatchMath.instructionSet = gBatchMath.bestInstructionSet;
+	gBatchMath.boundKernels = &gBatchMath.kernels[gBatchMath.instructionSet];
+}
+
+inline const BatchMathKernels* GetBatchMathKernels()
+{
+	if (gBatchMath.boundKernels == nullptr)
+		InitBatchMath();
+
+	return gBatchMath.boundKernels;
+}
+
+BatchMathInstructionSet GetBestBatchMathInstructionSet()
+{
+	GetBatchMathKernels();
+
+	return gBatchMath.bestInstructionSet;
+}
+
+void SetBatchMathInstructionSet(BatchMathInstructionSet instructionSet)
+{
+	GetBatchMathKernels();
+
+	if (instructionSet > gBatchMath.bestInstructionSet)
+		instructionSet = gBatchMath.bestInstructionSet;
+
+	gBatchMath.instructionSet = instructionSet;
+	gBatchMath.boundKernels = &gBatchMath.kernels[instructionSet];
+}
+
+BatchMathInstructionSet GetBatchMathInstructionSet()
+{
+	GetBatchMathKernels();
+
+	return gBatchMath.instructionSet;
+}
+
+void TransformPointStream(const mat4* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	GetBatchMathKernels()->transformPoints((const float*)mat, in, out, count);
+}
+
+void TransformVectorStream(const mat4* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	GetBatchMathKernels()->transformVectors((const float*)mat, in, out, count);
+}
+
+void TransformFloat4Stream(const mat4* mat, Float4Stream in, Float4Stream out, uint32_t count)
+{
+	GetBatchMathKernels()->transformFloat4s((const float*)mat, in, out, count);
+}
+
+void MultiplyMatrices(const mat4* matsA, const mat4* matsB, mat4* outMats, uint32_t count)
+{
+	GetBatchMathKernels()->multiplyMatrices((const float*)matsA, (const float*)matsB, (float*)outMats, count);
+}
+
+void InvertMatrices(const mat4* mats, mat4* outMats, uint32_t count)
+{
+	GetBatchMathKernels()->invertMatrices((const float*)mats, (float*)outMats, count);
+}
+
+void NormalizeStream(Float3Stream in, Float3Stream out, uint32_t count)
+{
+	GetBatchMathKernels()->normalize(in, out, count);
+}
+
+void DotStream(Float3Stream a, Float3Stream b, float* out, uint32_t count)
+{
+	GetBatchMathKernels()->dot(a, b, out, count);
+}
+
+void NlerpQuatStream(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	GetBatchMathKernels()->nlerpQuats(a, b, t, out, count);
+}
+
+void SlerpQuatStream(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	GetBatchMathKernels()->slerpQuats(a, b, t, out, count);
+}
+
+void RenormalizeQuatStream(Float4Stream in, Float4Stream out, uint32_t count)
+{
+	GetBatchMathKernels()->renormalizeQuats(in, out, count);
+}
+
+void QuatStreamToMatrices3x4(Float4Stream quats, vec4* outRows, uint32_t count)
+{
+	GetBatchMathKernels()->quatsToMatrices3x4(quats, (float*)outRows, count);
+}
+
+//Elements per stream and matrices per array in CrossCheckBatchMathKernels.
+//64 + 3, so every kernel also runs its scalar tail.
+#define BATCH_MATH_CHECK_COUNT 67
+
+struct BatchMathCheckData
+{
+	//Inputs, 4 streams of BATCH_MATH_CHECK_COUNT elements or BATCH_MATH_CHECK_COUNT matrices
+	float a[4 * BATCH_MATH_CHECK_COUNT];
+	float b[4 * BATCH_MATH_CHECK_COUNT];
+	float matsA[16 * BATCH_MATH_CHECK_COUNT];
+	float matsB[16 * BATCH_MATH_CHECK_COUNT];
+
+	//Unit quaternions and interpolation factors
+	float quatsA[4 * BATCH_MATH_CHECK_COUNT];
+	float quatsB[4 * BATCH_MATH_CHECK_COUNT];
+	float t[BATCH_MATH_CHECK_COUNT];
+
+	//The absolute values of the inputs. The scalar kernels on them give the size of the terms of every result.
+	float absA[4 * BATCH_MATH_CHECK_COUNT];
+	float absB[4 * BATCH_MATH_CHECK_COUNT];
+	float absMatsA[16 * BATCH_MATH_CHECK_COUNT];
+	float absMatsB[16 * BATCH_MATH_CHECK_COUNT];
+
+	float reference[16 * BATCH_MATH_CHECK_COUNT];
+	float scale[16 * BATCH_MATH_CHECK_COUNT];
+	float result[16 * BATCH_MATH_CHECK_COUNT];
+};
+
+inline Float3Stream GetCheckFloat3Stream(float* data)
+{
+	return Float3Stream{ data, data + BATCH_MATH_CHECK_COUNT, data + 2 * BATCH_MATH_CHECK_COUNT };
+}
+
+inline Float4Stream GetCheckFloat4Stream(float* data)
+{
+	return Float4Stream{ data, data + BATCH_MATH_CHECK_COUNT, data + 2 * BATCH_MATH_CHECK_COUNT, data + 3 * BATCH_MATH_CHECK_COUNT };
+}
+
+//Returns the distance between value and reference in units in the last place of max(|reference|, scale)
+float GetUlpError(float value, float reference, float scale)
+{
+	if (value != value || reference != reference)
+		return (value != value && reference != reference) ? 0.0f : FLT_MAX;
+
+	float magnitude = fabsf(reference) > scale ? fabsf(reference) : scale;
+	if (magnitude < FLT_MIN)
+		magnitude = FLT_MIN;
+
+	//magnitude = m * 2^exponent with m in [0.5, 1), so its unit in the last place is 2^(exponent - 24)
+	int exponent = 0;
+	frexpf(magnitude, &exponent);
+
+	return fabsf(value - reference) / ldexpf(1.0f, exponent - 24);
+}
+
+void CompareBatchMathResults(const float* results, const float* references, const float* scales, uint32_t count, BatchMathCheckResult* outResult)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (memcmp(&results[i], &references[i], sizeof(float)) != 0)
+			outResult->bitwiseEqual = false;
+
+		float ulps = GetUlpError(results[i], references[i], scales[i]);
+		if (ulps > outResult->maxUlps)
+			outResult->maxUlps = ulps;
+	}
+}
+
+void CheckBatchMathKernelSet(BatchMathCheckData* data, const BatchMathKernels* reference, const BatchMathKernels* kernels, BatchMathCheckResult* outResults)
+{
+	const uint32_t count = BATCH_MATH_CHECK_COUNT;
+
+	Float3Stream a3 = GetCheckFloat3Stream(data->a);
+	Float3Stream b3 = GetCheckFloat3Stream(data->b);
+	Float3Stream absA3 = GetCheckFloat3Stream(data->absA);
+	Float3Stream absB3 = GetCheckFloat3Stream(data->absB);
+	Float3Stream reference3 = GetCheckFloat3Stream(data->reference);
+	Float3Stream scale3 = GetCheckFloat3Stream(data->scale);
+	Float3Stream result3 = GetCheckFloat3Stream(data->result);
+
+	reference->transformPoints(data->matsA, a3, reference3, count);
+	reference->transformPoints(data->absMatsA, absA3, scale3, count);
+	kernels->transformPoints(data->matsA, a3, result3, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 3 * count, &outResults[0]);
+
+	reference->transformVectors(data->matsA, a3, reference3, count);
+	reference->transformVectors(data->absMatsA, absA3, scale3, count);
+	kernels->transformVectors(data->matsA, a3, result3, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 3 * count, &outResults[1]);
+
+	reference->transformFloat4s(data->matsA, GetCheckFloat4Stream(data->a), GetCheckFloat4Stream(data->reference), count);
+	reference->transformFloat4s(data->absMatsA, GetCheckFloat4Stream(data->absA), GetCheckFloat4Stream(data->scale), count);
+	kernels->transformFloat4s(data->matsA, GetCheckFloat4Stream(data->a), GetCheckFloat4Stream(data->result), count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 4 * count, &outResults[2]);
+
+	reference->multiplyMatrices(data->matsA, data->matsB, data->reference, count);
+	reference->multiplyMatrices(data->absMatsA, data->absMatsB, data->scale, count);
+	kernels->multiplyMatrices(data->matsA, data->matsB, data->result, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 16 * count, &outResults[3]);
+
+	//The error of an inverse grows with the condition of the matrix, it's measured against the largest element
+	reference->invertMatrices(data->matsA, data->reference, count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		float largest = 0.0f;
+		for (uint32_t j = 0; j < 16; ++j)
+			largest = fabsf(data->reference[16 * i + j]) > largest ? fabsf(data->reference[16 * i + j]) : largest;
+
+		for (uint32_t j = 0; j < 16; ++j)
+			data->scale[16 * i + j] = largest;
+	}
+	kernels->invertMatrices(data->matsA, data->result, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 16 * count, &outResults[4]);
+
+	//The results are at most 1
+	reference->normalize(a3, reference3, count);
+	for (uint32_t i = 0; i < 3 * count; ++i)
+		data->scale[i] = 1.0f;
+	kernels->normalize(a3, result3, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 3 * count, &outResults[5]);
+
+	reference->dot(a3, b3, data->reference, count);
+	reference->dot(absA3, absB3, data->scale, count);
+	kernels->dot(a3, b3, data->result, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, count, &outResults[6]);
+
+	//The quaternion kernels give unit quaternions or rotation matrices, their elements are at most 1
+	for (uint32_t i = 0; i < 12 * count; ++i)
+		data->scale[i] = 1.0f;
+
+	Float4Stream quatsA = GetCheckFloat4Stream(data->quatsA);
+	Float4Stream quatsB = GetCheckFloat4Stream(data->quatsB);
+	Float4Stream reference4 = GetCheckFloat4Stream(data->reference);
+	Float4Stream result4 = GetCheckFloat4Stream(data->result);
+
+	reference->nlerpQuats(quatsA, quatsB, data->t, reference4, count);
+	kernels->nlerpQuats(quatsA, quatsB, data->t, result4, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 4 * count, &outResults[7]);
+
+	reference->slerpQuats(quatsA, quatsB, data->t, reference4, count);
+	kernels->slerpQuats(quatsA, quatsB, data->t, result4, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 4 * count, &outResults[8]);
+
+	//The scalar kernel is exact, this measures the error of the approximate reciprocal square roots
+	reference->renormalizeQuats(GetCheckFloat4Stream(data->a), reference4, count);
+	kernels->renormalizeQuats(GetCheckFloat4Stream(data->a), result4, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 4 * count, &outResults[9]);
+
+	reference->quatsToMatrices3x4(quatsA, data->reference, count);
+	kernels->quatsToMatrices3x4(quatsA, data->result, count);
+	CompareBatchMathResults(data->result, data->reference, data->scale, 12 * count, &outResults[10]);
+}
+
+bool CrossCheckBatchMathKernels(float maxUlps, BatchMathCheckResult* outResults)
+{
+	const char* kernelNames[BATCH_MATH_NUM_KERNELS] = {
+		"transformPoints", "transformVectors", "transformFloat4s", "multiplyMatrices", "invertMatrices", "normalize", "dot",
+		"nlerpQuats", "slerpQuats", "renormalizeQuats", "quatsToMatrices3x4" };
+
+	BatchMathInstructionSet bestInstructionSet = GetBestBatchMathInstructionSet();
+
+	BatchMathCheckData* data = (BatchMathCheckData*)calloc(1, sizeof(BatchMathCheckData));
+
+	uint32_t seed = 1;
+	for (uint32_t i = 0; i < 4 * BATCH_MATH_CHECK_COUNT; ++i)
+	{
+		data->a[i] = RandomFloat(seed, -1.0f, 1.0f);
+		data->b[i] = RandomFloat(seed, -1.0f, 1.0f);
+	}
+
+	//Diagonally dominant, so the inverses are well conditioned
+	for (uint32_t i = 0; i < 16 * BATCH_MATH_CHECK_COUNT; ++i)
+	{
+		data->matsA[i] = RandomFloat(seed, -1.0f, 1.0f);
+		data->matsB[i] = RandomFloat(seed, -1.0f, 1.0f);
+		if ((i % 16) % 5 == 0)
+			data->matsA[i] += 4.0f;
+	}
+
+	//Zero vectors and noninvertible matrices in a vector loop and in the tail
+	uint32_t zeroElements[2] = { 1, BATCH_MATH_CHECK_COUNT - 1 };
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		for (uint32_t j = 0; j < 4; ++j)
+			data->a[j * BATCH_MATH_CHECK_COUNT + zeroElements[i]] = 0.0f;
+
+		for (uint32_t j = 0; j < 16; ++j)
+			data->matsA[16 * zeroElements[i] + j] = 0.0f;
+	}
+
+	//Random rotations. The first pair is the same rotation and the second pair almost is, in a vector loop and in the
+	//tail, for the nlerp lanes of slerp. About half of the pairs have a negative dot product and take the short path.
+	RenormalizeQuatsScalar(GetCheckFloat4Stream(data->b), GetCheckFloat4Stream(data->quatsA), 0, BATCH_MATH_CHECK_COUNT);
+	for (uint32_t i = 0; i < 4 * BATCH_MATH_CHECK_COUNT; ++i)
+		data->quatsB[i] = RandomFloat(seed, -1.0f, 1.0f);
+
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		data->quatsB[i * BATCH_MATH_CHECK_COUNT + 2] = data->quatsA[i * BATCH_MATH_CHECK_COUNT + 2];
+		data->quatsB[i * BATCH_MATH_CHECK_COUNT + BATCH_MATH_CHECK_COUNT - 2] = -data->quatsA[i * BATCH_MATH_CHECK_COUNT + BATCH_MATH_CHECK_COUNT - 2] + 0.001f;
+	}
+	RenormalizeQuatsScalar(GetCheckFloat4Stream(data->quatsB), GetCheckFloat4Stream(data->quatsB), 0, BATCH_MATH_CHECK_COUNT);
+
+	for (uint32_t i = 0; i < BATCH_MATH_CHECK_COUNT; ++i)
+		data->t[i] = RandomFloat(seed);
+
+	for (uint32_t i = 0; i < 4 * BATCH_MATH_CHECK_COUNT; ++i)
+	{
+		data->absA[i] = fabsf(data->a[i]);
+		data->absB[i] = fabsf(data->b[i]);
+	}
+
+	for (uint32_t i = 0; i < 16 * BATCH_MATH_CHECK_COUNT; ++i)
+	{
+		data->absMatsA[i] = fabsf(data->matsA[i]);
+		data->absMatsB[i] = fabsf(data->matsB[i]);
+	}
+
+	bool passed = true;
+	for (uint32_t set = 0; set <= bestInstructionSet; ++set)
+	{
+		BatchMathCheckResult results[BATCH_MATH_NUM_KERNELS];
+		for (uint32_t i = 0; i < BATCH_MATH_NUM_KERNELS; ++i)
+		{
+			results[i].instructionSet = (BatchMathInstructionSet)set;
+			results[i].kernel = kernelNames[i];
+			results[i].maxUlps = 0.0f;
+			results[i].bitwiseEqual = true;
+		}
+
+		CheckBatchMathKernelSet(data, &gBatchMath.kernels[BATCH_MATH_INSTRUCTION_SET_SCALAR], &gBatchMath.kernels[set], results);
+
+		for (uint32_t i = 0; i < BATCH_MATH_NUM_KERNELS; ++i)
+		{
+			if (results[i].maxUlps > maxUlps)
+				passed = false;
+
+			if (outResults)
+				outResults[set * BATCH_MATH_NUM_KERNELS + i] = results[i];
+		}
+	}
+
+	free(data);
+
+	return passed;
+}
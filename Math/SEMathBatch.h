@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMath_Header.h"
+#include "SEMathBatchKernels.h"
+
+//Math on many elements at once, for skinning, culling and shape updates.
+//The vectors are structure of arrays streams, so the kernels work on 4, 8 or 16 elements per instruction.
+//Every function has a scalar, SSE 4.2, AVX2 and AVX-512 kernel, the elements left over are done one at a time.
+//InitBatchMath binds the best kernels the processor supports, SetBatchMathInstructionSet can pick another set.
+//The output streams can be the input streams, the arrays don't need to be aligned.
+
+enum BatchMathInstructionSet
+{
+	//The reference the other kernels are checked against
+	BATCH_MATH_INSTRUCTION_SET_SCALAR = 0,
+	BATCH_MATH_INSTRUCTION_SET_SSE42 = 1,
+
+	//AVX2 and FMA
+	BATCH_MATH_INSTRUCTION_SET_AVX2 = 2,
+	BATCH_MATH_INSTRUCTION_SET_AVX512 = 3,
+	BATCH_MATH_INSTRUCTION_SET_COUNT
+};
+
+//Number of kernels CrossCheckBatchMathKernels checks per instruction set
+#define BATCH_MATH_NUM_KERNELS 11
+
+//Error allowed by the check debug builds run at startup. The kernels with FMA round fewer times than the scalar kernels.
+#define BATCH_MATH_CHECK_MAX_ULPS 4.0f
+
+//The largest error of a kernel against the scalar kernel on the same inputs
+struct BatchMathCheckResult
+{
+	BatchMathInstructionSet instructionSet;
+
+	//Name of the BatchMathKernels member
+	const char* kernel;
+
+	//In units in the last place. Results that lose precision to cancellation are measured against the size of their terms.
+	float maxUlps;
+	bool bitwiseEqual;
+};
+
+//Queries cpuid and binds the best kernels. Called by WindowsMain at startup, before any thread is started.
+//The batch functions call it on first use if it wasn't.
+void InitBatchMath();
+
+//Returns the best instruction set of the processor
+BatchMathInstructionSet GetBestBatchMathInstructionSet();
+
+//Binds the kernels of instructionSet, or of the best set the processor supports if it's lower.
+//Must not be called while a batch function runs on another thread.
+void SetBatchMathInstructionSet(BatchMathInstructionSet instructionSet);
+
+//Returns the instruction set of the bound kernels
+BatchMathInstructionSet GetBatchMathInstructionSet();
+
+//Test mode. Runs every kernel of every instruction set the processor supports on the same random inputs, with counts
+//that leave elements over for the tails, and compares them with the scalar kernels.
+//outResults can be nullptr or hold BATCH_MATH_INSTRUCTION_SET_COUNT * BATCH_MATH_NUM_KERNELS results, the sets the
+//processor doesn't support are skipped and their results left as they are.
+//Returns false if any result is more than maxUlps away from the scalar result.
+bool CrossCheckBatchMathKernels(float maxUlps, BatchMathCheckResult* outResults);
+
+//out[i] = float4(in[i], 1) * mat, the last column of mat is ignored
+void TransformPointStream(const mat4* mat, Float3Stream in, Float3Stream out, uint32_t count);
+
+//out[i] = float4(in[i], 0) * mat, the last column of mat is ignored
+void TransformVectorStream(const mat4* mat, Float3Stream in, Float3Stream out, uint32_t count);
+
+//out[i] = in[i] * mat
+void TransformFloat4Stream(const mat4* mat, Float4Stream in, Float4Stream out, uint32_t count);
+
+//outMats[i] = matsA[i] * matsB[i]. outMats can be matsA or matsB.
+void MultiplyMatrices(const mat4* matsA, const mat4* matsB, mat4* outMats, uint32_t count);
+
+//outMats[i] = Inverse(mats[i]). Noninvertible matrices give the zero matrix like Inverse. outMats can be mats.
+void InvertMatrices(const mat4* mats, mat4* outMats, uint32_t count);
+
+//out[i] = in[i] / length(in[i]). Vectors of length 0 stay 0.
+void NormalizeStream(Float3Stream in, Float3Stream out, uint32_t count);
+
+//out[i] = dot(a[i], b[i])
+void DotStream(Float3Stream a, Float3Stream b, float* out, uint32_t count);
+
+//The quaternion streams are (x, y, z, w) with w the scalar part, like quat(x, y, z, scalar).
+
+//out[i] = Nlerp(a[i], b[i], t[i])
+void NlerpQuatStream(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count);
+
+//out[i] = Slerp(a[i], b[i], t[i]) for unit quaternions, with t in [0, 1].
+//acos and sin are polynomials, the results are within 1e-6 of Slerp.
+void SlerpQuatStream(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count);
+
+//out[i] = Normalize(in[i]) with an approximate reciprocal square root and a Newton step, the relative error is below 5e-7.
+//Cheaper than NormalizeStream, for quaternions that drift from length 1 after many products or nlerps.
+//Quaternions of length 0 stay 0.
+void RenormalizeQuatStream(Float4Stream in, Float4Stream out, uint32_t count);
+
+//Writes the rotation matrices of unit quaternions as 3x4 matrices in the layout of ShapeInstance:
+//outRows[3 * i + j] is column j of QuaternionToMatrix(quats[i]) with a w of 0, so p * QuaternionToMatrix(quats[i]) is
+//(dot(outRows[3 * i], p), dot(outRows[3 * i + 1], p), dot(outRows[3 * i + 2], p)).
+void QuatStreamToMatrices3x4(Float4Stream quats, vec4* outRows, uint32_t count);
@@ -0,0 +1,356 @@
+#pragma once
+
+//Shared by the kernels of every instruction set. SEMathBatch_AVX2.cpp and SEMathBatch_AVX512.cpp are compiled with
+//AVX2 and AVX-512 enabled, so they don't include the math library: an inline function compiled there could be the copy
+//the linker keeps for the whole program and run on a CPU without AVX. The scalar tails are static for the same reason.
+
+#include <cmath>
+#include <cstdint>
+
+//A stream of 3D vectors as structure of arrays, element i is (x[i], y[i], z[i])
+struct Float3Stream
+{
+	float* x;
+	float* y;
+	float* z;
+};
+
+//A stream of 4D vectors as structure of arrays, element i is (x[i], y[i], z[i], w[i])
+struct Float4Stream
+{
+	float* x;
+	float* y;
+	float* z;
+	float* w;
+};
+
+//The matrices are 16 floats in row major order, vectors are multiplied from the left.
+struct BatchMathKernels
+{
+	void (*transformPoints)(const float* mat, Float3Stream in, Float3Stream out, uint32_t count);
+	void (*transformVectors)(const float* mat, Float3Stream in, Float3Stream out, uint32_t count);
+	void (*transformFloat4s)(const float* mat, Float4Stream in, Float4Stream out, uint32_t count);
+	void (*multiplyMatrices)(const float* matsA, const float* matsB, float* outMats, uint32_t count);
+	void (*invertMatrices)(const float* mats, float* outMats, uint32_t count);
+	void (*normalize)(Float3Stream in, Float3Stream out, uint32_t count);
+	void (*dot)(Float3Stream a, Float3Stream b, float* out, uint32_t count);
+
+	//Quaternions are Float4Streams with w the scalar part
+	void (*nlerpQuats)(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count);
+	void (*slerpQuats)(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count);
+	void (*renormalizeQuats)(Float4Stream in, Float4Stream out, uint32_t count);
+	void (*quatsToMatrices3x4)(Float4Stream quats, float* outRows, uint32_t count);
+};
+
+//Above this cos(angle) slerp uses nlerp, sin(angle) goes to 0 and the arc is almost a straight line. The same as Slerp.
+#define BATCH_SLERP_NLERP_THRESHOLD 0.9995f
+
+//Coefficients of acos(x) = sqrt(1 - x) * (A0 + A1 * x + ... + A7 * x^7) for x in [0, 1], the error is below 2e-8.
+//Abramowitz and Stegun 4.4.46.
+#define BATCH_ACOS_A0 1.5707963050f
+#define BATCH_ACOS_A1 -0.2145988016f
+#define BATCH_ACOS_A2 0.0889789874f
+#define BATCH_ACOS_A3 -0.0501743046f
+#define BATCH_ACOS_A4 0.0308918810f
+#define BATCH_ACOS_A5 -0.0170881256f
+#define BATCH_ACOS_A6 0.0066700901f
+#define BATCH_ACOS_A7 -0.0012624911f
+
+//Coefficients of sin(x) = x + x^3 * (S3 + S5 * x^2 + ... + S11 * x^8), the Taylor series. The error is below 6e-8 for
+//x in [0, pi / 2], the range of the slerp angles.
+#define BATCH_SIN_S3 -1.6666667e-1f
+#define BATCH_SIN_S5 8.3333333e-3f
+#define BATCH_SIN_S7 -1.9841270e-4f
+#define BATCH_SIN_S9 2.7557319e-6f
+#define BATCH_SIN_S11 -2.5052108e-8f
+
+void GetBatchMathKernelsScalar(BatchMathKernels* kernels);
+void GetBatchMathKernelsSSE42(BatchMathKernels* kernels);
+void GetBatchMathKernelsAVX2(BatchMathKernels* kernels);
+void GetBatchMathKernelsAVX512(BatchMathKernels* kernels);
+
+//Scalar versions for the elements [first, count) the vector loops leave over
+
+static inline void TransformPointsScalar(const float* mat, Float3Stream in, Float3Stream out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		float x = in.x[i];
+		float y = in.y[i];
+		float z = in.z[i];
+		out.x[i] = x * mat[0] + y * mat[4] + z * mat[8] + mat[12];
+		out.y[i] = x * mat[1] + y * mat[5] + z * mat[9] + mat[13];
+		out.z[i] = x * mat[2] + y * mat[6] + z * mat[10] + mat[14];
+	}
+}
+
+static inline void TransformVectorsScalar(const float* mat, Float3Stream in, Float3Stream out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		float x = in.x[i];
+		float y = in.y[i];
+		float z = in.z[i];
+		out.x[i] = x * mat[0] + y * mat[4] + z * mat[8];
+		out.y[i] = x * mat[1] + y * mat[5] + z * mat[9];
+		out.z[i] = x * mat[2] + y * mat[6] + z * mat[10];
+	}
+}
+
+static inline void TransformFloat4sScalar(const float* mat, Float4Stream in, Float4Stream out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		float x = in.x[i];
+		float y = in.y[i];
+		float z = in.z[i];
+		float w = in.w[i];
+		out.x[i] = x * mat[0] + y * mat[4] + z * mat[8] + w * mat[12];
+		out.y[i] = x * mat[1] + y * mat[5] + z * mat[9] + w * mat[13];
+		out.z[i] = x * mat[2] + y * mat[6] + z * mat[10] + w * mat[14];
+		out.w[i] = x * mat[3] + y * mat[7] + z * mat[11] + w * mat[15];
+	}
+}
+
+static inline void MultiplyMatricesScalar(const float* matsA, const float* matsB, float* outMats, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		const float* a = matsA + 16 * i;
+		const float* b = matsB + 16 * i;
+
+		//Everything is read before the first write, outMats can be matsA or matsB
+		float result[16];
+		for (uint32_t row = 0; row < 4; ++row)
+		{
+			for (uint32_t col = 0; col < 4; ++col)
+				result[4 * row + col] = (a[4 * row] * b[col] + a[4 * row + 1] * b[4 + col]) + (a[4 * row + 2] * b[8 + col] + a[4 * row + 3] * b[12 + col]);
+		}
+
+		for (uint32_t j = 0; j < 16; ++j)
+			outMats[16 * i + j] = result[j];
+	}
+}
+
+//Cramer's rule on the 2x2 blocks like the SIMD kernels, with the same order of operations.
+//Noninvertible matrices give the zero matrix.
+static inline void InvertMatricesScalar(const float* mats, float* outMats, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		const float* m = mats + 16 * i;
+
+		//mat = | A B |, the blocks are (m00, m01, m10, m11)
+		//      | C D |
+		float a[4] = { m[0], m[1], m[4], m[5] };
+		float b[4] = { m[2], m[3], m[6], m[7] };
+		float c[4] = { m[8], m[9], m[12], m[13] };
+		float d[4] = { m[10], m[11], m[14], m[15] };
+
+		float detA = a[0] * a[3] - a[1] * a[2];
+		float detB = b[0] * b[3] - b[1] * b[2];
+		float detC = c[0] * c[3] - c[1] * c[2];
+		float detD = d[0] * d[3] - d[1] * d[2];
+
+		//adjugate(D) * C and adjugate(A) * B
+		float adjDC[4] = { d[3] * c[0] - d[1] * c[2], d[3] * c[1] - d[1] * c[3], d[0] * c[2] - d[2] * c[0], d[0] * c[3] - d[2] * c[1] };
+		float adjAB[4] = { a[3] * b[0] - a[1] * b[2], a[3] * b[1] - a[1] * b[3], a[0] * b[2] - a[2] * b[0], a[0] * b[3] - a[2] * b[1] };
+
+		//adjugate(X) = det(D) * A - B * adjugate(D) * C and so on
+		float x[4] = {
+			detD * a[0] - (b[0] * adjDC[0] + b[1] * adjDC[2]), detD * a[1] - (b[1] * adjDC[3] + b[0] * adjDC[1]),
+			detD * a[2] - (b[2] * adjDC[0] + b[3] * adjDC[2]), detD * a[3] - (b[3] * adjDC[3] + b[2] * adjDC[1]) };
+		float w[4] = {
+			detA * d[0] - (c[0] * adjAB[0] + c[1] * adjAB[2]), detA * d[1] - (c[1] * adjAB[3] + c[0] * adjAB[1]),
+			detA * d[2] - (c[2] * adjAB[0] + c[3] * adjAB[2]), detA * d[3] - (c[3] * adjAB[3] + c[2] * adjAB[1]) };
+		float y[4] = {
+			detB * c[0] - (d[0] * adjAB[3] - d[1] * adjAB[2]), detB * c[1] - (d[1] * adjAB[0] - d[0] * adjAB[1]),
+			detB * c[2] - (d[2] * adjAB[3] - d[3] * adjAB[2]), detB * c[3] - (d[3] * adjAB[0] - d[2] * adjAB[1]) };
+		float z[4] = {
+			detC * b[0] - (a[0] * adjDC[3] - a[1] * adjDC[2]), detC * b[1] - (a[1] * adjDC[0] - a[0] * adjDC[1]),
+			detC * b[2] - (a[2] * adjDC[3] - a[3] * adjDC[2]), detC * b[3] - (a[3] * adjDC[0] - a[2] * adjDC[1]) };
+
+		float trace = (adjAB[0] * adjDC[0] + adjAB[1] * adjDC[2]) + (adjAB[2] * adjDC[1] + adjAB[3] * adjDC[3]);
+		float det = (detA * detD + detB * detC) - trace;
+
+		float* out = outMats + 16 * i;
+		if (det == 0.0f)
+		{
+			for (uint32_t j = 0; j < 16; ++j)
+				out[j] = 0.0f;
+
+			continue;
+		}
+
+		//The signs of the adjugates
+		float invDet = 1.0f / det;
+		float negInvDet = -1.0f / det;
+
+		//Swaps the diagonals of the adjugates and puts the blocks back into rows
+		float result[16] = {
+			x[3] * invDet, x[1] * negInvDet, y[3] * invDet, y[1] * negInvDet,
+			x[2] * negInvDet, x[0] * invDet, y[2] * negInvDet, y[0] * invDet,
+			z[3] * invDet, z[1] * negInvDet, w[3] * invDet, w[1] * negInvDet,
+			z[2] * negInvDet, z[0] * invDet, w[2] * negInvDet, w[0] * invDet };
+
+		for (uint32_t j = 0; j < 16; ++j)
+			out[j] = result[j];
+	}
+}
+
+static inline void NormalizeScalar(Float3Stream in, Float3Stream out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		float x = in.x[i];
+		float y = in.y[i];
+		float z = in.z[i];
+		float lengthSq = x * x + y * y + z * z;
+		float invLength = (lengthSq > 0.0f) ? 1.0f / sqrtf(lengthSq) : 0.0f;
+		out.x[i] = x * invLength;
+		out.y[i] = y * invLength;
+		out.z[i] = z * invLength;
+	}
+}
+
+static inline void NlerpQuatsScalar(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		//Negating b takes the shortest path
+		float dot = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i] + a.w[i] * b.w[i];
+		float weightA = 1.0f - t[i];
+		float weightB = (dot < 0.0f) ? -t[i] : t[i];
+
+		float x = a.x[i] * weightA + b.x[i] * weightB;
+		float y = a.y[i] * weightA + b.y[i] * weightB;
+		float z = a.z[i] * weightA + b.z[i] * weightB;
+		float w = a.w[i] * weightA + b.w[i] * weightB;
+
+		float lengthSq = x * x + y * y + z * z + w * w;
+		float invLength = (lengthSq > 0.0f) ? 1.0f / sqrtf(lengthSq) : 0.0f;
+		out.x[i] = x * invLength;
+		out.y[i] = y * invLength;
+		out.z[i] = z * invLength;
+		out.w[i] = w * invLength;
+	}
+}
+
+//Returns sin(x) for x in [0, pi / 2]
+static inline float SinScalar(float x)
+{
+	float x2 = x * x;
+	float p = BATCH_SIN_S11;
+	p = p * x2 + BATCH_SIN_S9;
+	p = p * x2 + BATCH_SIN_S7;
+	p = p * x2 + BATCH_SIN_S5;
+	p = p * x2 + BATCH_SIN_S3;
+
+	return (x * x2) * p + x;
+}
+
+static inline void SlerpQuatsScalar(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		float dot = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i] + a.w[i] * b.w[i];
+		float cosAngle = fabsf(dot);
+		if (cosAngle > BATCH_SLERP_NLERP_THRESHOLD)
+		{
+			NlerpQuatsScalar(a, b, t, out, i, i + 1);
+			continue;
+		}
+
+		float p = BATCH_ACOS_A7;
+		p = p * cosAngle + BATCH_ACOS_A6;
+		p = p * cosAngle + BATCH_ACOS_A5;
+		p = p * cosAngle + BATCH_ACOS_A4;
+		p = p * cosAngle + BATCH_ACOS_A3;
+		p = p * cosAngle + BATCH_ACOS_A2;
+		p = p * cosAngle + BATCH_ACOS_A1;
+		p = p * cosAngle + BATCH_ACOS_A0;
+		float angle = sqrtf(1.0f - cosAngle) * p;
+
+		//sin(angle) = sqrt(1 - cos(angle)^2)
+		float invSinAngle = 1.0f / sqrtf((1.0f - cosAngle) * (1.0f + cosAngle));
+		float weightA = SinScalar((1.0f - t[i]) * angle) * invSinAngle;
+		float weightB = SinScalar(t[i] * angle) * invSinAngle;
+		if (dot < 0.0f)
+			weightB = -weightB;
+
+		float x = a.x[i] * weightA + b.x[i] * weightB;
+		float y = a.y[i] * weightA + b.y[i] * weightB;
+		float z = a.z[i] * weightA + b.z[i] * weightB;
+		float w = a.w[i] * weightA + b.w[i] * weightB;
+		out.x[i] = x;
+		out.y[i] = y;
+		out.z[i] = z;
+		out.w[i] = w;
+	}
+}
+
+//Exact, the vector kernels use rsqrt and a Newton step
+static inline void RenormalizeQuatsScalar(Float4Stream in, Float4Stream out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		float x = in.x[i];
+		float y = in.y[i];
+		float z = in.z[i];
+		float w = in.w[i];
+		float lengthSq = x * x + y * y + z * z + w * w;
+		float invLength = (lengthSq > 0.0f) ? 1.0f / sqrtf(lengthSq) : 0.0f;
+		out.x[i] = x * invLength;
+		out.y[i] = y * invLength;
+		out.z[i] = z * invLength;
+		out.w[i] = w * invLength;
+	}
+}
+
+//outRows[12 * i + 4 * j] receives column j of the rotation matrix of quaternion i, with a w of 0
+static inline void QuatsToMatrices3x4Scalar(Float4Stream quats, float* outRows, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+	{
+		float x = quats.x[i];
+		float y = quats.y[i];
+		float z = quats.z[i];
+		float w = quats.w[i];
+
+		float x2 = x * 2.0f;
+		float y2 = y * 2.0f;
+		float z2 = z * 2.0f;
+
+		float xx = x * x2;
+		float yy = y * y2;
+		float zz = z * z2;
+		float xy = x * y2;
+		float xz = x * z2;
+		float yz = y * z2;
+		float wx = w * x2;
+		float wy = w * y2;
+		float wz = w * z2;
+
+		float* rows = outRows + 12 * i;
+		rows[0] = 1.0f - (yy + zz);
+		rows[1] = xy - wz;
+		rows[2] = xz + wy;
+		rows[3] = 0.0f;
+
+		rows[4] = xy + wz;
+		rows[5] = 1.0f - (xx + zz);
+		rows[6] = yz - wx;
+		rows[7] = 0.0f;
+
+		rows[8] = xz - wy;
+		rows[9] = yz + wx;
+		rows[10] = 1.0f - (xx + yy);
+		rows[11] = 0.0f;
+	}
+}
+
+static inline void DotScalar(Float3Stream a, Float3Stream b, float* out, uint32_t first, uint32_t count)
+{
+	for (uint32_t i = first; i < count; ++i)
+		out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+}
@@ -0,0 +1,446 @@
+#include <immintrin.h>
+
+#include "SEMathBatchKernels.h"
+
+//AVX2 kernels, 8 elements at a time with FMA.
+//Compiled with AVX2 enabled and only called if GetCPUFeatures reports CPU_FEATURE_FLAGS_AVX2.
+
+void TransformPointsAVX2(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	//m[4 * row + col]
+	__m256 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm256_set1_ps(mat[i]);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(in.x + i);
+		__m256 y = _mm256_loadu_ps(in.y + i);
+		__m256 z = _mm256_loadu_ps(in.z + i);
+
+		_mm256_storeu_ps(out.x + i, _mm256_fmadd_ps(x, m[0], _mm256_fmadd_ps(y, m[4], _mm256_fmadd_ps(z, m[8], m[12]))));
+		_mm256_storeu_ps(out.y + i, _mm256_fmadd_ps(x, m[1], _mm256_fmadd_ps(y, m[5], _mm256_fmadd_ps(z, m[9], m[13]))));
+		_mm256_storeu_ps(out.z + i, _mm256_fmadd_ps(x, m[2], _mm256_fmadd_ps(y, m[6], _mm256_fmadd_ps(z, m[10], m[14]))));
+	}
+
+	TransformPointsScalar(mat, in, out, i, count);
+}
+
+void TransformVectorsAVX2(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	__m256 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm256_set1_ps(mat[i]);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(in.x + i);
+		__m256 y = _mm256_loadu_ps(in.y + i);
+		__m256 z = _mm256_loadu_ps(in.z + i);
+
+		_mm256_storeu_ps(out.x + i, _mm256_fmadd_ps(x, m[0], _mm256_fmadd_ps(y, m[4], _mm256_mul_ps(z, m[8]))));
+		_mm256_storeu_ps(out.y + i, _mm256_fmadd_ps(x, m[1], _mm256_fmadd_ps(y, m[5], _mm256_mul_ps(z, m[9]))));
+		_mm256_storeu_ps(out.z + i, _mm256_fmadd_ps(x, m[2], _mm256_fmadd_ps(y, m[6], _mm256_mul_ps(z, m[10]))));
+	}
+
+	TransformVectorsScalar(mat, in, out, i, count);
+}
+
+void TransformFloat4sAVX2(const float* mat, Float4Stream in, Float4Stream out, uint32_t count)
+{
+	__m256 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm256_set1_ps(mat[i]);
+
+	float* outputs[4] = { out.x, out.y, out.z, out.w };
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(in.x + i);
+		__m256 y = _mm256_loadu_ps(in.y + i);
+		__m256 z = _mm256_loadu_ps(in.z + i);
+		__m256 w = _mm256_loadu_ps(in.w + i);
+
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			__m256 result = _mm256_fmadd_ps(x, m[j], _mm256_fmadd_ps(y, m[4 + j], _mm256_fmadd_ps(z, m[8 + j], _mm256_mul_ps(w, m[12 + j]))));
+			_mm256_storeu_ps(outputs[j] + i, result);
+		}
+	}
+
+	TransformFloat4sScalar(mat, in, out, i, count);
+}
+
+void MultiplyMatricesAVX2(const float* matsA, const float* matsB, float* outMats, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const float* a = matsA + 16 * i;
+		const float* b = matsB + 16 * i;
+
+		//Row k of B in both halves
+		__m256 b0 = _mm256_broadcast_ps((const __m128*)b);
+		__m256 b1 = _mm256_broadcast_ps((const __m128*)(b + 4));
+		__m256 b2 = _mm256_broadcast_ps((const __m128*)(b + 8));
+		__m256 b3 = _mm256_broadcast_ps((const __m128*)(b + 12));
+
+		//Two rows of A per register, the permutes broadcast element k of each row to its half
+		__m256 rows[2];
+		for (uint32_t j = 0; j < 2; ++j)
+		{
+			__m256 row = _mm256_loadu_ps(a + 8 * j);
+			__m256 sum0 = _mm256_fmadd_ps(_mm256_permute_ps(row, _MM_SHUFFLE(1, 1, 1, 1)), b1, _mm256_mul_ps(_mm256_permute_ps(row, _MM_SHUFFLE(0, 0, 0, 0)), b0));
+			__m256 sum1 = _mm256_fmadd_ps(_mm256_permute_ps(row, _MM_SHUFFLE(3, 3, 3, 3)), b3, _mm256_mul_ps(_mm256_permute_ps(row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+			rows[j] = _mm256_add_ps(sum0, sum1);
+		}
+
+		_mm256_storeu_ps(outMats + 16 * i, rows[0]);
+		_mm256_storeu_ps(outMats + 16 * i + 8, rows[1]);
+	}
+}
+
+//Two 2x2 matrices per register, one in each half as (m00, m01, m10, m11)
+
+//Returns a * b
+static inline __m256 Multiply2x2AVX2(__m256 a, __m256 b)
+{
+	return _mm256_add_ps(_mm256_mul_ps(a, _mm256_permute_ps(b, _MM_SHUFFLE(3, 0, 3, 0))),
+		_mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute_ps(b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//Returns adjugate(a) * b
+static inline __m256 AdjugateMultiply2x2AVX2(__m256 a, __m256 b)
+{
+	return _mm256_sub_ps(_mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		_mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 2, 1, 1)), _mm256_permute_ps(b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+//Returns a * adjugate(b)
+static inline __m256 MultiplyAdjugate2x2AVX2(__m256 a, __m256 b)
+{
+	return _mm256_sub_ps(_mm256_mul_ps(a, _mm256_permute_ps(b, _MM_SHUFFLE(0, 3, 0, 3))),
+		_mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute_ps(b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+void InvertMatricesAVX2(const float* mats, float* outMats, uint32_t count)
+{
+	__m256 zero = _mm256_setzero_ps();
+	__m256 signs = _mm256_set_ps(1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f);
+
+	//The SSE 4.2 kernel on two matrices at once, matrix i in the lower half and i + 1 in the upper half.
+	//No FMA, so the results are the same as the other kernels.
+	uint32_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		const float* m0 = mats + 16 * i;
+		const float* m1 = m0 + 16;
+
+		__m256 r[4];
+		for (uint32_t j = 0; j < 4; ++j)
+			r[j] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(m0 + 4 * j)), _mm_loadu_ps(m1 + 4 * j), 1);
+
+		__m256 a = _mm256_shuffle_ps(r[0], r[1], _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 b = _mm256_shuffle_ps(r[0], r[1], _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 c = _mm256_shuffle_ps(r[2], r[3], _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 d = _mm256_shuffle_ps(r[2], r[3], _MM_SHUFFLE(3, 2, 3, 2));
+
+		__m256 blockDets = _mm256_sub_ps(
+			_mm256_mul_ps(_mm256_shuffle_ps(r[0], r[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(r[1], r[3], _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm256_mul_ps(_mm256_shuffle_ps(r[0], r[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm256_shuffle_ps(r[1], r[3], _MM_SHUFFLE(2, 0, 2, 0))));
+
+		__m256 detA = _mm256_permute_ps(blockDets, _MM_SHUFFLE(0, 0, 0, 0));
+		__m256 detB = _mm256_permute_ps(blockDets, _MM_SHUFFLE(1, 1, 1, 1));
+		__m256 detC = _mm256_permute_ps(blockDets, _MM_SHUFFLE(2, 2, 2, 2));
+		__m256 detD = _mm256_permute_ps(blockDets, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m256 adjDC = AdjugateMultiply2x2AVX2(d, c);
+		__m256 adjAB = AdjugateMultiply2x2AVX2(a, b);
+
+		__m256 x = _mm256_sub_ps(_mm256_mul_ps(detD, a), Multiply2x2AVX2(b, adjDC));
+		__m256 w = _mm256_sub_ps(_mm256_mul_ps(detA, d), Multiply2x2AVX2(c, adjAB));
+		__m256 y = _mm256_sub_ps(_mm256_mul_ps(detB, c), MultiplyAdjugate2x2AVX2(d, adjAB));
+		__m256 z = _mm256_sub_ps(_mm256_mul_ps(detC, b), MultiplyAdjugate2x2AVX2(a, adjDC));
+
+		//hadd works within each half
+		__m256 trace = _mm256_mul_ps(adjAB, _mm256_permute_ps(adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+		trace = _mm256_hadd_ps(trace, trace);
+		trace = _mm256_hadd_ps(trace, trace);
+		__m256 det = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(detA, detD), _mm256_mul_ps(detB, detC)), trace);
+
+		__m256 invDet = _mm256_div_ps(signs, det);
+		__m256 invertible = _mm256_cmp_ps(det, zero, _CMP_NEQ_UQ);
+		x = _mm256_and_ps(_mm256_mul_ps(x, invDet), invertible);
+		y = _mm256_and_ps(_mm256_mul_ps(y, invDet), invertible);
+		z = _mm256_and_ps(_mm256_mul_ps(z, invDet), invertible);
+		w = _mm256_and_ps(_mm256_mul_ps(w, invDet), invertible);
+
+		__m256 rows[4] = {
+			_mm256_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)),
+			_mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)),
+			_mm256_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)),
+			_mm256_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)) };
+
+		float* out0 = outMats + 16 * i;
+		float* out1 = out0 + 16;
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			_mm_storeu_ps(out0 + 4 * j, _mm256_castps256_ps128(rows[j]));
+			_mm_storeu_ps(out1 + 4 * j, _mm256_extractf128_ps(rows[j], 1));
+		}
+	}
+
+	InvertMatricesScalar(mats, outMats, i, count);
+}
+
+void NormalizeAVX2(Float3Stream in, Float3Stream out, uint32_t count)
+{
+	__m256 zero = _mm256_setzero_ps();
+	__m256 one = _mm256_set1_ps(1.0f);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(in.x + i);
+		__m256 y = _mm256_loadu_ps(in.y + i);
+		__m256 z = _mm256_loadu_ps(in.z + i);
+
+		__m256 lengthSq = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+		__m256 invLength = _mm256_and_ps(_mm256_div_ps(one, _mm256_sqrt_ps(lengthSq)), _mm256_cmp_ps(lengthSq, zero, _CMP_GT_OQ));
+
+		_mm256_storeu_ps(out.x + i, _mm256_mul_ps(x, invLength));
+		_mm256_storeu_ps(out.y + i, _mm256_mul_ps(y, invLength));
+		_mm256_storeu_ps(out.z + i, _mm256_mul_ps(z, invLength));
+	}
+
+	NormalizeScalar(in, out, i, count);
+}
+
+void DotAVX2(Float3Stream a, Float3Stream b, float* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 result = _mm256_mul_ps(_mm256_loadu_ps(a.x + i), _mm256_loadu_ps(b.x + i));
+		result = _mm256_fmadd_ps(_mm256_loadu_ps(a.y + i), _mm256_loadu_ps(b.y + i), result);
+		result = _mm256_fmadd_ps(_mm256_loadu_ps(a.z + i), _mm256_loadu_ps(b.z + i), result);
+		_mm256_storeu_ps(out + i, result);
+	}
+
+	DotScalar(a, b, out, i, count);
+}
+
+//Returns the normalized a * weightA + b * weightB, lanes of length 0 are left 0
+static inline void LerpNormalizeAVX2(const __m256* a, const __m256* b, __m256 weightA, __m256 weightB, __m256* out)
+{
+	for (uint32_t j = 0; j < 4; ++j)
+		out[j] = _mm256_fmadd_ps(b[j], weightB, _mm256_mul_ps(a[j], weightA));
+
+	__m256 lengthSq = _mm256_fmadd_ps(out[3], out[3], _mm256_fmadd_ps(out[2], out[2], _mm256_fmadd_ps(out[1], out[1], _mm256_mul_ps(out[0], out[0]))));
+	__m256 invLength = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(lengthSq)), _mm256_cmp_ps(lengthSq, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+	for (uint32_t j = 0; j < 4; ++j)
+		out[j] = _mm256_mul_ps(out[j], invLength);
+}
+
+static inline __m256 QuatDotAVX2(const __m256* a, const __m256* b)
+{
+	return _mm256_fmadd_ps(a[3], b[3], _mm256_fmadd_ps(a[2], b[2], _mm256_fmadd_ps(a[1], b[1], _mm256_mul_ps(a[0], b[0]))));
+}
+
+void NlerpQuatsAVX2(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 signMask = _mm256_set1_ps(-0.0f);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 qa[4] = { _mm256_loadu_ps(a.x + i), _mm256_loadu_ps(a.y + i), _mm256_loadu_ps(a.z + i), _mm256_loadu_ps(a.w + i) };
+		__m256 qb[4] = { _mm256_loadu_ps(b.x + i), _mm256_loadu_ps(b.y + i), _mm256_loadu_ps(b.z + i), _mm256_loadu_ps(b.w + i) };
+		__m256 weight = _mm256_loadu_ps(t + i);
+
+		__m256 flip = _mm256_and_ps(_mm256_cmp_ps(QuatDotAVX2(qa, qb), _mm256_setzero_ps(), _CMP_LT_OQ), signMask);
+
+		__m256 result[4];
+		LerpNormalizeAVX2(qa, qb, _mm256_sub_ps(one, weight), _mm256_xor_ps(weight, flip), result);
+
+		_mm256_storeu_ps(out.x + i, result[0]);
+		_mm256_storeu_ps(out.y + i, result[1]);
+		_mm256_storeu_ps(out.z + i, result[2]);
+		_mm256_storeu_ps(out.w + i, result[3]);
+	}
+
+	NlerpQuatsScalar(a, b, t, out, i, count);
+}
+
+//Returns sin(x) for x in [0, pi / 2]
+static inline __m256 SinAVX2(__m256 x)
+{
+	__m256 x2 = _mm256_mul_ps(x, x);
+	__m256 p = _mm256_set1_ps(BATCH_SIN_S11);
+	p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(BATCH_SIN_S9));
+	p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(BATCH_SIN_S7));
+	p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(BATCH_SIN_S5));
+	p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(BATCH_SIN_S3));
+
+	return _mm256_fmadd_ps(_mm256_mul_ps(x, x2), p, x);
+}
+
+void SlerpQuatsAVX2(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 signMask = _mm256_set1_ps(-0.0f);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 qa[4] = { _mm256_loadu_ps(a.x + i), _mm256_loadu_ps(a.y + i), _mm256_loadu_ps(a.z + i), _mm256_loadu_ps(a.w + i) };
+		__m256 qb[4] = { _mm256_loadu_ps(b.x + i), _mm256_loadu_ps(b.y + i), _mm256_loadu_ps(b.z + i), _mm256_loadu_ps(b.w + i) };
+		__m256 weight = _mm256_loadu_ps(t + i);
+
+		__m256 dot = QuatDotAVX2(qa, qb);
+		__m256 flip = _mm256_and_ps(_mm256_cmp_ps(dot, _mm256_setzero_ps(), _CMP_LT_OQ), signMask);
+		__m256 cosAngle = _mm256_andnot_ps(signMask, dot);
+
+		//acos(cosAngle)
+		__m256 p = _mm256_set1_ps(BATCH_ACOS_A7);
+		p = _mm256_fmadd_ps(p, cosAngle, _mm256_set1_ps(BATCH_ACOS_A6));
+		p = _mm256_fmadd_ps(p, cosAngle, _mm256_set1_ps(BATCH_ACOS_A5));
+		p = _mm256_fmadd_ps(p, cosAngle, _mm256_set1_ps(BATCH_ACOS_A4));
+		p = _mm256_fmadd_ps(p, cosAngle, _mm256_set1_ps(BATCH_ACOS_A3));
+		p = _mm256_fmadd_ps(p, cosAngle, _mm256_set1_ps(BATCH_ACOS_A2));
+		p = _mm256_fmadd_ps(p, cosAngle, _mm256_set1_ps(BATCH_ACOS_A1));
+		p = _mm256_fmadd_ps(p, cosAngle, _mm256_set1_ps(BATCH_ACOS_A0));
+		__m256 oneMinusCos = _mm256_sub_ps(one, cosAngle);
+		__m256 angle = _mm256_mul_ps(_mm256_sqrt_ps(oneMinusCos), p);
+
+		__m256 invSinAngle = _mm256_div_ps(one, _mm256_sqrt_ps(_mm256_mul_ps(oneMinusCos, _mm256_add_ps(one, cosAngle))));
+		__m256 weightA = _mm256_mul_ps(SinAVX2(_mm256_mul_ps(_mm256_sub_ps(one, weight), angle)), invSinAngle);
+		__m256 weightB = _mm256_xor_ps(_mm256_mul_ps(SinAVX2(_mm256_mul_ps(weight, angle)), invSinAngle), flip);
+
+		__m256 result[4];
+		for (uint32_t j = 0; j < 4; ++j)
+			result[j] = _mm256_fmadd_ps(qb[j], weightB, _mm256_mul_ps(qa[j], weightA));
+
+		//The lanes of almost the same rotation get nlerp
+		__m256 nearlyParallel = _mm256_cmp_ps(cosAngle, _mm256_set1_ps(BATCH_SLERP_NLERP_THRESHOLD), _CMP_GT_OQ);
+		if (_mm256_movemask_ps(nearlyParallel) != 0)
+		{
+			__m256 nlerp[4];
+			LerpNormalizeAVX2(qa, qb, _mm256_sub_ps(one, weight), _mm256_xor_ps(weight, flip), nlerp);
+			for (uint32_t j = 0; j < 4; ++j)
+				result[j] = _mm256_blendv_ps(result[j], nlerp[j], nearlyParallel);
+		}
+
+		_mm256_storeu_ps(out.x + i, result[0]);
+		_mm256_storeu_ps(out.y + i, result[1]);
+		_mm256_storeu_ps(out.z + i, result[2]);
+		_mm256_storeu_ps(out.w + i, result[3]);
+	}
+
+	SlerpQuatsScalar(a, b, t, out, i, count);
+}
+
+void RenormalizeQuatsAVX2(Float4Stream in, Float4Stream out, uint32_t count)
+{
+	__m256 half = _mm256_set1_ps(0.5f);
+	__m256 threeHalves = _mm256_set1_ps(1.5f);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(in.x + i);
+		__m256 y = _mm256_loadu_ps(in.y + i);
+		__m256 z = _mm256_loadu_ps(in.z + i);
+		__m256 w = _mm256_loadu_ps(in.w + i);
+
+		__m256 lengthSq = _mm256_fmadd_ps(w, w, _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x))));
+
+		//rsqrt and a Newton step
+		__m256 estimate = _mm256_rsqrt_ps(lengthSq);
+		__m256 invLength = _mm256_mul_ps(estimate, _mm256_fnmadd_ps(_mm256_mul_ps(_mm256_mul_ps(half, lengthSq), estimate), estimate, threeHalves));
+		invLength = _mm256_and_ps(invLength, _mm256_cmp_ps(lengthSq, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+		_mm256_storeu_ps(out.x + i, _mm256_mul_ps(x, invLength));
+		_mm256_storeu_ps(out.y + i, _mm256_mul_ps(y, invLength));
+		_mm256_storeu_ps(out.z + i, _mm256_mul_ps(z, invLength));
+		_mm256_storeu_ps(out.w + i, _mm256_mul_ps(w, invLength));
+	}
+
+	RenormalizeQuatsScalar(in, out, i, count);
+}
+
+void QuatsToMatrices3x4AVX2(Float4Stream quats, float* outRows, uint32_t count)
+{
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 two = _mm256_set1_ps(2.0f);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(quats.x + i);
+		__m256 y = _mm256_loadu_ps(quats.y + i);
+		__m256 z = _mm256_loadu_ps(quats.z + i);
+		__m256 w = _mm256_loadu_ps(quats.w + i);
+
+		__m256 x2 = _mm256_mul_ps(x, two);
+		__m256 y2 = _mm256_mul_ps(y, two);
+		__m256 z2 = _mm256_mul_ps(z, two);
+
+		__m256 xx = _mm256_mul_ps(x, x2);
+		__m256 yy = _mm256_mul_ps(y, y2);
+		__m256 zz = _mm256_mul_ps(z, z2);
+		__m256 xy = _mm256_mul_ps(x, y2);
+		__m256 xz = _mm256_mul_ps(x, z2);
+		__m256 yz = _mm256_mul_ps(y, z2);
+		__m256 wx = _mm256_mul_ps(w, x2);
+		__m256 wy = _mm256_mul_ps(w, y2);
+		__m256 wz = _mm256_mul_ps(w, z2);
+
+		__m256 columns[3][3] =
+		{
+			{ _mm256_sub_ps(one, _mm256_add_ps(yy, zz)), _mm256_sub_ps(xy, wz), _mm256_add_ps(xz, wy) },
+			{ _mm256_add_ps(xy, wz), _mm256_sub_ps(one, _mm256_add_ps(xx, zz)), _mm256_sub_ps(yz, wx) },
+			{ _mm256_sub_ps(xz, wy), _mm256_add_ps(yz, wx), _mm256_sub_ps(one, _mm256_add_ps(xx, yy)) }
+		};
+
+		//Each half is transposed on its own, 4 matrices at a time
+		for (uint32_t half = 0; half < 2; ++half)
+		{
+			float* rows = outRows + 12 * (i + 4 * half);
+			for (uint32_t j = 0; j < 3; ++j)
+			{
+				__m128 c0 = (half == 0) ? _mm256_castps256_ps128(columns[j][0]) : _mm256_extractf128_ps(columns[j][0], 1);
+				__m128 c1 = (half == 0) ? _mm256_castps256_ps128(columns[j][1]) : _mm256_extractf128_ps(columns[j][1], 1);
+				__m128 c2 = (half == 0) ? _mm256_castps256_ps128(columns[j][2]) : _mm256_extractf128_ps(columns[j][2], 1);
+				__m128 c3 = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+				_mm_storeu_ps(rows + 4 * j, c0);
+				_mm_storeu_ps(rows + 12 + 4 * j, c1);
+				_mm_storeu_ps(rows + 24 + 4 * j, c2);
+				_mm_storeu_ps(rows + 36 + 4 * j, c3);
+			}
+		}
+	}
+
+	QuatsToMatrices3x4Scalar(quats, outRows, i, count);
+}
+
+void GetBatchMathKernelsAVX2(BatchMathKernels* kernels)
+{
+	kernels->transformPoints = TransformPointsAVX2;
+	kernels->transformVectors = TransformVectorsAVX2;
+	kernels->transformFloat4s = TransformFloat4sAVX2;
+	kernels->multiplyMatrices = MultiplyMatricesAVX2;
+	kernels->invertMatrices = InvertMatricesAVX2;
+	kernels->normalize = NormalizeAVX2;
+	kernels->dot = DotAVX2;
+	kernels->nlerpQuats = NlerpQuatsAVX2;
+	kernels->slerpQuats = SlerpQuatsAVX2;
+	kernels->renormalizeQuats = RenormalizeQuatsAVX2;
+	kernels->quatsToMatrices3x4 = QuatsToMatrices3x4AVX2;
+}
@@ -0,0 +1,457 @@
+#include <immintrin.h>
+
+#include "SEMathBatchKernels.h"
+
+//AVX-512 kernels, 16 elements at a time.
+//Compiled with AVX-512 enabled and only called if GetCPUFeatures reports CPU_FEATURE_FLAGS_AVX512.
+
+void TransformPointsAVX512(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	//m[4 * row + col]
+	__m512 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm512_set1_ps(mat[i]);
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x = _mm512_loadu_ps(in.x + i);
+		__m512 y = _mm512_loadu_ps(in.y + i);
+		__m512 z = _mm512_loadu_ps(in.z + i);
+
+		_mm512_storeu_ps(out.x + i, _mm512_fmadd_ps(x, m[0], _mm512_fmadd_ps(y, m[4], _mm512_fmadd_ps(z, m[8], m[12]))));
+		_mm512_storeu_ps(out.y + i, _mm512_fmadd_ps(x, m[1], _mm512_fmadd_ps(y, m[5], _mm512_fmadd_ps(z, m[9], m[13]))));
+		_mm512_storeu_ps(out.z + i, _mm512_fmadd_ps(x, m[2], _mm512_fmadd_ps(y, m[6], _mm512_fmadd_ps(z, m[10], m[14]))));
+	}
+
+	TransformPointsScalar(mat, in, out, i, count);
+}
+
+void TransformVectorsAVX512(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	__m512 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm512_set1_ps(mat[i]);
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x = _mm512_loadu_ps(in.x + i);
+		__m512 y = _mm512_loadu_ps(in.y + i);
+		__m512 z = _mm512_loadu_ps(in.z + i);
+
+		_mm512_storeu_ps(out.x + i, _mm512_fmadd_ps(x, m[0], _mm512_fmadd_ps(y, m[4], _mm512_mul_ps(z, m[8]))));
+		_mm512_storeu_ps(out.y + i, _mm512_fmadd_ps(x, m[1], _mm512_fmadd_ps(y, m[5], _mm512_mul_ps(z, m[9]))));
+		_mm512_storeu_ps(out.z + i, _mm512_fmadd_ps(x, m[2], _mm512_fmadd_ps(y, m[6], _mm512_mul_ps(z, m[10]))));
+	}
+
+	TransformVectorsScalar(mat, in, out, i, count);
+}
+
+void TransformFloat4sAVX512(const float* mat, Float4Stream in, Float4Stream out, uint32_t count)
+{
+	__m512 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm512_set1_ps(mat[i]);
+
+	float* outputs[4] = { out.x, out.y, out.z, out.w };
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x = _mm512_loadu_ps(in.x + i);
+		__m512 y = _mm512_loadu_ps(in.y + i);
+		__m512 z = _mm512_loadu_ps(in.z + i);
+		__m512 w = _mm512_loadu_ps(in.w + i);
+
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			__m512 result = _mm512_fmadd_ps(x, m[j], _mm512_fmadd_ps(y, m[4 + j], _mm512_fmadd_ps(z, m[8 + j], _mm512_mul_ps(w, m[12 + j]))));
+			_mm512_storeu_ps(outputs[j] + i, result);
+		}
+	}
+
+	TransformFloat4sScalar(mat, in, out, i, count);
+}
+
+void MultiplyMatricesAVX512(const float* matsA, const float* matsB, float* outMats, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const float* b = matsB + 16 * i;
+
+		//The whole of A in one register, the permutes broadcast element k of every row to its lane.
+		//Row k of B is in all four lanes.
+		__m512 a = _mm512_loadu_ps(matsA + 16 * i);
+		__m512 b0 = _mm512_broadcast_f32x4(_mm_loadu_ps(b));
+		__m512 b1 = _mm512_broadcast_f32x4(_mm_loadu_ps(b + 4));
+		__m512 b2 = _mm512_broadcast_f32x4(_mm_loadu_ps(b + 8));
+		__m512 b3 = _mm512_broadcast_f32x4(_mm_loadu_ps(b + 12));
+
+		__m512 sum0 = _mm512_fmadd_ps(_mm512_permute_ps(a, _MM_SHUFFLE(1, 1, 1, 1)), b1, _mm512_mul_ps(_mm512_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 0)), b0));
+		__m512 sum1 = _mm512_fmadd_ps(_mm512_permute_ps(a, _MM_SHUFFLE(3, 3, 3, 3)), b3, _mm512_mul_ps(_mm512_permute_ps(a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+
+		_mm512_storeu_ps(outMats + 16 * i, _mm512_add_ps(sum0, sum1));
+	}
+}
+
+//Four 2x2 matrices per register, one in each quarter as (m00, m01, m10, m11)
+
+//Returns a * b
+static inline __m512 Multiply2x2AVX512(__m512 a, __m512 b)
+{
+	return _mm512_add_ps(_mm512_mul_ps(a, _mm512_permute_ps(b, _MM_SHUFFLE(3, 0, 3, 0))),
+		_mm512_mul_ps(_mm512_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)), _mm512_permute_ps(b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//Returns adjugate(a) * b
+static inline __m512 AdjugateMultiply2x2AVX512(__m512 a, __m512 b)
+{
+	return _mm512_sub_ps(_mm512_mul_ps(_mm512_permute_ps(a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		_mm512_mul_ps(_mm512_permute_ps(a, _MM_SHUFFLE(2, 2, 1, 1)), _mm512_permute_ps(b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+//Returns a * adjugate(b)
+static inline __m512 MultiplyAdjugate2x2AVX512(__m512 a, __m512 b)
+{
+	return _mm512_sub_ps(_mm512_mul_ps(a, _mm512_permute_ps(b, _MM_SHUFFLE(0, 3, 0, 3))),
+		_mm512_mul_ps(_mm512_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)), _mm512_permute_ps(b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+void InvertMatricesAVX512(const float* mats, float* outMats, uint32_t count)
+{
+	__m512 zero = _mm512_setzero_ps();
+	__m512 signs = _mm512_broadcast_f32x4(_mm_set_ps(1.0f, -1.0f, -1.0f, 1.0f));
+
+	//The SSE 4.2 kernel on four matrices at once, matrix i + k in quarter k.
+	//No FMA, so the results are the same as the other kernels.
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const float* m = mats + 16 * i;
+
+		__m512 r[4];
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			r[j] = _mm512_castps128_ps512(_mm_loadu_ps(m + 4 * j));
+			r[j] = _mm512_insertf32x4(r[j], _mm_loadu_ps(m + 16 + 4 * j), 1);
+			r[j] = _mm512_insertf32x4(r[j], _mm_loadu_ps(m + 32 + 4 * j), 2);
+			r[j] = _mm512_insertf32x4(r[j], _mm_loadu_ps(m + 48 + 4 * j), 3);
+		}
+
+		__m512 a = _mm512_shuffle_ps(r[0], r[1], _MM_SHUFFLE(1, 0, 1, 0));
+		__m512 b = _mm512_shuffle_ps(r[0], r[1], _MM_SHUFFLE(3, 2, 3, 2));
+		__m512 c = _mm512_shuffle_ps(r[2], r[3], _MM_SHUFFLE(1, 0, 1, 0));
+		__m512 d = _mm512_shuffle_ps(r[2], r[3], _MM_SHUFFLE(3, 2, 3, 2));
+
+		__m512 blockDets = _mm512_sub_ps(
+			_mm512_mul_ps(_mm512_shuffle_ps(r[0], r[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm512_shuffle_ps(r[1], r[3], _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm512_mul_ps(_mm512_shuffle_ps(r[0], r[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm512_shuffle_ps(r[1], r[3], _MM_SHUFFLE(2, 0, 2, 0))));
+
+		__m512 detA = _mm512_permute_ps(blockDets, _MM_SHUFFLE(0, 0, 0, 0));
+		__m512 detB = _mm512_permute_ps(blockDets, _MM_SHUFFLE(1, 1, 1, 1));
+		__m512 detC = _mm512_permute_ps(blockDets, _MM_SHUFFLE(2, 2, 2, 2));
+		__m512 detD = _mm512_permute_ps(blockDets, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m512 adjDC = AdjugateMultiply2x2AVX512(d, c);
+		__m512 adjAB = AdjugateMultiply2x2AVX512(a, b);
+
+		__m512 x = _mm512_sub_ps(_mm512_mul_ps(detD, a), Multiply2x2AVX512(b, adjDC));
+		__m512 w = _mm512_sub_ps(_mm512_mul_ps(detA, d), Multiply2x2AVX512(c, adjAB));
+		__m512 y = _mm512_sub_ps(_mm512_mul_ps(detB, c), MultiplyAdjugate2x2AVX512(d, adjAB));
+		__m512 z = _mm512_sub_ps(_mm512_mul_ps(detC, b), MultiplyAdjugate2x2AVX512(a, adjDC));
+
+		//There is no 512 bit hadd, the two permutes add the same pairs in the same order
+		__m512 trace = _mm512_mul_ps(adjAB, _mm512_permute_ps(adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+		trace = _mm512_add_ps(trace, _mm512_permute_ps(trace, _MM_SHUFFLE(2, 3, 0, 1)));
+		trace = _mm512_add_ps(trace, _mm512_permute_ps(trace, _MM_SHUFFLE(1, 0, 3, 2)));
+		__m512 det = _mm512_sub_ps(_mm512_add_ps(_mm512_mul_ps(detA, detD), _mm512_mul_ps(detB, detC)), trace);
+
+		__m512 invDet = _mm512_div_ps(signs, det);
+		__mmask16 invertible = _mm512_cmp_ps_mask(det, zero, _CMP_NEQ_UQ);
+		x = _mm512_maskz_mul_ps(invertible, x, invDet);
+		y = _mm512_maskz_mul_ps(invertible, y, invDet);
+		z = _mm512_maskz_mul_ps(invertible, z, invDet);
+		w = _mm512_maskz_mul_ps(invertible, w, invDet);
+
+		__m512 rows[4] = {
+			_mm512_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)),
+			_mm512_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)),
+			_mm512_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)),
+			_mm512_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)) };
+
+		float* out = outMats + 16 * i;
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			_mm_storeu_ps(out + 4 * j, _mm512_castps512_ps128(rows[j]));
+			_mm_storeu_ps(out + 16 + 4 * j, _mm512_extractf32x4_ps(rows[j], 1));
+			_mm_storeu_ps(out + 32 + 4 * j, _mm512_extractf32x4_ps(rows[j], 2));
+			_mm_storeu_ps(out + 48 + 4 * j, _mm512_extractf32x4_ps(rows[j], 3));
+		}
+	}
+
+	InvertMatricesScalar(mats, outMats, i, count);
+}
+
+void NormalizeAVX512(Float3Stream in, Float3Stream out, uint32_t count)
+{
+	__m512 zero = _mm512_setzero_ps();
+	__m512 one = _mm512_set1_ps(1.0f);
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x = _mm512_loadu_ps(in.x + i);
+		__m512 y = _mm512_loadu_ps(in.y + i);
+		__m512 z = _mm512_loadu_ps(in.z + i);
+
+		__m512 lengthSq = _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x)));
+
+		//Lanes of length 0 are left 0
+		__mmask16 nonZero = _mm512_cmp_ps_mask(lengthSq, zero, _CMP_GT_OQ);
+		__m512 invLength = _mm512_maskz_div_ps(nonZero, one, _mm512_sqrt_ps(lengthSq));
+
+		_mm512_storeu_ps(out.x + i, _mm512_mul_ps(x, invLength));
+		_mm512_storeu_ps(out.y + i, _mm512_mul_ps(y, invLength));
+		_mm512_storeu_ps(out.z + i, _mm512_mul_ps(z, invLength));
+	}
+
+	NormalizeScalar(in, out, i, count);
+}
+
+void DotAVX512(Float3Stream a, Float3Stream b, float* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 result = _mm512_mul_ps(_mm512_loadu_ps(a.x + i), _mm512_loadu_ps(b.x + i));
+		result = _mm512_fmadd_ps(_mm512_loadu_ps(a.y + i), _mm512_loadu_ps(b.y + i), result);
+		result = _mm512_fmadd_ps(_mm512_loadu_ps(a.z + i), _mm512_loadu_ps(b.z + i), result);
+		_mm512_storeu_ps(out + i, result);
+	}
+
+	DotScalar(a, b, out, i, count);
+}
+
+//Returns the normalized a * weightA + b * weightB, lanes of length 0 are left 0
+static inline void LerpNormalizeAVX512(const __m512* a, const __m512* b, __m512 weightA, __m512 weightB, __m512* out)
+{
+	for (uint32_t j = 0; j < 4; ++j)
+		out[j] = _mm512_fmadd_ps(b[j], weightB, _mm512_mul_ps(a[j], weightA));
+
+	__m512 lengthSq = _mm512_fmadd_ps(out[3], out[3], _mm512_fmadd_ps(out[2], out[2], _mm512_fmadd_ps(out[1], out[1], _mm512_mul_ps(out[0], out[0]))));
+	__mmask16 nonZero = _mm512_cmp_ps_mask(lengthSq, _mm512_setzero_ps(), _CMP_GT_OQ);
+	__m512 invLength = _mm512_maskz_div_ps(nonZero, _mm512_set1_ps(1.0f), _mm512_sqrt_ps(lengthSq));
+
+	for (uint32_t j = 0; j < 4; ++j)
+		out[j] = _mm512_mul_ps(out[j], invLength);
+}
+
+static inline __m512 QuatDotAVX512(const __m512* a, const __m512* b)
+{
+	return _mm512_fmadd_ps(a[3], b[3], _mm512_fmadd_ps(a[2], b[2], _mm512_fmadd_ps(a[1], b[1], _mm512_mul_ps(a[0], b[0]))));
+}
+
+void NlerpQuatsAVX512(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	__m512 one = _mm512_set1_ps(1.0f);
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 qa[4] = { _mm512_loadu_ps(a.x + i), _mm512_loadu_ps(a.y + i), _mm512_loadu_ps(a.z + i), _mm512_loadu_ps(a.w + i) };
+		__m512 qb[4] = { _mm512_loadu_ps(b.x + i), _mm512_loadu_ps(b.y + i), _mm512_loadu_ps(b.z + i), _mm512_loadu_ps(b.w + i) };
+		__m512 weight = _mm512_loadu_ps(t + i);
+
+		//Negating the weight of b takes the shortest path
+		__mmask16 flip = _mm512_cmp_ps_mask(QuatDotAVX512(qa, qb), _mm512_setzero_ps(), _CMP_LT_OQ);
+		__m512 weightB = _mm512_mask_sub_ps(weight, flip, _mm512_setzero_ps(), weight);
+
+		__m512 result[4];
+		LerpNormalizeAVX512(qa, qb, _mm512_sub_ps(one, weight), weightB, result);
+
+		_mm512_storeu_ps(out.x + i, result[0]);
+		_mm512_storeu_ps(out.y + i, result[1]);
+		_mm512_storeu_ps(out.z + i, result[2]);
+		_mm512_storeu_ps(out.w + i, result[3]);
+	}
+
+	NlerpQuatsScalar(a, b, t, out, i, count);
+}
+
+//Returns sin(x) for x in [0, pi / 2]
+static inline __m512 SinAVX512(__m512 x)
+{
+	__m512 x2 = _mm512_mul_ps(x, x);
+	__m512 p = _mm512_set1_ps(BATCH_SIN_S11);
+	p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(BATCH_SIN_S9));
+	p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(BATCH_SIN_S7));
+	p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(BATCH_SIN_S5));
+	p = _mm512_fmadd_ps(p, x2, _mm512_set1_ps(BATCH_SIN_S3));
+
+	return _mm512_fmadd_ps(_mm512_mul_ps(x, x2), p, x);
+}
+
+void SlerpQuatsAVX512(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	__m512 zero = _mm512_setzero_ps();
+	__m512 one = _mm512_set1_ps(1.0f);
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 qa[4] = { _mm512_loadu_ps(a.x + i), _mm512_loadu_ps(a.y + i), _mm512_loadu_ps(a.z + i), _mm512_loadu_ps(a.w + i) };
+		__m512 qb[4] = { _mm512_loadu_ps(b.x + i), _mm512_loadu_ps(b.y + i), _mm512_loadu_ps(b.z + i), _mm512_loadu_ps(b.w + i) };
+		__m512 weight = _mm512_loadu_ps(t + i);
+
+		__m512 dot = QuatDotAVX512(qa, qb);
+		__mmask16 flip = _mm512_cmp_ps_mask(dot, zero, _CMP_LT_OQ);
+		__m512 cosAngle = _mm512_abs_ps(dot);
+
+		//acos(cosAngle)
+		__m512 p = _mm512_set1_ps(BATCH_ACOS_A7);
+		p = _mm512_fmadd_ps(p, cosAngle, _mm512_set1_ps(BATCH_ACOS_A6));
+		p = _mm512_fmadd_ps(p, cosAngle, _mm512_set1_ps(BATCH_ACOS_A5));
+		p = _mm512_fmadd_ps(p, cosAngle, _mm512_set1_ps(BATCH_ACOS_A4));
+		p = _mm512_fmadd_ps(p, cosAngle, _mm512_set1_ps(BATCH_ACOS_A3));
+		p = _mm512_fmadd_ps(p, cosAngle, _mm512_set1_ps(BATCH_ACOS_A2));
+		p = _mm512_fmadd_ps(p, cosAngle, _mm512_set1_ps(BATCH_ACOS_A1));
+		p = _mm512_fmadd_ps(p, cosAngle, _mm512_set1_ps(BATCH_ACOS_A0));
+		__m512 oneMinusCos = _mm512_sub_ps(one, cosAngle);
+		__m512 angle = _mm512_mul_ps(_mm512_sqrt_ps(oneMinusCos), p);
+
+		__m512 invSinAngle = _mm512_div_ps(one, _mm512_sqrt_ps(_mm512_mul_ps(oneMinusCos, _mm512_add_ps(one, cosAngle))));
+		__m512 weightA = _mm512_mul_ps(SinAVX512(_mm512_mul_ps(_mm512_sub_ps(one, weight), angle)), invSinAngle);
+		__m512 weightB = _mm512_mul_ps(SinAVX512(_mm512_mul_ps(weight, angle)), invSinAngle);
+		weightB = _mm512_mask_sub_ps(weightB, flip, zero, weightB);
+
+		__m512 result[4];
+		for (uint32_t j = 0; j < 4; ++j)
+			result[j] = _mm512_fmadd_ps(qb[j], weightB, _mm512_mul_ps(qa[j], weightA));
+
+		//The lanes of almost the same rotation get nlerp
+		__mmask16 nearlyParallel = _mm512_cmp_ps_mask(cosAngle, _mm512_set1_ps(BATCH_SLERP_NLERP_THRESHOLD), _CMP_GT_OQ);
+		if (nearlyParallel != 0)
+		{
+			__m512 nlerp[4];
+			LerpNormalizeAVX512(qa, qb, _mm512_sub_ps(one, weight), _mm512_mask_sub_ps(weight, flip, zero, weight), nlerp);
+			for (uint32_t j = 0; j < 4; ++j)
+				result[j] = _mm512_mask_blend_ps(nearlyParallel, result[j], nlerp[j]);
+		}
+
+		_mm512_storeu_ps(out.x + i, result[0]);
+		_mm512_storeu_ps(out.y + i, result[1]);
+		_mm512_storeu_ps(out.z + i, result[2]);
+		_mm512_storeu_ps(out.w + i, result[3]);
+	}
+
+	SlerpQuatsScalar(a, b, t, out, i, count);
+}
+
+void RenormalizeQuatsAVX512(Float4Stream in, Float4Stream out, uint32_t count)
+{
+	__m512 half = _mm512_set1_ps(0.5f);
+	__m512 threeHalves = _mm512_set1_ps(1.5f);
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x = _mm512_loadu_ps(in.x + i);
+		__m512 y = _mm512_loadu_ps(in.y + i);
+		__m512 z = _mm512_loadu_ps(in.z + i);
+		__m512 w = _mm512_loadu_ps(in.w + i);
+
+		__m512 lengthSq = _mm512_fmadd_ps(w, w, _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x))));
+
+		//rsqrt14 has 14 bits, the Newton step makes it almost exact
+		__mmask16 nonZero = _mm512_cmp_ps_mask(lengthSq, _mm512_setzero_ps(), _CMP_GT_OQ);
+		__m512 estimate = _mm512_rsqrt14_ps(lengthSq);
+		__m512 invLength = _mm512_maskz_mul_ps(nonZero, estimate, _mm512_fnmadd_ps(_mm512_mul_ps(_mm512_mul_ps(half, lengthSq), estimate), estimate, threeHalves));
+
+		_mm512_storeu_ps(out.x + i, _mm512_mul_ps(x, invLength));
+		_mm512_storeu_ps(out.y + i, _mm512_mul_ps(y, invLength));
+		_mm512_storeu_ps(out.z + i, _mm512_mul_ps(z, invLength));
+		_mm512_storeu_ps(out.w + i, _mm512_mul_ps(w, invLength));
+	}
+
+	RenormalizeQuatsScalar(in, out, i, count);
+}
+
+void QuatsToMatrices3x4AVX512(Float4Stream quats, float* outRows, uint32_t count)
+{
+	__m512 one = _mm512_set1_ps(1.0f);
+	__m512 two = _mm512_set1_ps(2.0f);
+
+	uint32_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x = _mm512_loadu_ps(quats.x + i);
+		__m512 y = _mm512_loadu_ps(quats.y + i);
+		__m512 z = _mm512_loadu_ps(quats.z + i);
+		__m512 w = _mm512_loadu_ps(quats.w + i);
+
+		__m512 x2 = _mm512_mul_ps(x, two);
+		__m512 y2 = _mm512_mul_ps(y, two);
+		__m512 z2 = _mm512_mul_ps(z, two);
+
+		__m512 xx = _mm512_mul_ps(x, x2);
+		__m512 yy = _mm512_mul_ps(y, y2);
+		__m512 zz = _mm512_mul_ps(z, z2);
+		__m512 xy = _mm512_mul_ps(x, y2);
+		__m512 xz = _mm512_mul_ps(x, z2);
+		__m512 yz = _mm512_mul_ps(y, z2);
+		__m512 wx = _mm512_mul_ps(w, x2);
+		__m512 wy = _mm512_mul_ps(w, y2);
+		__m512 wz = _mm512_mul_ps(w, z2);
+
+		__m512 columns[3][3] =
+		{
+			{ _mm512_sub_ps(one, _mm512_add_ps(yy, zz)), _mm512_sub_ps(xy, wz), _mm512_add_ps(xz, wy) },
+			{ _mm512_add_ps(xy, wz), _mm512_sub_ps(one, _mm512_add_ps(xx, zz)), _mm512_sub_ps(yz, wx) },
+			{ _mm512_sub_ps(xz, wy), _mm512_add_ps(yz, wx), _mm512_sub_ps(one, _mm512_add_ps(xx, yy)) }
+		};
+
+		//Each quarter is transposed on its own, 4 matrices at a time
+		alignas(64) float lanes[3][3][16];
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+				_mm512_store_ps(lanes[j][k], columns[j][k]);
+		}
+
+		for (uint32_t quarter = 0; quarter < 4; ++quarter)
+		{
+			float* rows = outRows + 12 * (i + 4 * quarter);
+			for (uint32_t j = 0; j < 3; ++j)
+			{
+				__m128 c0 = _mm_load_ps(lanes[j][0] + 4 * quarter);
+				__m128 c1 = _mm_load_ps(lanes[j][1] + 4 * quarter);
+				__m128 c2 = _mm_load_ps(lanes[j][2] + 4 * quarter);
+				__m128 c3 = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+				_mm_storeu_ps(rows + 4 * j, c0);
+				_mm_storeu_ps(rows + 12 + 4 * j, c1);
+				_mm_storeu_ps(rows + 24 + 4 * j, c2);
+				_mm_storeu_ps(rows + 36 + 4 * j, c3);
+			}
+		}
+	}
+
+	QuatsToMatrices3x4Scalar(quats, outRows, i, count);
+}
+
+void GetBatchMathKernelsAVX512(BatchMathKernels* kernels)
+{
+	kernels->transformPoints = TransformPointsAVX512;
+	kernels->transformVectors = TransformVectorsAVX512;
+	kernels->transformFloat4s = TransformFloat4sAVX512;
+	kernels->multiplyMatrices = MultiplyMatricesAVX512;
+	kernels->invertMatrices = InvertMatricesAVX512;
+	kernels->normalize = NormalizeAVX512;
+	kernels->dot = DotAVX512;
+	kernels->nlerpQuats = NlerpQuatsAVX512;
+	kernels->slerpQuats = SlerpQuatsAVX512;
+	kernels->renormalizeQuats = RenormalizeQuatsAVX512;
+	kernels->quatsToMatrices3x4 = QuatsToMatrices3x4AVX512;
+}
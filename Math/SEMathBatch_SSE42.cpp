@@ -0,0 +1,426 @@
+#include <nmmintrin.h>
+
+#include "SEMathBatchKernels.h"
+
+//SSE 4.2 kernels, 4 elements at a time. Every x64 CPU the engine runs on has them.
+
+void TransformPointsSSE42(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	//m[4 * row + col]
+	__m128 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm_set_ps1(mat[i]);
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(in.x + i);
+		__m128 y = _mm_loadu_ps(in.y + i);
+		__m128 z = _mm_loadu_ps(in.z + i);
+
+		_mm_storeu_ps(out.x + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0]), _mm_mul_ps(y, m[4])), _mm_add_ps(_mm_mul_ps(z, m[8]), m[12])));
+		_mm_storeu_ps(out.y + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[1]), _mm_mul_ps(y, m[5])), _mm_add_ps(_mm_mul_ps(z, m[9]), m[13])));
+		_mm_storeu_ps(out.z + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[2]), _mm_mul_ps(y, m[6])), _mm_add_ps(_mm_mul_ps(z, m[10]), m[14])));
+	}
+
+	TransformPointsScalar(mat, in, out, i, count);
+}
+
+void TransformVectorsSSE42(const float* mat, Float3Stream in, Float3Stream out, uint32_t count)
+{
+	__m128 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm_set_ps1(mat[i]);
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(in.x + i);
+		__m128 y = _mm_loadu_ps(in.y + i);
+		__m128 z = _mm_loadu_ps(in.z + i);
+
+		_mm_storeu_ps(out.x + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0]), _mm_mul_ps(y, m[4])), _mm_mul_ps(z, m[8])));
+		_mm_storeu_ps(out.y + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[1]), _mm_mul_ps(y, m[5])), _mm_mul_ps(z, m[9])));
+		_mm_storeu_ps(out.z + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[2]), _mm_mul_ps(y, m[6])), _mm_mul_ps(z, m[10])));
+	}
+
+	TransformVectorsScalar(mat, in, out, i, count);
+}
+
+void TransformFloat4sSSE42(const float* mat, Float4Stream in, Float4Stream out, uint32_t count)
+{
+	__m128 m[16];
+	for (uint32_t i = 0; i < 16; ++i)
+		m[i] = _mm_set_ps1(mat[i]);
+
+	float* outputs[4] = { out.x, out.y, out.z, out.w };
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(in.x + i);
+		__m128 y = _mm_loadu_ps(in.y + i);
+		__m128 z = _mm_loadu_ps(in.z + i);
+		__m128 w = _mm_loadu_ps(in.w + i);
+
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			__m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[j]), _mm_mul_ps(y, m[4 + j])), _mm_add_ps(_mm_mul_ps(z, m[8 + j]), _mm_mul_ps(w, m[12 + j])));
+			_mm_storeu_ps(outputs[j] + i, result);
+		}
+	}
+
+	TransformFloat4sScalar(mat, in, out, i, count);
+}
+
+void MultiplyMatricesSSE42(const float* matsA, const float* matsB, float* outMats, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const float* a = matsA + 16 * i;
+		const float* b = matsB + 16 * i;
+
+		__m128 b0 = _mm_loadu_ps(b);
+		__m128 b1 = _mm_loadu_ps(b + 4);
+		__m128 b2 = _mm_loadu_ps(b + 8);
+		__m128 b3 = _mm_loadu_ps(b + 12);
+
+		//Everything is loaded before the first store, outMats can be matsA or matsB
+		__m128 rows[4];
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			__m128 row = _mm_loadu_ps(a + 4 * j);
+			__m128 sum0 = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0), _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+			__m128 sum1 = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2), _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+			rows[j] = _mm_add_ps(sum0, sum1);
+		}
+
+		for (uint32_t j = 0; j < 4; ++j)
+			_mm_storeu_ps(outMats + 16 * i + 4 * j, rows[j]);
+	}
+}
+
+//2x2 matrices in one register, (m00, m01, m10, m11)
+
+//Returns a * b
+static inline __m128 Multiply2x2SSE42(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//Returns adjugate(a) * b
+static inline __m128 AdjugateMultiply2x2SSE42(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+//Returns a * adjugate(b)
+static inline __m128 MultiplyAdjugate2x2SSE42(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+void InvertMatricesSSE42(const float* mats, float* outMats, uint32_t count)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 signs = _mm_set_ps(1.0f, -1.0f, -1.0f, 1.0f);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		__m128 r0 = _mm_loadu_ps(mats + 16 * i);
+		__m128 r1 = _mm_loadu_ps(mats + 16 * i + 4);
+		__m128 r2 = _mm_loadu_ps(mats + 16 * i + 8);
+		__m128 r3 = _mm_loadu_ps(mats + 16 * i + 12);
+
+		//Cramer's rule on the 2x2 blocks, the same as Inverse(mat4)
+		__m128 a = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(1, 0, 1, 0));
+		__m128 b = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(3, 2, 3, 2));
+		__m128 c = _mm_shuffle_ps(r2, r3, _MM_SHUFFLE(1, 0, 1, 0));
+		__m128 d = _mm_shuffle_ps(r2, r3, _MM_SHUFFLE(3, 2, 3, 2));
+
+		//(det(A), det(B), det(C), det(D))
+		__m128 blockDets = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+
+		__m128 detA = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 detB = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 detC = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 detD = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m128 adjDC = AdjugateMultiply2x2SSE42(d, c);
+		__m128 adjAB = AdjugateMultiply2x2SSE42(a, b);
+
+		__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Multiply2x2SSE42(b, adjDC));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Multiply2x2SSE42(c, adjAB));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), MultiplyAdjugate2x2SSE42(d, adjAB));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), MultiplyAdjugate2x2SSE42(a, adjDC));
+
+		__m128 trace = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+		trace = _mm_hadd_ps(trace, trace);
+		trace = _mm_hadd_ps(trace, trace);
+		__m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+		//Noninvertible matrices give 0 instead of infinities and NaNs
+		__m128 invDet = _mm_div_ps(signs, det);
+		__m128 invertible = _mm_cmpneq_ps(det, zero);
+		x = _mm_and_ps(_mm_mul_ps(x, invDet), invertible);
+		y = _mm_and_ps(_mm_mul_ps(y, invDet), invertible);
+		z = _mm_and_ps(_mm_mul_ps(z, invDet), invertible);
+		w = _mm_and_ps(_mm_mul_ps(w, invDet), invertible);
+
+		_mm_storeu_ps(outMats + 16 * i, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(outMats + 16 * i + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+		_mm_storeu_ps(outMats + 16 * i + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(outMats + 16 * i + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+	}
+}
+
+void NormalizeSSE42(Float3Stream in, Float3Stream out, uint32_t count)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set_ps1(1.0f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(in.x + i);
+		__m128 y = _mm_loadu_ps(in.y + i);
+		__m128 z = _mm_loadu_ps(in.z + i);
+
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+
+		//1 / 0 is infinity, the mask turns it into 0
+		__m128 invLength = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(lengthSq)), _mm_cmpgt_ps(lengthSq, zero));
+
+		_mm_storeu_ps(out.x + i, _mm_mul_ps(x, invLength));
+		_mm_storeu_ps(out.y + i, _mm_mul_ps(y, invLength));
+		_mm_storeu_ps(out.z + i, _mm_mul_ps(z, invLength));
+	}
+
+	NormalizeScalar(in, out, i, count);
+}
+
+void DotSSE42(Float3Stream a, Float3Stream b, float* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_mul_ps(_mm_loadu_ps(a.x + i), _mm_loadu_ps(b.x + i));
+		__m128 y = _mm_mul_ps(_mm_loadu_ps(a.y + i), _mm_loadu_ps(b.y + i));
+		__m128 z = _mm_mul_ps(_mm_loadu_ps(a.z + i), _mm_loadu_ps(b.z + i));
+		_mm_storeu_ps(out + i, _mm_add_ps(_mm_add_ps(x, y), z));
+	}
+
+	DotScalar(a, b, out, i, count);
+}
+
+//Returns the normalized a * weightA + b * weightB, lanes of length 0 are left 0
+static inline void LerpNormalizeSSE42(const __m128* a, const __m128* b, __m128 weightA, __m128 weightB, __m128* out)
+{
+	for (uint32_t j = 0; j < 4; ++j)
+		out[j] = _mm_add_ps(_mm_mul_ps(a[j], weightA), _mm_mul_ps(b[j], weightB));
+
+	__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(out[0], out[0]), _mm_mul_ps(out[1], out[1])), _mm_mul_ps(out[2], out[2])), _mm_mul_ps(out[3], out[3]));
+	__m128 invLength = _mm_and_ps(_mm_div_ps(_mm_set_ps1(1.0f), _mm_sqrt_ps(lengthSq)), _mm_cmpgt_ps(lengthSq, _mm_setzero_ps()));
+
+	for (uint32_t j = 0; j < 4; ++j)
+		out[j] = _mm_mul_ps(out[j], invLength);
+}
+
+void NlerpQuatsSSE42(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	__m128 one = _mm_set_ps1(1.0f);
+	__m128 signMask = _mm_set_ps1(-0.0f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 qa[4] = { _mm_loadu_ps(a.x + i), _mm_loadu_ps(a.y + i), _mm_loadu_ps(a.z + i), _mm_loadu_ps(a.w + i) };
+		__m128 qb[4] = { _mm_loadu_ps(b.x + i), _mm_loadu_ps(b.y + i), _mm_loadu_ps(b.z + i), _mm_loadu_ps(b.w + i) };
+		__m128 weight = _mm_loadu_ps(t + i);
+
+		//Negating b takes the shortest path
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(qa[0], qb[0]), _mm_mul_ps(qa[1], qb[1])), _mm_mul_ps(qa[2], qb[2])), _mm_mul_ps(qa[3], qb[3]));
+		__m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), signMask);
+
+		__m128 result[4];
+		LerpNormalizeSSE42(qa, qb, _mm_sub_ps(one, weight), _mm_xor_ps(weight, flip), result);
+
+		_mm_storeu_ps(out.x + i, result[0]);
+		_mm_storeu_ps(out.y + i, result[1]);
+		_mm_storeu_ps(out.z + i, result[2]);
+		_mm_storeu_ps(out.w + i, result[3]);
+	}
+
+	NlerpQuatsScalar(a, b, t, out, i, count);
+}
+
+//Returns sin(x) for x in [0, pi / 2]
+static inline __m128 SinSSE42(__m128 x)
+{
+	__m128 x2 = _mm_mul_ps(x, x);
+	__m128 p = _mm_set_ps1(BATCH_SIN_S11);
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set_ps1(BATCH_SIN_S9));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set_ps1(BATCH_SIN_S7));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set_ps1(BATCH_SIN_S5));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set_ps1(BATCH_SIN_S3));
+
+	return _mm_add_ps(_mm_mul_ps(_mm_mul_ps(x, x2), p), x);
+}
+
+void SlerpQuatsSSE42(Float4Stream a, Float4Stream b, const float* t, Float4Stream out, uint32_t count)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set_ps1(1.0f);
+	__m128 signMask = _mm_set_ps1(-0.0f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 qa[4] = { _mm_loadu_ps(a.x + i), _mm_loadu_ps(a.y + i), _mm_loadu_ps(a.z + i), _mm_loadu_ps(a.w + i) };
+		__m128 qb[4] = { _mm_loadu_ps(b.x + i), _mm_loadu_ps(b.y + i), _mm_loadu_ps(b.z + i), _mm_loadu_ps(b.w + i) };
+		__m128 weight = _mm_loadu_ps(t + i);
+
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(qa[0], qb[0]), _mm_mul_ps(qa[1], qb[1])), _mm_mul_ps(qa[2], qb[2])), _mm_mul_ps(qa[3], qb[3]));
+		__m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, zero), signMask);
+		__m128 cosAngle = _mm_andnot_ps(signMask, dot);
+
+		//acos(cosAngle)
+		__m128 p = _mm_set_ps1(BATCH_ACOS_A7);
+		p = _mm_add_ps(_mm_mul_ps(p, cosAngle), _mm_set_ps1(BATCH_ACOS_A6));
+		p = _mm_add_ps(_mm_mul_ps(p, cosAngle), _mm_set_ps1(BATCH_ACOS_A5));
+		p = _mm_add_ps(_mm_mul_ps(p, cosAngle), _mm_set_ps1(BATCH_ACOS_A4));
+		p = _mm_add_ps(_mm_mul_ps(p, cosAngle), _mm_set_ps1(BATCH_ACOS_A3));
+		p = _mm_add_ps(_mm_mul_ps(p, cosAngle), _mm_set_ps1(BATCH_ACOS_A2));
+		p = _mm_add_ps(_mm_mul_ps(p, cosAngle), _mm_set_ps1(BATCH_ACOS_A1));
+		p = _mm_add_ps(_mm_mul_ps(p, cosAngle), _mm_set_ps1(BATCH_ACOS_A0));
+		__m128 oneMinusCos = _mm_sub_ps(one, cosAngle);
+		__m128 angle = _mm_mul_ps(_mm_sqrt_ps(oneMinusCos), p);
+
+		__m128 invSinAngle = _mm_div_ps(one, _mm_sqrt_ps(_mm_mul_ps(oneMinusCos, _mm_add_ps(one, cosAngle))));
+		__m128 weightA = _mm_mul_ps(SinSSE42(_mm_mul_ps(_mm_sub_ps(one, weight), angle)), invSinAngle);
+		__m128 weightB = _mm_xor_ps(_mm_mul_ps(SinSSE42(_mm_mul_ps(weight, angle)), invSinAngle), flip);
+
+		__m128 result[4];
+		for (uint32_t j = 0; j < 4; ++j)
+			result[j] = _mm_add_ps(_mm_mul_ps(qa[j], weightA), _mm_mul_ps(qb[j], weightB));
+
+		//The lanes of almost the same rotation get nlerp
+		__m128 nearlyParallel = _mm_cmpgt_ps(cosAngle, _mm_set_ps1(BATCH_SLERP_NLERP_THRESHOLD));
+		if (_mm_movemask_ps(nearlyParallel) != 0)
+		{
+			__m128 nlerp[4];
+			LerpNormalizeSSE42(qa, qb, _mm_sub_ps(one, weight), _mm_xor_ps(weight, flip), nlerp);
+			for (uint32_t j = 0; j < 4; ++j)
+				result[j] = _mm_blendv_ps(result[j], nlerp[j], nearlyParallel);
+		}
+
+		_mm_storeu_ps(out.x + i, result[0]);
+		_mm_storeu_ps(out.y + i, result[1]);
+		_mm_storeu_ps(out.z + i, result[2]);
+		_mm_storeu_ps(out.w + i, result[3]);
+	}
+
+	SlerpQuatsScalar(a, b, t, out, i, count);
+}
+
+void RenormalizeQuatsSSE42(Float4Stream in, Float4Stream out, uint32_t count)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 half = _mm_set_ps1(0.5f);
+	__m128 threeHalves = _mm_set_ps1(1.5f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(in.x + i);
+		__m128 y = _mm_loadu_ps(in.y + i);
+		__m128 z = _mm_loadu_ps(in.z + i);
+		__m128 w = _mm_loadu_ps(in.w + i);
+
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), _mm_mul_ps(w, w));
+
+		//rsqrt has 12 bits, a Newton step y * (1.5 - 0.5 * lengthSq * y * y) makes it about 22
+		__m128 estimate = _mm_rsqrt_ps(lengthSq);
+		__m128 invLength = _mm_mul_ps(estimate, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, lengthSq), estimate), estimate)));
+		invLength = _mm_and_ps(invLength, _mm_cmpgt_ps(lengthSq, zero));
+
+		_mm_storeu_ps(out.x + i, _mm_mul_ps(x, invLength));
+		_mm_storeu_ps(out.y + i, _mm_mul_ps(y, invLength));
+		_mm_storeu_ps(out.z + i, _mm_mul_ps(z, invLength));
+		_mm_storeu_ps(out.w + i, _mm_mul_ps(w, invLength));
+	}
+
+	RenormalizeQuatsScalar(in, out, i, count);
+}
+
+//Writes the columns of 4 rotation matrices, rows[j] holds element j of every column in the lanes
+static inline void StoreMatrices3x4SSE42(__m128 (*columns)[4], float* outRows)
+{
+	for (uint32_t j = 0; j < 3; ++j)
+	{
+		_MM_TRANSPOSE4_PS(columns[j][0], columns[j][1], columns[j][2], columns[j][3]);
+		for (uint32_t i = 0; i < 4; ++i)
+			_mm_storeu_ps(outRows + 12 * i + 4 * j, columns[j][i]);
+	}
+}
+
+void QuatsToMatrices3x4SSE42(Float4Stream quats, float* outRows, uint32_t count)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set_ps1(1.0f);
+	__m128 two = _mm_set_ps1(2.0f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(quats.x + i);
+		__m128 y = _mm_loadu_ps(quats.y + i);
+		__m128 z = _mm_loadu_ps(quats.z + i);
+		__m128 w = _mm_loadu_ps(quats.w + i);
+
+		__m128 x2 = _mm_mul_ps(x, two);
+		__m128 y2 = _mm_mul_ps(y, two);
+		__m128 z2 = _mm_mul_ps(z, two);
+
+		__m128 xx = _mm_mul_ps(x, x2);
+		__m128 yy = _mm_mul_ps(y, y2);
+		__m128 zz = _mm_mul_ps(z, z2);
+		__m128 xy = _mm_mul_ps(x, y2);
+		__m128 xz = _mm_mul_ps(x, z2);
+		__m128 yz = _mm_mul_ps(y, z2);
+		__m128 wx = _mm_mul_ps(w, x2);
+		__m128 wy = _mm_mul_ps(w, y2);
+		__m128 wz = _mm_mul_ps(w, z2);
+
+		__m128 columns[3][4] =
+		{
+			{ _mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_sub_ps(xy, wz), _mm_add_ps(xz, wy), zero },
+			{ _mm_add_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_sub_ps(yz, wx), zero },
+			{ _mm_sub_ps(xz, wy), _mm_add_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy)), zero }
+		};
+
+		StoreMatrices3x4SSE42(columns, outRows + 12 * i);
+	}
+
+	QuatsToMatrices3x4Scalar(quats, outRows, i, count);
+}
+
+void GetBatchMathKernelsSSE42(BatchMathKernels* kernels)
+{
+	kernels->transformPoints = TransformPointsSSE42;
+	kernels->transformVectors = TransformVectorsSSE42;
+	kernels->transformFloat4s = TransformFloat4sSSE42;
+	kernels->multiplyMatrices = MultiplyMatricesSSE42;
+	kernels->invertMatrices = InvertMatricesSSE42;
+	kernels->normalize = NormalizeSSE42;
+	kernels->dot = DotSSE42;
+	kernels->nlerpQuats = NlerpQuatsSSE42;
+	kernels->slerpQuats = SlerpQuatsSSE42;
+	kernels->renormalizeQuats = RenormalizeQuatsSSE42;
+	kernels->quatsToMatrices3x4 = QuatsToMatrices3x4SSE42;
+}
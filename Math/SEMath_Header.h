@@ -1,6 +1,11 @@
 #pragma once
 
+//Picks the implementation of the value types, vec4, mat4, quat and so on. They are inlined everywhere, so this stays a
+//compile time choice: SSE is in every x64 processor and USE_FMA adds FMA when the compiler targets AVX2.
+//The batch functions in SEMathBatch.h pick their kernels at runtime from the processor's instruction sets instead.
+#ifndef USE_SIMD
 #define USE_SIMD 1
+#endif
 
 #if USE_SIMD
 #include "SEMath_Intrinsics.h"
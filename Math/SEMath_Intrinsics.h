@@ -7,6 +7,20 @@
 
 #include "SEMath_Utility.h"
 
+//The matrix products use FMA when the compiler targets it (/arch:AVX2 with MSVC).
+//Define USE_FMA as 0 before including the math library to turn it off.
+#ifndef USE_FMA
+#if defined(__AVX2__) || defined(__FMA__)
+#define USE_FMA 1
+#else
+#define USE_FMA 0
+#endif
+#endif
+
+#if USE_FMA
+#include <immintrin.h>
+#endif
+
 
 //VECTOR2
 //------------------------------------------------------------------------------------------------------------
@@ -662,7 +676,7 @@ class Matrix2x2_Intrinsics
 {
 public:
 
-	//Creates an identity matrix
+	//Creates a zero matrix
 	Matrix2x2_Intrinsics();
 
 	//Creates a matrix with the specified rows.
@@ -731,7 +745,7 @@ public:
 	friend float Determinant(const Matrix2x2_Intrinsics& mat);
 
 	//Returns the inverse of the matrix.
-	//Returns the identity matrix if mat is noninvertible (singular)
+	//Returns the zero matrix if mat is noninvertible (singular)
 	friend Matrix2x2_Intrinsics Inverse(const Matrix2x2_Intrinsics& mat);
 
 	//Returns the result of matA + matB.
@@ -1103,7 +1117,7 @@ class Matrix3x3_Intrinsics
 {
 public:
 
-	//Creates an identity matrix
+	//Creates a zero matrix
 	Matrix3x3_Intrinsics();
 
 	//Creates a matrix with the specified rows.
@@ -1184,7 +1198,7 @@ public:
 	friend float Determinant(const Matrix3x3_Intrinsics& mat);
 
 	//Returns the inverse of the matrix.
-	//Returns the identity matrix if mat is noninvertible (singular)
+	//Returns the zero matrix if mat is noninvertible (singular)
 	friend Matrix3x3_Intrinsics Inverse(const Matrix3x3_Intrinsics& mat);
 
 	//Returns the result of matA + matB.
@@ -1612,11 +1626,65 @@ inline Matrix3x3_Intrinsics operator/(const Matrix3x3_Intrinsics& mat, float k)
 
 //MATRIX4X4
 //------------------------------------------------------------------------------------------------------------
+
+//Returns a * b + c
+inline __m128 MultiplyAdd(__m128 a, __m128 b, __m128 c)
+{
+#if USE_FMA
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+//Returns row * mat, the sum of the rows of mat scaled by the elements of row.
+//Two partial sums so the multiply-adds don't all wait on each other.
+inline __m128 MultiplyRowMatrix(__m128 row, const __m128* mat)
+{
+	__m128 sum0 = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), mat[0]);
+	__m128 sum1 = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), mat[2]);
+	sum0 = MultiplyAdd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), mat[1], sum0);
+	sum1 = MultiplyAdd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), mat[3], sum1);
+
+	return _mm_add_ps(sum0, sum1);
+}
+
+//2x2 matrices in one register, (m00, m01, m10, m11).
+
+//Returns a * b
+inline __m128 Multiply2x2(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//Returns adjugate(a) * b
+inline __m128 AdjugateMultiply2x2(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+//Returns a * adjugate(b)
+inline __m128 MultiplyAdjugate2x2(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//Returns the cross product of the xyz parts, w is 0
+inline __m128 Cross3(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))));
+}
+
 class Matrix4x4_Intrinsics
 {
 public:
 
-	//Creates an identity matrix
+	//Creates a zero matrix
 	Matrix4x4_Intrinsics();
 
 	//Creates a matrix with the specified rows.
@@ -1698,9 +1766,17 @@ public:
 	friend float Determinant(const Matrix4x4_Intrinsics& mat);
 
 	//Returns the inverse of the matrix.
-	//Returns the identity matrix if mat is noninvertible (singular)
+	//Returns the zero matrix if mat is noninvertible (singular)
 	friend Matrix4x4_Intrinsics Inverse(const Matrix4x4_Intrinsics& mat);
 
+	//Returns the inverse of an affine matrix, one whose last column is (0, 0, 0, 1).
+	//Cheaper than Inverse. Returns the zero matrix if mat is noninvertible (singular)
+	friend Matrix4x4_Intrinsics AffineInverse(const Matrix4x4_Intrinsics& mat);
+
+	//Returns the inverse of a rotation followed by a translation, the 3x3 part must be orthonormal.
+	//The cheapest inverse, the 3x3 part is transposed.
+	friend Matrix4x4_Intrinsics OrthonormalInverse(const Matrix4x4_Intrinsics& mat);
+
 	//Returns the result of matA + matB.
 	friend Matrix4x4_Intrinsics operator+(const Matrix4x4_Intrinsics& matA, const Matrix4x4_Intrinsics& matB);
 
@@ -1902,41 +1978,13 @@ inline Matrix4x4_Intrinsics& Matrix4x4_Intrinsics::operator-=(const Matrix4x4_In
 
 inline Matrix4x4_Intrinsics& Matrix4x4_Intrinsics::operator*=(const Matrix4x4_Intrinsics& matB)
 {
-	__m128 b0 = matB.mat[0];
-	__m128 b1 = matB.mat[1];
-	__m128 b2 = matB.mat[2];
-	__m128 b3 = matB.mat[3];
-
-	_MM_TRANSPOSE4_PS(b0, b1, b2, b3);
-
-	this->mat[0] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[0], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[0], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[0], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[0], b0, 0xf1))
-	);
-
-	this->mat[1] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[1], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[1], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[1], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[1], b0, 0xf1))
-	);
+	//matB can be this
+	__m128 b[4] = { matB.mat[0], matB.mat[1], matB.mat[2], matB.mat[3] };
 
-
-	this->mat[2] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[2], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[2], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[2], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[2], b0, 0xf1))
-	);
-
-	this->mat[3] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[3], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[3], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[3], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(this->mat[3], b0, 0xf1))
-	);
+	this->mat[0] = MultiplyRowMatrix(this->mat[0], b);
+	this->mat[1] = MultiplyRowMatrix(this->mat[1], b);
+	this->mat[2] = MultiplyRowMatrix(this->mat[2], b);
+	this->mat[3] = MultiplyRowMatrix(this->mat[3], b);
 
 	return *this;
 }
@@ -2019,81 +2067,100 @@ inline float Determinant(const Matrix4x4_Intrinsics& mat)
 
 inline Matrix4x4_Intrinsics Inverse(const Matrix4x4_Intrinsics& mat)
 {
-	float det = Determinant(mat);
-	if (CompareFloats(det, 0.0f))
+	//Cramer's rule on the 2x2 blocks of mat = | A B |
+	//                                         | C D |
+	//the inverse is 1 / det * | adjugate(X) adjugate(Y) |
+	//                         | adjugate(Z) adjugate(W) |
+	__m128 a = _mm_movelh_ps(mat.mat[0], mat.mat[1]);
+	__m128 b = _mm_movehl_ps(mat.mat[1], mat.mat[0]);
+	__m128 c = _mm_movelh_ps(mat.mat[2], mat.mat[3]);
+	__m128 d = _mm_movehl_ps(mat.mat[3], mat.mat[2]);
+
+	//(det(A), det(B), det(C), det(D))
+	__m128 blockDets = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(mat.mat[0], mat.mat[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(mat.mat[1], mat.mat[3], _MM_SHUFFLE(3, 1, 3, 1))),
+		_mm_mul_ps(_mm_shuffle_ps(mat.mat[0], mat.mat[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(mat.mat[1], mat.mat[3], _MM_SHUFFLE(2, 0, 2, 0))));
+
+	__m128 detA = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 detB = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 detC = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(2, 2, 2, 2));
+	__m128 detD = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(3, 3, 3, 3));
+
+	__m128 adjDC = AdjugateMultiply2x2(d, c);
+	__m128 adjAB = AdjugateMultiply2x2(a, b);
+
+	//adjugate(X) = det(D) * A - B * adjugate(D) * C and so on
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Multiply2x2(b, adjDC));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Multiply2x2(c, adjAB));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), MultiplyAdjugate2x2(d, adjAB));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), MultiplyAdjugate2x2(a, adjDC));
+
+	//det = det(A) * det(D) + det(B) * det(C) - trace(adjugate(A) * B * adjugate(D) * C)
+	__m128 trace = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+	trace = _mm_hadd_ps(trace, trace);
+	trace = _mm_hadd_ps(trace, trace);
+	__m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+	if (CompareFloats(_mm_cvtss_f32(det), 0.0f))
 		return Matrix4x4_Intrinsics();
 
-	Matrix4x4_Intrinsics cofactors;
-
-	//0th row
-	cofactors.matA[0][0] = Determinant(Matrix3x3_Intrinsics(mat.matA[1][1], mat.matA[1][2], mat.matA[1][3],
-		mat.matA[2][1], mat.matA[2][2], mat.matA[2][3],
-		mat.matA[3][1], mat.matA[3][2], mat.matA[3][3]));
-
-	cofactors.matA[0][1] = -Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][2], mat.matA[1][3],
-		mat.matA[2][0], mat.matA[2][2], mat.matA[2][3],
-		mat.matA[3][0], mat.matA[3][2], mat.matA[3][3]));
-
-	cofactors.matA[0][2] = Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][1], mat.matA[1][3],
-		mat.matA[2][0], mat.matA[2][1], mat.matA[2][3],
-		mat.matA[3][0], mat.matA[3][1], mat.matA[3][3]));
-
-	cofactors.matA[0][3] = -Determinant(Matrix3x3_Intrinsics(mat.matA[1][0], mat.matA[1][1], mat.matA[1][2],
-		mat.matA[2][0], mat.matA[2][1], mat.matA[2][2],
-		mat.matA[3][0], mat.matA[3][1], mat.matA[3][2]));
+	//The signs of the adjugates
+	__m128 invDet = _mm_div_ps(_mm_set_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps(x, invDet);
+	y = _mm_mul_ps(y, invDet);
+	z = _mm_mul_ps(z, invDet);
+	w = _mm_mul_ps(w, invDet);
 
-	//1st row
-	cofactors.matA[1][0] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][1], mat.matA[0][2], mat.matA[0][3],
-		mat.matA[2][1], mat.matA[2][2], mat.matA[2][3],
-		mat.matA[3][1], mat.matA[3][2], mat.matA[3][3]));
+	//The shuffles swap the diagonals of the adjugates and put the blocks back into rows
+	Matrix4x4_Intrinsics result;
+	result.mat[0] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3));
+	result.mat[1] = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2));
+	result.mat[2] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3));
+	result.mat[3] = _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2));
 
-	cofactors.matA[1][1] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][2], mat.matA[0][3],
-		mat.matA[2][0], mat.matA[2][2], mat.matA[2][3],
-		mat.matA[3][0], mat.matA[3][2], mat.matA[3][3]));
+	return result;
+}
 
-	cofactors.matA[1][2] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][3],
-		mat.matA[2][0], mat.matA[2][1], mat.matA[2][3],
-		mat.matA[3][0], mat.matA[3][1], mat.matA[3][3]));
+inline Matrix4x4_Intrinsics AffineInverse(const Matrix4x4_Intrinsics& mat)
+{
+	//The inverse of the 3x3 part has the columns (row1 x row2, row2 x row0, row0 x row1) / det
+	__m128 r0 = Cross3(mat.mat[1], mat.mat[2]);
+	__m128 r1 = Cross3(mat.mat[2], mat.mat[0]);
+	__m128 r2 = Cross3(mat.mat[0], mat.mat[1]);
+	__m128 r3 = _mm_setzero_ps();
 
-	cofactors.matA[1][3] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][2],
-		mat.matA[2][0], mat.matA[2][1], mat.matA[2][2],
-		mat.matA[3][0], mat.matA[3][1], mat.matA[3][2]));
+	__m128 det = _mm_dp_ps(mat.mat[0], r0, 0x7f);
+	if (CompareFloats(_mm_cvtss_f32(det), 0.0f))
+		return Matrix4x4_Intrinsics();
 
-	//2nd row
-	cofactors.matA[2][0] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][1], mat.matA[0][2], mat.matA[0][3],
-		mat.matA[1][1], mat.matA[1][2], mat.matA[1][3],
-		mat.matA[3][1], mat.matA[3][2], mat.matA[3][3]));
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
 
-	cofactors.matA[2][1] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][2], mat.matA[0][3],
-		mat.matA[1][0], mat.matA[1][2], mat.matA[1][3],
-		mat.matA[3][0], mat.matA[3][2], mat.matA[3][3]));
+	__m128 invDet = _mm_div_ps(_mm_set_ps1(1.0f), det);
 
-	cofactors.matA[2][2] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][3],
-		mat.matA[1][0], mat.matA[1][1], mat.matA[1][3],
-		mat.matA[3][0], mat.matA[3][1], mat.matA[3][3]));
+	Matrix4x4_Intrinsics result;
+	result.mat[0] = _mm_mul_ps(r0, invDet);
+	result.mat[1] = _mm_mul_ps(r1, invDet);
+	result.mat[2] = _mm_mul_ps(r2, invDet);
 
-	cofactors.matA[2][3] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][2],
-		mat.matA[1][0], mat.matA[1][1], mat.matA[1][2],
-		mat.matA[3][0], mat.matA[3][1], mat.matA[3][2]));
+	//-translation * inverse of the 3x3 part, the last column of the rows is 0
+	result.mat[3] = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), MultiplyRowMatrix(mat.mat[3], result.mat));
 
-	//3rd row
-	cofactors.matA[3][0] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][1], mat.matA[0][2], mat.matA[0][3],
-		mat.matA[1][1], mat.matA[1][2], mat.matA[1][3],
-		mat.matA[2][1], mat.matA[2][2], mat.matA[2][3]));
+	return result;
+}
 
-	cofactors.matA[3][1] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][2], mat.matA[0][3],
-		mat.matA[1][0], mat.matA[1][2], mat.matA[1][3],
-		mat.matA[2][0], mat.matA[2][2], mat.matA[2][3]));
+inline Matrix4x4_Intrinsics OrthonormalInverse(const Matrix4x4_Intrinsics& mat)
+{
+	Matrix4x4_Intrinsics result;
+	result.mat[0] = mat.mat[0];
+	result.mat[1] = mat.mat[1];
+	result.mat[2] = mat.mat[2];
+	result.mat[3] = _mm_setzero_ps();
 
-	cofactors.matA[3][2] = -Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][3],
-		mat.matA[1][0], mat.matA[1][1], mat.matA[1][3],
-		mat.matA[2][0], mat.matA[2][1], mat.matA[2][3]));
+	_MM_TRANSPOSE4_PS(result.mat[0], result.mat[1], result.mat[2], result.mat[3]);
 
-	cofactors.matA[3][3] = Determinant(Matrix3x3_Intrinsics(mat.matA[0][0], mat.matA[0][1], mat.matA[0][2],
-		mat.matA[1][0], mat.matA[1][1], mat.matA[1][2],
-		mat.matA[2][0], mat.matA[2][1], mat.matA[2][2]));
+	result.mat[3] = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), MultiplyRowMatrix(mat.mat[3], result.mat));
 
-	return (1.0f / det) * Transpose(cofactors);
+	return result;
 }
 
 inline Matrix4x4_Intrinsics operator+(const Matrix4x4_Intrinsics& matA, const Matrix4x4_Intrinsics& matB)
@@ -2124,40 +2191,10 @@ inline Matrix4x4_Intrinsics operator*(const Matrix4x4_Intrinsics& matA, const Ma
 {
 	Matrix4x4_Intrinsics result;
 
-	__m128 b0 = matB.mat[0];
-	__m128 b1 = matB.mat[1];
-	__m128 b2 = matB.mat[2];
-	__m128 b3 = matB.mat[3];
-
-	_MM_TRANSPOSE4_PS(b0, b1, b2, b3);
-
-	result.mat[0] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[0], b0, 0xf1))
-	);
-
-	result.mat[1] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[1], b0, 0xf1))
-	);
-
-	result.mat[2] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[2], b0, 0xf1))
-	);
-
-	result.mat[3] = _mm_set_ps(
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b3, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b2, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b1, 0xf1)),
-		_mm_cvtss_f32(_mm_dp_ps(matA.mat[3], b0, 0xf1))
-	);
+	result.mat[0] = MultiplyRowMatrix(matA.mat[0], matB.mat);
+	result.mat[1] = MultiplyRowMatrix(matA.mat[1], matB.mat);
+	result.mat[2] = MultiplyRowMatrix(matA.mat[2], matB.mat);
+	result.mat[3] = MultiplyRowMatrix(matA.mat[3], matB.mat);
 
 	return result;
 }
@@ -2342,6 +2379,14 @@ public:
 	//Returns the matrix representation of quaterion q.
 	friend Matrix4x4_Intrinsics QuaternionToMatrix(const Quaternion_Intrinsics& q);
 
+	//Returns the normalized linear interpolation from a to b, t = 0 gives a.
+	//If dot(a, b) < 0, b is negated first. -b is the same rotation and closer to a, so this takes the shortest path.
+	friend Quaternion_Intrinsics Nlerp(const Quaternion_Intrinsics& a, const Quaternion_Intrinsics& b, float t);
+
+	//Returns the spherical linear interpolation from a to b, t = 0 gives a. a and b must be unit quaternions.
+	//Takes the shortest path like Nlerp, and uses Nlerp if a and b are almost the same rotation.
+	friend Quaternion_Intrinsics Slerp(const Quaternion_Intrinsics& a, const Quaternion_Intrinsics& b, float t);
+
 private:
 	Quaternion_Intrinsics(__m128 quat);
 
@@ -2701,6 +2746,566 @@ inline Matrix4x4_Intrinsics QuaternionToMatrix(const Quaternion_Intrinsics& q)
 		m20, m21, m22, m23,
 		m30, m31, m32, m33);
 }
+
+inline Quaternion_Intrinsics Nlerp(const Quaternion_Intrinsics& a, const Quaternion_Intrinsics& b, float t)
+{
+	//The sign bit of dot(a, b) negates b
+	__m128 sign = _mm_and_ps(_mm_dp_ps(a.quat, b.quat, 0xff), _mm_set_ps1(-0.0f));
+	__m128 result = MultiplyAdd(_mm_xor_ps(b.quat, sign), _mm_set_ps1(t), _mm_mul_ps(a.quat, _mm_set_ps1(1.0f - t)));
+
+	return Quaternion_Intrinsics(_mm_div_ps(result, _mm_sqrt_ps(_mm_dp_ps(result, result, 0xff))));
+}
+
+inline Quaternion_Intrinsics Slerp(const Quaternion_Intrinsics& a, const Quaternion_Intrinsics& b, float t)
+{
+	__m128 dot = _mm_dp_ps(a.quat, b.quat, 0xff);
+	__m128 sign = _mm_and_ps(dot, _mm_set_ps1(-0.0f));
+	float cosAngle = fabsf(_mm_cvtss_f32(dot));
+
+	//sin(angle) goes to 0 and the arc is almost a straight line
+	if (cosAngle > 0.9995f)
+		return Nlerp(a, b, t);
+
+	float angle = acosf(cosAngle);
+	float invSinAngle = 1.0f / sinf(angle);
+	__m128 weightA = _mm_set_ps1(sinf((1.0f - t) * angle) * invSinAngle);
+	__m128 weightB = _mm_set_ps1(sinf(t * angle) * invSinAngle);
+
+	return Quaternion_Intrinsics(MultiplyAdd(_mm_xor_ps(b.quat, sign), weightB, _mm_mul_ps(a.quat, weightA)));
+}
 //------------------------------------------------------------------------------------------------------------
 
-typedef Quaternion_Intrinsics quat;
\ No newline at end of file
+typedef Quaternion_Intrinsics quat;
+
+//COMPACT TRANSFORMS
+//------------------------------------------------------------------------------------------------------------
+//Smaller than a mat4 for uniform and instance buffers, and cheaper to compose and invert on the CPU.
+//They transform row vectors like mat4, a * b applies a, then b.
+//The shader library decodes them in transform.h.hlsl and transform.h.glsl, with the same member layout.
+
+//Returns the __m128 of a vec3, vec4 or quat, their only member. vec3 keeps a w of 0.
+template<typename T>
+inline __m128 LoadM128(const T& value)
+{
+	static_assert(sizeof(T) == sizeof(__m128), "T must be a vec3, vec4 or quat.");
+	return _mm_load_ps((const float*)&value);
+}
+
+//Returns a vec3, vec4 or quat with the __m128 value
+template<typename T>
+inline T StoreM128(__m128 value)
+{
+	static_assert(sizeof(T) == sizeof(__m128), "T must be a vec3, vec4 or quat.");
+	T result;
+	_mm_store_ps((float*)&result, value);
+	return result;
+}
+
+//Returns the quaternion product a * b, quaternions are (x, y, z, scalar).
+//Four shuffled products instead of the horizontal adds of Quaternion_Intrinsics' operator*.
+inline __m128 MultiplyQuaternions(__m128 a, __m128 b)
+{
+	//The scalar part subtracts the first two products, the vector part adds them
+	__m128 sign = _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+
+	__m128 result = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+	__m128 product = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 3, 3)));
+	result = _mm_add_ps(result, _mm_xor_ps(product, sign));
+	product = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 0, 2)));
+	result = _mm_add_ps(result, _mm_xor_ps(product, sign));
+	product = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 0, 2, 1)));
+
+	return _mm_sub_ps(result, product);
+}
+
+//Returns the xyz of v rotated by the unit quaternion q, w stays the w of v.
+//v + scalar * t + q.xyz x t with t = 2 * q.xyz x v, two cross products instead of two quaternion products.
+inline __m128 RotateByQuaternion(__m128 q, __m128 v)
+{
+	__m128 t = Cross3(q, v);
+	t = _mm_add_ps(t, t);
+
+	return _mm_add_ps(MultiplyAdd(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 3, 3)), t, v), Cross3(q, t));
+}
+
+class TransformTRS_Intrinsics;
+
+//An affine transform, a mat4 whose last column is (0, 0, 0, 1), in 48 bytes.
+//Row j is column j of the mat4 (a transposed model matrix without its last row, the layout of ShapeInstance),
+//so transforming a point is three dot products with (p, 1).
+class Matrix3x4_Intrinsics
+{
+public:
+	//Creates an identity matrix
+	Matrix3x4_Intrinsics();
+
+	//Creates a matrix with the specified rows, row j is column j of the mat4.
+	Matrix3x4_Intrinsics(const vec4& row0, const vec4& row1, const vec4& row2);
+
+	//Creates a matrix from the first three columns of mat, the last column is dropped.
+	explicit Matrix3x4_Intrinsics(const Matrix4x4_Intrinsics& mat);
+
+	//Returns row j, column j of the mat4.
+	vec4 GetRow(uint32_t row) const;
+
+	//Returns the mat4, its last column is (0, 0, 0, 1).
+	friend Matrix4x4_Intrinsics Matrix3x4ToMatrix(const Matrix3x4_Intrinsics& mat);
+
+	//Returns the transform that applies a, then b.
+	friend Matrix3x4_Intrinsics operator*(const Matrix3x4_Intrinsics& a, const Matrix3x4_Intrinsics& b);
+
+	//Returns the inverse of mat. Returns the zero matrix if mat is noninvertible (singular), like Inverse of a mat4.
+	friend Matrix3x4_Intrinsics Inverse(const Matrix3x4_Intrinsics& mat);
+
+	//Returns (p, 1) * mat
+	friend Vector3_Intrinsics TransformPoint(const Matrix3x4_Intrinsics& mat, const Vector3_Intrinsics& p);
+
+	//Returns (v, 0) * mat
+	friend Vector3_Intrinsics TransformVector(const Matrix3x4_Intrinsics& mat, const Vector3_Intrinsics& v);
+
+	//Returns n * transpose(inverse(mat)) for normals, without the inverse: the cofactors of the 3x3 part are the
+	//inverse transpose times the determinant. The result has to be normalized, and points the other way if the
+	//determinant is negative.
+	friend Vector3_Intrinsics TransformNormal(const Matrix3x4_Intrinsics& mat, const Vector3_Intrinsics& n);
+
+	friend Matrix3x4_Intrinsics TransformTRSToMatrix3x4(const TransformTRS_Intrinsics& transform);
+
+private:
+	union
+	{
+		__m128 mat[3];
+		float matA[3][4];
+	};
+};
+
+inline Matrix3x4_Intrinsics::Matrix3x4_Intrinsics()
+{
+	mat[0] = _mm_set_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	mat[1] = _mm_set_ps(0.0f, 0.0f, 1.0f, 0.0f);
+	mat[2] = _mm_set_ps(0.0f, 1.0f, 0.0f, 0.0f);
+}
+
+inline Matrix3x4_Intrinsics::Matrix3x4_Intrinsics(const vec4& row0, const vec4& row1, const vec4& row2)
+{
+	mat[0] = LoadM128(row0);
+	mat[1] = LoadM128(row1);
+	mat[2] = LoadM128(row2);
+}
+
+inline Matrix3x4_Intrinsics::Matrix3x4_Intrinsics(const Matrix4x4_Intrinsics& mat)
+{
+	const float* rows = (const float*)&mat;
+	__m128 row0 = _mm_load_ps(rows);
+	__m128 row1 = _mm_load_ps(rows + 4);
+	__m128 row2 = _mm_load_ps(rows + 8);
+	__m128 row3 = _mm_load_ps(rows + 12);
+
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+	this->mat[0] = row0;
+	this->mat[1] = row1;
+	this->mat[2] = row2;
+}
+
+inline vec4 Matrix3x4_Intrinsics::GetRow(uint32_t row) const
+{
+	assert(row < 3 && "Matrix3x4 has 3 rows.");
+
+	return StoreM128<vec4>(mat[row]);
+}
+
+inline Matrix4x4_Intrinsics Matrix3x4ToMatrix(const Matrix3x4_Intrinsics& mat)
+{
+	__m128 row0 = mat.mat[0];
+	__m128 row1 = mat.mat[1];
+	__m128 row2 = mat.mat[2];
+	__m128 row3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+	Matrix4x4_Intrinsics result;
+	float* rows = (float*)&result;
+	_mm_store_ps(rows, row0);
+	_mm_store_ps(rows + 4, row1);
+	_mm_store_ps(rows + 8, row2);
+	_mm_store_ps(rows + 12, row3);
+
+	return result;
+}
+
+inline Matrix3x4_Intrinsics operator*(const Matrix3x4_Intrinsics& a, const Matrix3x4_Intrinsics& b)
+{
+	//The rows are transposed, so this is b * a with a fourth row of (0, 0, 0, 1) under a
+	Matrix3x4_Intrinsics result;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		__m128 row = b.mat[i];
+		__m128 sum = _mm_blend_ps(_mm_setzero_ps(), row, 0x8);
+		sum = MultiplyAdd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), a.mat[0], sum);
+		sum = MultiplyAdd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), a.mat[1], sum);
+		result.mat[i] = MultiplyAdd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), a.mat[2], sum);
+	}
+
+	return result;
+}
+
+inline Matrix3x4_Intrinsics Inverse(const Matrix3x4_Intrinsics& mat)
+{
+	//The rows are the transposed 3x3 part L and the translation t, the inverse is L^-1 and -L^-1 * t.
+	//L^-1 has the columns (row1 x row2, row2 x row0, row0 x row1) / det, Cross3 ignores the translations in w.
+	__m128 c0 = Cross3(mat.mat[1], mat.mat[2]);
+	__m128 c1 = Cross3(mat.mat[2], mat.mat[0]);
+	__m128 c2 = Cross3(mat.mat[0], mat.mat[1]);
+
+	__m128 det = _mm_dp_ps(mat.mat[0], c0, 0x7f);
+	if (CompareFloats(_mm_cvtss_f32(det), 0.0f))
+		return Matrix3x4_Intrinsics(vec4(), vec4(), vec4());
+
+	//-(L^-1 * t) * det, the sum of the columns scaled by the translation
+	__m128 c3 = _mm_mul_ps(_mm_shuffle_ps(mat.mat[0], mat.mat[0], _MM_SHUFFLE(3, 3, 3, 3)), c0);
+	c3 = MultiplyAdd(_mm_shuffle_ps(mat.mat[1], mat.mat[1], _MM_SHUFFLE(3, 3, 3, 3)), c1, c3);
+	c3 = MultiplyAdd(_mm_shuffle_ps(mat.mat[2], mat.mat[2], _MM_SHUFFLE(3, 3, 3, 3)), c2, c3);
+	c3 = _mm_xor_ps(c3, _mm_set_ps1(-0.0f));
+
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	__m128 invDet = _mm_div_ps(_mm_set_ps1(1.0f), det);
+
+	Matrix3x4_Intrinsics result;
+	result.mat[0] = _mm_mul_ps(c0, invDet);
+	result.mat[1] = _mm_mul_ps(c1, invDet);
+	result.mat[2] = _mm_mul_ps(c2, invDet);
+
+	return result;
+}
+
+inline Vector3_Intrinsics TransformPoint(const Matrix3x4_Intrinsics& mat, const Vector3_Intrinsics& p)
+{
+	__m128 point = _mm_blend_ps(LoadM128(p), _mm_set_ps1(1.0f), 0x8);
+	__m128 result = _mm_dp_ps(mat.mat[0], point, 0xf1);
+	result = _mm_or_ps(result, _mm_dp_ps(mat.mat[1], point, 0xf2));
+	result = _mm_or_ps(result, _mm_dp_ps(mat.mat[2], point, 0xf4));
+
+	return StoreM128<Vector3_Intrinsics>(result);
+}
+
+inline Vector3_Intrinsics TransformVector(const Matrix3x4_Intrinsics& mat, const Vector3_Intrinsics& v)
+{
+	__m128 vec = LoadM128(v);
+	__m128 result = _mm_dp_ps(mat.mat[0], vec, 0x71);
+	result = _mm_or_ps(result, _mm_dp_ps(mat.mat[1], vec, 0x72));
+	result = _mm_or_ps(result, _mm_dp_ps(mat.mat[2], vec, 0x74));
+
+	return StoreM128<Vector3_Intrinsics>(result);
+}
+
+inline Vector3_Intrinsics TransformNormal(const Matrix3x4_Intrinsics& mat, const Vector3_Intrinsics& n)
+{
+	//Component i is dot(row(i + 1) x row(i + 2), n), the rows of the cofactor matrix of the transposed 3x3 part
+	__m128 normal = LoadM128(n);
+	__m128 result = _mm_dp_ps(Cross3(mat.mat[1], mat.mat[2]), normal, 0x71);
+	result = _mm_or_ps(result, _mm_dp_ps(Cross3(mat.mat[2], mat.mat[0]), normal, 0x72));
+	result = _mm_or_ps(result, _mm_dp_ps(Cross3(mat.mat[0], mat.mat[1]), normal, 0x74));
+
+	return StoreM128<Vector3_Intrinsics>(result);
+}
+
+typedef Matrix3x4_Intrinsics mat3x4;
+
+//A rotation, a uniform scale and a translation in 32 bytes, p * Scale(scale) * QuaternionToMatrix(rotation) * Translate(translation).
+//The cheapest transform to compose and invert, and normals only need the rotation. rotation must be a unit quaternion.
+class TransformTRS_Intrinsics
+{
+public:
+	//Creates an identity transform
+	TransformTRS_Intrinsics();
+	TransformTRS_Intrinsics(const Quaternion_Intrinsics& rotation, const Vector3_Intrinsics& translation, float scale);
+
+	Quaternion_Intrinsics GetRotation() const;
+	Vector3_Intrinsics GetTranslation() const;
+	float GetScale() const;
+
+	void SetRotation(const Quaternion_Intrinsics& rotation);
+	void SetTranslation(const Vector3_Intrinsics& translation);
+	void SetScale(float scale);
+
+	//Returns Scale(scale) * QuaternionToMatrix(rotation) * Translate(translation)
+	friend Matrix4x4_Intrinsics TransformTRSToMatrix(const TransformTRS_Intrinsics& transform);
+
+	//Returns the transform as a Matrix3x4, for objects that are drawn with one
+	friend Matrix3x4_Intrinsics TransformTRSToMatrix3x4(const TransformTRS_Intrinsics& transform);
+
+	//Returns the transform that applies a, then b.
+	friend TransformTRS_Intrinsics operator*(const TransformTRS_Intrinsics& a, const TransformTRS_Intrinsics& b);
+
+	//Returns the inverse of transform, the scale must not be 0.
+	friend TransformTRS_Intrinsics Inverse(const TransformTRS_Intrinsics& transform);
+
+	//Returns (p, 1) * TransformTRSToMatrix(transform)
+	friend Vector3_Intrinsics TransformPoint(const TransformTRS_Intrinsics& transform, const Vector3_Intrinsics& p);
+
+	//Returns (v, 0) * TransformTRSToMatrix(transform)
+	friend Vector3_Intrinsics TransformVector(const TransformTRS_Intrinsics& transform, const Vector3_Intrinsics& v);
+
+private:
+	__m128 rotation;
+
+	//xyz is the translation, w the scale
+	__m128 translationScale;
+};
+
+inline TransformTRS_Intrinsics::TransformTRS_Intrinsics()
+{
+	rotation = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+	translationScale = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+inline TransformTRS_Intrinsics::TransformTRS_Intrinsics(const Quaternion_Intrinsics& rotation, const Vector3_Intrinsics& translation, float scale)
+{
+	this->rotation = LoadM128(rotation);
+	translationScale = _mm_blend_ps(LoadM128(translation), _mm_set_ps1(scale), 0x8);
+}
+
+inline Quaternion_Intrinsics TransformTRS_Intrinsics::GetRotation() const
+{
+	return StoreM128<Quaternion_Intrinsics>(rotation);
+}
+
+inline Vector3_Intrinsics TransformTRS_Intrinsics::GetTranslation() const
+{
+	return StoreM128<Vector3_Intrinsics>(_mm_blend_ps(translationScale, _mm_setzero_ps(), 0x8));
+}
+
+inline float TransformTRS_Intrinsics::GetScale() const
+{
+	return _mm_cvtss_f32(_mm_shuffle_ps(translationScale, translationScale, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+inline void TransformTRS_Intrinsics::SetRotation(const Quaternion_Intrinsics& rotation)
+{
+	this->rotation = LoadM128(rotation);
+}
+
+inline void TransformTRS_Intrinsics::SetTranslation(const Vector3_Intrinsics& translation)
+{
+	translationScale = _mm_blend_ps(LoadM128(translation), translationScale, 0x8);
+}
+
+inline void TransformTRS_Intrinsics::SetScale(float scale)
+{
+	translationScale = _mm_blend_ps(translationScale, _mm_set_ps1(scale), 0x8);
+}
+
+inline Matrix4x4_Intrinsics TransformTRSToMatrix(const TransformTRS_Intrinsics& transform)
+{
+	return Matrix3x4ToMatrix(TransformTRSToMatrix3x4(transform));
+}
+
+inline Matrix3x4_Intrinsics TransformTRSToMatrix3x4(const TransformTRS_Intrinsics& transform)
+{
+	//The columns of the rotation matrix have a w of 0, scale them and put the translation in w
+	__m128 translationScale = transform.translationScale;
+	__m128 scale = _mm_shuffle_ps(translationScale, translationScale, _MM_SHUFFLE(3, 3, 3, 3));
+	Matrix3x4_Intrinsics rotation(QuaternionToMatrix(StoreM128<Quaternion_Intrinsics>(transform.rotation)));
+
+	Matrix3x4_Intrinsics result;
+	result.mat[0] = _mm_blend_ps(_mm_mul_ps(rotation.mat[0], scale), _mm_shuffle_ps(translationScale, translationScale, _MM_SHUFFLE(0, 0, 0, 0)), 0x8);
+	result.mat[1] = _mm_blend_ps(_mm_mul_ps(rotation.mat[1], scale), _mm_shuffle_ps(translationScale, translationScale, _MM_SHUFFLE(1, 1, 1, 1)), 0x8);
+	result.mat[2] = _mm_blend_ps(_mm_mul_ps(rotation.mat[2], scale), _mm_shuffle_ps(translationScale, translationScale, _MM_SHUFFLE(2, 2, 2, 2)), 0x8);
+
+	return result;
+}
+
+inline TransformTRS_Intrinsics operator*(const TransformTRS_Intrinsics& a, const TransformTRS_Intrinsics& b)
+{
+	//w of a's translation times b's scale is the scale of the product, RotateByQuaternion keeps it
+	__m128 bScale = _mm_shuffle_ps(b.translationScale, b.translationScale, _MM_SHUFFLE(3, 3, 3, 3));
+	__m128 translationScale = RotateByQuaternion(b.rotation, _mm_mul_ps(a.translationScale, bScale));
+
+	TransformTRS_Intrinsics result;
+	result.rotation = MultiplyQuaternions(b.rotation, a.rotation);
+	result.translationScale = _mm_add_ps(translationScale, _mm_blend_ps(b.translationScale, _mm_setzero_ps(), 0x8));
+
+	return result;
+}
+
+inline TransformTRS_Intrinsics Inverse(const TransformTRS_Intrinsics& transform)
+{
+	__m128 scale = _mm_shuffle_ps(transform.translationScale, transform.translationScale, _MM_SHUFFLE(3, 3, 3, 3));
+	__m128 invScale = _mm_div_ps(_mm_set_ps1(1.0f), scale);
+
+	TransformTRS_Intrinsics result;
+	result.rotation = _mm_xor_ps(transform.rotation, _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f));
+
+	//-Rotate(Conjugate(rotation), translation) / scale
+	__m128 translation = RotateByQuaternion(result.rotation, _mm_mul_ps(transform.translationScale, _mm_xor_ps(invScale, _mm_set_ps1(-0.0f))));
+	result.translationScale = _mm_blend_ps(translation, invScale, 0x8);
+
+	return result;
+}
+
+inline Vector3_Intrinsics TransformPoint(const TransformTRS_Intrinsics& transform, const Vector3_Intrinsics& p)
+{
+	__m128 scale = _mm_shuffle_ps(transform.translationScale, transform.translationScale, _MM_SHUFFLE(3, 3, 3, 3));
+	__m128 result = RotateByQuaternion(transform.rotation, _mm_mul_ps(LoadM128(p), scale));
+
+	return StoreM128<Vector3_Intrinsics>(_mm_add_ps(result, _mm_blend_ps(transform.translationScale, _mm_setzero_ps(), 0x8)));
+}
+
+inline Vector3_Intrinsics TransformVector(const TransformTRS_Intrinsics& transform, const Vector3_Intrinsics& v)
+{
+	__m128 scale = _mm_shuffle_ps(transform.translationScale, transform.translationScale, _MM_SHUFFLE(3, 3, 3, 3));
+
+	return StoreM128<Vector3_Intrinsics>(RotateByQuaternion(transform.rotation, _mm_mul_ps(LoadM128(v), scale)));
+}
+
+typedef TransformTRS_Intrinsics trs;
+
+//A rotation and a translation in 32 bytes, real + dual * e with e * e = 0.
+//real is the rotation and dual is 0.5 * (translation, 0) * real. The weighted sum of dual quaternions, normalized,
+//is still a rotation and a translation, so skinning with them keeps the volume around twisted joints that blended
+//matrices lose. real must be a unit quaternion.
+class DualQuaternion_Intrinsics
+{
+public:
+	//Creates an identity transform
+	DualQuaternion_Intrinsics();
+
+	//Creates the transform that rotates, then translates.
+	DualQuaternion_Intrinsics(const Quaternion_Intrinsics& rotation, const Vector3_Intrinsics& translation);
+
+	Quaternion_Intrinsics GetReal() const;
+	Quaternion_Intrinsics GetDual() const;
+
+	//Returns 2 * dual * Conjugate(real)
+	Vector3_Intrinsics GetTranslation() const;
+
+	//Returns the weighted sum a + b, for blends
+	friend DualQuaternion_Intrinsics operator+(const DualQuaternion_Intrinsics& a, const DualQuaternion_Intrinsics& b);
+
+	//Returns the weighted a * k, for blends
+	friend DualQuaternion_Intrinsics operator*(const DualQuaternion_Intrinsics& a, float k);
+
+	//Returns the transform that applies a, then b.
+	friend DualQuaternion_Intrinsics operator*(const DualQuaternion_Intrinsics& a, const DualQuaternion_Intrinsics& b);
+
+	//Returns a blend back as a unit dual quaternion: both parts divided by the length of real, and the part of dual
+	//along real removed.
+	friend DualQuaternion_Intrinsics Normalize(const DualQuaternion_Intrinsics& a);
+
+	//Returns the inverse of a unit dual quaternion, the conjugates of both parts.
+	friend DualQuaternion_Intrinsics Inverse(const DualQuaternion_Intrinsics& a);
+
+	//Returns p rotated, then translated
+	friend Vector3_Intrinsics TransformPoint(const DualQuaternion_Intrinsics& a, const Vector3_Intrinsics& p);
+
+	//Returns v rotated
+	friend Vector3_Intrinsics TransformVector(const DualQuaternion_Intrinsics& a, const Vector3_Intrinsics& v);
+
+	//Returns QuaternionToMatrix(real) * Translate(translation) as a Matrix3x4
+	friend Matrix3x4_Intrinsics DualQuaternionToMatrix3x4(const DualQuaternion_Intrinsics& a);
+
+private:
+	__m128 real;
+	__m128 dual;
+};
+
+inline DualQuaternion_Intrinsics::DualQuaternion_Intrinsics()
+{
+	real = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+	dual = _mm_setzero_ps();
+}
+
+inline DualQuaternion_Intrinsics::DualQuaternion_Intrinsics(const Quaternion_Intrinsics& rotation, const Vector3_Intrinsics& translation)
+{
+	real = LoadM128(rotation);
+	dual = _mm_mul_ps(MultiplyQuaternions(LoadM128(translation), real), _mm_set_ps1(0.5f));
+}
+
+inline Quaternion_Intrinsics DualQuaternion_Intrinsics::GetReal() const
+{
+	return StoreM128<Quaternion_Intrinsics>(real);
+}
+
+inline Quaternion_Intrinsics DualQuaternion_Intrinsics::GetDual() const
+{
+	return StoreM128<Quaternion_Intrinsics>(dual);
+}
+
+inline Vector3_Intrinsics DualQuaternion_Intrinsics::GetTranslation() const
+{
+	__m128 translation = MultiplyQuaternions(dual, _mm_xor_ps(real, _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f)));
+	translation = _mm_add_ps(translation, translation);
+
+	return StoreM128<Vector3_Intrinsics>(_mm_blend_ps(translation, _mm_setzero_ps(), 0x8));
+}
+
+inline DualQuaternion_Intrinsics operator+(const DualQuaternion_Intrinsics& a, const DualQuaternion_Intrinsics& b)
+{
+	DualQuaternion_Intrinsics result;
+	result.real = _mm_add_ps(a.real, b.real);
+	result.dual = _mm_add_ps(a.dual, b.dual);
+
+	return result;
+}
+
+inline DualQuaternion_Intrinsics operator*(const DualQuaternion_Intrinsics& a, float k)
+{
+	__m128 scale = _mm_set_ps1(k);
+
+	DualQuaternion_Intrinsics result;
+	result.real = _mm_mul_ps(a.real, scale);
+	result.dual = _mm_mul_ps(a.dual, scale);
+
+	return result;
+}
+
+inline DualQuaternion_Intrinsics operator*(const DualQuaternion_Intrinsics& a, const DualQuaternion_Intrinsics& b)
+{
+	DualQuaternion_Intrinsics result;
+	result.real = MultiplyQuaternions(b.real, a.real);
+	result.dual = _mm_add_ps(MultiplyQuaternions(b.real, a.dual), MultiplyQuaternions(b.dual, a.real));
+
+	return result;
+}
+
+inline DualQuaternion_Intrinsics Normalize(const DualQuaternion_Intrinsics& a)
+{
+	__m128 invLength = _mm_div_ps(_mm_set_ps1(1.0f), _mm_sqrt_ps(_mm_dp_ps(a.real, a.real, 0xff)));
+
+	DualQuaternion_Intrinsics result;
+	result.real = _mm_mul_ps(a.real, invLength);
+	result.dual = _mm_mul_ps(a.dual, invLength);
+	result.dual = _mm_sub_ps(result.dual, _mm_mul_ps(result.real, _mm_dp_ps(result.real, result.dual, 0xff)));
+
+	return result;
+}
+
+inline DualQuaternion_Intrinsics Inverse(const DualQuaternion_Intrinsics& a)
+{
+	__m128 sign = _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f);
+
+	DualQuaternion_Intrinsics result;
+	result.real = _mm_xor_ps(a.real, sign);
+	result.dual = _mm_xor_ps(a.dual, sign);
+
+	return result;
+}
+
+inline Vector3_Intrinsics TransformPoint(const DualQuaternion_Intrinsics& a, const Vector3_Intrinsics& p)
+{
+	return StoreM128<Vector3_Intrinsics>(_mm_add_ps(RotateByQuaternion(a.real, LoadM128(p)), LoadM128(a.GetTranslation())));
+}
+
+inline Vector3_Intrinsics TransformVector(const DualQuaternion_Intrinsics& a, const Vector3_Intrinsics& v)
+{
+	return StoreM128<Vector3_Intrinsics>(RotateByQuaternion(a.real, LoadM128(v)));
+}
+
+inline Matrix3x4_Intrinsics DualQuaternionToMatrix3x4(const DualQuaternion_Intrinsics& a)
+{
+	return TransformTRSToMatrix3x4(TransformTRS_Intrinsics(a.GetReal(), a.GetTranslation(), 1.0f));
+}
+
+typedef DualQuaternion_Intrinsics dualquat;
+//------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,613 @@
+#include <immintrin.h>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "SEBVH.h"
+#include "../Thread/SEThread.h"
+
+//Meshes with fewer triangles are built on the calling thread only
+#define BVH_PARALLEL_MIN_TRIANGLES 16384
+
+//Below this depth nodes are split in half instead of by the SAH, which bounds the depth of the tree to BVH_STACK_SIZE
+#define BVH_MAX_SAH_DEPTH 32
+#define BVH_STACK_SIZE 64
+
+struct BVHBuilder
+{
+	BVHNode* nodes;
+
+	//Triangles in leaf order, the nodes reference ranges of it while building
+	uint32_t* triangles;
+
+	//3 floats per triangle
+	float* centroids;
+	float* boundsMin;
+	float* boundsMax;
+};
+
+//A subtree built on a worker thread, its nodes are allocated from [base, end)
+struct BVHBuildTask
+{
+	uint32_t node;
+	uint32_t depth;
+	uint32_t base;
+	uint32_t end;
+};
+
+struct BVHBin
+{
+	float boundsMin[3];
+	float boundsMax[3];
+	uint32_t count;
+};
+
+inline float HalfSurfaceArea(const float* boundsMin, const float* boundsMax)
+{
+	float dx = boundsMax[0] - boundsMin[0];
+	float dy = boundsMax[1] - boundsMin[1];
+	float dz = boundsMax[2] - boundsMin[2];
+
+	return dx * dy + dy * dz + dz * dx;
+}
+
+inline void GrowBounds(float* boundsMin, float* boundsMax, const float* otherMin, const float* otherMax)
+{
+	for (uint32_t k = 0; k < 3; ++k)
+	{
+		boundsMin[k] = (otherMin[k] < boundsMin[k]) ? otherMin[k] : boundsMin[k];
+		boundsMax[k] = (otherMax[k] > boundsMax[k]) ? otherMax[k] : boundsMax[k];
+	}
+}
+
+void UpdateNodeBounds(const BVHBuilder* builder, BVHNode* node)
+{
+	for (uint32_t k = 0; k < 3; ++k)
+	{
+		node->boundsMin[k] = FLT_MAX;
+		node->boundsMax[k] = -FLT_MAX;
+	}
+
+	for (uint32_t i = node->leftFirst; i < node->leftFirst + node->count; ++i)
+	{
+		uint32_t t = builder->triangles[i];
+		GrowBounds(node->boundsMin, node->boundsMax, &builder->boundsMin[t * 3], &builder->boundsMax[t * 3]);
+	}
+}
+
+inline uint32_t CentroidBin(float centroid, float centroidMin, float binScale)
+{
+	uint32_t bin = (uint32_t)((centroid - centroidMin) * binScale);
+	return (bin < BVH_NUM_BINS - 1) ? bin : BVH_NUM_BINS - 1;
+}
+
+//Splits the leaf into two children allocated at *nextNode. Returns false if the node stays a leaf.
+//A packet tests BVH_MAX_LEAF_TRIANGLES triangles for the price of one, so only larger nodes are split.
+//The split is the cheapest plane between BVH_NUM_BINS centroid bins on any axis by the SAH, or the middle if no plane separates the triangles.
+bool SplitNode(BVHBuilder* builder, uint32_t nodeIndex, uint32_t depth, uint32_t* nextNode)
+{
+	BVHNode* node = &builder->nodes[nodeIndex];
+	uint32_t first = node->leftFirst;
+	uint32_t count = node->count;
+	if (count <= BVH_MAX_LEAF_TRIANGLES)
+		return false;
+
+	float centroidMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float centroidMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (uint32_t i = first; i < first + count; ++i)
+	{
+		const float* centroid = &builder->centroids[builder->triangles[i] * 3];
+		GrowBounds(centroidMin, centroidMax, centroid, centroid);
+	}
+
+	int32_t bestAxis = -1;
+	uint32_t bestBin = 0;
+	float bestCost = FLT_MAX;
+	for (uint32_t axis = 0; axis < 3 && depth < BVH_MAX_SAH_DEPTH; ++axis)
+	{
+		float extent = centroidMax[axis] - centroidMin[axis];
+		if (extent <= 0.0f)
+			continue;
+
+		BVHBin bins[BVH_NUM_BINS];
+		for (uint32_t b = 0; b < BVH_NUM_BINS; ++b)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				bins[b].boundsMin[k] = FLT_MAX;
+				bins[b].boundsMax[k] = -FLT_MAX;
+			}
+			bins[b].count = 0;
+		}
+
+		float binScale = BVH_NUM_BINS / extent;
+		for (uint32_t i = first; i < first + count; ++i)
+		{
+			uint32_t t = builder->triangles[i];
+			BVHBin* bin = &bins[CentroidBin(builder->centroids[t * 3 + axis], centroidMin[axis], binScale)];
+			GrowBounds(bin->boundsMin, bin->boundsMax, &builder->boundsMin[t * 3], &builder->boundsMax[t * 3]);
+			++bin->count;
+		}
+
+		//Sweep from the left to get the cost of the left side of every plane, then from the right
+		float leftArea[BVH_NUM_BINS - 1];
+		uint32_t leftCount[BVH_NUM_BINS - 1];
+		float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		uint32_t sum = 0;
+		for (uint32_t b = 0; b < BVH_NUM_BINS - 1; ++b)
+		{
+			GrowBounds(boundsMin, boundsMax, bins[b].boundsMin, bins[b].boundsMax);
+			sum = sum + bins[b].count;
+			leftCount[b] = sum;
+			leftArea[b] = (sum > 0) ? HalfSurfaceArea(boundsMin, boundsMax) : 0.0f;
+		}
+
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			boundsMin[k] = FLT_MAX;
+			boundsMax[k] = -FLT_MAX;
+		}
+		sum = 0;
+		for (uint32_t b = BVH_NUM_BINS - 1; b > 0; --b)
+		{
+			GrowBounds(boundsMin, boundsMax, bins[b].boundsMin, bins[b].boundsMax);
+			sum = sum + bins[b].count;
+			if (leftCount[b - 1] == 0 || sum == 0)
+				continue;
+
+			float cost = leftCount[b - 1] * leftArea[b - 1] + sum * HalfSurfaceArea(boundsMin, boundsMax);
+			if (cost < bestCost)
+			{
+				bestAxis = (int32_t)axis;
+				bestBin = b - 1;
+				bestCost = cost;
+			}
+		}
+	}
+
+	uint32_t split = first + count / 2;
+	if (bestAxis != -1)
+	{
+		float binScale = BVH_NUM_BINS / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+		uint32_t i = first;
+		uint32_t j = first + count;
+		while (i < j)
+		{
+			uint32_t t = builder->triangles[i];
+			if (CentroidBin(builder->centroids[t * 3 + bestAxis], centroidMin[bestAxis], binScale) <= bestBin)
+			{
+				++i;
+			}
+			else
+			{
+				--j;
+				builder->triangles[i] = builder->triangles[j];
+				builder->triangles[j] = t;
+			}
+		}
+		split = i;
+	}
+
+	uint32_t left = *nextNode;
+	*nextNode = *nextNode + 2;
+
+	builder->nodes[left].leftFirst = first;
+	builder->nodes[left].count = split - first;
+	builder->nodes[left + 1].leftFirst = split;
+	builder->nodes[left + 1].count = first + count - split;
+	UpdateNodeBounds(builder, &builder->nodes[left]);
+	UpdateNodeBounds(builder, &builder->nodes[left + 1]);
+
+	node = &builder->nodes[nodeIndex];
+	node->leftFirst = left;
+	node->count = 0;
+
+	return true;
+}
+
+//Builds the subtree below the node depth first. Nodes with at most deferCount triangles are added to the stb_ds array
+//tasks instead of being split, deferCount 0 builds the whole subtree.
+void BuildSubtree(BVHBuilder* builder, uint32_t root, uint32_t rootDepth, uint32_t* nextNode, uint32_t deferCount, BVHBuildTask** tasks)
+{
+	//Every node on the stack is a leaf of the partial tree, there are at most as many as triangles
+	uint32_t maxStackSize = builder->nodes[root].count + 1;
+	uint32_t* stack = (uint32_t*)malloc(maxStackSize * 2 * sizeof(uint32_t));
+	uint32_t stackSize = 1;
+	stack[0] = root;
+	stack[1] = rootDepth;
+
+	while (stackSize > 0)
+	{
+		--stackSize;
+		uint32_t node = stack[stackSize * 2];
+		uint32_t depth = stack[stackSize * 2 + 1];
+
+		if (deferCount > 0 && builder->nodes[node].count <= deferCount)
+		{
+			BVHBuildTask task{ node, depth, 0, 0 };
+			arrpush(*tasks, task);
+			continue;
+		}
+
+		if (!SplitNode(builder, node, depth, nextNode))
+			continue;
+
+		uint32_t left = builder->nodes[node].leftFirst;
+		stack[stackSize * 2] = left + 1;
+		stack[stackSize * 2 + 1] = depth + 1;
+		stack[stackSize * 2 + 2] = left;
+		stack[stackSize * 2 + 3] = depth + 1;
+		stackSize = stackSize + 2;
+	}
+
+	free(stack);
+}
+
+struct BVHBuildTasks
+{
+	BVHBuilder* builder;
+	BVHBuildTask* tasks;
+};
+
+void BuildSubtreesRange(void* data, uint32_t begin, uint32_t end)
+{
+	BVHBuildTasks* buildTasks = (BVHBuildTasks*)data;
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		BVHBuildTask* task = &buildTasks->tasks[i];
+		uint32_t nextNode = task->base;
+		BuildSubtree(buildTasks->builder, task->node, task->depth, &nextNode, 0, nullptr);
+		task->end = nextNode;
+	}
+}
+
+void BuildBVH(const Vertex* vertices, const uint32_t* indices, uint32_t numTriangles, BVH* outBVH)
+{
+	BVHBuilder builder{};
+
+	//The tree has at most 2 * numTriangles nodes, the subtrees get as many again for their own worst case before they are compacted
+	uint32_t maxNodes = numTriangles * 4 + 2;
+	builder.nodes = (BVHNode*)malloc(maxNodes * sizeof(BVHNode));
+	builder.triangles = (uint32_t*)malloc(((numTriangles > 0) ? numTriangles : 1) * sizeof(uint32_t));
+	builder.centroids = (float*)malloc(((numTriangles > 0) ? numTriangles : 1) * 3 * sizeof(float));
+	builder.boundsMin = (float*)malloc(((numTriangles > 0) ? numTriangles : 1) * 3 * sizeof(float));
+	builder.boundsMax = (float*)malloc(((numTriangles > 0) ? numTriangles : 1) * 3 * sizeof(float));
+
+	for (uint32_t t = 0; t < numTriangles; ++t)
+	{
+		builder.triangles[t] = t;
+
+		const vec4* p[3] = { &vertices[indices[t * 3]].position, &vertices[indices[t * 3 + 1]].position, &vertices[indices[t * 3 + 2]].position };
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			float position[3] = { p[j]->GetX(), p[j]->GetY(), p[j]->GetZ() };
+			if (j == 0)
+			{
+				memcpy(&builder.boundsMin[t * 3], position, sizeof(position));
+				memcpy(&builder.boundsMax[t * 3], position, sizeof(position));
+			}
+			else
+			{
+				GrowBounds(&builder.boundsMin[t * 3], &builder.boundsMax[t * 3], position, position);
+			}
+		}
+
+		for (uint32_t k = 0; k < 3; ++k)
+			builder.centroids[t * 3 + k] = (builder.boundsMin[t * 3 + k] + builder.boundsMax[t * 3 + k]) * 0.5f;
+	}
+
+	builder.nodes[0].leftFirst = 0;
+	builder.nodes[0].count = numTriangles;
+	UpdateNodeBounds(&builder, &builder.nodes[0]);
+	memset(&builder.nodes[1], 0, sizeof(BVHNode));
+
+	uint32_t nextNode = 2;
+	if (numTriangles < BVH_PARALLEL_MIN_TRIANGLES)
+	{
+		BuildSubtree(&builder, 0, 0, &nextNode, 0, nullptr);
+	}
+	else
+	{
+		//Build the top of the tree until the subtrees are small enough to give every core a few of them
+		BVHBuildTask* tasks = nullptr;
+		uint32_t deferCount = numTriangles / (GetNumLogicalCores() * 4);
+		BuildSubtree(&builder, 0, 0, &nextNode, deferCount, &tasks);
+
+		uint32_t numTasks = (uint32_t)arrlenu(tasks);
+		uint32_t base = nextNode;
+		for (uint32_t i = 0; i < numTasks; ++i)
+		{
+			tasks[i].base = base;
+			base = base + builder.nodes[tasks[i].node].count * 2;
+		}
+
+		BVHBuildTasks buildTasks{ &builder, tasks };
+		ParallelFor(numTasks, 1, BuildSubtreesRange, &buildTasks);
+
+		//Move the subtrees next to each other
+		for (uint32_t i = 0; i < numTasks; ++i)
+		{
+			const BVHBuildTask* task = &tasks[i];
+			uint32_t numNodes = task->end - task->base;
+			uint32_t offset = task->base - nextNode;
+
+			memmove(&builder.nodes[nextNode], &builder.nodes[task->base], numNodes * sizeof(BVHNode));
+			for (uint32_t n = nextNode; n < nextNode + numNodes; ++n)
+			{
+				if (builder.nodes[n].count == 0)
+					builder.nodes[n].leftFirst -= offset;
+			}
+
+			if (builder.nodes[task->node].count == 0)
+				builder.nodes[task->node].leftFirst -= offset;
+
+			nextNode = nextNode + numNodes;
+		}
+
+		arrfree(tasks);
+	}
+
+	//Copy the triangles of every leaf into its packet
+	outBVH->numNodes = nextNode;
+	outBVH->nodes = (BVHNode*)realloc(builder.nodes, nextNode * sizeof(BVHNode));
+	outBVH->numPackets = 0;
+	for (uint32_t n = 0; n < nextNode; ++n)
+	{
+		if (outBVH->nodes[n].count > 0)
+			++outBVH->numPackets;
+	}
+
+	outBVH->packets = (BVHTrianglePacket*)malloc(((outBVH->numPackets > 0) ? outBVH->numPackets : 1) * sizeof(BVHTrianglePacket));
+	uint32_t packetIndex = 0;
+	for (uint32_t n = 0; n < nextNode; ++n)
+	{
+		BVHNode* node = &outBVH->nodes[n];
+		if (node->count == 0)
+			continue;
+
+		BVHTrianglePacket* packet = &outBVH->packets[packetIndex];
+		memset(packet, 0, sizeof(BVHTrianglePacket));
+		for (uint32_t lane = 0; lane < 4; ++lane)
+		{
+			if (lane >= node->count)
+			{
+				packet->triangles[lane] = BVH_INVALID_TRIANGLE;
+				continue;
+			}
+
+			uint32_t t = builder.triangles[node->leftFirst + lane];
+			vec4 p0 = vertices[indices[t * 3]].position;
+			vec4 e0 = vertices[indices[t * 3 + 1]].position - p0;
+			vec4 e1 = vertices[indices[t * 3 + 2]].position - p0;
+
+			packet->v0[0][lane] = p0.GetX();
+			packet->v0[1][lane] = p0.GetY();
+			packet->v0[2][lane] = p0.GetZ();
+			packet->e0[0][lane] = e0.GetX();
+			packet->e0[1][lane] = e0.GetY();
+			packet->e0[2][lane] = e0.GetZ();
+			packet->e1[0][lane] = e1.GetX();
+			packet->e1[1][lane] = e1.GetY();
+			packet->e1[2][lane] = e1.GetZ();
+			packet->triangles[lane] = t;
+		}
+
+		node->leftFirst = packetIndex;
+		++packetIndex;
+	}
+
+	free(builder.triangles);
+	free(builder.centroids);
+	free(builder.boundsMin);
+	free(builder.boundsMax);
+}
+
+void DestroyBVH(BVH* bvh)
+{
+	free(bvh->nodes);
+	free(bvh->packets);
+	bvh->nodes = nullptr;
+	bvh->packets = nullptr;
+	bvh->numNodes = 0;
+	bvh->numPackets = 0;
+}
+
+struct BVHRay
+{
+	//Broadcast origin, direction and inverse direction
+	__m128 origin[3];
+	__m128 direction[3];
+	__m128 invDirection[3];
+};
+
+void SetupRay(vec3 origin, vec3 direction, BVHRay* outRay)
+{
+	float o[3] = { origin.GetX(), origin.GetY(), origin.GetZ() };
+	float d[3] = { direction.GetX(), direction.GetY(), direction.GetZ() };
+	for (uint32_t k = 0; k < 3; ++k)
+	{
+		//Keeps 0 * inf out of the slab test
+		float invD = (fabsf(d[k]) > 1e-20f) ? 1.0f / d[k] : ((d[k] < 0.0f) ? -1e20f : 1e20f);
+
+		outRay->origin[k] = _mm_set_ps1(o[k]);
+		outRay->direction[k] = _mm_set_ps1(d[k]);
+		outRay->invDirection[k] = _mm_set_ps1(invD);
+	}
+}
+
+//Slab test of both children of a node at once.
+//The boxes are transposed so x, y and z each hold [leftMin, rightMin, leftMax, rightMax].
+//Returns a 2-bit mask of the children hit with tNear < maxT and their entry distances.
+inline uint32_t IntersectChildren(const BVHNode* children, const BVHRay* ray, float maxT, float* outNear)
+{
+	__m128 x = _mm_load_ps(children[0].boundsMin);
+	__m128 y = _mm_load_ps(children[1].boundsMin);
+	__m128 z = _mm_load_ps(children[0].boundsMax);
+	__m128 w = _mm_load_ps(children[1].boundsMax);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+
+	__m128 tx = _mm_mul_ps(_mm_sub_ps(x, ray->origin[0]), ray->invDirection[0]);
+	__m128 ty = _mm_mul_ps(_mm_sub_ps(y, ray->origin[1]), ray->invDirection[1]);
+	__m128 tz = _mm_mul_ps(_mm_sub_ps(z, ray->origin[2]), ray->invDirection[2]);
+
+	//Swap the min and max halves to pair every plane of a box with its opposite
+	__m128 sx = _mm_shuffle_ps(tx, tx, _MM_SHUFFLE(1, 0, 3, 2));
+	__m128 sy = _mm_shuffle_ps(ty, ty, _MM_SHUFFLE(1, 0, 3, 2));
+	__m128 sz = _mm_shuffle_ps(tz, tz, _MM_SHUFFLE(1, 0, 3, 2));
+
+	__m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx, sx), _mm_min_ps(ty, sy)), _mm_max_ps(_mm_min_ps(tz, sz), _mm_setzero_ps()));
+	__m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx, sx), _mm_max_ps(ty, sy)), _mm_min_ps(_mm_max_ps(tz, sz), _mm_set_ps1(maxT)));
+
+	_mm_storeu_ps(outNear, tNear);
+
+	return (uint32_t)_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) & 3;
+}
+
+//Moller-Trumbore test of the 4 triangles of a packet. Returns the mask of the lanes hit with 0 < t < maxT.
+inline uint32_t IntersectPacket(const BVHTrianglePacket* packet, const BVHRay* ray, float maxT, __m128* outT, __m128* outU, __m128* outV)
+{
+	__m128 e0x = _mm_load_ps(packet->e0[0]);
+	__m128 e0y = _mm_load_ps(packet->e0[1]);
+	__m128 e0z = _mm_load_ps(packet->e0[2]);
+	__m128 e1x = _mm_load_ps(packet->e1[0]);
+	__m128 e1y = _mm_load_ps(packet->e1[1]);
+	__m128 e1z = _mm_load_ps(packet->e1[2]);
+
+	//p = d x e1
+	__m128 px = _mm_sub_ps(_mm_mul_ps(ray->direction[1], e1z), _mm_mul_ps(ray->direction[2], e1y));
+	__m128 py = _mm_sub_ps(_mm_mul_ps(ray->direction[2], e1x), _mm_mul_ps(ray->direction[0], e1z));
+	__m128 pz = _mm_sub_ps(_mm_mul_ps(ray->direction[0], e1y), _mm_mul_ps(ray->direction[1], e1x));
+
+	__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e0x, px), _mm_mul_ps(e0y, py)), _mm_mul_ps(e0z, pz));
+	__m128 invDet = _mm_div_ps(_mm_set_ps1(1.0f), det);
+
+	//s = o - v0
+	__m128 sx = _mm_sub_ps(ray->origin[0], _mm_load_ps(packet->v0[0]));
+	__m128 sy = _mm_sub_ps(ray->origin[1], _mm_load_ps(packet->v0[1]));
+	__m128 sz = _mm_sub_ps(ray->origin[2], _mm_load_ps(packet->v0[2]));
+
+	__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+	//q = s x e0
+	__m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e0z), _mm_mul_ps(sz, e0y));
+	__m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e0x), _mm_mul_ps(sx, e0z));
+	__m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e0y), _mm_mul_ps(sy, e0x));
+
+	__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ray->direction[0], qx), _mm_mul_ps(ray->direction[1], qy)), _mm_mul_ps(ray->direction[2], qz)), invDet);
+	__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, qx), _mm_mul_ps(e1y, qy)), _mm_mul_ps(e1z, qz)), invDet);
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 hit = _mm_cmpneq_ps(det, zero);
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+	hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set_ps1(1.0f)));
+	hit = _mm_and_ps(hit, _mm_cmpgt_ps(t, zero));
+	hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_set_ps1(maxT)));
+
+	*outT = t;
+	*outU = u;
+	*outV = v;
+
+	return (uint32_t)_mm_movemask_ps(hit);
+}
+
+//Traverses the tree front to back. Stops at the first hit if anyHit is true.
+bool TraverseBVH(const BVH* bvh, vec3 origin, vec3 direction, float maxT, bool anyHit, RayHit* outHit)
+{
+	//A root without children and triangles is an empty tree
+	if (bvh->numNodes == 0 || (bvh->numNodes == 2 && bvh->nodes[0].count == 0))
+		return false;
+
+	BVHRay ray;
+	SetupRay(origin, direction, &ray);
+
+	RayHit hit{ maxT, 0.0f, 0.0f, BVH_INVALID_TRIANGLE };
+
+	//Far children and their entry distances
+	uint32_t stack[BVH_STACK_SIZE];
+	float stackNear[BVH_STACK_SIZE];
+	uint32_t stackSize = 0;
+
+	//The root is tested as the left child of the pair [0, 1], node 1 is empty and never hit
+	float tNear[4];
+	uint32_t node = 0;
+	if ((IntersectChildren(&bvh->nodes[0], &ray, maxT, tNear) & 1) == 0)
+		return false;
+
+	while (true)
+	{
+		const BVHNode* current = &bvh->nodes[node];
+		if (current->count > 0)
+		{
+			__m128 t, u, v;
+			uint32_t mask = IntersectPacket(&bvh->packets[current->leftFirst], &ray, hit.t, &t, &u, &v);
+			if (mask != 0)
+			{
+				float laneT[4], laneU[4], laneV[4];
+				_mm_storeu_ps(laneT, t);
+				_mm_storeu_ps(laneU, u);
+				_mm_storeu_ps(laneV, v);
+				for (uint32_t lane = 0; lane < 4; ++lane)
+				{
+					if ((mask & (1 << lane)) != 0 && laneT[lane] < hit.t)
+					{
+						hit.t = laneT[lane];
+						hit.u = laneU[lane];
+						hit.v = laneV[lane];
+						hit.triangle = bvh->packets[current->leftFirst].triangles[lane];
+					}
+				}
+
+				if (anyHit)
+					break;
+			}
+		}
+		else
+		{
+			uint32_t mask = IntersectChildren(&bvh->nodes[current->leftFirst], &ray, hit.t, tNear);
+			if (mask == 3)
+			{
+				//Visit the nearer child first
+				uint32_t nearChild = (tNear[1] < tNear[0]) ? 1 : 0;
+				stack[stackSize] = current->leftFirst + (1 - nearChild);
+				stackNear[stackSize] = tNear[1 - nearChild];
+				++stackSize;
+				node = current->leftFirst + nearChild;
+				continue;
+			}
+
+			if (mask != 0)
+			{
+				node = current->leftFirst + ((mask == 2) ? 1 : 0);
+				continue;
+			}
+		}
+
+		//Skip the children that are behind the closest hit found after they were pushed
+		while (stackSize > 0 && stackNear[stackSize - 1] > hit.t)
+			--stackSize;
+
+		if (stackSize == 0)
+			break;
+
+		--stackSize;
+		node = stack[stackSize];
+	}
+
+	if (outHit != nullptr)
+		*outHit = hit;
+
+	return hit.triangle != BVH_INVALID_TRIANGLE;
+}
+
+bool IntersectBVH(const BVH* bvh, vec3 origin, vec3 direction, float maxT, RayHit* outHit)
+{
+	return TraverseBVH(bvh, origin, direction, maxT, false, outHit);
+}
+
+bool OccludedBVH(const BVH* bvh, vec3 origin, vec3 direction, float maxT)
+{
+	return TraverseBVH(bvh, origin, direction, maxT, true, nullptr);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMesh.h"
+
+#define BVH_MAX_LEAF_TRIANGLES 4
+#define BVH_NUM_BINS 16
+#define BVH_INVALID_TRIANGLE 0xFFFFFFFF
+
+//32 bytes, two nodes per cache line.
+//Interior nodes (count == 0) have their children at leftFirst and leftFirst + 1, the children of a node are always side by side
+//and start at an even index, so both boxes are fetched and tested together.
+//Leaves have count triangles in the packet leftFirst.
+struct BVHNode
+{
+	float boundsMin[3];
+	uint32_t leftFirst;
+	float boundsMax[3];
+	uint32_t count;
+};
+
+//The triangles of a leaf in SoA layout for the 4-wide intersection test.
+//v0 is the first vertex and e0, e1 the edges to the other two, [axis][lane]. Unused lanes are degenerate and never hit.
+struct alignas(16) BVHTrianglePacket
+{
+	float v0[3][4];
+	float e0[3][4];
+	float e1[3][4];
+	uint32_t triangles[4];
+};
+
+//Node 0 is the root and node 1 is unused, so every pair of children is aligned.
+struct BVH
+{
+	BVHNode* nodes;
+	uint32_t numNodes;
+
+	BVHTrianglePacket* packets;
+	uint32_t numPackets;
+};
+
+struct RayHit
+{
+	//Distance along the ray in units of the length of the direction
+	float t;
+
+	//Barycentric coordinates of the hit, the position is (1 - u - v) * p0 + u * p1 + v * p2
+	float u;
+	float v;
+
+	//Index of the triangle in the index list the BVH was built from, BVH_INVALID_TRIANGLE on a miss
+	uint32_t triangle;
+};
+
+//Builds a BVH over the triangle list with a binned SAH.
+//The top of the tree is built on the calling thread, the subtrees below it in parallel.
+//The BVH copies the triangles, it doesn't reference vertices or indices afterwards.
+void BuildBVH(const Vertex* vertices, const uint32_t* indices, uint32_t numTriangles, BVH* outBVH);
+
+void DestroyBVH(BVH* bvh);
+
+//Finds the closest triangle the ray hits with 0 < t < maxT. Both sides of a triangle are hit.
+//Returns false on a miss.
+bool IntersectBVH(const BVH* bvh, vec3 origin, vec3 direction, float maxT, RayHit* outHit);
+
+//Returns true if the ray hits any triangle with 0 < t < maxT. Stops at the first hit, for shadow rays.
+bool OccludedBVH(const BVH* bvh, vec3 origin, vec3 direction, float maxT);
@@ -0,0 +1,220 @@
+#include <immintrin.h>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "SEBounds.h"
+
+//position is 16-byte aligned with x, y, z, w first in both math libraries
+inline __m128 LoadPosition(const Vertex* vertex)
+{
+	return _mm_load_ps((const float*)&vertex->position);
+}
+
+//Squared length of the xyz part
+inline float LengthSquared3(__m128 v)
+{
+	float f[4];
+	_mm_storeu_ps(f, _mm_mul_ps(v, v));
+
+	return f[0] + f[1] + f[2];
+}
+
+void ComputeMeshBounds(const Vertex* vertices, uint32_t numVertices, MeshBounds* outBounds)
+{
+	memset(outBounds, 0, sizeof(MeshBounds));
+	if (numVertices == 0)
+		return;
+
+	//Two accumulators to break the dependency chain
+	__m128 boundsMin[2] = { _mm_set_ps1(FLT_MAX), _mm_set_ps1(FLT_MAX) };
+	__m128 boundsMax[2] = { _mm_set_ps1(-FLT_MAX), _mm_set_ps1(-FLT_MAX) };
+	uint32_t i = 0;
+	for (; i + 1 < numVertices; i += 2)
+	{
+		__m128 p0 = LoadPosition(&vertices[i]);
+		__m128 p1 = LoadPosition(&vertices[i + 1]);
+		boundsMin[0] = _mm_min_ps(boundsMin[0], p0);
+		boundsMax[0] = _mm_max_ps(boundsMax[0], p0);
+		boundsMin[1] = _mm_min_ps(boundsMin[1], p1);
+		boundsMax[1] = _mm_max_ps(boundsMax[1], p1);
+	}
+
+	if (i < numVertices)
+	{
+		__m128 p = LoadPosition(&vertices[i]);
+		boundsMin[0] = _mm_min_ps(boundsMin[0], p);
+		boundsMax[0] = _mm_max_ps(boundsMax[0], p);
+	}
+
+	__m128 vMin = _mm_min_ps(boundsMin[0], boundsMin[1]);
+	__m128 vMax = _mm_max_ps(boundsMax[0], boundsMax[1]);
+
+	float f[4];
+	_mm_storeu_ps(f, vMin);
+	memcpy(outBounds->boundsMin, f, 3 * sizeof(float));
+	_mm_storeu_ps(f, vMax);
+	memcpy(outBounds->boundsMax, f, 3 * sizeof(float));
+
+	//Sphere around the center of the box
+	__m128 boxCenter = _mm_mul_ps(_mm_add_ps(vMin, vMax), _mm_set_ps1(0.5f));
+	float boxRadiusSq = 0.0f;
+	for (uint32_t j = 0; j < numVertices; ++j)
+	{
+		float distanceSq = LengthSquared3(_mm_sub_ps(LoadPosition(&vertices[j]), boxCenter));
+		boxRadiusSq = (distanceSq > boxRadiusSq) ? distanceSq : boxRadiusSq;
+	}
+
+	//Ritter's sphere. Starts with the sphere through a far apart pair of points and grows it to contain the rest.
+	__m128 x = LoadPosition(&vertices[0]);
+	__m128 y = x;
+	float maxDistanceSq = 0.0f;
+	for (uint32_t j = 0; j < numVertices; ++j)
+	{
+		__m128 p = LoadPosition(&vertices[j]);
+		float distanceSq = LengthSquared3(_mm_sub_ps(p, x));
+		if (distanceSq > maxDistanceSq)
+		{
+			y = p;
+			maxDistanceSq = distanceSq;
+		}
+	}
+
+	__m128 z = y;
+	maxDistanceSq = 0.0f;
+	for (uint32_t j = 0; j < numVertices; ++j)
+	{
+		__m128 p = LoadPosition(&vertices[j]);
+		float distanceSq = LengthSquared3(_mm_sub_ps(p, y));
+		if (distanceSq > maxDistanceSq)
+		{
+			z = p;
+			maxDistanceSq = distanceSq;
+		}
+	}
+
+	__m128 center = _mm_mul_ps(_mm_add_ps(y, z), _mm_set_ps1(0.5f));
+	float radius = sqrtf(maxDistanceSq) * 0.5f;
+	for (uint32_t j = 0; j < numVertices; ++j)
+	{
+		__m128 offset = _mm_sub_ps(LoadPosition(&vertices[j]), center);
+		float distanceSq = LengthSquared3(offset);
+		if (distanceSq > radius * radius)
+		{
+			//Move the center towards the point so the new sphere touches both it and the far side of the old sphere
+			float distance = sqrtf(distanceSq);
+			float newRadius = (radius + distance) * 0.5f;
+			center = _mm_add_ps(center, _mm_mul_ps(offset, _mm_set_ps1((distance - newRadius) / distance)));
+			radius = newRadius;
+		}
+	}
+
+	//Rounding in the growth steps can leave points just outside, so the radius is measured again
+	float ritterRadiusSq = 0.0f;
+	for (uint32_t j = 0; j < numVertices; ++j)
+	{
+		float distanceSq = LengthSquared3(_mm_sub_ps(LoadPosition(&vertices[j]), center));
+		ritterRadiusSq = (distanceSq > ritterRadiusSq) ? distanceSq : ritterRadiusSq;
+	}
+	radius = sqrtf(ritterRadiusSq);
+
+	if (boxRadiusSq < ritterRadiusSq)
+	{
+		center = boxCenter;
+		radius = sqrtf(boxRadiusSq);
+	}
+
+	_mm_storeu_ps(f, center);
+	memcpy(outBounds->center, f, 3 * sizeof(float));
+	outBounds->radius = radius;
+}
+
+void TransformMeshBounds(const MeshBounds* bounds, const mat4* model, MeshBounds* outBounds)
+{
+	//p' = p.x * row0 + p.y * row1 + p.z * row2 + row3
+	vec4 rowVectors[4] = { model->GetRow(0), model->GetRow(1), model->GetRow(2), model->GetRow(3) };
+	__m128 rows[4];
+	for (uint32_t i = 0; i < 4; ++i)
+		rows[i] = _mm_load_ps((const float*)&rowVectors[i]);
+
+	//Every row adds the smaller and the larger of its products with the min and max of its axis
+	__m128 boundsMin = rows[3];
+	__m128 boundsMax = rows[3];
+	__m128 center = rows[3];
+	float maxScaleSq = 0.0f;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		__m128 a = _mm_mul_ps(rows[i], _mm_set_ps1(bounds->boundsMin[i]));
+		__m128 b = _mm_mul_ps(rows[i], _mm_set_ps1(bounds->boundsMax[i]));
+		boundsMin = _mm_add_ps(boundsMin, _mm_min_ps(a, b));
+		boundsMax = _mm_add_ps(boundsMax, _mm_max_ps(a, b));
+		center = _mm_add_ps(center, _mm_mul_ps(rows[i], _mm_set_ps1(bounds->center[i])));
+
+		float scaleSq = LengthSquared3(rows[i]);
+		maxScaleSq = (scaleSq > maxScaleSq) ? scaleSq : maxScaleSq;
+	}
+
+	float f[4];
+	_mm_storeu_ps(f, boundsMin);
+	memcpy(outBounds->boundsMin, f, 3 * sizeof(float));
+	_mm_storeu_ps(f, boundsMax);
+	memcpy(outBounds->boundsMax, f, 3 * sizeof(float));
+	_mm_storeu_ps(f, center);
+	memcpy(outBounds->center, f, 3 * sizeof(float));
+	outBounds->radius = bounds->radius * sqrtf(maxScaleSq);
+}
+
+inline bool IsEmptyMeshBounds(const MeshBounds* bounds)
+{
+	const MeshBounds empty{};
+
+	return memcmp(bounds, &empty, sizeof(MeshBounds)) == 0;
+}
+
+void MergeMeshBounds(const MeshBounds* a, const MeshBounds* b, MeshBounds* outBounds)
+{
+	if (IsEmptyMeshBounds(b) == true)
+	{
+		*outBounds = *a;
+		return;
+	}
+
+	if (IsEmptyMeshBounds(a) == true)
+	{
+		*outBounds = *b;
+		return;
+	}
+
+	MeshBounds result{};
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		result.boundsMin[i] = (a->boundsMin[i] < b->boundsMin[i]) ? a->boundsMin[i] : b->boundsMin[i];
+		result.boundsMax[i] = (a->boundsMax[i] > b->boundsMax[i]) ? a->boundsMax[i] : b->boundsMax[i];
+	}
+
+	float offset[3] = { b->center[0] - a->center[0], b->center[1] - a->center[1], b->center[2] - a->center[2] };
+	float distance = sqrtf(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+	if (distance + b->radius <= a->radius)
+	{
+		memcpy(result.center, a->center, 3 * sizeof(float));
+		result.radius = a->radius;
+	}
+	else if (distance + a->radius <= b->radius)
+	{
+		memcpy(result.center, b->center, 3 * sizeof(float));
+		result.radius = b->radius;
+	}
+	else
+	{
+		//The new sphere touches the far sides of both spheres
+		result.radius = (distance + a->radius + b->radius) * 0.5f;
+		float t = (result.radius - a->radius) / distance;
+
+		//Rounding can leave the far sides just outside
+		result.radius *= 1.0f + 4.0f * FLT_EPSILON;
+		for (uint32_t i = 0; i < 3; ++i)
+			result.center[i] = a->center[i] + offset[i] * t;
+	}
+
+	*outBounds = result;
+}
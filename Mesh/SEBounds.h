@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMesh.h"
+
+struct MeshBounds
+{
+	//Axis-aligned bounding box
+	float boundsMin[3];
+	float boundsMax[3];
+
+	//Bounding sphere
+	float center[3];
+	float radius;
+};
+
+//Computes the bounding box and sphere of the vertex positions, all zero if there are no vertices.
+//The box is a 4-wide SSE min/max reduction. The sphere is the smaller of Ritter's sphere and the sphere around the center of the box.
+void ComputeMeshBounds(const Vertex* vertices, uint32_t numVertices, MeshBounds* outBounds);
+
+//Transforms the bounds by a model matrix, for example Shape::model.
+//The box is the box around the transformed box (Arvo's method), the sphere is scaled by the largest axis scale of the matrix.
+void TransformMeshBounds(const MeshBounds* bounds, const mat4* model, MeshBounds* outBounds);
+
+//Stores the bounds of both a and b in outBounds, which can be a or b.
+//The box is the union of the boxes, the sphere is the smallest sphere around both spheres.
+//Bounds with a zero box and radius, like the bounds of no vertices, are treated as empty.
+void MergeMeshBounds(const MeshBounds* a, const MeshBounds* b, MeshBounds* outBounds);
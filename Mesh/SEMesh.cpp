@@ -1,4 +1,12 @@
+#include <immintrin.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
 #include "SEMesh.h"
+#include "SEMeshKernels.h"
+#include "../Math/SECPUFeatures.h"
+#include "../Thread/SEThread.h"
 
 void CreateTriangle(Triangle* triangle, const Vertex* pVertices, uint32_t i0, uint32_t i1, uint32_t i2)
 {
@@ -66,4 +74,550 @@ vec4 ComputeTangent(const Triangle* const triangle)
 	float tz = f * (v1 * e0z - v0 * e1z);
 
 	return vec4(tx, ty, tz, 0.0f);
+}
+
+//Computes the frames of 4 triangles. corners[k][j] is the jth vertex of the kth triangle.
+//position is 16-byte aligned with x, y, z, w first and texCoords starts with u, v in both math libraries.
+void ComputeTriangleFrames4(const Vertex* const corners[4][3], vec4* outNormals, vec4* outTangents)
+{
+	//p[j] = SoA position of the jth vertex of the 4 triangles
+	__m128 p[3][4];
+	for (uint32_t j = 0; j < 3; ++j)
+	{
+		p[j][0] = _mm_load_ps((const float*)&corners[0][j]->position);
+		p[j][1] = _mm_load_ps((const float*)&corners[1][j]->position);
+		p[j][2] = _mm_load_ps((const float*)&corners[2][j]->position);
+		p[j][3] = _mm_load_ps((const float*)&corners[3][j]->position);
+		_MM_TRANSPOSE4_PS(p[j][0], p[j][1], p[j][2], p[j][3]);
+	}
+
+	//e0 = p1 - p0
+	//e1 = p2 - p0
+	__m128 e0x = _mm_sub_ps(p[1][0], p[0][0]);
+	__m128 e0y = _mm_sub_ps(p[1][1], p[0][1]);
+	__m128 e0z = _mm_sub_ps(p[1][2], p[0][2]);
+	__m128 e1x = _mm_sub_ps(p[2][0], p[0][0]);
+	__m128 e1y = _mm_sub_ps(p[2][1], p[0][1]);
+	__m128 e1z = _mm_sub_ps(p[2][2], p[0][2]);
+
+	__m128 zero = _mm_setzero_ps();
+
+	if (outNormals != nullptr)
+	{
+		//n = normalize(e0 x e1)
+		__m128 nx = _mm_sub_ps(_mm_mul_ps(e0y, e1z), _mm_mul_ps(e0z, e1y));
+		__m128 ny = _mm_sub_ps(_mm_mul_ps(e0z, e1x), _mm_mul_ps(e0x, e1z));
+		__m128 nz = _mm_sub_ps(_mm_mul_ps(e0x, e1y), _mm_mul_ps(e0y, e1x));
+
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+		__m128 valid = _mm_cmpgt_ps(length, zero);
+		__m128 invLength = _mm_and_ps(_mm_div_ps(_mm_set_ps1(1.0f), length), valid);
+
+		nx = _mm_mul_ps(nx, invLength);
+		ny = _mm_mul_ps(ny, invLength);
+		nz = _mm_mul_ps(nz, invLength);
+		__m128 nw = zero;
+
+		_MM_TRANSPOSE4_PS(nx, ny, nz, nw);
+		_mm_store_ps((float*)&outNormals[0], nx);
+		_mm_store_ps((float*)&outNormals[1], ny);
+		_mm_store_ps((float*)&outNormals[2], nz);
+		_mm_store_ps((float*)&outNormals[3], nw);
+	}
+
+	if (outTangents != nullptr)
+	{
+		//t[j] = SoA texture coordinates of the jth vertex of the 4 triangles
+		__m128 tu[3];
+		__m128 tv[3];
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			const float* t0 = (const float*)&corners[0][j]->texCoords;
+			const float* t1 = (const float*)&corners[1][j]->texCoords;
+			const float* t2 = (const float*)&corners[2][j]->texCoords;
+			const float* t3 = (const float*)&corners[3][j]->texCoords;
+			tu[j] = _mm_setr_ps(t0[0], t1[0], t2[0], t3[0]);
+			tv[j] = _mm_setr_ps(t0[1], t1[1], t2[1], t3[1]);
+		}
+
+		__m128 u0 = _mm_sub_ps(tu[1], tu[0]);
+		__m128 u1 = _mm_sub_ps(tu[2], tu[0]);
+		__m128 v0 = _mm_sub_ps(tv[1], tv[0]);
+		__m128 v1 = _mm_sub_ps(tv[2], tv[0]);
+
+		//f = 1 / (u0 * v1 - u1 * v0), 0 if the uv triangle is degenerate
+		__m128 f = _mm_sub_ps(_mm_mul_ps(u0, v1), _mm_mul_ps(u1, v0));
+		__m128 valid = _mm_cmpneq_ps(f, zero);
+		f = _mm_and_ps(_mm_div_ps(_mm_set_ps1(1.0f), f), valid);
+
+		//t = f * (v1 * e0 - v0 * e1)
+		__m128 tx = _mm_mul_ps(f, _mm_sub_ps(_mm_mul_ps(v1, e0x), _mm_mul_ps(v0, e1x)));
+		__m128 ty = _mm_mul_ps(f, _mm_sub_ps(_mm_mul_ps(v1, e0y), _mm_mul_ps(v0, e1y)));
+		__m128 tz = _mm_mul_ps(f, _mm_sub_ps(_mm_mul_ps(v1, e0z), _mm_mul_ps(v0, e1z)));
+		__m128 tw = zero;
+
+		_MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+		_mm_store_ps((float*)&outTangents[0], tx);
+		_mm_store_ps((float*)&outTangents[1], ty);
+		_mm_store_ps((float*)&outTangents[2], tz);
+		_mm_store_ps((float*)&outTangents[3], tw);
+	}
+}
+
+//The triangles of a batch call, either an index list or a Triangle list
+struct TriangleSource
+{
+	const Vertex* vertices;
+	const uint32_t* indices;
+	const Triangle* triangles;
+};
+
+inline void GetTriangleIndices(const TriangleSource* source, uint32_t i, uint32_t* outIndices)
+{
+	if (source->triangles != nullptr)
+	{
+		outIndices[0] = source->triangles[i].i0;
+		outIndices[1] = source->triangles[i].i1;
+		outIndices[2] = source->triangles[i].i2;
+	}
+	else
+	{
+		outIndices[0] = source->indices[i * 3];
+		outIndices[1] = source->indices[i * 3 + 1];
+		outIndices[2] = source->indices[i * 3 + 2];
+	}
+}
+
+inline void GetTriangleCorners(const TriangleSource* source, uint32_t i, const Vertex** outCorners)
+{
+	const Vertex* vertices = (source->vertices != nullptr) ? source->vertices : source->triangles[i].vertices;
+
+	uint32_t triangleIndices[3];
+	GetTriangleIndices(source, i, triangleIndices);
+	outCorners[0] = &vertices[triangleIndices[0]];
+	outCorners[1] = &vertices[triangleIndices[1]];
+	outCorners[2] = &vertices[triangleIndices[2]];
+}
+
+//Runs the 8-wide AVX2 kernel over the triangles if the CPU supports it, then the 4-wide kernel over the rest.
+//Both kernels give the same results. The last batch repeats its final triangle and only the valid results are copied out.
+void ComputeTriangleFramesBatched(const TriangleSource* source, uint32_t numTriangles, vec4* outNormals, vec4* outTangents)
+{
+	if (numTriangles == 0 || (outNormals == nullptr && outTangents == nullptr))
+		return;
+
+	uint32_t i = 0;
+	if ((GetCPUFeatures() & CPU_FEATURE_FLAGS_AVX2) != 0)
+	{
+		const float* positions[8][3];
+		const float* texCoords[8][3];
+		for (; i + 8 <= numTriangles; i = i + 8)
+		{
+			for (uint32_t k = 0; k < 8; ++k)
+			{
+				const Vertex* triangleCorners[3];
+				GetTriangleCorners(source, i + k, triangleCorners);
+				for (uint32_t j = 0; j < 3; ++j)
+				{
+					positions[k][j] = (const float*)&triangleCorners[j]->position;
+					texCoords[k][j] = (const float*)&triangleCorners[j]->texCoords;
+				}
+			}
+
+			ComputeTriangleFrames8AVX2(positions, texCoords,
+				(outNormals != nullptr) ? (float*)&outNormals[i] : nullptr,
+				(outTangents != nullptr) ? (float*)&outTangents[i] : nullptr);
+		}
+	}
+
+	const Vertex* corners[4][3];
+	for (; i + 4 <= numTriangles; i = i + 4)
+	{
+		for (uint32_t k = 0; k < 4; ++k)
+			GetTriangleCorners(source, i + k, corners[k]);
+
+		ComputeTriangleFrames4(corners,
+			(outNormals != nullptr) ? &outNormals[i] : nullptr,
+			(outTangents != nullptr) ? &outTangents[i] : nullptr);
+	}
+
+	uint32_t remaining = numTriangles - i;
+	if (remaining > 0)
+	{
+		vec4 normals[4];
+		vec4 tangents[4];
+		for (uint32_t k = 0; k < 4; ++k)
+			GetTriangleCorners(source, i + ((k < remaining) ? k : remaining - 1), corners[k]);
+
+		ComputeTriangleFrames4(corners,
+			(outNormals != nullptr) ? normals : nullptr,
+			(outTangents != nullptr) ? tangents : nullptr);
+
+		for (uint32_t k = 0; k < remaining; ++k)
+		{
+			if (outNormals != nullptr)
+				outNormals[i + k] = normals[k];
+
+			if (outTangents != nullptr)
+				outTangents[i + k] = tangents[k];
+		}
+	}
+}
+
+#define TANGENT_FRAME_MIN_RANGE_SIZE 4096
+
+//Groups the corners of the triangles by vertex with a counting sort, so every vertex can be processed independently.
+//The corners of vertex v are outVertexCorners[outVertexCornerOffsets[v]] to outVertexCorners[outVertexCornerOffsets[v + 1] - 1]
+//in triangle order, corner j of triangle i is i * 3 + j. Free both arrays with free.
+void SortCornersByVertex(const TriangleSource* source, uint32_t numTriangles, uint32_t numVertices,
+	uint32_t** outVertexCornerOffsets, uint32_t** outVertexCorners)
+{
+	uint32_t numCorners = numTriangles * 3;
+	uint32_t* vertexCornerOffsets = (uint32_t*)calloc(numVertices + 1, sizeof(uint32_t));
+	uint32_t* vertexCorners = (uint32_t*)malloc((numCorners > 0 ? numCorners : 1) * sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < numTriangles; ++i)
+	{
+		uint32_t triangleIndices[3];
+		GetTriangleIndices(source, i, triangleIndices);
+		++vertexCornerOffsets[triangleIndices[0] + 1];
+		++vertexCornerOffsets[triangleIndices[1] + 1];
+		++vertexCornerOffsets[triangleIndices[2] + 1];
+	}
+
+	for (uint32_t v = 0; v < numVertices; ++v)
+		vertexCornerOffsets[v + 1] = vertexCornerOffsets[v + 1] + vertexCornerOffsets[v];
+
+	uint32_t* cursors = (uint32_t*)malloc((numVertices > 0 ? numVertices : 1) * sizeof(uint32_t));
+	memcpy(cursors, vertexCornerOffsets, numVertices * sizeof(uint32_t));
+	for (uint32_t i = 0; i < numTriangles; ++i)
+	{
+		uint32_t triangleIndices[3];
+		GetTriangleIndices(source, i, triangleIndices);
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			vertexCorners[cursors[triangleIndices[j]]] = i * 3 + j;
+			++cursors[triangleIndices[j]];
+		}
+	}
+	free(cursors);
+
+	*outVertexCornerOffsets = vertexCornerOffsets;
+	*outVertexCorners = vertexCorners;
+}
+
+struct TriangleFrameAccumulateJob
+{
+	Vertex* vertices;
+	const vec4* normals;
+	const vec4* tangents;
+	const uint32_t* vertexCornerOffsets;
+	const uint32_t* vertexCorners;
+};
+
+//Adds the frames of the triangles of every vertex in [begin, end) in triangle order.
+//Every vertex is written by one range only, so the ranges don't conflict.
+void AccumulateVertexFrames(void* data, uint32_t begin, uint32_t end)
+{
+	TriangleFrameAccumulateJob* job = (TriangleFrameAccumulateJob*)data;
+
+	for (uint32_t v = begin; v < end; ++v)
+	{
+		Vertex* vertex = &job->vertices[v];
+		for (uint32_t c = job->vertexCornerOffsets[v]; c < job->vertexCornerOffsets[v + 1]; ++c)
+		{
+			uint32_t triangle = job->vertexCorners[c] / 3;
+			if (job->normals != nullptr)
+				vertex->normal += job->normals[triangle];
+
+			if (job->tangents != nullptr)
+				vertex->tangent += job->tangents[triangle];
+		}
+	}
+}
+
+//Computes the frames in batches, then adds them to the vertices of each triangle.
+//Large meshes are grouped by vertex and accumulated in parallel. The sums are added in triangle order either way,
+//so the results don't depend on the number of threads.
+void AccumulateTriangleFramesBatched(Vertex* vertices, const TriangleSource* source, uint32_t numTriangles, uint32_t flags)
+{
+	vec4* normals = nullptr;
+	vec4* tangents = nullptr;
+	if (flags & TRIANGLE_FRAME_FLAGS_NORMAL)
+		normals = (vec4*)_mm_malloc(numTriangles * sizeof(vec4), 16);
+
+	if (flags & TRIANGLE_FRAME_FLAGS_TANGENT)
+		tangents = (vec4*)_mm_malloc(numTriangles * sizeof(vec4), 16);
+
+	ComputeTriangleFramesBatched(source, numTriangles, normals, tangents);
+
+	if (numTriangles < TANGENT_FRAME_MIN_RANGE_SIZE * 2 || GetNumLogicalCores() == 1)
+	{
+		//Nothing to split, the sort would cost more than the scatter
+		for (uint32_t i = 0; i < numTriangles; ++i)
+		{
+			uint32_t triangleIndices[3];
+			GetTriangleIndices(source, i, triangleIndices);
+
+			for (uint32_t j = 0; j < 3; ++j)
+			{
+				if (normals != nullptr)
+					vertices[triangleIndices[j]].normal += normals[i];
+
+				if (tangents != nullptr)
+					vertices[triangleIndices[j]].tangent += tangents[i];
+			}
+		}
+	}
+	else
+	{
+		uint32_t numVertices = 0;
+		for (uint32_t i = 0; i < numTriangles; ++i)
+		{
+			uint32_t triangleIndices[3];
+			GetTriangleIndices(source, i, triangleIndices);
+			for (uint32_t j = 0; j < 3; ++j)
+				numVertices = (triangleIndices[j] + 1 > numVertices) ? triangleIndices[j] + 1 : numVertices;
+		}
+
+		uint32_t* vertexCornerOffsets = nullptr;
+		uint32_t* vertexCorners = nullptr;
+		SortCornersByVertex(source, numTriangles, numVertices, &vertexCornerOffsets, &vertexCorners);
+
+		TriangleFrameAccumulateJob job{ vertices, normals, tangents, vertexCornerOffsets, vertexCorners };
+		ParallelFor(numVertices, TANGENT_FRAME_MIN_RANGE_SIZE, AccumulateVertexFrames, &job);
+
+		free(vertexCornerOffsets);
+		free(vertexCorners);
+	}
+
+	if (normals != nullptr)
+		_mm_free(normals);
+
+	if (tangents != nullptr)
+		_mm_free(tangents);
+}
+
+void ComputeTriangleFrames(const Vertex* vertices, const uint32_t* indices, uint32_t numTriangles, vec4* outNormals, vec4* outTangents)
+{
+	TriangleSource source{ vertices, indices, nullptr };
+	ComputeTriangleFramesBatched(&source, numTriangles, outNormals, outTangents);
+}
+
+void ComputeTriangleFrames(const Triangle* triangles, uint32_t numTriangles, vec4* outNormals, vec4* outTangents)
+{
+	TriangleSource source{ nullptr, nullptr, triangles };
+	ComputeTriangleFramesBatched(&source, numTriangles, outNormals, outTangents);
+}
+
+void AccumulateTriangleFrames(Vertex* vertices, const uint32_t* indices, uint32_t numTriangles, uint32_t flags)
+{
+	TriangleSource source{ vertices, indices, nullptr };
+	AccumulateTriangleFramesBatched(vertices, &source, numTriangles, flags);
+}
+
+void AccumulateTriangleFrames(Vertex* vertices, const Triangle* triangles, uint32_t numTriangles, uint32_t flags)
+{
+	TriangleSource source{ vertices, nullptr, triangles };
+	AccumulateTriangleFramesBatched(vertices, &source, numTriangles, flags);
+}
+
+struct TangentFrameJob
+{
+	Vertex* vertices;
+	const TriangleSource* source;
+
+	//xyz = angle weighted tangent of the corner, w = angle weighted orientation of its triangle
+	vec4* cornerTangents;
+
+	//The corners of vertex v are vertexCorners[vertexCornerOffsets[v]] to vertexCorners[vertexCornerOffsets[v + 1] - 1]
+	const uint32_t* vertexCornerOffsets;
+	const uint32_t* vertexCorners;
+};
+
+inline void LoadFloat3(const vec4* v, float* out)
+{
+	out[0] = v->GetX();
+	out[1] = v->GetY();
+	out[2] = v->GetZ();
+}
+
+inline float Dot3(const float* a, const float* b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+//Loads the normal and makes it unit length, normals read from files aren't always normalized
+inline void LoadNormal(const vec4* normal, float* out)
+{
+	LoadFloat3(normal, out);
+
+	float length = sqrtf(Dot3(out, out));
+	if (length > 0.0f)
+	{
+		out[0] = out[0] / length;
+		out[1] = out[1] / length;
+		out[2] = out[2] / length;
+	}
+}
+
+//v = normalize(v - dot(n, v) * n), returns false if the result is zero
+inline bool ProjectAndNormalize(const float* n, float* v)
+{
+	float d = Dot3(n, v);
+	v[0] = v[0] - d * n[0];
+	v[1] = v[1] - d * n[1];
+	v[2] = v[2] - d * n[2];
+
+	float length = sqrtf(Dot3(v, v));
+	if (!(length > 1e-20f))
+		return false;
+
+	v[0] = v[0] / length;
+	v[1] = v[1] / length;
+	v[2] = v[2] / length;
+
+	return true;
+}
+
+//Computes the contribution of the 3 corners of every triangle in [begin, end)
+void ComputeCornerTangents(void* data, uint32_t begin, uint32_t end)
+{
+	TangentFrameJob* job = (TangentFrameJob*)data;
+
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		uint32_t triangleIndices[3];
+		GetTriangleIndices(job->source, i, triangleIndices);
+		vec4* cornerTangents = &job->cornerTangents[i * 3];
+
+		float p[3][3];
+		float t[3][2];
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			const Vertex* vertex = &job->vertices[triangleIndices[j]];
+			LoadFloat3(&vertex->position, p[j]);
+			t[j][0] = vertex->texCoords.GetX();
+			t[j][1] = vertex->texCoords.GetY();
+
+			cornerTangents[j] = vec4(0.0f, 0.0f, 0.0f, 0.0f);
+		}
+
+		//The tangent of the triangle points along +u, see ComputeTangent
+		float t21x = t[1][0] - t[0][0];
+		float t21y = t[1][1] - t[0][1];
+		float t31x = t[2][0] - t[0][0];
+		float t31y = t[2][1] - t[0][1];
+		float signedArea = t21x * t31y - t21y * t31x;
+		if (signedArea == 0.0f)
+			continue;
+
+		//A triangle with a negative uv area is mirrored
+		float orientation = (signedArea > 0.0f) ? 1.0f : -1.0f;
+
+		float os[3];
+		for (uint32_t k = 0; k < 3; ++k)
+			os[k] = orientation * (t31y * (p[1][k] - p[0][k]) - t21y * (p[2][k] - p[0][k]));
+
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			float n[3];
+			LoadNormal(&job->vertices[triangleIndices[j]].normal, n);
+
+			float tangent[3] = { os[0], os[1], os[2] };
+			if (!ProjectAndNormalize(n, tangent))
+				continue;
+
+			//The angle of the corner between the edges projected onto the tangent plane
+			const float* p0 = p[j];
+			const float* p1 = p[(j + 1) % 3];
+			const float* p2 = p[(j + 2) % 3];
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			if (!ProjectAndNormalize(n, e1) || !ProjectAndNormalize(n, e2))
+				continue;
+
+			float cosAngle = Dot3(e1, e2);
+			cosAngle = (cosAngle > 1.0f) ? 1.0f : ((cosAngle < -1.0f) ? -1.0f : cosAngle);
+			float angle = acosf(cosAngle);
+
+			cornerTangents[j] = vec4(tangent[0] * angle, tangent[1] * angle, tangent[2] * angle, orientation * angle);
+		}
+	}
+}
+
+//Sums the corners of every vertex in [begin, end) in a fixed order and builds the final frame
+void ResolveVertexTangents(void* data, uint32_t begin, uint32_t end)
+{
+	TangentFrameJob* job = (TangentFrameJob*)data;
+
+	for (uint32_t v = begin; v < end; ++v)
+	{
+		float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (uint32_t c = job->vertexCornerOffsets[v]; c < job->vertexCornerOffsets[v + 1]; ++c)
+		{
+			const vec4* corner = &job->cornerTangents[job->vertexCorners[c]];
+			sum[0] = sum[0] + corner->GetX();
+			sum[1] = sum[1] + corner->GetY();
+			sum[2] = sum[2] + corner->GetZ();
+			sum[3] = sum[3] + corner->GetW();
+		}
+
+		Vertex* vertex = &job->vertices[v];
+		float n[3];
+		LoadNormal(&vertex->normal, n);
+
+		float tangent[3] = { sum[0], sum[1], sum[2] };
+		if (!ProjectAndNormalize(n, tangent))
+		{
+			//Pick the axis least aligned with the normal
+			tangent[0] = (fabsf(n[0]) < 0.9f) ? 1.0f : 0.0f;
+			tangent[1] = (fabsf(n[0]) < 0.9f) ? 0.0f : 1.0f;
+			tangent[2] = 0.0f;
+			if (!ProjectAndNormalize(n, tangent))
+			{
+				tangent[0] = 1.0f;
+				tangent[1] = 0.0f;
+				tangent[2] = 0.0f;
+			}
+		}
+
+		//A vertex shared by mirrored and non-mirrored triangles takes the handedness with the larger angle
+		float handedness = (sum[3] < 0.0f) ? -1.0f : 1.0f;
+
+		vertex->tangent = vec4(tangent[0], tangent[1], tangent[2], handedness);
+	}
+}
+
+void ComputeTangentFramesParallel(Vertex* vertices, uint32_t numVertices, const TriangleSource* source, uint32_t numTriangles)
+{
+	if (numVertices == 0)
+		return;
+
+	uint32_t numCorners = numTriangles * 3;
+	vec4* cornerTangents = (vec4*)_mm_malloc((numCorners > 0 ? numCorners : 1) * sizeof(vec4), 16);
+
+	uint32_t* vertexCornerOffsets = nullptr;
+	uint32_t* vertexCorners = nullptr;
+	SortCornersByVertex(source, numTriangles, numVertices, &vertexCornerOffsets, &vertexCorners);
+
+	TangentFrameJob job{ vertices, source, cornerTangents, vertexCornerOffsets, vertexCorners };
+	ParallelFor(numTriangles, TANGENT_FRAME_MIN_RANGE_SIZE, ComputeCornerTangents, &job);
+	ParallelFor(numVertices, TANGENT_FRAME_MIN_RANGE_SIZE, ResolveVertexTangents, &job);
+
+	_mm_free(cornerTangents);
+	free(vertexCornerOffsets);
+	free(vertexCorners);
+}
+
+void ComputeTangentFrames(Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numTriangles)
+{
+	TriangleSource source{ vertices, indices, nullptr };
+	ComputeTangentFramesParallel(vertices, numVertices, &source, numTriangles);
+}
+
+void ComputeTangentFrames(Vertex* vertices, uint32_t numVertices, const Triangle* triangles, uint32_t numTriangles)
+{
+	TriangleSource source{ vertices, nullptr, triangles };
+	ComputeTangentFramesParallel(vertices, numVertices, &source, numTriangles);
 }
\ No newline at end of file
@@ -21,4 +21,35 @@ struct Triangle
 
 void CreateTriangle(Triangle* triangle, const Vertex* pVertices, uint32_t i0, uint32_t i1, uint32_t i2);
 vec4 ComputeNormal(const Triangle* const triangle);
-vec4 ComputeTangent(const Triangle* const triangle);
\ No newline at end of file
+vec4 ComputeTangent(const Triangle* const triangle);
+
+enum TriangleFrameFlags
+{
+	TRIANGLE_FRAME_FLAGS_NORMAL = 0x1,
+	TRIANGLE_FRAME_FLAGS_TANGENT = 0x2,
+	TRIANGLE_FRAME_FLAGS_ALL = TRIANGLE_FRAME_FLAGS_NORMAL | TRIANGLE_FRAME_FLAGS_TANGENT
+};
+
+//Batch versions of ComputeNormal and ComputeTangent.
+//The triangles are processed 4 at a time with SSE, the vertices are gathered into SoA registers.
+//Stores the unit normal and the tangent of every triangle in outNormals and outTangents, either can be nullptr.
+//Degenerate triangles get a zero normal.
+//The triangle i is made of the vertices indices[3i], indices[3i + 1] and indices[3i + 2].
+void ComputeTriangleFrames(const Vertex* vertices, const uint32_t* indices, uint32_t numTriangles, vec4* outNormals, vec4* outTangents);
+void ComputeTriangleFrames(const Triangle* triangles, uint32_t numTriangles, vec4* outNormals, vec4* outTangents);
+
+//Adds the normal and/or tangent of every triangle to its three vertices.
+//The Triangle version reads the vertices from the vertices parameter, not from Triangle::vertices.
+//The frames are computed in batches first and then scattered, so the kernel never writes to a vertex.
+void AccumulateTriangleFrames(Vertex* vertices, const uint32_t* indices, uint32_t numTriangles, uint32_t flags);
+void AccumulateTriangleFrames(Vertex* vertices, const Triangle* triangles, uint32_t numTriangles, uint32_t flags);
+
+//Generates MikkTSpace-style tangent frames and overwrites the tangent of every vertex.
+//The normals must be final, the tangents are made orthogonal to them.
+//tangent.xyz is unit length and tangent.w is the handedness of the frame (+1 or -1), the bitangent is w * cross(tangent.xyz, normal.xyz).
+//Every corner contributes the tangent of its triangle projected onto the vertex normal, weighted by the corner angle.
+//Vertices without a valid uv direction get an arbitrary tangent orthogonal to the normal.
+//Large meshes are processed on multiple threads, the result doesn't depend on the number of threads.
+//The Triangle version reads the vertices from the vertices parameter, not from Triangle::vertices.
+void ComputeTangentFrames(Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numTriangles);
+void ComputeTangentFrames(Vertex* vertices, uint32_t numVertices, const Triangle* triangles, uint32_t numTriangles);
\ No newline at end of file
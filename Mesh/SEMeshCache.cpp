@@ -0,0 +1,240 @@
+#include <Windows.h>
+#include <cstdio>
+#include <cstring>
+
+#include "SEMeshCache.h"
+
+uint64_t HashMemory(const void* data, uint64_t size, uint64_t hash)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+
+	for (uint64_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+void GetMeshCacheFilename(const char* sourceFilename, char* outFilename)
+{
+	outFilename[0] = '\0';
+	strcat_s(outFilename, MAX_FILE_PATH, sourceFilename);
+	strcat_s(outFilename, MAX_FILE_PATH, ".semesh");
+}
+
+uint64_t HashFile(const char* filename)
+{
+	SEMappedFile file{};
+	MapFile(filename, &file);
+	uint64_t hash = HashMemory(file.data, file.size);
+	UnmapFile(&file);
+
+	return hash;
+}
+
+void GetMeshCacheDependency(const char* filename, MeshCacheDependency* outDependency)
+{
+	MeshCacheDependency dependency{};
+	strcpy_s(dependency.filename, filename);
+
+	SEFileStats stats{};
+	if (GetFileStats(filename, &stats) == true)
+	{
+		dependency.exists = 1;
+		dependency.size = stats.size;
+		dependency.writeTime = stats.writeTime;
+		dependency.hash = HashFile(filename);
+	}
+
+	*outDependency = dependency;
+}
+
+//A different write time alone doesn't mean the contents changed, e.g. after a checkout
+bool IsFileUnchanged(const char* filename, const SEFileStats* stats, uint64_t size, uint64_t writeTime, uint64_t hash)
+{
+	if (stats->size != size)
+		return false;
+
+	return stats->writeTime == writeTime || HashFile(filename) == hash;
+}
+
+//True if count elements of size bytes starting at offset end at or before end.
+//Compares against the space left instead of computing offset + count * size, which a corrupt header could wrap.
+bool IsMeshCacheRangeValid(uint64_t offset, uint64_t count, uint64_t size, uint64_t end)
+{
+	return offset <= end && count <= (end - offset) / size;
+}
+
+//The arrays must be in the order of the layout, each one ending before the next starts and the last one inside the file,
+//so no pointer built from the header can point outside the mapping.
+bool IsMeshCacheLayoutValid(const MeshCacheHeader* header, uint64_t fileSize)
+{
+	return IsMeshCacheRangeValid(0, 1, sizeof(MeshCacheHeader), header->submeshesOffset) &&
+		IsMeshCacheRangeValid(header->submeshesOffset, header->numSubmeshes, sizeof(MeshSubmesh), header->materialsOffset) &&
+		IsMeshCacheRangeValid(header->materialsOffset, header->numMaterials, sizeof(MeshMaterial), header->dependenciesOffset) &&
+		IsMeshCacheRangeValid(header->dependenciesOffset, header->numDependencies, sizeof(MeshCacheDependency), header->verticesOffset) &&
+		IsMeshCacheRangeValid(header->verticesOffset, header->numVertices, sizeof(Vertex), header->indicesOffset) &&
+		IsMeshCacheRangeValid(header->indicesOffset, header->numIndices, sizeof(uint32_t), fileSize);
+}
+
+bool LoadMeshCache(const char* cacheFilename, const char* sourceFilename, MeshCache* outCache)
+{
+	SEFileStats cacheStats{};
+	SEFileStats sourceStats{};
+	if (GetFileStats(cacheFilename, &cacheStats) == false || GetFileStats(sourceFilename, &sourceStats) == false)
+		return false;
+
+	if (cacheStats.size < sizeof(MeshCacheHeader))
+		return false;
+
+	MeshCache cache{};
+	MapFile(cacheFilename, &cache.file);
+
+	const MeshCacheHeader* header = (const MeshCacheHeader*)cache.file.data;
+	bool valid = header->magic == MESH_CACHE_MAGIC &&
+		header->version == MESH_CACHE_VERSION &&
+		header->vertexLayout == MESH_VERTEX_LAYOUT_STANDARD &&
+		header->vertexStride == sizeof(Vertex) &&
+		IsMeshCacheLayoutValid(header, cache.file.size);
+
+	valid = valid && IsFileUnchanged(sourceFilename, &sourceStats, header->sourceSize, header->sourceWriteTime, header->sourceHash);
+
+	const MeshCacheDependency* dependencies = (const MeshCacheDependency*)(cache.file.data + header->dependenciesOffset);
+	for (uint32_t i = 0; i < header->numDependencies && valid == true; ++i)
+	{
+		//The filename is read as a string
+		if (memchr(dependencies[i].filename, '\0', MAX_FILE_PATH) == nullptr)
+		{
+			valid = false;
+			break;
+		}
+
+		SEFileStats stats{};
+		bool exists = GetFileStats(dependencies[i].filename, &stats);
+		if (exists == true)
+			valid = dependencies[i].exists == 1 &&
+				IsFileUnchanged(dependencies[i].filename, &stats, dependencies[i].size, dependencies[i].writeTime, dependencies[i].hash);
+		else
+			valid = dependencies[i].exists == 0;
+	}
+
+	if (valid == false)
+	{
+		UnmapFile(&cache.file);
+		return false;
+	}
+
+	cache.header = header;
+	cache.submeshes = (const MeshSubmesh*)(cache.file.data + header->submeshesOffset);
+	cache.materials = (const MeshMaterial*)(cache.file.data + header->materialsOffset);
+	cache.dependencies = dependencies;
+	cache.vertices = (const Vertex*)(cache.file.data + header->verticesOffset);
+	cache.indices = (const uint32_t*)(cache.file.data + header->indicesOffset);
+
+	*outCache = cache;
+
+	return true;
+}
+
+void UnloadMeshCache(MeshCache* cache)
+{
+	UnmapFile(&cache->file);
+	*cache = MeshCache{};
+}
+
+void InitMeshCacheHeader(MeshCacheHeader* header, const SEFileStats* sourceStats, uint64_t sourceHash,
+	uint32_t numVertices, uint32_t numIndices, uint32_t numSubmeshes, uint32_t numMaterials, uint32_t numDependencies, const MeshBounds* bounds)
+{
+	*header = MeshCacheHeader{};
+	header->magic = MESH_CACHE_MAGIC;
+	header->version = MESH_CACHE_VERSION;
+	header->sourceSize = sourceStats->size;
+	header->sourceWriteTime = sourceStats->writeTime;
+	header->sourceHash = sourceHash;
+	header->vertexLayout = MESH_VERTEX_LAYOUT_STANDARD;
+	header->vertexStride = sizeof(Vertex);
+	header->numVertices = numVertices;
+	header->numIndices = numIndices;
+	header->numSubmeshes = numSubmeshes;
+	header->numMaterials = numMaterials;
+	header->numDependencies = numDependencies;
+	header->bounds = *bounds;
+
+	//Every array starts at a multiple of 16 bytes
+	header->submeshesOffset = (sizeof(MeshCacheHeader) + 15) & ~15ull;
+	header->materialsOffset = (header->submeshesOffset + (uint64_t)numSubmeshes * sizeof(MeshSubmesh) + 15) & ~15ull;
+	header->dependenciesOffset = (header->materialsOffset + (uint64_t)numMaterials * sizeof(MeshMaterial) + 15) & ~15ull;
+	header->verticesOffset = (header->dependenciesOffset + (uint64_t)numDependencies * sizeof(MeshCacheDependency) + 15) & ~15ull;
+	header->indicesOffset = header->verticesOffset + (uint64_t)numVertices * sizeof(Vertex);
+}
+
+bool WriteMeshCacheHeader(FILE* file, const MeshCacheHeader* header,
+	const MeshSubmesh* submeshes, const MeshMaterial* materials, const MeshCacheDependency* dependencies)
+{
+	const char padding[16]{};
+	uint64_t paddingSizes[4] =
+	{
+		header->submeshesOffset - sizeof(MeshCacheHeader),
+		header->materialsOffset - header->submeshesOffset - header->numSubmeshes * sizeof(MeshSubmesh),
+		header->dependenciesOffset - header->materialsOffset - header->numMaterials * sizeof(MeshMaterial),
+		header->verticesOffset - header->dependenciesOffset - header->numDependencies * sizeof(MeshCacheDependency)
+	};
+
+	bool result = fwrite(header, sizeof(MeshCacheHeader), 1, file) == 1;
+	result = result && fwrite(padding, 1, paddingSizes[0], file) == paddingSizes[0];
+	result = result && fwrite(submeshes, sizeof(MeshSubmesh), header->numSubmeshes, file) == header->numSubmeshes;
+	result = result && fwrite(padding, 1, paddingSizes[1], file) == paddingSizes[1];
+	result = result && fwrite(materials, sizeof(MeshMaterial), header->numMaterials, file) == header->numMaterials;
+	result = result && fwrite(padding, 1, paddingSizes[2], file) == paddingSizes[2];
+	result = result && fwrite(dependencies, sizeof(MeshCacheDependency), header->numDependencies, file) == header->numDependencies;
+	result = result && fwrite(padding, 1, paddingSizes[3], file) == paddingSizes[3];
+
+	return result;
+}
+
+FILE* BeginMeshCacheWrite(const char* cacheFilename, char* outTempFilename)
+{
+	outTempFilename[0] = '\0';
+	strcat_s(outTempFilename, MAX_FILE_PATH, cacheFilename);
+	strcat_s(outTempFilename, MAX_FILE_PATH, ".tmp");
+
+	FILE* file = nullptr;
+	fopen_s(&file, outTempFilename, "wb");
+
+	return file;
+}
+
+bool EndMeshCacheWrite(FILE* file, bool result, const char* tempFilename, const char* cacheFilename)
+{
+	result = fclose(file) == 0 && result;
+
+	//Replaces the old cache in one step, a loader never sees a partial file
+	result = result && MoveFileExA(tempFilename, cacheFilename, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+
+	//Don't leave a partial cache behind
+	if (result == false)
+		remove(tempFilename);
+
+	return result;
+}
+
+void WriteMeshCache(const char* cacheFilename, const SEFileStats* sourceStats, uint64_t sourceHash,
+	const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	const MeshSubmesh* submeshes, uint32_t numSubmeshes, const MeshMaterial* materials, uint32_t numMaterials,
+	const MeshCacheDependency* dependencies, uint32_t numDependencies, const MeshBounds* bounds)
+{
+	char tempFilename[MAX_FILE_PATH]{};
+	FILE* file = BeginMeshCacheWrite(cacheFilename, tempFilename);
+	if (!file)
+		return;
+
+	MeshCacheHeader header{};
+	InitMeshCacheHeader(&header, sourceStats, sourceHash, numVertices, numIndices, numSubmeshes, numMaterials, numDependencies, bounds);
+
+	bool result = WriteMeshCacheHeader(file, &header, submeshes, materials, dependencies);
+	result = result && fwrite(vertices, sizeof(Vertex), numVertices, file) == numVertices;
+	result = result && fwrite(indices, sizeof(uint32_t), numIndices, file) == numIndices;
+	EndMeshCacheWrite(file, result, tempFilename, cacheFilename);
+}
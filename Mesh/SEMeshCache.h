@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMesh.h"
+#include "SEBounds.h"
+#include "SEMeshMaterial.h"
+#include "../FileSystem/SEFileSystem.h"
+
+//.semesh is a binary cache of a loaded mesh. It stores the Vertex and index arrays exactly as they are in memory
+//so a cache hit maps the file and needs no parsing.
+//
+//Layout
+//MeshCacheHeader
+//MeshSubmesh[numSubmeshes] (16-byte aligned)
+//MeshMaterial[numMaterials] (16-byte aligned)
+//MeshCacheDependency[numDependencies] (16-byte aligned)
+//Vertex[numVertices] (16-byte aligned)
+//uint32_t[numIndices]
+
+#define MESH_CACHE_MAGIC 0x48534D53 //"SMSH"
+
+//Increase when the layout of the file or the output of a loader changes so old caches are rebuilt.
+#define MESH_CACHE_VERSION 6
+
+enum MeshVertexLayout
+{
+	//The Vertex struct
+	MESH_VERTEX_LAYOUT_STANDARD = 0
+};
+
+//A range of the index array drawn with one material.
+struct MeshSubmesh
+{
+	uint32_t indexOffset;
+	uint32_t indexCount;
+
+	//Index into the materials of the mesh or MESH_NO_MATERIAL
+	uint32_t materialIndex;
+
+	//Bounds of the vertices the range references
+	MeshBounds bounds;
+
+	char name[MESH_MAX_NAME_LENGTH];
+};
+
+//A file other than the source that the mesh was built from, for example a .mtl library.
+struct MeshCacheDependency
+{
+	char filename[MAX_FILE_PATH];
+
+	//0 if the file didn't exist. The cache is rebuilt when it appears.
+	uint32_t exists;
+
+	uint64_t size;
+	uint64_t writeTime;
+	uint64_t hash;
+};
+
+struct MeshCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+
+	//Used to detect changes to the source file
+	uint64_t sourceSize;
+	uint64_t sourceWriteTime;
+	uint64_t sourceHash;
+
+	uint32_t vertexLayout;
+	uint32_t vertexStride;
+	uint32_t numVertices;
+	uint32_t numIndices;
+	uint32_t numSubmeshes;
+	uint32_t numMaterials;
+	uint32_t numDependencies;
+
+	//Bounds of the vertex positions
+	MeshBounds bounds;
+
+	//Byte offsets from the start of the file
+	uint64_t submeshesOffset;
+	uint64_t materialsOffset;
+	uint64_t dependenciesOffset;
+	uint64_t verticesOffset;
+	uint64_t indicesOffset;
+};
+
+//A mapped .semesh file. The pointers point into the mapping and are valid until UnloadMeshCache is called.
+struct MeshCache
+{
+	SEMappedFile file;
+	const MeshCacheHeader* header = nullptr;
+	const MeshSubmesh* submeshes = nullptr;
+	const MeshMaterial* materials = nullptr;
+	const MeshCacheDependency* dependencies = nullptr;
+	const Vertex* vertices = nullptr;
+	const uint32_t* indices = nullptr;
+};
+
+//64-bit FNV-1a hash of the memory.
+//Data can be hashed in pieces by passing the hash of the previous pieces.
+uint64_t HashMemory(const void* data, uint64_t size, uint64_t hash = 0xCBF29CE484222325ull);
+
+//Stores "sourceFilename.semesh" in outFilename.
+void GetMeshCacheFilename(const char* sourceFilename, char* outFilename);
+
+//Maps the cache file.
+//Returns false if the cache doesn't exist, was written by a different version or vertex layout,
+//or the source file or one of the dependencies has changed since it was written.
+//A file is only hashed when its size matches but its write time doesn't.
+bool LoadMeshCache(const char* cacheFilename, const char* sourceFilename, MeshCache* outCache);
+void UnloadMeshCache(MeshCache* cache);
+
+//Fills in a dependency record for the file.
+void GetMeshCacheDependency(const char* filename, MeshCacheDependency* outDependency);
+
+//Fills in the header of a cache file, including the offsets of the arrays.
+void InitMeshCacheHeader(MeshCacheHeader* header, const SEFileStats* sourceStats, uint64_t sourceHash,
+	uint32_t numVertices, uint32_t numIndices, uint32_t numSubmeshes, uint32_t numMaterials, uint32_t numDependencies, const MeshBounds* bounds);
+
+//Writes everything before the vertices, so the vertices and indices can be written after it in pieces.
+//Returns false if writing fails.
+bool WriteMeshCacheHeader(FILE* file, const MeshCacheHeader* header,
+	const MeshSubmesh* submeshes, const MeshMaterial* materials, const MeshCacheDependency* dependencies);
+
+//Opens "cacheFilename.tmp" for writing and stores its name in outTempFilename, which holds MAX_FILE_PATH characters.
+//Returns nullptr if it can't be opened.
+FILE* BeginMeshCacheWrite(const char* cacheFilename, char* outTempFilename);
+
+//Closes the file of BeginMeshCacheWrite and, if result is true, renames it to cacheFilename, replacing the old cache.
+//Otherwise, or if closing or renaming fails, the temporary file is removed. Returns true if the cache was replaced.
+bool EndMeshCacheWrite(FILE* file, bool result, const char* tempFilename, const char* cacheFilename);
+
+//Writes the cache file. sourceStats and sourceHash identify the source file the mesh was loaded from.
+//Failing to write the cache isn't an error, the mesh is loaded from the source next time.
+void WriteMeshCache(const char* cacheFilename, const SEFileStats* sourceStats, uint64_t sourceHash,
+	const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	const MeshSubmesh* submeshes, uint32_t numSubmeshes, const MeshMaterial* materials, uint32_t numMaterials,
+	const MeshCacheDependency* dependencies, uint32_t numDependencies, const MeshBounds* bounds);
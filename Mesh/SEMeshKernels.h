@@ -0,0 +1,13 @@
+#pragma once
+
+//Triangle kernels compiled for a wider instruction set than the rest of the engine.
+//SEMesh_AVX2.cpp is compiled with AVX2 enabled, so it doesn't include the math library: an inline function compiled
+//there could be the copy the linker keeps for the whole program and run on a CPU without AVX.
+
+#include <cstdint>
+
+//Computes the frames of 8 triangles like ComputeTriangleFrames4, without FMA so the results are the same.
+//positions[k][j] points to the 16-byte aligned x, y, z, w position of the jth vertex of the kth triangle,
+//texCoords[k][j] to its u, v texture coordinates. outNormals and outTangents are 8 16-byte aligned x, y, z, w vectors
+//each and may be nullptr. Only call it if GetCPUFeatures reports CPU_FEATURE_FLAGS_AVX2.
+void ComputeTriangleFrames8AVX2(const float* const positions[8][3], const float* const texCoords[8][3], float* outNormals, float* outTangents);
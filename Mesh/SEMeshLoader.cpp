@@ -1,10 +1,15 @@
 #include <stdio.h>
 #include <cmath>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
 #include <Windows.h>
-#include "SEMesh.h"
+#include "SEMeshLoader.h"
+#include "SEMeshCache.h"
+#include "SEMeshOptimizer.h"
 #include "..\FileSystem\SEFileSystem.h"
-
-#define STB_DS_IMPLEMENTATION
+#include "..\Thread\SEThread.h"
 
 
 int32_t StringToInt32(char* str)
@@ -58,378 +63,1904 @@ int64_t StringToInt64(char* str)
 	return value;
 }
 
-float StringToFloat(char* str)
+//Powers of ten that are exactly representable as a double
+const double gPowersOfTen[] =
 {
-	//formula used value = value * base + digit
-	//keep track of the number of digits right of the decimal point, call it N.
-	//divde value by base^N (value / base^N)
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
 
-	uint32_t index = 0;
-	bool negative = false;
-	if (str[index] == '-')
+//A decimal number split into its parts.
+//value = mantissa * 10^exponent
+struct DecimalNumber
+{
+	uint64_t mantissa;
+	int32_t exponent;
+	bool negative;
+
+	//True if nonzero digits after the first 19 significant ones were dropped
+	bool truncated;
+};
+
+inline bool IsDecimalDigit(char ch)
+{
+	return (uint32_t)(ch - '0') < 10;
+}
+
+//Parses [+-]digits[.digits][(e|E)[+-]digits] in the range [begin, end).
+//Returns a pointer to the first character after the number or begin if there are no digits.
+const char* ParseDecimal(const char* begin, const char* end, DecimalNumber* number)
+{
+	DecimalNumber result{};
+
+	const char* cur = begin;
+	if (cur < end && (*cur == '-' || *cur == '+'))
 	{
-		negative = true;
-		++index;
+		result.negative = (*cur == '-');
+		++cur;
 	}
 
-	char* dot = strchr(str, '.');
-	uint32_t dotIndex = dot - str;
+	//The digits are accumulated into an integer mantissa and the decimal point only changes the exponent.
+	//Leading zeros aren't significant. Only 19 significant digits fit in the mantissa.
+	uint32_t numDigits = 0;
+	uint32_t numSignificantDigits = 0;
+	while (cur < end && IsDecimalDigit(*cur))
+	{
+		uint32_t digit = *cur - '0';
+		if (numSignificantDigits < 19)
+		{
+			result.mantissa = result.mantissa * 10 + digit;
+			numSignificantDigits += (result.mantissa != 0);
+		}
+		else
+		{
+			++result.exponent;
+			result.truncated |= (digit != 0);
+		}
 
-	uint32_t n = 0;
-	float value = 0.0f;
-	while (str[index] != '\0')
+		++numDigits;
+		++cur;
+	}
+
+	if (cur < end && *cur == '.')
+	{
+		++cur;
+		while (cur < end && IsDecimalDigit(*cur))
+		{
+			uint32_t digit = *cur - '0';
+			if (numSignificantDigits < 19)
+			{
+				result.mantissa = result.mantissa * 10 + digit;
+				numSignificantDigits += (result.mantissa != 0);
+				--result.exponent;
+			}
+			else
+			{
+				result.truncated |= (digit != 0);
+			}
+
+			++numDigits;
+			++cur;
+		}
+	}
+
+	if (numDigits == 0)
+		return begin;
+
+	//The exponent is only part of the number if it has digits
+	if (cur < end && (*cur == 'e' || *cur == 'E'))
 	{
-		if (str[index] != '.')
-			value = value * 10.0f + (str[index] - '0');
+		const char* exponentBegin = cur;
+		++cur;
+
+		bool negativeExponent = false;
+		if (cur < end && (*cur == '-' || *cur == '+'))
+		{
+			negativeExponent = (*cur == '-');
+			++cur;
+		}
+
+		if (cur < end && IsDecimalDigit(*cur))
+		{
+			int32_t exponent = 0;
+			while (cur < end && IsDecimalDigit(*cur))
+			{
+				//Anything this large over- or underflows anyway
+				if (exponent < 100000)
+					exponent = exponent * 10 + (*cur - '0');
 
-		if (index > dotIndex)
-			++n;
+				++cur;
+			}
 
-		++index;
+			result.exponent += negativeExponent ? -exponent : exponent;
+		}
+		else
+		{
+			cur = exponentBegin;
+		}
 	}
 
-	value = value / pow(10, n);
+	*number = result;
 
-	if (negative)
-		value = -value;
+	return cur;
+}
 
-	return value;
+//Clinger's fast path.
+//If the mantissa and the power of ten are both exactly representable as doubles
+//a single multiplication or division gives the correctly rounded result.
+bool DecimalToDoubleFast(const DecimalNumber* number, double* value)
+{
+	if (number->truncated == true || number->mantissa > (1ull << 53))
+		return false;
+
+	double mantissa = (double)number->mantissa;
+	double result = 0.0;
+	if (number->mantissa == 0)
+		result = 0.0;
+	else if (number->exponent >= 0 && number->exponent <= 22)
+		result = mantissa * gPowersOfTen[number->exponent];
+	else if (number->exponent < 0 && number->exponent >= -22)
+		result = mantissa / gPowersOfTen[-number->exponent];
+	else
+		return false;
+
+	*value = number->negative ? -result : result;
+
+	return true;
 }
 
-double StringToDouble(char* str)
+//Copies the number into a null-terminated buffer so the C library can convert it.
+void CopyNumber(const char* begin, const char* end, char* buffer, uint32_t bufferSize)
 {
-	//formula used value = value * base + digit
-	//keep track of the number of digits right of the decimal point, call it N.
-	//divde value by base^N (value / base^N)
+	uint32_t length = (uint32_t)(end - begin);
+	if (length > bufferSize - 1)
+		length = bufferSize - 1;
 
-	uint32_t index = 0;
-	bool negative = false;
-	if (str[index] == '-')
+	memcpy(buffer, begin, length);
+	buffer[length] = '\0';
+}
+
+const char* ParseDouble(const char* begin, const char* end, double* value)
+{
+	DecimalNumber number{};
+	const char* cur = ParseDecimal(begin, end, &number);
+	if (cur == begin)
 	{
-		negative = true;
-		++index;
+		*value = 0.0;
+		return begin;
 	}
 
-	char* dot = strchr(str, '.');
-	uint32_t dotIndex = dot - str;
+	if (DecimalToDoubleFast(&number, value) == true)
+		return cur;
 
-	uint32_t n = 0;
-	double value = 0.0;
-	while (str[index] != '\0')
+	//Slow path, correctly rounded by the C library
+	char buffer[256]{};
+	CopyNumber(begin, cur, buffer, sizeof(buffer));
+	*value = strtod(buffer, nullptr);
+
+	return cur;
+}
+
+const char* ParseFloat(const char* begin, const char* end, float* value)
+{
+	DecimalNumber number{};
+	const char* cur = ParseDecimal(begin, end, &number);
+	if (cur == begin)
 	{
-		if (str[index] != '.')
-			value = value * 10.0 + (str[index] - '0');
+		*value = 0.0f;
+		return begin;
+	}
 
-		if (index > dotIndex)
-			++n;
+	//Rounding the correctly rounded double to float gives the correctly rounded float,
+	//unless the double is exactly halfway between two floats. Then the rounding direction is unknown.
+	//The low 29 bits of the double mantissa are the bits a normal float drops.
+	double result = 0.0;
+	if (DecimalToDoubleFast(&number, &result) == true)
+	{
+		uint64_t bits = 0;
+		memcpy(&bits, &result, sizeof(double));
 
-		++index;
+		double magnitude = fabs(result);
+		bool halfway = (bits & 0x1FFFFFFFull) == 0x10000000ull;
+		if (magnitude == 0.0 || (magnitude >= FLT_MIN && magnitude <= FLT_MAX && halfway == false))
+		{
+			*value = (float)result;
+			return cur;
+		}
 	}
 
-	value = value / pow(10, n);
+	//Slow path, correctly rounded by the C library
+	char buffer[256]{};
+	CopyNumber(begin, cur, buffer, sizeof(buffer));
+	*value = strtof(buffer, nullptr);
 
-	if (negative)
-		value = -value;
+	return cur;
+}
+
+float StringToFloat(char* str)
+{
+	float value = 0.0f;
+	ParseFloat(str, str + strlen(str), &value);
 
 	return value;
 }
 
-struct OBJVertexData
+double StringToDouble(char* str)
 {
-	//stb_ds arrays
-	vec3* v = nullptr;
-	vec3* vn = nullptr;
-	vec2* vt = nullptr;
-	bool vnExist = false;
-	bool vtExist = false;
-};
+	double value = 0.0;
+	ParseDouble(str, str + strlen(str), &value);
+
+	return value;
+}
 
-struct OBJFace
+inline bool OBJIsDigit(char ch)
 {
-	int32_t vIndex;
-	int32_t vtIndex = -1;
-	int32_t vnIndex = -1;
-};
+	return (uint32_t)(ch - '0') < 10;
+}
 
-void OBJParseVertex(char* buf, OBJVertexData* vData)
+inline bool OBJIsSpace(char ch)
 {
-	uint32_t index = 0;
-	uint32_t numIterations = 3;
+	return ch == ' ' || ch == '\t';
+}
 
-	++index;
-	char ch = buf[index];
-	if (ch == 'n' || ch == 't')
-	{
-		if (ch == 't')
-			numIterations = 2;
+inline const char* OBJSkipSpaces(const char* cur, const char* end)
+{
+	while (cur < end && OBJIsSpace(*cur))
+		++cur;
+
+	return cur;
+}
+
+//Returns a pointer to the '\n' that ends the line or end if it is the last line.
+inline const char* OBJFindLineEnd(const char* cur, const char* end)
+{
+	const char* newLine = (const char*)memchr(cur, '\n', end - cur);
+
+	return (newLine != nullptr) ? newLine : end;
+}
 
-		index = index + 2;
+const char* OBJParseInt(const char* cur, const char* end, int32_t* value)
+{
+	//formula used value = value * base + digit
+
+	bool negative = false;
+	if (cur < end && (*cur == '-' || *cur == '+'))
+	{
+		negative = (*cur == '-');
+		++cur;
 	}
-	else //ch == ' '
+
+	int32_t result = 0;
+	while (cur < end && OBJIsDigit(*cur))
 	{
-		index = index + 1;
+		result = result * 10 + (*cur - '0');
+		++cur;
 	}
 
-	double value[3]{};
+	*value = negative ? -result : result;
+
+	return cur;
+}
 
-	for (uint32_t i = 0; i < numIterations; ++i)
+const char* OBJParseVertex(const char* cur, const char* end, OBJVertexData* vData)
+{
+	//cur points to the 'v' that starts the line
+	++cur;
+	char ch = *cur;
+	uint32_t numValues = 3;
+	if (ch == 'n' || ch == 't')
 	{
-		char valueStr[32]{};
-		while (buf[index] != ' ' && buf[index] != '\n')
-		{
-			strncat_s(valueStr, 32, &buf[index], 1);
-			++index;
-		}
-		value[i] = StringToDouble(valueStr);
-		++index;
+		if (ch == 't')
+			numValues = 2;
+
+		++cur;
+	}
+
+	float value[3]{};
+	for (uint32_t i = 0; i < numValues; ++i)
+	{
+		cur = OBJSkipSpaces(cur, end);
+		cur = ParseFloat(cur, end, &value[i]);
 	}
 
 	if (ch == 'n')
 	{
-		vec3 vn(value[0], value[1], value[2]);
-		arrpush(vData->vn, vn);
+		arrpush(vData->vn, vec3(value[0], value[1], value[2]));
 	}
 	else if (ch == 't')
 	{
-		vec2 vt(value[0], value[1]);
-		arrpush(vData->vt, vt);
+		arrpush(vData->vt, vec2(value[0], value[1]));
 	}
 	else //ch == ' '
 	{
-		vec3 v(value[0], value[1], value[2]);
-		arrpush(vData->v, v);
+		arrpush(vData->v, vec3(value[0], value[1], value[2]));
 	}
+
+	//Ignore any optional values (w, vertex colors)
+	return OBJFindLineEnd(cur, end);
 }
 
-void OBJParseFace(char* buf, OBJFace** faces)
+const char* OBJParseFace(const char* cur, const char* end, OBJChunk* chunk, uint32_t* outNumIndices)
 {
-	uint32_t index = 2;
-	char valueStr[16]{};
+	//cur points to the 'f' that starts the line
+	const char* lineEnd = OBJFindLineEnd(cur, end);
+	++cur;
 
-	while (buf[index] != '\n' && buf[index] != '\0')
+	//Negative indices are relative to the number of elements defined so far.
+	//They are resolved against the counts of the chunk and recorded so the merge can add the counts of the previous chunks.
+	int32_t count[3] = { (int32_t)arrlen(chunk->vData.v), (int32_t)arrlen(chunk->vData.vt), (int32_t)arrlen(chunk->vData.vn) };
+
+	uint32_t numIndices = 0;
+	while (true)
 	{
+		cur = OBJSkipSpaces(cur, lineEnd);
+		if (cur == lineEnd || !(OBJIsDigit(*cur) || *cur == '-'))
+			break;
+
 		OBJFace face{};
+		int32_t* index[3] = { &face.vIndex, &face.vtIndex, &face.vnIndex };
+		bool parsed[3] = { true, false, false };
+
 		//vertex index
-		valueStr[0] = '\0';
-		while (buf[index] != ' ' && buf[index] != '\n' && buf[index] != '/')
-		{
-			strncat_s(valueStr, 16, &buf[index], 1);
-			++index;
-		}
-		face.vIndex = StringToInt32(valueStr);
+		cur = OBJParseInt(cur, lineEnd, &face.vIndex);
 
-		if (buf[index] == '/')
+		if (cur < lineEnd && *cur == '/')
 		{
-			if (buf[index + 1] == '/')
+			++cur;
+
+			//texture index, empty in the v//vn form
+			if (cur < lineEnd && *cur != '/')
 			{
-				//normal index
-				index = index + 2;
-				valueStr[0] = '\0';
-				while (buf[index] != ' ' && buf[index] != '\n')
-				{
-					strncat_s(valueStr, 16, &buf[index], 1);
-					++index;
-				}
-				face.vnIndex = StringToInt32(valueStr);
+				cur = OBJParseInt(cur, lineEnd, &face.vtIndex);
+				parsed[1] = true;
 			}
-			else
+
+			//normal index
+			if (cur < lineEnd && *cur == '/')
 			{
-				//texture index
-				++index;
-				valueStr[0] = '\0';
-				while (buf[index] != ' ' && buf[index] != '\n' && buf[index] != '/')
-				{
-					strncat_s(valueStr, 16, &buf[index], 1);
-					++index;
-				}
-				face.vtIndex = StringToInt32(valueStr);
+				cur = OBJParseInt(cur + 1, lineEnd, &face.vnIndex);
+				parsed[2] = true;
+			}
+		}
 
-				if (buf[index] == '/')
-				{
-					//normal index
-					++index;
-					valueStr[0] = '\0';
-					while (buf[index] != ' ' && buf[index] != '\n')
-					{
-						strncat_s(valueStr, 16, &buf[index], 1);
-						++index;
-					}
-					face.vnIndex = StringToInt32(valueStr);
-				}
+		uint32_t faceIndex = (uint32_t)arrlenu(chunk->faces);
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			if (parsed[i] == true && *index[i] < 0)
+			{
+				*index[i] = count[i] + *index[i] + 1;
+				arrpush(chunk->relativeIndices, faceIndex * 3 + i);
 			}
 		}
-		++index;
-		arrpush(*faces, face);
+
+		arrpush(chunk->faces, face);
+		++numIndices;
 	}
+
+	*outNumIndices = numIndices;
+
+	return lineEnd;
+}
+
+//Copies [begin, end) to dest and null terminates it. The string is truncated to destSize - 1 characters.
+void OBJCopyString(char* dest, size_t destSize, const char* begin, const char* end)
+{
+	size_t length = end - begin;
+	if (length > destSize - 1)
+		length = destSize - 1;
+
+	memcpy(dest, begin, length);
+	dest[length] = '\0';
+}
+
+//Returns a pointer to the end of the word starting at cur.
+inline const char* OBJFindWordEnd(const char* cur, const char* end)
+{
+	while (cur < end && !OBJIsSpace(*cur) && *cur != '\r' && *cur != '\n')
+		++cur;
+
+	return cur;
+}
+
+inline bool OBJIsKeyword(const char* begin, const char* end, const char* keyword)
+{
+	size_t length = strlen(keyword);
+
+	return (size_t)(end - begin) == length && memcmp(begin, keyword, length) == 0;
 }
 
-void ParseOBJ(const char* filename, Vertex** vertices, uint32_t** indices, uint32_t* numVertices, uint32_t* numIndices)
+const char* OBJParseStatement(const char* cur, const char* end, OBJStatementType type, OBJChunk* chunk)
 {
-	FILE* file = nullptr;
+	//cur points to the first character after the keyword
+	const char* lineEnd = OBJFindLineEnd(cur, end);
+	uint32_t faceIndex = (uint32_t)arrlenu(chunk->faceSizes);
 
-	fopen_s(&file, filename, "r");
+	cur = OBJSkipSpaces(cur, lineEnd);
+	const char* argumentEnd = lineEnd;
+	while (argumentEnd > cur && (OBJIsSpace(argumentEnd[-1]) || argumentEnd[-1] == '\r'))
+		--argumentEnd;
 
-	char errorMsg[256]{};
-	if (!file)
+	if (type == OBJ_STATEMENT_MATERIAL_LIBRARY)
 	{
-		strcat_s(errorMsg, "Failed to open file ");
-		strcat_s(errorMsg, filename);
-		strcat_s(errorMsg, ". Exiting prorgam.");
-		MessageBoxA(nullptr, errorMsg, "File open error.", MB_OK);
-		exit(-1);
+		//mtllib takes a list of filenames
+		while (cur < argumentEnd)
+		{
+			const char* wordEnd = OBJFindWordEnd(cur, argumentEnd);
+
+			OBJStatement statement{ type, faceIndex };
+			OBJCopyString(statement.name, MAX_FILE_PATH, cur, wordEnd);
+			arrpush(chunk->statements, statement);
+
+			cur = OBJSkipSpaces(wordEnd, argumentEnd);
+		}
+	}
+	else
+	{
+		//Names can contain spaces
+		OBJStatement statement{ type, faceIndex };
+		OBJCopyString(statement.name, MESH_MAX_NAME_LENGTH, cur, argumentEnd);
+		arrpush(chunk->statements, statement);
 	}
 
-	OBJVertexData vData;
-	OBJFace* faces = nullptr; //a stb_ds array
+	return lineEnd;
+}
 
-	char buf[128]{};
-	bool firstFace = true;
-	uint32_t numIndicesPerFace = 0;
-	while (fgets(buf, 128, file) != nullptr)
+void OBJParseChunk(OBJChunk* chunk)
+{
+	//Single pass over the mapped range. Every statement is tokenized in place, no line is copied.
+	const char* cur = chunk->begin;
+	const char* end = chunk->end;
+	while (cur < end)
 	{
-		uint32_t index = 0;
-		if (buf[index] == 'v')
+		cur = OBJSkipSpaces(cur, end);
+		if (cur == end)
+			break;
+
+		const char* next = cur + 1;
+		if (*cur == 'v' && next < end)
 		{
-			++index;
-			if (buf[index] == 'n' || buf[index] == 't')
+			if (OBJIsSpace(*next))
 			{
-				if (buf[index] == 'n')
-					vData.vnExist = true;
-				else if (buf[index] == 't')
-					vData.vtExist = true;
-
-				index = index + 2;
+				cur = OBJParseVertex(cur, end, &chunk->vData);
 			}
-			else
+			else if ((*next == 'n' || *next == 't') && next + 1 < end && OBJIsSpace(next[1]))
 			{
-				++index;
-			}
+				if (*next == 'n')
+					chunk->vData.vnExist = true;
+				else
+					chunk->vData.vtExist = true;
 
-			if (buf[index] == '-' || (buf[index] >= '0' && buf[index] <= '9'))
-			{
-				OBJParseVertex(buf, &vData);
+				cur = OBJParseVertex(cur, end, &chunk->vData);
 			}
 		}
-		else if (buf[index] == 'f')
+		else if (*cur == 'f' && next < end && OBJIsSpace(*next))
 		{
-			if (firstFace == true)
-			{
-				uint32_t i = 0;
-				while (buf[i] != '\0')
-				{
-					if (buf[i] == ' ')
-						++numIndicesPerFace;
+			uint32_t numFaceIndices = 0;
+			cur = OBJParseFace(cur, end, chunk, &numFaceIndices);
+			arrpush(chunk->faceSizes, numFaceIndices);
+		}
+		else if (*cur == 'o' || *cur == 'g' || *cur == 'u' || *cur == 'm')
+		{
+			const char* wordEnd = OBJFindWordEnd(cur, end);
+			if (OBJIsKeyword(cur, wordEnd, "o"))
+				cur = OBJParseStatement(wordEnd, end, OBJ_STATEMENT_OBJECT, chunk);
+			else if (OBJIsKeyword(cur, wordEnd, "g"))
+				cur = OBJParseStatement(wordEnd, end, OBJ_STATEMENT_GROUP, chunk);
+			else if (OBJIsKeyword(cur, wordEnd, "usemtl"))
+				cur = OBJParseStatement(wordEnd, end, OBJ_STATEMENT_USE_MATERIAL, chunk);
+			else if (OBJIsKeyword(cur, wordEnd, "mtllib"))
+				cur = OBJParseStatement(wordEnd, end, OBJ_STATEMENT_MATERIAL_LIBRARY, chunk);
+		}
 
-					++i;
-				}
-				firstFace = false;
-			}
+		//Skip the rest of the line. Comments and unsupported statements are skipped entirely.
+		cur = OBJFindLineEnd(cur, end);
+		if (cur < end)
+			++cur;
+	}
+}
 
-			index = index + 2;
-			if (buf[index] >= '0' && buf[index] <= '9')
-			{
-				OBJParseFace(buf, &faces);
-			}
+void OBJParseChunkThread(void* data)
+{
+	OBJParseChunk((OBJChunk*)data);
+}
+
+//Appends a stb_ds array to another one.
+template<typename T>
+void OBJAppend(T** dest, T* src)
+{
+	size_t length = arrlenu(src);
+	if (length == 0)
+		return;
+
+	size_t offset = arrlenu(*dest);
+	arrsetlen(*dest, offset + length);
+	memcpy(*dest + offset, src, length * sizeof(T));
+}
+
+//Concatenates the chunks in file order.
+//The relative indices and statements of each chunk are rebased by the number of elements in the chunks before it.
+void OBJMergeChunks(OBJChunk* chunks, uint32_t numChunks, OBJVertexData* outVData, OBJFace** outFaces, uint32_t** outFaceSizes,
+	OBJStatement** outStatements)
+{
+	size_t numV = 0;
+	size_t numVt = 0;
+	size_t numVn = 0;
+	size_t numFaces = 0;
+	for (uint32_t i = 0; i < numChunks; ++i)
+	{
+		numV += arrlenu(chunks[i].vData.v);
+		numVt += arrlenu(chunks[i].vData.vt);
+		numVn += arrlenu(chunks[i].vData.vn);
+		numFaces += arrlenu(chunks[i].faces);
+	}
+
+	OBJVertexData vData;
+	OBJFace* faces = nullptr;
+	arrsetcap(vData.v, numV);
+	arrsetcap(vData.vt, numVt);
+	arrsetcap(vData.vn, numVn);
+	arrsetcap(faces, numFaces);
+
+	uint32_t* faceSizes = nullptr;
+	OBJStatement* statements = nullptr;
+	for (uint32_t i = 0; i < numChunks; ++i)
+	{
+		OBJChunk* chunk = &chunks[i];
+
+		//The face indices of the statements are rebased like the relative indices
+		uint32_t faceBase = (uint32_t)arrlenu(faceSizes);
+		for (uint32_t j = 0; j < arrlenu(chunk->statements); ++j)
+			chunk->statements[j].faceIndex += faceBase;
+
+		int32_t base[3] = { (int32_t)arrlen(vData.v), (int32_t)arrlen(vData.vt), (int32_t)arrlen(vData.vn) };
+		for (uint32_t j = 0; j < arrlenu(chunk->relativeIndices); ++j)
+		{
+			uint32_t faceIndex = chunk->relativeIndices[j] / 3;
+			uint32_t component = chunk->relativeIndices[j] % 3;
+			int32_t* index = &chunk->faces[faceIndex].vIndex;
+			index[component] += base[component];
 		}
+
+		OBJAppend(&vData.v, chunk->vData.v);
+		OBJAppend(&vData.vt, chunk->vData.vt);
+		OBJAppend(&vData.vn, chunk->vData.vn);
+		OBJAppend(&faces, chunk->faces);
+
+		vData.vnExist |= chunk->vData.vnExist;
+		vData.vtExist |= chunk->vData.vtExist;
+
+		OBJAppend(&faceSizes, chunk->faceSizes);
+		OBJAppend(&statements, chunk->statements);
+
+		arrfree(chunk->vData.v);
+		arrfree(chunk->vData.vt);
+		arrfree(chunk->vData.vn);
+		arrfree(chunk->faces);
+		arrfree(chunk->relativeIndices);
+		arrfree(chunk->faceSizes);
+		arrfree(chunk->statements);
 	}
 
-	Vertex* vertexList = (Vertex*)calloc(arrlenu(vData.v), sizeof(Vertex));
-	for (uint32_t i = 0; i < arrlenu(faces); i = i + numIndicesPerFace)
+	*outVData = vData;
+	*outFaces = faces;
+	*outFaceSizes = faceSizes;
+	*outStatements = statements;
+}
+
+//Hashes a (v, vt, vn) index triple.
+inline uint32_t OBJHashFace(const OBJFace* face)
+{
+	uint32_t hash = (uint32_t)face->vIndex * 0x9E3779B1u;
+	hash ^= (uint32_t)face->vtIndex * 0x85EBCA77u;
+	hash ^= (uint32_t)face->vnIndex * 0xC2B2AE3Du;
+	hash ^= hash >> 15;
+
+	return hash;
+}
+
+inline bool OBJFaceEqual(const OBJFace* a, const OBJFace* b)
+{
+	return a->vIndex == b->vIndex && a->vtIndex == b->vtIndex && a->vnIndex == b->vnIndex;
+}
+
+//Creates one vertex for every distinct (v, vt, vn) triple referenced by the faces and appends it to vertices.
+//outCornerVertices receives the index of the welded vertex of every face corner, relative to the first appended vertex.
+//outPositionIndices receives the position index of every appended vertex.
+//The lookup is an open-addressing hash map with linear probing. The table only stores vertex indices,
+//the keys are kept in a separate array in vertex order.
+void OBJWeldVertices(const char* filename, const OBJVertexData* vData, const OBJFace* faces, uint32_t numCorners,
+	Vertex** vertices, uint32_t* outCornerVertices, uint32_t** outPositionIndices)
+{
+	const uint32_t emptySlot = 0xFFFFFFFF;
+
+	//At most half full
+	uint32_t capacity = 16;
+	while (capacity < numCorners * 2)
+		capacity = capacity << 1;
+
+	uint32_t mask = capacity - 1;
+	uint32_t* table = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+	memset(table, 0xFF, capacity * sizeof(uint32_t));
+
+	int32_t numV = (int32_t)arrlen(vData->v);
+	int32_t numVt = (int32_t)arrlen(vData->vt);
+	int32_t numVn = (int32_t)arrlen(vData->vn);
+
+	OBJFace* keys = nullptr; //a stb_ds array
+	for (uint32_t i = 0; i < numCorners; ++i)
 	{
-		for (uint32_t j = 0; j < numIndicesPerFace; ++j)
+		const OBJFace* face = &faces[i];
+
+		bool vtExist = face->vtIndex != -1;
+		bool vnExist = face->vnIndex != -1;
+		if (face->vIndex < 1 || face->vIndex > numV ||
+			(vtExist == true && (face->vtIndex < 1 || face->vtIndex > numVt)) ||
+			(vnExist == true && (face->vnIndex < 1 || face->vnIndex > numVn)))
+		{
+			char errorMsg[256]{};
+			strcat_s(errorMsg, "Invalid face index in file ");
+			strcat_s(errorMsg, filename);
+			strcat_s(errorMsg, ". Exiting prorgam.");
+			MessageBoxA(nullptr, errorMsg, "OBJ parse error.", MB_OK);
+			exit(-1);
+		}
+
+		uint32_t slot = OBJHashFace(face) & mask;
+		while (table[slot] != emptySlot && OBJFaceEqual(&keys[table[slot]], face) == false)
+			slot = (slot + 1) & mask;
+
+		if (table[slot] == emptySlot)
 		{
-			int32_t vIndex = faces[i + j].vIndex - 1;
-			vec3 v = vData.v[vIndex];
-			vertexList[vIndex].position = vec4(v.GetX(), v.GetY(), v.GetZ(), 1.0f);
+			table[slot] = (uint32_t)arrlenu(keys);
+			arrpush(keys, *face);
+			arrpush(*outPositionIndices, face->vIndex - 1);
 
-			int32_t vnIndex = faces[i + j].vnIndex - 1;
-			if (vnIndex > -1)
+			Vertex vertex{};
+			vec3 v = vData->v[face->vIndex - 1];
+			vertex.position = vec4(v.GetX(), v.GetY(), v.GetZ(), 1.0f);
+
+			if (vnExist == true)
 			{
-				vec3 vn = vData.vn[vnIndex];
-				vertexList[vnIndex].normal = vec4(vn.GetX(), vn.GetY(), vn.GetZ(), 0.0f);
+				vec3 vn = vData->vn[face->vnIndex - 1];
+				vertex.normal = vec4(vn.GetX(), vn.GetY(), vn.GetZ(), 0.0f);
 			}
 
-			int32_t vtIndex = faces[i + j].vtIndex - 1;
-			if (vtIndex > -1)
-				vertexList[vtIndex].texCoords = vData.vt[vtIndex];
+			if (vtExist == true)
+				vertex.texCoords = vData->vt[face->vtIndex - 1];
+
+			arrpush(*vertices, vertex);
 		}
 
-		if (numIndicesPerFace == 3)
-		{
-			int32_t vIndex = faces[i].vIndex - 1;
-			arrpush(*indices, vIndex);
+		outCornerVertices[i] = table[slot];
+	}
 
-			vIndex = faces[i + 1].vIndex - 1;
-			arrpush(*indices, vIndex);
+	free(table);
+	arrfree(keys);
+}
 
-			vIndex = faces[i + 2].vIndex - 1;
-			arrpush(*indices, vIndex);
-		}
-		else if (numIndicesPerFace == 4)
-		{
-			//0 1 2
-			//abc
-			int32_t vIndex = faces[i].vIndex - 1;
-			arrpush(*indices, vIndex);
+struct OBJPoint
+{
+	float x;
+	float y;
+};
+
+//Twice the signed area of the triangle abc. Positive if abc is counterclockwise.
+inline float OBJCross(OBJPoint a, OBJPoint b, OBJPoint c)
+{
+	return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
 
-			vIndex = faces[i + 1].vIndex - 1;
-			arrpush(*indices, vIndex);
+inline bool OBJPointInTriangle(OBJPoint p, OBJPoint a, OBJPoint b, OBJPoint c)
+{
+	return OBJCross(a, b, p) >= 0.0f && OBJCross(b, c, p) >= 0.0f && OBJCross(c, a, p) >= 0.0f;
+}
 
-			vIndex = faces[i + 2].vIndex - 1;
-			arrpush(*indices, vIndex);
+//Appends the triangles of a face with numCorners corners to indices. The winding of the face is kept.
+//The face is projected onto the plane of its largest normal component.
+//Convex faces are fan triangulated, concave faces are ear clipped.
+void OBJTriangulateFace(const Vertex* vertexList, const uint32_t* corners, uint32_t numCorners, uint32_t** indices,
+	OBJPoint** scratchPoints, uint32_t** scratchCorners)
+{
+	if (numCorners < 3)
+		return;
 
-			//0 2 3
-			//acd
-			vIndex = faces[i].vIndex - 1;
-			arrpush(*indices, vIndex);
+	if (numCorners == 3)
+	{
+		arrpush(*indices, corners[0]);
+		arrpush(*indices, corners[1]);
+		arrpush(*indices, corners[2]);
+		return;
+	}
 
-			vIndex = faces[i + 2].vIndex - 1;
-			arrpush(*indices, vIndex);
+	//Newell's method gives the normal of a non-planar or concave polygon
+	float nx = 0.0f;
+	float ny = 0.0f;
+	float nz = 0.0f;
+	for (uint32_t i = 0; i < numCorners; ++i)
+	{
+		vec4 p0 = vertexList[corners[i]].position;
+		vec4 p1 = vertexList[corners[(i + 1) % numCorners]].position;
+		nx += (p0.GetY() - p1.GetY()) * (p0.GetZ() + p1.GetZ());
+		ny += (p0.GetZ() - p1.GetZ()) * (p0.GetX() + p1.GetX());
+		nz += (p0.GetX() - p1.GetX()) * (p0.GetY() + p1.GetY());
+	}
 
-			vIndex = faces[i + 3].vIndex - 1;
-			arrpush(*indices, vIndex);
-		}
+	//Drop the axis of the largest normal component. Flip the other axis if needed so the face is counterclockwise.
+	float ax = fabsf(nx);
+	float ay = fabsf(ny);
+	float az = fabsf(nz);
+	uint32_t u = 0;
+	uint32_t v = 1;
+	float sign = nz;
+	if (ax >= ay && ax >= az)
+	{
+		u = 1;
+		v = 2;
+		sign = nx;
+	}
+	else if (ay >= az)
+	{
+		u = 2;
+		v = 0;
+		sign = ny;
 	}
 
-	for (uint32_t i = 0; i < arrlenu(faces); i = i + 3)
+	arrsetlen(*scratchPoints, numCorners);
+	OBJPoint* points = *scratchPoints;
+	for (uint32_t i = 0; i < numCorners; ++i)
 	{
-		Triangle triangle{};
-		CreateTriangle(&triangle, vertexList, faces[i].vIndex - 1, faces[i + 1].vIndex - 1, faces[i + 2].vIndex - 1);
+		vec4 p = vertexList[corners[i]].position;
+		float coords[3] = { p.GetX(), p.GetY(), p.GetZ() };
+		points[i].x = coords[u];
+		points[i].y = (sign < 0.0f) ? -coords[v] : coords[v];
+	}
 
-		uint32_t i0 = triangle.i0;
-		uint32_t i1 = triangle.i1;
-		uint32_t i2 = triangle.i2;
+	bool convex = true;
+	for (uint32_t i = 0; i < numCorners && convex == true; ++i)
+		convex = OBJCross(points[i], points[(i + 1) % numCorners], points[(i + 2) % numCorners]) >= 0.0f;
 
-		if (vData.vnExist == false)
+	//Degenerate faces have no orientation to clip against
+	if (convex == true || sign == 0.0f)
+	{
+		for (uint32_t i = 1; i < numCorners - 1; ++i)
 		{
-			vec4 normal;
-			normal = ComputeNormal(&triangle);
-			vertexList[i0].normal += normal;
-			vertexList[i1].normal += normal;
-			vertexList[i2].normal += normal;
+			arrpush(*indices, corners[0]);
+			arrpush(*indices, corners[i]);
+			arrpush(*indices, corners[i + 1]);
 		}
-
-		vec4 tangent;
-		tangent = ComputeTangent(&triangle);
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
+		return;
 	}
 
-	for (uint32_t i = 0; i < arrlenu(vData.v); ++i)
+	//Ear clipping
+	//remaining holds the positions in the face of the corners that haven't been clipped
+	arrsetlen(*scratchCorners, numCorners);
+	uint32_t* remaining = *scratchCorners;
+	for (uint32_t i = 0; i < numCorners; ++i)
+		remaining[i] = i;
+
+	uint32_t numRemaining = numCorners;
+	uint32_t i = 0;
+	uint32_t numTries = 0;
+	while (numRemaining > 3)
 	{
-		if (vData.vnExist == false)
-			vertexList[i].normal = Normalize(vertexList[i].normal);
+		uint32_t prev = remaining[(i + numRemaining - 1) % numRemaining];
+		uint32_t cur = remaining[i];
+		uint32_t next = remaining[(i + 1) % numRemaining];
 
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
-		arrpush(*vertices, vertexList[i]);
+		bool ear = OBJCross(points[prev], points[cur], points[next]) > 0.0f;
+		for (uint32_t j = 0; j < numRemaining && ear == true; ++j)
+		{
+			uint32_t k = remaining[j];
+			if (k != prev && k != cur && k != next)
+				ear = !OBJPointInTriangle(points[k], points[prev], points[cur], points[next]);
+		}
+
+		if (ear == true)
+		{
+			arrpush(*indices, corners[prev]);
+			arrpush(*indices, corners[cur]);
+			arrpush(*indices, corners[next]);
+
+			memmove(&remaining[i], &remaining[i + 1], (numRemaining - i - 1) * sizeof(uint32_t));
+			--numRemaining;
+			i = (i < numRemaining) ? i : 0;
+			numTries = 0;
+		}
+		else
+		{
+			i = (i + 1) % numRemaining;
+
+			//No ear left because the face intersects itself, fan the rest
+			if (++numTries > numRemaining)
+				break;
+		}
+	}
+
+	for (uint32_t j = 1; j < numRemaining - 1; ++j)
+	{
+		arrpush(*indices, corners[remaining[0]]);
+		arrpush(*indices, corners[remaining[j]]);
+		arrpush(*indices, corners[remaining[j + 1]]);
+	}
+}
+
+//Stores the filename relative to the directory of baseFilename in outPath. Absolute filenames are copied unchanged.
+void OBJResolvePath(const char* baseFilename, const char* begin, const char* end, char* outPath)
+{
+	bool absolute = (begin < end && (*begin == '/' || *begin == '\\')) || (end - begin > 1 && begin[1] == ':');
+
+	size_t directoryLength = 0;
+	if (absolute == false)
+	{
+		for (size_t i = 0; baseFilename[i] != '\0'; ++i)
+		{
+			if (baseFilename[i] == '/' || baseFilename[i] == '\\')
+				directoryLength = i + 1;
+		}
+	}
+
+	OBJCopyString(outPath, MAX_FILE_PATH, baseFilename, baseFilename + directoryLength);
+	directoryLength = strlen(outPath);
+	OBJCopyString(outPath + directoryLength, MAX_FILE_PATH - directoryLength, begin, end);
+}
+
+bool ParseMTL(const char* filename, MeshMaterial** materials)
+{
+	SEFileStats stats{};
+	if (GetFileStats(filename, &stats) == false)
+		return false;
+
+	SEMappedFile file{};
+	MapFile(filename, &file);
+
+	const char* cur = file.data;
+	const char* end = file.data + file.size;
+
+	//Index of the material of the last newmtl, the statements before the first one are ignored
+	size_t current = arrlenu(*materials);
+	bool firstMaterial = true;
+
+	//Pr overrides the roughness derived from Ns wherever it is in the material
+	bool roughnessFromPr = false;
+	while (cur < end)
+	{
+		cur = OBJSkipSpaces(cur, end);
+		const char* lineEnd = OBJFindLineEnd(cur, end);
+		const char* wordEnd = OBJFindWordEnd(cur, lineEnd);
+
+		const char* argument = OBJSkipSpaces(wordEnd, lineEnd);
+		const char* argumentEnd = lineEnd;
+		while (argumentEnd > argument && (OBJIsSpace(argumentEnd[-1]) || argumentEnd[-1] == '\r'))
+			--argumentEnd;
+
+		if (OBJIsKeyword(cur, wordEnd, "newmtl"))
+		{
+			if (firstMaterial == false)
+				++current;
+
+			MeshMaterial material{};
+			OBJCopyString(material.name, MESH_MAX_NAME_LENGTH, argument, argumentEnd);
+			arrpush(*materials, material);
+
+			firstMaterial = false;
+			roughnessFromPr = false;
+		}
+		else if (firstMaterial == false)
+		{
+			MeshMaterial* material = &(*materials)[current];
+
+			//Texture statements can have options before the filename, the filename is the last word
+			const char* lastWord = argumentEnd;
+			while (lastWord > argument && !OBJIsSpace(lastWord[-1]))
+				--lastWord;
+
+			float value = 0.0f;
+			bool hasValue = ParseFloat(argument, argumentEnd, &value) != argument;
+
+			if (OBJIsKeyword(cur, wordEnd, "Kd") && hasValue == true)
+			{
+				//Kd r [g b], g and b default to r
+				float color[3] = { value, value, value };
+				const char* next = ParseFloat(argument, argumentEnd, &color[0]);
+				for (uint32_t i = 1; i < 3; ++i)
+				{
+					const char* valueBegin = OBJSkipSpaces(next, argumentEnd);
+					next = ParseFloat(valueBegin, argumentEnd, &color[i]);
+					if (next == valueBegin)
+						color[i] = color[0];
+				}
+
+				material->albedo = vec4(color[0], color[1], color[2], material->albedo.GetW());
+			}
+			else if (OBJIsKeyword(cur, wordEnd, "d") && hasValue == true)
+			{
+				material->albedo.SetW(value);
+			}
+			else if (OBJIsKeyword(cur, wordEnd, "Tr") && hasValue == true)
+			{
+				material->albedo.SetW(1.0f - value);
+			}
+			else if (OBJIsKeyword(cur, wordEnd, "Ns") && hasValue == true)
+			{
+				//Blinn-Phong exponent to roughness, the exponent 2 / roughness^2 - 2 has the same highlight width
+				if (roughnessFromPr == false)
+					material->roughness = sqrtf(2.0f / (((value > 0.0f) ? value : 0.0f) + 2.0f));
+			}
+			else if (OBJIsKeyword(cur, wordEnd, "Pr") && hasValue == true)
+			{
+				material->roughness = value;
+				roughnessFromPr = true;
+			}
+			else if (OBJIsKeyword(cur, wordEnd, "Pm") && hasValue == true)
+			{
+				material->metallic = value;
+			}
+			else if (lastWord < argumentEnd)
+			{
+				char* map = nullptr;
+				if (OBJIsKeyword(cur, wordEnd, "map_Kd"))
+					map = material->albedoMap;
+				else if (OBJIsKeyword(cur, wordEnd, "map_Bump") || OBJIsKeyword(cur, wordEnd, "map_bump") ||
+					OBJIsKeyword(cur, wordEnd, "bump") || OBJIsKeyword(cur, wordEnd, "norm"))
+					map = material->normalMap;
+				else if (OBJIsKeyword(cur, wordEnd, "map_Pr"))
+					map = material->roughnessMap;
+				else if (OBJIsKeyword(cur, wordEnd, "map_Pm"))
+					map = material->metallicMap;
+
+				if (map != nullptr)
+					OBJResolvePath(filename, lastWord, argumentEnd, map);
+			}
+		}
+
+		cur = (lineEnd < end) ? lineEnd + 1 : end;
+	}
+
+	UnmapFile(&file);
+
+	return true;
+}
+
+//Assigns every face to a submesh. outFaceSubmeshes receives the submesh index of every face.
+//The material libraries are loaded before any usemtl is resolved, so the order of mtllib and usemtl doesn't matter.
+void OBJResolveSubmeshes(const char* filename, const OBJStatement* statements, uint32_t numStatements, uint32_t numFaces,
+	uint32_t* outFaceSubmeshes, MeshSubmesh** outSubmeshes, MeshMaterial** outMaterials, MeshCacheDependency** outDependencies)
+{
+	for (uint32_t i = 0; i < numStatements; ++i)
+	{
+		if (statements[i].type != OBJ_STATEMENT_MATERIAL_LIBRARY)
+			continue;
+
+		char libraryFilename[MAX_FILE_PATH]{};
+		OBJResolvePath(filename, statements[i].name, statements[i].name + strlen(statements[i].name), libraryFilename);
+
+		bool loaded = false;
+		for (uint32_t j = 0; j < arrlenu(*outDependencies) && loaded == false; ++j)
+			loaded = strcmp((*outDependencies)[j].filename, libraryFilename) == 0;
+
+		if (loaded == true)
+			continue;
+
+		//A missing library is still a dependency, the cache is rebuilt when it is added
+		MeshCacheDependency dependency{};
+		GetMeshCacheDependency(libraryFilename, &dependency);
+		arrpush(*outDependencies, dependency);
+
+		ParseMTL(libraryFilename, outMaterials);
+	}
+
+	char objectName[MESH_MAX_NAME_LENGTH]{};
+	char groupName[MESH_MAX_NAME_LENGTH]{};
+	uint32_t materialIndex = MESH_NO_MATERIAL;
+
+	//The submesh is only looked up when a face needs it, so empty groups don't make submeshes
+	const uint32_t noSubmesh = 0xFFFFFFFF;
+	uint32_t submeshIndex = noSubmesh;
+	uint32_t statement = 0;
+	for (uint32_t i = 0; i < numFaces; ++i)
+	{
+		for (; statement < numStatements && statements[statement].faceIndex <= i; ++statement)
+		{
+			const OBJStatement* cur = &statements[statement];
+			if (cur->type == OBJ_STATEMENT_OBJECT)
+			{
+				strcpy_s(objectName, cur->name);
+				groupName[0] = '\0';
+			}
+			else if (cur->type == OBJ_STATEMENT_GROUP)
+			{
+				strcpy_s(groupName, cur->name);
+			}
+			else if (cur->type == OBJ_STATEMENT_USE_MATERIAL)
+			{
+				materialIndex = MESH_NO_MATERIAL;
+				if (cur->name[0] != '\0')
+				{
+					for (uint32_t j = 0; j < arrlenu(*outMaterials) && materialIndex == MESH_NO_MATERIAL; ++j)
+					{
+						if (strcmp((*outMaterials)[j].name, cur->name) == 0)
+							materialIndex = j;
+					}
+
+					if (materialIndex == MESH_NO_MATERIAL)
+					{
+						MeshMaterial material{};
+						strcpy_s(material.name, cur->name);
+						materialIndex = (uint32_t)arrlenu(*outMaterials);
+						arrpush(*outMaterials, material);
+					}
+				}
+			}
+			else
+			{
+				continue;
+			}
+
+			submeshIndex = noSubmesh;
+		}
+
+		if (submeshIndex == noSubmesh)
+		{
+			const char* name = (groupName[0] != '\0') ? groupName : objectName;
+			for (uint32_t j = 0; j < arrlenu(*outSubmeshes) && submeshIndex == noSubmesh; ++j)
+			{
+				if ((*outSubmeshes)[j].materialIndex == materialIndex && strcmp((*outSubmeshes)[j].name, name) == 0)
+					submeshIndex = j;
+			}
+
+			if (submeshIndex == noSubmesh)
+			{
+				MeshSubmesh submesh{};
+				submesh.materialIndex = materialIndex;
+				strcpy_s(submesh.name, name);
+				submeshIndex = (uint32_t)arrlenu(*outSubmeshes);
+				arrpush(*outSubmeshes, submesh);
+			}
+		}
+
+		outFaceSubmeshes[i] = submeshIndex;
+	}
+}
+
+//Runs OptimizeVertexCache and OptimizeOverdraw on the triangles of every submesh and OptimizeVertexFetch on the whole mesh,
+//so no triangle leaves the range of its submesh. Stores the bounds of every submesh.
+//Each submesh is remapped to its own vertices first, so the cost doesn't grow with the number of vertices of the other submeshes.
+void OBJOptimizeSubmeshes(Vertex* vertices, uint32_t numVertices, uint32_t* indices, uint32_t numIndices,
+	MeshSubmesh* submeshes, uint32_t numSubmeshes)
+{
+	const uint32_t unused = 0xFFFFFFFF;
+
+	uint32_t* localIndices = (uint32_t*)malloc(((numVertices > 0) ? numVertices : 1) * sizeof(uint32_t));
+	memset(localIndices, 0xFF, numVertices * sizeof(uint32_t));
+
+	uint32_t* globalIndices = nullptr; //a stb_ds array
+	Vertex* localVertices = nullptr; //a stb_ds array
+	uint32_t* clusters = nullptr; //a stb_ds array
+	for (uint32_t i = 0; i < numSubmeshes; ++i)
+	{
+		uint32_t* range = indices + submeshes[i].indexOffset;
+		uint32_t count = submeshes[i].indexCount;
+
+		arrsetlen(globalIndices, 0);
+		arrsetlen(localVertices, 0);
+		for (uint32_t j = 0; j < count; ++j)
+		{
+			uint32_t vertex = range[j];
+			if (localIndices[vertex] == unused)
+			{
+				localIndices[vertex] = (uint32_t)arrlenu(globalIndices);
+				arrpush(globalIndices, vertex);
+				arrpush(localVertices, vertices[vertex]);
+			}
+
+			range[j] = localIndices[vertex];
+		}
+
+		uint32_t numLocalVertices = (uint32_t)arrlenu(localVertices);
+		if (count >= 3)
+		{
+			arrsetlen(clusters, count / 3);
+			uint32_t numClusters = OptimizeVertexCache(range, count, numLocalVertices, MESH_OPTIMIZER_CACHE_SIZE, clusters);
+			OptimizeOverdraw(range, count, localVertices, numLocalVertices, clusters, numClusters,
+				MESH_OPTIMIZER_CACHE_SIZE, MESH_OPTIMIZER_OVERDRAW_THRESHOLD);
+		}
+
+		ComputeMeshBounds(localVertices, numLocalVertices, &submeshes[i].bounds);
+
+		for (uint32_t j = 0; j < count; ++j)
+			range[j] = globalIndices[range[j]];
+
+		for (uint32_t j = 0; j < numLocalVertices; ++j)
+			localIndices[globalIndices[j]] = unused;
+	}
+
+	OptimizeVertexFetch(vertices, numVertices, indices, numIndices);
+
+	free(localIndices);
+	arrfree(globalIndices);
+	arrfree(localVertices);
+	arrfree(clusters);
+}
+
+void ParseOBJ(const char* filename, Vertex** vertices, uint32_t** indices, uint32_t* numVertices, uint32_t* numIndices,
+	uint32_t flags, MeshBounds* outBounds, MeshSubmesh** outSubmeshes, MeshMaterial** outMaterials)
+{
+	char cacheFilename[MAX_FILE_PATH]{};
+	SEFileStats sourceStats{};
+	if (flags & OBJ_PARSE_FLAGS_CACHE)
+	{
+		GetMeshCacheFilename(filename, cacheFilename);
+		GetFileStats(filename, &sourceStats);
+
+		MeshCache cache{};
+		if (LoadMeshCache(cacheFilename, filename, &cache) == true)
+		{
+			uint32_t vertexOffset = (uint32_t)arrlenu(*vertices);
+			uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+			arrsetlen(*vertices, vertexOffset + cache.header->numVertices);
+			arrsetlen(*indices, indexOffset + cache.header->numIndices);
+			memcpy(*vertices + vertexOffset, cache.vertices, cache.header->numVertices * sizeof(Vertex));
+			memcpy(*indices + indexOffset, cache.indices, cache.header->numIndices * sizeof(uint32_t));
+
+			*numVertices = cache.header->numVertices;
+			*numIndices = cache.header->numIndices;
+			if (outBounds != nullptr)
+				*outBounds = cache.header->bounds;
+
+			for (uint32_t i = 0; i < cache.header->numSubmeshes && outSubmeshes != nullptr; ++i)
+				arrpush(*outSubmeshes, cache.submeshes[i]);
+
+			for (uint32_t i = 0; i < cache.header->numMaterials && outMaterials != nullptr; ++i)
+				arrpush(*outMaterials, cache.materials[i]);
+
+			UnloadMeshCache(&cache);
+
+			return;
+		}
+	}
+
+	SEMappedFile file{};
+	MapFile(filename, &file);
+
+	const char* begin = file.data;
+	const char* end = file.data + file.size;
+
+	//Small files aren't worth the cost of starting threads
+	uint32_t numChunks = 1;
+	if (flags & OBJ_PARSE_FLAGS_MULTITHREADED)
+	{
+		uint64_t maxChunks = file.size / OBJ_MIN_CHUNK_SIZE;
+		numChunks = GetNumLogicalCores();
+		if (numChunks > OBJ_MAX_CHUNKS)
+			numChunks = OBJ_MAX_CHUNKS;
+		if (numChunks > maxChunks)
+			numChunks = (maxChunks > 0) ? (uint32_t)maxChunks : 1;
+	}
+
+	//Split the file into chunks that start at the beginning of a line
+	OBJChunk chunks[OBJ_MAX_CHUNKS]{};
+	const char* chunkBegin = begin;
+	for (uint32_t i = 0; i < numChunks; ++i)
+	{
+		const char* chunkEnd = end;
+		if (i < numChunks - 1)
+		{
+			chunkEnd = begin + (file.size * (i + 1)) / numChunks;
+			if (chunkEnd < chunkBegin)
+				chunkEnd = chunkBegin;
+
+			chunkEnd = OBJFindLineEnd(chunkEnd, end);
+			if (chunkEnd < end)
+				++chunkEnd;
+		}
+
+		chunks[i].begin = chunkBegin;
+		chunks[i].end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	//The first chunk is parsed on the calling thread
+	Thread threads[OBJ_MAX_CHUNKS]{};
+	for (uint32_t i = 1; i < numChunks; ++i)
+		StartThread(&threads[i], OBJParseChunkThread, &chunks[i]);
+
+	OBJParseChunk(&chunks[0]);
+
+	for (uint32_t i = 1; i < numChunks; ++i)
+		JoinThread(&threads[i]);
+
+	OBJVertexData vData;
+	OBJFace* faces = nullptr; //a stb_ds array
+	uint32_t* faceSizes = nullptr; //a stb_ds array
+	OBJStatement* statements = nullptr; //a stb_ds array
+	OBJMergeChunks(chunks, numChunks, &vData, &faces, &faceSizes, &statements);
+
+	uint64_t sourceHash = 0;
+	if (flags & OBJ_PARSE_FLAGS_CACHE)
+		sourceHash = HashMemory(file.data, file.size);
+
+	UnmapFile(&file);
+
+	uint32_t numCorners = (uint32_t)arrlenu(faces);
+	uint32_t vertexOffset = (uint32_t)arrlenu(*vertices);
+	uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+
+	//Weld the corners of the faces into unique vertices
+	uint32_t* cornerVertices = (uint32_t*)malloc(numCorners * sizeof(uint32_t));
+	uint32_t* positionIndices = nullptr; //a stb_ds array
+	OBJWeldVertices(filename, &vData, faces, numCorners, vertices, cornerVertices, &positionIndices);
+
+	Vertex* vertexList = *vertices + vertexOffset;
+	uint32_t numUniqueVertices = (uint32_t)arrlenu(*vertices) - vertexOffset;
+
+	//Group the faces into submeshes
+	uint32_t numFaces = (uint32_t)arrlenu(faceSizes);
+	uint32_t* faceSubmeshes = (uint32_t*)malloc(((numFaces > 0) ? numFaces : 1) * sizeof(uint32_t));
+	MeshSubmesh* submeshes = nullptr; //a stb_ds array
+	MeshMaterial* materials = nullptr; //a stb_ds array
+	MeshCacheDependency* dependencies = nullptr; //a stb_ds array
+	OBJResolveSubmeshes(filename, statements, (uint32_t)arrlenu(statements), numFaces, faceSubmeshes, &submeshes, &materials, &dependencies);
+	uint32_t numSubmeshes = (uint32_t)arrlenu(submeshes);
+
+	//Sort the faces by submesh with a counting sort, the faces of a submesh stay in file order
+	uint32_t* faceCorners = (uint32_t*)malloc(((numFaces > 0) ? numFaces : 1) * sizeof(uint32_t));
+	uint32_t* submeshFaces = (uint32_t*)calloc(numSubmeshes + 1, sizeof(uint32_t));
+	uint32_t* sortedFaces = (uint32_t*)malloc(((numFaces > 0) ? numFaces : 1) * sizeof(uint32_t));
+	uint32_t corner = 0;
+	for (uint32_t i = 0; i < numFaces; ++i)
+	{
+		faceCorners[i] = corner;
+		corner += faceSizes[i];
+		++submeshFaces[faceSubmeshes[i] + 1];
+	}
+
+	for (uint32_t i = 0; i < numSubmeshes; ++i)
+		submeshFaces[i + 1] += submeshFaces[i];
+
+	for (uint32_t i = 0; i < numFaces; ++i)
+		sortedFaces[submeshFaces[faceSubmeshes[i]]++] = i;
+
+	//Triangulate the faces. submeshFaces[i] is now the end of submesh i in sortedFaces.
+	OBJPoint* scratchPoints = nullptr; //a stb_ds array
+	uint32_t* scratchCorners = nullptr; //a stb_ds array
+	uint32_t face = 0;
+	for (uint32_t i = 0; i < numSubmeshes; ++i)
+	{
+		submeshes[i].indexOffset = (uint32_t)arrlenu(*indices) - indexOffset;
+		for (; face < submeshFaces[i]; ++face)
+		{
+			uint32_t faceIndex = sortedFaces[face];
+			OBJTriangulateFace(vertexList, &cornerVertices[faceCorners[faceIndex]], faceSizes[faceIndex], indices, &scratchPoints, &scratchCorners);
+		}
+
+		submeshes[i].indexCount = (uint32_t)arrlenu(*indices) - indexOffset - submeshes[i].indexOffset;
+	}
+
+	arrfree(scratchPoints);
+	arrfree(scratchCorners);
+	free(cornerVertices);
+	free(faceSubmeshes);
+	free(faceCorners);
+	free(submeshFaces);
+	free(sortedFaces);
+
+	uint32_t* indexList = *indices + indexOffset;
+	uint32_t numIndexList = (uint32_t)arrlenu(*indices) - indexOffset;
+
+	//Computed normals are accumulated per position so vertices split by a uv seam still share a smooth normal
+	vec4* positionNormals = nullptr;
+	if (vData.vnExist == false)
+		positionNormals = (vec4*)calloc(arrlenu(vData.v), sizeof(vec4));
+
+	uint32_t numTriangles = numIndexList / 3;
+	if (vData.vnExist == false)
+	{
+		vec4* faceNormals = (vec4*)_mm_malloc(numTriangles * sizeof(vec4), 16);
+		ComputeTriangleFrames(vertexList, indexList, numTriangles, faceNormals, nullptr);
+
+		for (uint32_t i = 0; i < numTriangles; ++i)
+		{
+			positionNormals[positionIndices[indexList[i * 3]]] += faceNormals[i];
+			positionNormals[positionIndices[indexList[i * 3 + 1]]] += faceNormals[i];
+			positionNormals[positionIndices[indexList[i * 3 + 2]]] += faceNormals[i];
+		}
+
+		_mm_free(faceNormals);
+	}
+
+	if (vData.vnExist == false)
+	{
+		for (uint32_t i = 0; i < numUniqueVertices; ++i)
+			vertexList[i].normal = Normalize(positionNormals[positionIndices[i]]);
 	}
 
-	*numVertices = arrlenu(vData.v);
-	*numIndices = arrlenu(faces);
-	free(vertexList);
+	ComputeTangentFrames(vertexList, numUniqueVertices, indexList, numTriangles);
+
+	//File order is rarely good for the vertex cache
+	OBJOptimizeSubmeshes(vertexList, numUniqueVertices, indexList, numIndexList, submeshes, numSubmeshes);
+
+	MeshBounds bounds{};
+	if ((flags & OBJ_PARSE_FLAGS_CACHE) || outBounds != nullptr)
+		ComputeMeshBounds(vertexList, numUniqueVertices, &bounds);
+
+	if (outBounds != nullptr)
+		*outBounds = bounds;
+
+	if (flags & OBJ_PARSE_FLAGS_CACHE)
+	{
+		WriteMeshCache(cacheFilename, &sourceStats, sourceHash, vertexList, numUniqueVertices, indexList, numIndexList,
+			submeshes, numSubmeshes, materials, (uint32_t)arrlenu(materials), dependencies, (uint32_t)arrlenu(dependencies), &bounds);
+	}
+
+	if (outSubmeshes != nullptr)
+		OBJAppend(outSubmeshes, submeshes);
+
+	if (outMaterials != nullptr)
+		OBJAppend(outMaterials, materials);
+
+	*numVertices = numUniqueVertices;
+	*numIndices = numIndexList;
+	free(positionNormals);
+	arrfree(positionIndices);
 	arrfree(vData.v);
 	arrfree(vData.vt);
 	arrfree(vData.vn);
 	arrfree(faces);
-}
\ No newline at end of file
+	arrfree(faceSizes);
+	arrfree(statements);
+	arrfree(submeshes);
+	arrfree(materials);
+	arrfree(dependencies);
+}
+
+//Elements of an attribute in one page of the attribute cache of ConvertOBJToMeshCache
+#define OBJ_STREAM_PAGE_ELEMENTS 4096
+
+//Estimated peak bytes per face corner of a block. Covers the corners, the weld tables, the vertices, the indices
+//and the buffers of the normal, tangent and optimizer passes.
+#define OBJ_STREAM_BYTES_PER_CORNER 384
+
+enum OBJStreamFile
+{
+	OBJ_STREAM_FILE_V,
+	OBJ_STREAM_FILE_VT,
+	OBJ_STREAM_FILE_VN,
+	OBJ_STREAM_FILE_FACES,
+	OBJ_STREAM_FILE_FACE_SIZES,
+	OBJ_STREAM_FILE_VERTICES,
+	OBJ_STREAM_FILE_INDICES,
+	OBJ_STREAM_FILE_COUNT
+};
+
+const char* gOBJStreamFileSuffixes[OBJ_STREAM_FILE_COUNT] =
+{
+	".v.tmp", ".vt.tmp", ".vn.tmp", ".faces.tmp", ".facesizes.tmp", ".vertices.tmp", ".indices.tmp"
+};
+
+//A direct-mapped cache of pages of the spilled v, vt and vn arrays.
+//Faces mostly reference attributes defined close to them, so few pages are read more than once.
+struct OBJAttributeCache
+{
+	FILE* files[3];
+	uint32_t elementSizes[3];
+	uint32_t counts[3];
+	uint32_t pageSize;
+	uint32_t numPages;
+	uint8_t* pages;
+
+	//(attribute << 48) | (page + 1) of every slot, 0 if the slot is empty
+	uint64_t* pageKeys;
+
+	//Set if a page couldn't be read. The fetched attributes are zero from then on.
+	bool readFailed;
+};
+
+const float* OBJFetchAttribute(OBJAttributeCache* cache, uint32_t attribute, uint32_t index)
+{
+	uint64_t page = index / OBJ_STREAM_PAGE_ELEMENTS;
+	uint64_t key = ((uint64_t)attribute << 48) | (page + 1);
+	uint32_t slot = (uint32_t)(((key * 0x9E3779B97F4A7C15ull) >> 32) % cache->numPages);
+	uint32_t elementSize = cache->elementSizes[attribute];
+
+	uint8_t* data = cache->pages + (size_t)slot * cache->pageSize;
+	if (cache->pageKeys[slot] != key)
+	{
+		//The last page is shorter, the elements past the end are never fetched
+		uint64_t firstElement = page * OBJ_STREAM_PAGE_ELEMENTS;
+		uint64_t numLeft = cache->counts[attribute] - firstElement;
+		size_t numElements = (size_t)((numLeft < OBJ_STREAM_PAGE_ELEMENTS) ? numLeft : OBJ_STREAM_PAGE_ELEMENTS);
+		bool readFailed = _fseeki64(cache->files[attribute], (int64_t)(firstElement * elementSize), SEEK_SET) != 0;
+		readFailed = readFailed || fread(data, elementSize, numElements, cache->files[attribute]) != numElements;
+		if (readFailed == true)
+		{
+			memset(data, 0, cache->pageSize);
+			cache->readFailed = true;
+			cache->pageKeys[slot] = 0;
+		}
+		else
+		{
+			cache->pageKeys[slot] = key;
+		}
+	}
+
+	return (const float*)(data + (index % OBJ_STREAM_PAGE_ELEMENTS) * elementSize);
+}
+
+//Returns the dense index of key in an open-addressing table and adds it to keys if it isn't in the table.
+inline uint32_t OBJFaceMapInsert(uint32_t* table, uint32_t mask, OBJFace** keys, const OBJFace* key, bool* outInserted)
+{
+	const uint32_t emptySlot = 0xFFFFFFFF;
+
+	uint32_t slot = OBJHashFace(key) & mask;
+	while (table[slot] != emptySlot && OBJFaceEqual(&(*keys)[table[slot]], key) == false)
+		slot = (slot + 1) & mask;
+
+	*outInserted = table[slot] == emptySlot;
+	if (*outInserted == true)
+	{
+		table[slot] = (uint32_t)arrlenu(*keys);
+		arrpush(*keys, *key);
+	}
+
+	return table[slot];
+}
+
+void OBJCloseStreamFiles(FILE** files, const char* cacheFilename)
+{
+	for (uint32_t i = 0; i < OBJ_STREAM_FILE_COUNT; ++i)
+	{
+		if (files[i] == nullptr)
+			continue;
+
+		fclose(files[i]);
+		files[i] = nullptr;
+
+		char tempFilename[MAX_FILE_PATH]{};
+		strcat_s(tempFilename, cacheFilename);
+		strcat_s(tempFilename, gOBJStreamFileSuffixes[i]);
+		remove(tempFilename);
+	}
+}
+
+//Shrinks the sphere of bounds to the one around the center of the box if it is smaller.
+//The sphere merged from the blocks grows with every block, this one only depends on the vertices.
+//Returns false if vertexFile couldn't be read.
+bool OBJFitBoundingSphere(FILE* vertexFile, char* buffer, size_t bufferSize, MeshBounds* bounds)
+{
+	float center[3] = {};
+	for (uint32_t i = 0; i < 3; ++i)
+		center[i] = (bounds->boundsMin[i] + bounds->boundsMax[i]) * 0.5f;
+
+	if (fseek(vertexFile, 0, SEEK_SET) != 0)
+		return false;
+
+	float radiusSq = 0.0f;
+	size_t numRead = 0;
+	while ((numRead = fread(buffer, sizeof(Vertex), bufferSize / sizeof(Vertex), vertexFile)) > 0)
+	{
+		for (size_t i = 0; i < numRead; ++i)
+		{
+			//position is the first member of Vertex
+			const float* position = (const float*)(buffer + i * sizeof(Vertex));
+			float offset[3] = { position[0] - center[0], position[1] - center[1], position[2] - center[2] };
+			float distanceSq = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+			radiusSq = (distanceSq > radiusSq) ? distanceSq : radiusSq;
+		}
+	}
+
+	if (ferror(vertexFile) != 0)
+		return false;
+
+	float radius = sqrtf(radiusSq);
+	if (radius < bounds->radius)
+	{
+		memcpy(bounds->center, center, 3 * sizeof(float));
+		bounds->radius = radius;
+	}
+
+	return true;
+}
+
+//Copies the rest of src to dest through the buffer.
+bool OBJCopyFile(FILE* src, FILE* dest, char* buffer, size_t bufferSize)
+{
+	if (fseek(src, 0, SEEK_SET) != 0)
+		return false;
+
+	size_t numRead = 0;
+	while ((numRead = fread(buffer, 1, bufferSize, src)) > 0)
+	{
+		if (fwrite(buffer, 1, numRead, dest) != numRead)
+			return false;
+	}
+
+	return ferror(src) == 0;
+}
+
+bool ConvertOBJToMeshCache(const char* filename, uint64_t memoryBudget)
+{
+	if (memoryBudget < OBJ_STREAM_MIN_MEMORY_BUDGET)
+		memoryBudget = OBJ_STREAM_MIN_MEMORY_BUDGET;
+
+	char cacheFilename[MAX_FILE_PATH]{};
+	GetMeshCacheFilename(filename, cacheFilename);
+
+	SEFileStats sourceStats{};
+	FILE* source = nullptr;
+	fopen_s(&source, filename, "rb");
+	if (!source || GetFileStats(filename, &sourceStats) == false)
+	{
+		char errorMsg[256]{};
+		strcat_s(errorMsg, "Failed to open file ");
+		strcat_s(errorMsg, filename);
+		strcat_s(errorMsg, ". Exiting prorgam.");
+		MessageBoxA(nullptr, errorMsg, "File open error.", MB_OK);
+		exit(-1);
+	}
+
+	FILE* files[OBJ_STREAM_FILE_COUNT]{};
+	for (uint32_t i = 0; i < OBJ_STREAM_FILE_COUNT; ++i)
+	{
+		char tempFilename[MAX_FILE_PATH]{};
+		strcat_s(tempFilename, cacheFilename);
+		strcat_s(tempFilename, gOBJStreamFileSuffixes[i]);
+		fopen_s(&files[i], tempFilename, "w+b");
+		if (!files[i])
+		{
+			fclose(source);
+			OBJCloseStreamFiles(files, cacheFilename);
+			return false;
+		}
+	}
+
+	//Pass 1: parse the file a window at a time and spill the attributes and faces.
+	//The parsed arrays of a window take a few times the size of the window.
+	size_t windowSize = (size_t)(memoryBudget / 8);
+	char* window = (char*)malloc(windowSize);
+	size_t filled = 0;
+
+	uint64_t sourceHash = HashMemory(nullptr, 0);
+	uint32_t counts[3] = {};
+	uint64_t numFaces = 0;
+	bool vnExist = false;
+	bool writeFailed = false;
+	while (true)
+	{
+		size_t numRead = fread(window + filled, 1, windowSize - filled, source);
+		sourceHash = HashMemory(window + filled, numRead, sourceHash);
+		filled += numRead;
+
+		bool endOfFile = filled < windowSize;
+		if (filled == 0)
+			break;
+
+		//Only complete lines are parsed, the rest is moved to the start of the window
+		const char* end = window + filled;
+		if (endOfFile == false)
+		{
+			while (end > window && end[-1] != '\n')
+				--end;
+
+			//A line longer than the window
+			if (end == window)
+			{
+				windowSize *= 2;
+				window = (char*)realloc(window, windowSize);
+				continue;
+			}
+		}
+
+		OBJChunk chunk{};
+		chunk.begin = window;
+		chunk.end = end;
+		OBJParseChunk(&chunk);
+
+		for (uint32_t j = 0; j < arrlenu(chunk.relativeIndices); ++j)
+		{
+			uint32_t faceIndex = chunk.relativeIndices[j] / 3;
+			uint32_t component = chunk.relativeIndices[j] % 3;
+			int32_t* index = &chunk.faces[faceIndex].vIndex;
+			index[component] += (int32_t)counts[component];
+		}
+
+		size_t lengths[5] = { arrlenu(chunk.vData.v), arrlenu(chunk.vData.vt), arrlenu(chunk.vData.vn), arrlenu(chunk.faces), arrlenu(chunk.faceSizes) };
+		//vec3 is padded in the SIMD math library, only the components are written
+		for (uint32_t j = 0; j < lengths[0]; ++j)
+		{
+			float v[3] = { chunk.vData.v[j].GetX(), chunk.vData.v[j].GetY(), chunk.vData.v[j].GetZ() };
+			writeFailed |= fwrite(v, sizeof(float), 3, files[OBJ_STREAM_FILE_V]) != 3;
+		}
+
+		for (uint32_t j = 0; j < lengths[1]; ++j)
+		{
+			float vt[2] = { chunk.vData.vt[j].GetX(), chunk.vData.vt[j].GetY() };
+			writeFailed |= fwrite(vt, sizeof(float), 2, files[OBJ_STREAM_FILE_VT]) != 2;
+		}
+
+		for (uint32_t j = 0; j < lengths[2]; ++j)
+		{
+			float vn[3] = { chunk.vData.vn[j].GetX(), chunk.vData.vn[j].GetY(), chunk.vData.vn[j].GetZ() };
+			writeFailed |= fwrite(vn, sizeof(float), 3, files[OBJ_STREAM_FILE_VN]) != 3;
+		}
+
+		writeFailed |= fwrite(chunk.faces, sizeof(OBJFace), lengths[3], files[OBJ_STREAM_FILE_FACES]) != lengths[3];
+		writeFailed |= fwrite(chunk.faceSizes, sizeof(uint32_t), lengths[4], files[OBJ_STREAM_FILE_FACE_SIZES]) != lengths[4];
+
+		for (uint32_t j = 0; j < 3; ++j)
+			counts[j] += (uint32_t)lengths[j];
+		numFaces += lengths[4];
+		vnExist |= chunk.vData.vnExist;
+
+		arrfree(chunk.vData.v);
+		arrfree(chunk.vData.vt);
+		arrfree(chunk.vData.vn);
+		arrfree(chunk.faces);
+		arrfree(chunk.relativeIndices);
+		arrfree(chunk.faceSizes);
+		arrfree(chunk.statements);
+
+		filled = window + filled - end;
+		memmove(window, end, filled);
+
+		if (endOfFile == true || writeFailed == true)
+			break;
+	}
+
+	fclose(source);
+
+	if (writeFailed == true)
+	{
+		free(window);
+		OBJCloseStreamFiles(files, cacheFilename);
+		return false;
+	}
+
+	//Pass 2: weld, triangulate and optimize the faces a block at a time.
+	//Half of the budget is for the block, a quarter for the attribute cache.
+	uint32_t cornersPerBlock = (uint32_t)((memoryBudget / 2) / OBJ_STREAM_BYTES_PER_CORNER);
+
+	OBJAttributeCache cache{};
+	cache.files[0] = files[OBJ_STREAM_FILE_V];
+	cache.files[1] = files[OBJ_STREAM_FILE_VT];
+	cache.files[2] = files[OBJ_STREAM_FILE_VN];
+	cache.elementSizes[0] = 3 * sizeof(float);
+	cache.elementSizes[1] = 2 * sizeof(float);
+	cache.elementSizes[2] = 3 * sizeof(float);
+	cache.counts[0] = counts[0];
+	cache.counts[1] = counts[1];
+	cache.counts[2] = counts[2];
+	cache.pageSize = OBJ_STREAM_PAGE_ELEMENTS * 3 * sizeof(float);
+	cache.numPages = (uint32_t)((memoryBudget / 4) / cache.pageSize);
+	cache.pages = (uint8_t*)malloc((size_t)cache.numPages * cache.pageSize);
+	cache.pageKeys = (uint64_t*)calloc(cache.numPages, sizeof(uint64_t));
+
+	for (uint32_t i = 0; i < OBJ_STREAM_FILE_COUNT; ++i)
+		fflush(files[i]);
+
+	//Every read of a spill file is checked, a short read would otherwise publish a cache of garbage
+	bool readFailed = fseek(files[OBJ_STREAM_FILE_FACES], 0, SEEK_SET) != 0;
+	readFailed = readFailed || fseek(files[OBJ_STREAM_FILE_FACE_SIZES], 0, SEEK_SET) != 0;
+
+	OBJFace* corners = nullptr; //a stb_ds array
+	uint32_t* faceSizes = nullptr; //a stb_ds array
+	uint32_t* cornerVertices = nullptr; //a stb_ds array
+	OBJFace* keys = nullptr; //a stb_ds array
+	OBJFace* positionKeys = nullptr; //a stb_ds array
+	uint32_t* vertexPositions = nullptr; //a stb_ds array
+	Vertex* vertices = nullptr; //a stb_ds array
+	uint32_t* indices = nullptr; //a stb_ds array
+	uint32_t* table = nullptr; //a stb_ds array
+	OBJPoint* scratchPoints = nullptr; //a stb_ds array
+	uint32_t* scratchCorners = nullptr; //a stb_ds array
+	MeshSubmesh* submeshes = nullptr; //a stb_ds array
+	arrsetcap(corners, cornersPerBlock);
+	arrsetcap(cornerVertices, cornersPerBlock);
+	arrsetcap(keys, cornersPerBlock);
+	arrsetcap(vertices, cornersPerBlock);
+	arrsetcap(indices, cornersPerBlock * 3);
+
+	MeshBounds bounds{};
+	uint64_t numVertices = 0;
+	uint64_t numIndices = 0;
+	uint64_t numFacesRead = 0;
+	uint32_t nextFaceSize = 0;
+	bool hasNextFaceSize = false;
+	bool tooLarge = false;
+	while (numFacesRead < numFaces && tooLarge == false && writeFailed == false && readFailed == false && cache.readFailed == false)
+	{
+		arrsetlen(corners, 0);
+		arrsetlen(faceSizes, 0);
+		while (numFacesRead < numFaces && readFailed == false)
+		{
+			if (hasNextFaceSize == false)
+			{
+				readFailed = fread(&nextFaceSize, sizeof(uint32_t), 1, files[OBJ_STREAM_FILE_FACE_SIZES]) != 1;
+				hasNextFaceSize = true;
+				if (readFailed == true)
+					break;
+			}
+
+			//A face larger than a block gets a block of its own
+			if (arrlenu(corners) > 0 && arrlenu(corners) + nextFaceSize > cornersPerBlock)
+				break;
+
+			size_t offset = arrlenu(corners);
+			arrsetlen(corners, offset + nextFaceSize);
+			readFailed = fread(corners + offset, sizeof(OBJFace), nextFaceSize, files[OBJ_STREAM_FILE_FACES]) != nextFaceSize;
+			if (readFailed == true)
+				break;
+
+			arrpush(faceSizes, nextFaceSize);
+			hasNextFaceSize = false;
+			++numFacesRead;
+		}
+
+		uint32_t numCorners = (uint32_t)arrlenu(corners);
+
+		//At most half full
+		uint32_t capacity = 16;
+		while (capacity < numCorners * 2)
+			capacity = capacity << 1;
+
+		arrsetlen(table, capacity);
+		memset(table, 0xFF, capacity * sizeof(uint32_t));
+		arrsetlen(keys, 0);
+		arrsetlen(vertices, 0);
+		arrsetlen(cornerVertices, numCorners);
+		for (uint32_t i = 0; i < numCorners; ++i)
+		{
+			const OBJFace* face = &corners[i];
+
+			bool vtExist = face->vtIndex != -1;
+			bool faceVnExist = face->vnIndex != -1;
+			if (face->vIndex < 1 || (uint32_t)face->vIndex > counts[0] ||
+				(vtExist == true && (face->vtIndex < 1 || (uint32_t)face->vtIndex > counts[1])) ||
+				(faceVnExist == true && (face->vnIndex < 1 || (uint32_t)face->vnIndex > counts[2])))
+			{
+				char errorMsg[256]{};
+				strcat_s(errorMsg, "Invalid face index in file ");
+				strcat_s(errorMsg, filename);
+				strcat_s(errorMsg, ". Exiting prorgam.");
+				MessageBoxA(nullptr, errorMsg, "OBJ parse error.", MB_OK);
+				exit(-1);
+			}
+
+			bool inserted = false;
+			cornerVertices[i] = OBJFaceMapInsert(table, capacity - 1, &keys, face, &inserted);
+			if (inserted == true)
+			{
+				Vertex vertex{};
+				const float* v = OBJFetchAttribute(&cache, 0, face->vIndex - 1);
+				vertex.position = vec4(v[0], v[1], v[2], 1.0f);
+
+				if (faceVnExist == true)
+				{
+					const float* vn = OBJFetchAttribute(&cache, 2, face->vnIndex - 1);
+					vertex.normal = vec4(vn[0], vn[1], vn[2], 0.0f);
+				}
+
+				if (vtExist == true)
+				{
+					const float* vt = OBJFetchAttribute(&cache, 1, face->vtIndex - 1);
+					vertex.texCoords = vec2(vt[0], vt[1]);
+				}
+
+				arrpush(vertices, vertex);
+			}
+		}
+
+		uint32_t numBlockVertices = (uint32_t)arrlenu(vertices);
+
+		arrsetlen(indices, 0);
+		uint32_t corner = 0;
+		for (uint32_t i = 0; i < arrlenu(faceSizes); ++i)
+		{
+			OBJTriangulateFace(vertices, &cornerVertices[corner], faceSizes[i], &indices, &scratchPoints, &scratchCorners);
+			corner += faceSizes[i];
+		}
+
+		uint32_t numBlockIndices = (uint32_t)arrlenu(indices);
+		uint32_t numTriangles = numBlockIndices / 3;
+
+		//Computed normals are accumulated per position like in ParseOBJ, but only within the block
+		if (vnExist == false && numTriangles > 0)
+		{
+			capacity = 16;
+			while (capacity < numBlockVertices * 2)
+				capacity = capacity << 1;
+
+			arrsetlen(table, capacity);
+			memset(table, 0xFF, capacity * sizeof(uint32_t));
+			arrsetlen(positionKeys, 0);
+			arrsetlen(vertexPositions, numBlockVertices);
+			for (uint32_t i = 0; i < numBlockVertices; ++i)
+			{
+				OBJFace position{ keys[i].vIndex };
+				bool inserted = false;
+				vertexPositions[i] = OBJFaceMapInsert(table, capacity - 1, &positionKeys, &position, &inserted);
+			}
+
+			vec4* faceNormals = (vec4*)_mm_malloc(numTriangles * sizeof(vec4), 16);
+			vec4* positionNormals = (vec4*)_mm_malloc(arrlenu(positionKeys) * sizeof(vec4), 16);
+			memset(positionNormals, 0, arrlenu(positionKeys) * sizeof(vec4));
+			ComputeTriangleFrames(vertices, indices, numTriangles, faceNormals, nullptr);
+
+			for (uint32_t i = 0; i < numTriangles; ++i)
+			{
+				positionNormals[vertexPositions[indices[i * 3]]] += faceNormals[i];
+				positionNormals[vertexPositions[indices[i * 3 + 1]]] += faceNormals[i];
+				positionNormals[vertexPositions[indices[i * 3 + 2]]] += faceNormals[i];
+			}
+
+			for (uint32_t i = 0; i < numBlockVertices; ++i)
+				vertices[i].normal = Normalize(positionNormals[vertexPositions[i]]);
+
+			_mm_free(faceNormals);
+			_mm_free(positionNormals);
+		}
+
+		ComputeTangentFrames(vertices, numBlockVertices, indices, numTriangles);
+		OptimizeMesh(vertices, numBlockVertices, indices, numBlockIndices);
+
+		MeshSubmesh submesh{};
+		submesh.indexOffset = (uint32_t)numIndices;
+		submesh.indexCount = numBlockIndices;
+		submesh.materialIndex = MESH_NO_MATERIAL;
+		ComputeMeshBounds(vertices, numBlockVertices, &submesh.bounds);
+		MergeMeshBounds(&bounds, &submesh.bounds, &bounds);
+
+		for (uint32_t i = 0; i < numBlockIndices; ++i)
+			indices[i] += (uint32_t)numVertices;
+
+		writeFailed |= fwrite(vertices, sizeof(Vertex), numBlockVertices, files[OBJ_STREAM_FILE_VERTICES]) != numBlockVertices;
+		writeFailed |= fwrite(indices, sizeof(uint32_t), numBlockIndices, files[OBJ_STREAM_FILE_INDICES]) != numBlockIndices;
+
+		arrpush(submeshes, submesh);
+		numVertices += numBlockVertices;
+		numIndices += numBlockIndices;
+		tooLarge = numVertices > 0xFFFFFFFFull || numIndices > 0xFFFFFFFFull;
+	}
+
+	arrfree(corners);
+	arrfree(faceSizes);
+	arrfree(cornerVertices);
+	arrfree(keys);
+	arrfree(positionKeys);
+	arrfree(vertexPositions);
+	arrfree(vertices);
+	arrfree(indices);
+	arrfree(table);
+	arrfree(scratchPoints);
+	arrfree(scratchCorners);
+	free(cache.pages);
+	free(cache.pageKeys);
+
+	//Assemble the cache file from the spilled vertices and indices
+	bool result = writeFailed == false && readFailed == false && cache.readFailed == false && tooLarge == false;
+	if (result == true)
+	{
+		char tempFilename[MAX_FILE_PATH]{};
+		FILE* file = BeginMeshCacheWrite(cacheFilename, tempFilename);
+		result = file != nullptr;
+		if (result == true)
+		{
+			fflush(files[OBJ_STREAM_FILE_VERTICES]);
+			fflush(files[OBJ_STREAM_FILE_INDICES]);
+			result = OBJFitBoundingSphere(files[OBJ_STREAM_FILE_VERTICES], window, windowSize, &bounds);
+
+			MeshCacheHeader header{};
+			InitMeshCacheHeader(&header, &sourceStats, sourceHash, (uint32_t)numVertices, (uint32_t)numIndices,
+				(uint32_t)arrlenu(submeshes), 0, 0, &bounds);
+			result = result && WriteMeshCacheHeader(file, &header, submeshes, nullptr, nullptr);
+			result = result && OBJCopyFile(files[OBJ_STREAM_FILE_VERTICES], file, window, windowSize);
+			result = result && OBJCopyFile(files[OBJ_STREAM_FILE_INDICES], file, window, windowSize);
+			result = EndMeshCacheWrite(file, result, tempFilename, cacheFilename);
+		}
+	}
+
+	free(window);
+	arrfree(submeshes);
+	OBJCloseStreamFiles(files, cacheFilename);
+
+	return result;
+}
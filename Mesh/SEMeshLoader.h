@@ -2,18 +2,29 @@
 #include <cstdint>
 
 #include "SEMesh.h"
+#include "SEBounds.h"
+#include "SEMeshCache.h"
+#include "SEMeshMaterial.h"
 
 int32_t StringToInt32(char* str);
 int64_t StringToInt64(char* str);
 float StringToFloat(char* str);
 double StringToDouble(char* str);
 
+//Parses a decimal floating point number [+-]digits[.digits][(e|E)[+-]digits] in the range [begin, end).
+//The result is correctly rounded. No memory is allocated.
+//Returns a pointer to the first character after the number or begin if there is no number.
+const char* ParseFloat(const char* begin, const char* end, float* value);
+const char* ParseDouble(const char* begin, const char* end, double* value);
+
 struct OBJVertexData
 {
 	//stb_ds arrays
 	vec3* v = nullptr;
 	vec3* vn = nullptr;
 	vec2* vt = nullptr;
+	bool vnExist = false;
+	bool vtExist = false;
 };
 
 struct OBJFace
@@ -23,6 +34,104 @@ struct OBJFace
 	int32_t vnIndex = -1;
 };
 
-void OBJParseVertex(char* buf, OBJVertexData* vData);
-void OBJParseFace(char* buf, OBJFace** faces);
-void ParseOBJ(const char* filename, Vertex** vertices, uint32_t** indices, uint32_t* numVertices, uint32_t* numIndices);
\ No newline at end of file
+enum OBJStatementType
+{
+	OBJ_STATEMENT_OBJECT, //o
+	OBJ_STATEMENT_GROUP, //g
+	OBJ_STATEMENT_USE_MATERIAL, //usemtl
+	OBJ_STATEMENT_MATERIAL_LIBRARY //mtllib, one statement per filename
+};
+
+//A statement that changes the submesh of the faces after it.
+struct OBJStatement
+{
+	OBJStatementType type;
+
+	//Number of faces before the statement
+	uint32_t faceIndex;
+
+	//The argument of the statement, truncated to MESH_MAX_NAME_LENGTH characters for names
+	char name[MAX_FILE_PATH];
+};
+
+//The parsed contents of a newline-aligned range [begin, end) of an OBJ file.
+struct OBJChunk
+{
+	const char* begin = nullptr;
+	const char* end = nullptr;
+
+	OBJVertexData vData;
+	OBJFace* faces = nullptr; //a stb_ds array
+
+	//Positions (face * 3 + component) of the indices that were relative (negative) in the file.
+	//They are resolved against the counts of this chunk only and rebased when the chunks are merged.
+	uint32_t* relativeIndices = nullptr; //a stb_ds array
+
+	//Number of corners of every face
+	uint32_t* faceSizes = nullptr; //a stb_ds array
+
+	OBJStatement* statements = nullptr; //a stb_ds array
+};
+
+enum OBJParseFlags
+{
+	OBJ_PARSE_FLAGS_NONE = 0,
+
+	//Splits the file into chunks and parses them in parallel.
+	//The result is identical to the serial parse.
+	OBJ_PARSE_FLAGS_MULTITHREADED = 0x1,
+
+	//Loads the mesh from "filename.semesh" if it is up to date with the OBJ file.
+	//Otherwise parses the OBJ file and writes the cache.
+	OBJ_PARSE_FLAGS_CACHE = 0x2
+};
+
+#define OBJ_MAX_CHUNKS 64
+#define OBJ_MIN_CHUNK_SIZE (1024 * 1024)
+
+//The OBJ parsers work directly on the memory of the file in the range [cur, end).
+//Each one parses the statement starting at cur and returns a pointer to the end of the line it parsed.
+const char* OBJParseVertex(const char* cur, const char* end, OBJVertexData* vData);
+const char* OBJParseFace(const char* cur, const char* end, OBJChunk* chunk, uint32_t* outNumIndices);
+const char* OBJParseStatement(const char* cur, const char* end, OBJStatementType type, OBJChunk* chunk);
+
+//Parses every statement in the range of the chunk.
+void OBJParseChunk(OBJChunk* chunk);
+
+//Parses the OBJ file with the specified filename.
+//The file is memory-mapped and tokenized in place, so lines of any length are supported.
+//Faces can have any number of corners. Convex faces are fan triangulated, concave faces are ear clipped.
+//Every distinct (v, vt, vn) triple becomes one vertex, so seams and hard edges keep their own attributes.
+//With OBJ_PARSE_FLAGS_MULTITHREADED files larger than OBJ_MIN_CHUNK_SIZE are parsed on multiple threads.
+//Stores the vertices and indices in a stb_ds array.
+//outBounds receives the bounds of the mesh, they are stored in the cache so a cache hit doesn't compute them. Can be nullptr.
+//
+//Every run of faces with the same o/g name and usemtl material becomes one submesh, runs with the same name and material are merged.
+//The triangles of a submesh are contiguous and vertex cache optimized on their own, so every submesh can be drawn with one call.
+//The submeshes are appended to outSubmeshes and the materials of the mtllib files to outMaterials, both stb_ds arrays that can be nullptr.
+//Index offsets are relative to the first index of the mesh and material indices to the first material of the mesh.
+//A usemtl material that no library defines gets a default material with its name.
+//Edits to the .mtl files invalidate the cache.
+void ParseOBJ(const char* filename, Vertex** vertices, uint32_t** indices, uint32_t* numVertices, uint32_t* numIndices,
+	uint32_t flags = OBJ_PARSE_FLAGS_CACHE, MeshBounds* outBounds = nullptr,
+	MeshSubmesh** outSubmeshes = nullptr, MeshMaterial** outMaterials = nullptr);
+
+//Lower bound of the memory budget of ConvertOBJToMeshCache
+#define OBJ_STREAM_MIN_MEMORY_BUDGET (16 * 1024 * 1024)
+
+//Converts the OBJ file to "filename.semesh" in bounded memory, for meshes that don't fit in memory through ParseOBJ.
+//The file is read in windows that are parsed with OBJParseChunk. The attributes and faces are spilled to temporary files
+//next to the output, then the faces are welded, triangulated, optimized and written in blocks of as many corners as fit in the budget.
+//Every block is one submesh. Vertices shared by two blocks are duplicated and computed normals are only smoothed within a block.
+//o, g, usemtl and mtllib are ignored.
+//Peak memory stays around memoryBudget bytes, which is raised to OBJ_STREAM_MIN_MEMORY_BUDGET.
+//ParseOBJ with OBJ_PARSE_FLAGS_CACHE loads the result like any other cache.
+//Returns false if a temporary file or the output can't be written or the mesh has more than 2^32 - 1 vertices or indices.
+bool ConvertOBJToMeshCache(const char* filename, uint64_t memoryBudget);
+
+//Parses the .mtl file with the specified filename and appends its materials to the stb_ds array.
+//The MTL parameters are mapped onto the PBR parameters of MeshMaterial:
+//Kd -> albedo.rgb, d or 1 - Tr -> albedo.a, Pm -> metallic, Pr or sqrt(2 / (Ns + 2)) -> roughness.
+//map_Kd, map_Bump/bump/norm, map_Pr and map_Pm are stored relative to the working directory.
+//Returns false if the file doesn't exist.
+bool ParseMTL(const char* filename, MeshMaterial** materials);
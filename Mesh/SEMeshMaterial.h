@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../Math/SEMath_Header.h"
+#include "../FileSystem/SEFileSystem.h"
+
+//Maximum length of a material or submesh name including the null terminator. Longer names are truncated.
+#define MESH_MAX_NAME_LENGTH 64
+
+//Material index of the faces that don't use a material
+#define MESH_NO_MATERIAL 0xFFFFFFFF
+
+struct MeshMaterial
+{
+	//albedo, metallic, roughness and ao have the layout of PBRMaterial in pbr.h.hlsl, pbr.h.glsl and the examples,
+	//so the start of a MeshMaterial can be copied directly into a PBRMaterial.
+	vec4 albedo = vec4(0.8f, 0.8f, 0.8f, 1.0f);
+	float metallic = 0.0f;
+	float roughness = 0.5f;
+	float ao = 1.0f;
+
+	char name[MESH_MAX_NAME_LENGTH]{};
+
+	//Texture filenames relative to the working directory, empty if the material has no such texture
+	char albedoMap[MAX_FILE_PATH]{};
+	char normalMap[MAX_FILE_PATH]{};
+	char roughnessMap[MAX_FILE_PATH]{};
+	char metallicMap[MAX_FILE_PATH]{};
+};
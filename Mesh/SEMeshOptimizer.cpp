@@ -0,0 +1,487 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+
+#include "SEMeshOptimizer.h"
+
+//A FIFO cache simulated with timestamps. A vertex is in the cache if fewer than cacheSize vertices were added after it.
+//Reset by advancing the timestamp past cacheSize.
+struct VertexCacheSim
+{
+	uint32_t* timestamps;
+	uint32_t timestamp;
+	uint32_t cacheSize;
+};
+
+void CreateVertexCacheSim(VertexCacheSim* sim, uint32_t numVertices, uint32_t cacheSize)
+{
+	sim->timestamps = (uint32_t*)calloc((numVertices > 0) ? numVertices : 1, sizeof(uint32_t));
+	sim->cacheSize = cacheSize;
+	sim->timestamp = cacheSize + 1;
+}
+
+void DestroyVertexCacheSim(VertexCacheSim* sim)
+{
+	free(sim->timestamps);
+	sim->timestamps = nullptr;
+}
+
+inline void ResetVertexCacheSim(VertexCacheSim* sim)
+{
+	sim->timestamp = sim->timestamp + sim->cacheSize + 1;
+}
+
+//Returns the number of cache misses of the triangle
+inline uint32_t AddTriangleToCacheSim(VertexCacheSim* sim, const uint32_t* triangle)
+{
+	uint32_t misses = 0;
+	for (uint32_t j = 0; j < 3; ++j)
+	{
+		uint32_t v = triangle[j];
+		if (sim->timestamp - sim->timestamps[v] > sim->cacheSize)
+		{
+			sim->timestamps[v] = sim->timestamp;
+			++sim->timestamp;
+			++misses;
+		}
+	}
+
+	return misses;
+}
+
+void AnalyzeVertexCache(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices, uint32_t cacheSize, VertexCacheStats* outStats)
+{
+	uint32_t numTriangles = numIndices / 3;
+
+	VertexCacheSim sim{};
+	CreateVertexCacheSim(&sim, numVertices, cacheSize);
+
+	uint32_t numTransforms = 0;
+	for (uint32_t i = 0; i < numTriangles; ++i)
+		numTransforms += AddTriangleToCacheSim(&sim, &indices[i * 3]);
+
+	//A referenced vertex has a timestamp, the others are still 0
+	uint32_t numReferenced = 0;
+	for (uint32_t v = 0; v < numVertices; ++v)
+	{
+		if (sim.timestamps[v] != 0)
+			++numReferenced;
+	}
+
+	DestroyVertexCacheSim(&sim);
+
+	outStats->numTransforms = numTransforms;
+	outStats->acmr = (numTriangles > 0) ? (float)numTransforms / numTriangles : 0.0f;
+	outStats->atvr = (numReferenced > 0) ? (float)numTransforms / numReferenced : 0.0f;
+}
+
+//Vertex to triangle adjacency in compressed rows.
+//The triangles of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1] - 1].
+struct VertexTriangles
+{
+	uint32_t* offsets;
+	uint32_t* triangles;
+};
+
+void CreateVertexTriangles(VertexTriangles* adjacency, const uint32_t* indices, uint32_t numIndices, uint32_t numVertices)
+{
+	adjacency->offsets = (uint32_t*)calloc(numVertices + 1, sizeof(uint32_t));
+	adjacency->triangles = (uint32_t*)malloc(((numIndices > 0) ? numIndices : 1) * sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < numIndices; ++i)
+		++adjacency->offsets[indices[i] + 1];
+
+	for (uint32_t v = 0; v < numVertices; ++v)
+		adjacency->offsets[v + 1] = adjacency->offsets[v + 1] + adjacency->offsets[v];
+
+	uint32_t* cursors = (uint32_t*)malloc(((numVertices > 0) ? numVertices : 1) * sizeof(uint32_t));
+	memcpy(cursors, adjacency->offsets, numVertices * sizeof(uint32_t));
+	for (uint32_t i = 0; i < numIndices; ++i)
+	{
+		adjacency->triangles[cursors[indices[i]]] = i / 3;
+		++cursors[indices[i]];
+	}
+	free(cursors);
+}
+
+void DestroyVertexTriangles(VertexTriangles* adjacency)
+{
+	free(adjacency->offsets);
+	free(adjacency->triangles);
+}
+
+//Tipsify's choice of the next fanning vertex.
+//Prefers the candidate that stays in the cache after its remaining triangles are emitted and entered the cache the earliest.
+//Falls back to the dead-end stack and then to the next vertex in input order with live triangles.
+//Returns -1 when every triangle has been emitted.
+int64_t TipsifyNextVertex(const uint32_t* candidates, uint32_t numCandidates, const uint32_t* liveTriangles,
+	const uint32_t* cacheTimestamps, uint32_t timestamp, uint32_t cacheSize,
+	uint32_t* deadEnd, uint32_t* deadEndSize, uint32_t* cursor, uint32_t numVertices, bool* outDeadEnd)
+{
+	int64_t best = -1;
+	int64_t bestPriority = -1;
+	for (uint32_t i = 0; i < numCandidates; ++i)
+	{
+		uint32_t v = candidates[i];
+		if (liveTriangles[v] == 0)
+			continue;
+
+		int64_t priority = 0;
+		if (timestamp - cacheTimestamps[v] + 2 * liveTriangles[v] <= cacheSize)
+			priority = timestamp - cacheTimestamps[v];
+
+		if (priority > bestPriority)
+		{
+			best = v;
+			bestPriority = priority;
+		}
+	}
+
+	if (best != -1)
+	{
+		*outDeadEnd = false;
+		return best;
+	}
+
+	*outDeadEnd = true;
+
+	while (*deadEndSize > 0)
+	{
+		--(*deadEndSize);
+		uint32_t v = deadEnd[*deadEndSize];
+		if (liveTriangles[v] > 0)
+			return v;
+	}
+
+	while (*cursor < numVertices)
+	{
+		uint32_t v = *cursor;
+		++(*cursor);
+		if (liveTriangles[v] > 0)
+			return v;
+	}
+
+	return -1;
+}
+
+uint32_t OptimizeVertexCache(uint32_t* indices, uint32_t numIndices, uint32_t numVertices, uint32_t cacheSize, uint32_t* outClusters)
+{
+	uint32_t numTriangles = numIndices / 3;
+	if (numTriangles == 0 || numVertices == 0)
+		return 0;
+
+	numIndices = numTriangles * 3;
+
+	VertexTriangles adjacency{};
+	CreateVertexTriangles(&adjacency, indices, numIndices, numVertices);
+
+	uint32_t* liveTriangles = (uint32_t*)malloc(numVertices * sizeof(uint32_t));
+	for (uint32_t v = 0; v < numVertices; ++v)
+		liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+	uint32_t* cacheTimestamps = (uint32_t*)calloc(numVertices, sizeof(uint32_t));
+	bool* emitted = (bool*)calloc(numTriangles, sizeof(bool));
+
+	//Every emitted corner is pushed once, so numIndices entries are enough
+	uint32_t* deadEnd = (uint32_t*)malloc(numIndices * sizeof(uint32_t));
+	uint32_t deadEndSize = 0;
+	uint32_t* candidates = (uint32_t*)malloc(numIndices * sizeof(uint32_t));
+
+	uint32_t* output = (uint32_t*)malloc(numIndices * sizeof(uint32_t));
+	uint32_t numOutput = 0;
+	uint32_t numClusters = 0;
+
+	uint32_t timestamp = cacheSize + 1;
+	uint32_t cursor = 1;
+	bool newCluster = true;
+	int64_t fanVertex = 0;
+	while (fanVertex >= 0)
+	{
+		uint32_t numCandidates = 0;
+
+		uint32_t f = (uint32_t)fanVertex;
+		for (uint32_t a = adjacency.offsets[f]; a < adjacency.offsets[f + 1]; ++a)
+		{
+			uint32_t t = adjacency.triangles[a];
+			if (emitted[t])
+				continue;
+
+			if (newCluster)
+			{
+				if (outClusters != nullptr)
+					outClusters[numClusters] = numOutput / 3;
+
+				++numClusters;
+				newCluster = false;
+			}
+
+			for (uint32_t j = 0; j < 3; ++j)
+			{
+				uint32_t v = indices[t * 3 + j];
+				output[numOutput] = v;
+				++numOutput;
+
+				deadEnd[deadEndSize] = v;
+				++deadEndSize;
+				candidates[numCandidates] = v;
+				++numCandidates;
+
+				--liveTriangles[v];
+				if (timestamp - cacheTimestamps[v] > cacheSize)
+				{
+					cacheTimestamps[v] = timestamp;
+					++timestamp;
+				}
+			}
+
+			emitted[t] = true;
+		}
+
+		bool deadEndReached = false;
+		fanVertex = TipsifyNextVertex(candidates, numCandidates, liveTriangles, cacheTimestamps, timestamp, cacheSize,
+			deadEnd, &deadEndSize, &cursor, numVertices, &deadEndReached);
+
+		if (deadEndReached)
+			newCluster = true;
+	}
+
+	memcpy(indices, output, numIndices * sizeof(uint32_t));
+
+	free(output);
+	free(candidates);
+	free(deadEnd);
+	free(emitted);
+	free(cacheTimestamps);
+	free(liveTriangles);
+	DestroyVertexTriangles(&adjacency);
+
+	return numClusters;
+}
+
+struct OverdrawCluster
+{
+	uint32_t begin;
+	uint32_t end;
+	float sortKey;
+};
+
+//Sorts by decreasing key, clusters with equal keys keep their order
+int CompareOverdrawClusters(const void* a, const void* b)
+{
+	const OverdrawCluster* clusterA = (const OverdrawCluster*)a;
+	const OverdrawCluster* clusterB = (const OverdrawCluster*)b;
+
+	if (clusterA->sortKey != clusterB->sortKey)
+		return (clusterA->sortKey > clusterB->sortKey) ? -1 : 1;
+
+	return (clusterA->begin < clusterB->begin) ? -1 : ((clusterA->begin > clusterB->begin) ? 1 : 0);
+}
+
+void OptimizeOverdraw(uint32_t* indices, uint32_t numIndices, const Vertex* vertices, uint32_t numVertices,
+	const uint32_t* clusters, uint32_t numClusters, uint32_t cacheSize, float threshold)
+{
+	uint32_t numTriangles = numIndices / 3;
+	if (numTriangles == 0 || numClusters == 0)
+		return;
+
+	//Split the clusters where the ACMR of the part so far is within the threshold of the ACMR of the whole cluster
+	OverdrawCluster* splitClusters = (OverdrawCluster*)malloc(numTriangles * sizeof(OverdrawCluster));
+	uint32_t numSplitClusters = 0;
+
+	VertexCacheSim sim{};
+	CreateVertexCacheSim(&sim, numVertices, cacheSize);
+
+	for (uint32_t c = 0; c < numClusters; ++c)
+	{
+		uint32_t begin = clusters[c];
+		uint32_t end = (c + 1 < numClusters) ? clusters[c + 1] : numTriangles;
+
+		ResetVertexCacheSim(&sim);
+		uint32_t clusterMisses = 0;
+		for (uint32_t i = begin; i < end; ++i)
+			clusterMisses += AddTriangleToCacheSim(&sim, &indices[i * 3]);
+
+		float clusterThreshold = threshold * (float)clusterMisses / (float)(end - begin);
+
+		ResetVertexCacheSim(&sim);
+		uint32_t start = begin;
+		uint32_t misses = 0;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			misses += AddTriangleToCacheSim(&sim, &indices[i * 3]);
+
+			if (i + 1 == end || (float)misses / (float)(i + 1 - start) <= clusterThreshold)
+			{
+				splitClusters[numSplitClusters] = OverdrawCluster{ start, i + 1, 0.0f };
+				++numSplitClusters;
+
+				start = i + 1;
+				misses = 0;
+				ResetVertexCacheSim(&sim);
+			}
+		}
+	}
+
+	DestroyVertexCacheSim(&sim);
+
+	//Area weighted centroid of the mesh
+	float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+
+	float* triangleCentroids = (float*)malloc(numTriangles * 3 * sizeof(float));
+	float* triangleNormals = (float*)malloc(numTriangles * 3 * sizeof(float));
+	for (uint32_t i = 0; i < numTriangles; ++i)
+	{
+		const vec4* p0 = &vertices[indices[i * 3]].position;
+		const vec4* p1 = &vertices[indices[i * 3 + 1]].position;
+		const vec4* p2 = &vertices[indices[i * 3 + 2]].position;
+
+		float e0[3] = { p1->GetX() - p0->GetX(), p1->GetY() - p0->GetY(), p1->GetZ() - p0->GetZ() };
+		float e1[3] = { p2->GetX() - p0->GetX(), p2->GetY() - p0->GetY(), p2->GetZ() - p0->GetZ() };
+
+		//Twice the area times the unit normal
+		float* n = &triangleNormals[i * 3];
+		n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+		n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+		n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+
+		float* centroid = &triangleCentroids[i * 3];
+		centroid[0] = (p0->GetX() + p1->GetX() + p2->GetX()) / 3.0f;
+		centroid[1] = (p0->GetY() + p1->GetY() + p2->GetY()) / 3.0f;
+		centroid[2] = (p0->GetZ() + p1->GetZ() + p2->GetZ()) / 3.0f;
+
+		float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		meshCentroid[0] = meshCentroid[0] + centroid[0] * area;
+		meshCentroid[1] = meshCentroid[1] + centroid[1] * area;
+		meshCentroid[2] = meshCentroid[2] + centroid[2] * area;
+		meshArea = meshArea + area;
+	}
+
+	if (meshArea > 0.0f)
+	{
+		meshCentroid[0] = meshCentroid[0] / meshArea;
+		meshCentroid[1] = meshCentroid[1] / meshArea;
+		meshCentroid[2] = meshCentroid[2] / meshArea;
+	}
+
+	//Clusters whose surface faces away from the center occlude the rest of the mesh, so they go first
+	for (uint32_t c = 0; c < numSplitClusters; ++c)
+	{
+		OverdrawCluster* cluster = &splitClusters[c];
+
+		float centroid[3] = { 0.0f, 0.0f, 0.0f };
+		float normal[3] = { 0.0f, 0.0f, 0.0f };
+		float area = 0.0f;
+		for (uint32_t i = cluster->begin; i < cluster->end; ++i)
+		{
+			const float* n = &triangleNormals[i * 3];
+			float triangleArea = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				centroid[k] = centroid[k] + triangleCentroids[i * 3 + k] * triangleArea;
+				normal[k] = normal[k] + n[k];
+			}
+			area = area + triangleArea;
+		}
+
+		if (area > 0.0f)
+		{
+			centroid[0] = centroid[0] / area;
+			centroid[1] = centroid[1] / area;
+			centroid[2] = centroid[2] / area;
+		}
+
+		float normalLength = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (normalLength > 0.0f)
+		{
+			normal[0] = normal[0] / normalLength;
+			normal[1] = normal[1] / normalLength;
+			normal[2] = normal[2] / normalLength;
+		}
+
+		cluster->sortKey = (centroid[0] - meshCentroid[0]) * normal[0] + (centroid[1] - meshCentroid[1]) * normal[1] +
+			(centroid[2] - meshCentroid[2]) * normal[2];
+	}
+
+	free(triangleNormals);
+	free(triangleCentroids);
+
+	qsort(splitClusters, numSplitClusters, sizeof(OverdrawCluster), CompareOverdrawClusters);
+
+	uint32_t* output = (uint32_t*)malloc(numTriangles * 3 * sizeof(uint32_t));
+	uint32_t numOutput = 0;
+	for (uint32_t c = 0; c < numSplitClusters; ++c)
+	{
+		uint32_t count = (splitClusters[c].end - splitClusters[c].begin) * 3;
+		memcpy(&output[numOutput], &indices[splitClusters[c].begin * 3], count * sizeof(uint32_t));
+		numOutput += count;
+	}
+
+	memcpy(indices, output, numOutput * sizeof(uint32_t));
+
+	free(output);
+	free(splitClusters);
+}
+
+uint32_t OptimizeVertexFetch(Vertex* vertices, uint32_t numVertices, uint32_t* indices, uint32_t numIndices)
+{
+	if (numVertices == 0)
+		return 0;
+
+	const uint32_t unused = 0xFFFFFFFF;
+	uint32_t* remap = (uint32_t*)malloc(numVertices * sizeof(uint32_t));
+	memset(remap, 0xFF, numVertices * sizeof(uint32_t));
+
+	uint32_t numReferenced = 0;
+	for (uint32_t i = 0; i < numIndices; ++i)
+	{
+		uint32_t v = indices[i];
+		if (remap[v] == unused)
+		{
+			remap[v] = numReferenced;
+			++numReferenced;
+		}
+
+		indices[i] = remap[v];
+	}
+
+	uint32_t next = numReferenced;
+	for (uint32_t v = 0; v < numVertices; ++v)
+	{
+		if (remap[v] == unused)
+		{
+			remap[v] = next;
+			++next;
+		}
+	}
+
+	Vertex* copy = (Vertex*)_mm_malloc(numVertices * sizeof(Vertex), 16);
+	memcpy(copy, vertices, numVertices * sizeof(Vertex));
+	for (uint32_t v = 0; v < numVertices; ++v)
+		vertices[remap[v]] = copy[v];
+
+	_mm_free(copy);
+	free(remap);
+
+	return numReferenced;
+}
+
+void OptimizeMesh(Vertex* vertices, uint32_t numVertices, uint32_t* indices, uint32_t numIndices, MeshOptimizationStats* outStats)
+{
+	if (outStats != nullptr)
+		AnalyzeVertexCache(indices, numIndices, numVertices, MESH_OPTIMIZER_CACHE_SIZE, &outStats->before);
+
+	uint32_t numTriangles = numIndices / 3;
+	uint32_t* clusters = (uint32_t*)malloc(((numTriangles > 0) ? numTriangles : 1) * sizeof(uint32_t));
+
+	uint32_t numClusters = OptimizeVertexCache(indices, numIndices, numVertices, MESH_OPTIMIZER_CACHE_SIZE, clusters);
+	OptimizeOverdraw(indices, numIndices, vertices, numVertices, clusters, numClusters,
+		MESH_OPTIMIZER_CACHE_SIZE, MESH_OPTIMIZER_OVERDRAW_THRESHOLD);
+	OptimizeVertexFetch(vertices, numVertices, indices, numIndices);
+
+	free(clusters);
+
+	if (outStats != nullptr)
+		AnalyzeVertexCache(indices, numIndices, numVertices, MESH_OPTIMIZER_CACHE_SIZE, &outStats->after);
+}
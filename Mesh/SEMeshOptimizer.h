@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMesh.h"
+
+//Size of the FIFO post-transform vertex cache the optimizer targets and the statistics simulate.
+#define MESH_OPTIMIZER_CACHE_SIZE 16
+
+//Clusters are only reordered if it doesn't raise the ACMR of a cluster above threshold * the ACMR of the vertex cache order.
+#define MESH_OPTIMIZER_OVERDRAW_THRESHOLD 1.05f
+
+struct VertexCacheStats
+{
+	uint32_t numTransforms; //vertex shader invocations
+	float acmr; //average cache miss ratio, transformed vertices per triangle. 0.5 is the best possible for large grids, 3 the worst.
+	float atvr; //average transformed vertex ratio, transformed vertices per vertex. 1 is the best possible.
+};
+
+struct MeshOptimizationStats
+{
+	VertexCacheStats before;
+	VertexCacheStats after;
+};
+
+//Simulates a FIFO vertex cache of cacheSize entries over the triangle list.
+void AnalyzeVertexCache(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices, uint32_t cacheSize, VertexCacheStats* outStats);
+
+//Reorders the triangles for the post-transform vertex cache with Tipsify (Sander et al. 2007).
+//Runs in linear time. Every time the walk reaches a dead end a new cluster begins.
+//If outClusters isn't nullptr it must hold numIndices / 3 entries and receives the first triangle of every cluster.
+//Returns the number of clusters.
+uint32_t OptimizeVertexCache(uint32_t* indices, uint32_t numIndices, uint32_t numVertices, uint32_t cacheSize, uint32_t* outClusters);
+
+//Reorders the clusters of a vertex cache optimized index array so the triangles facing away from the center of the mesh are drawn first,
+//which lowers overdraw from any viewpoint.
+//Clusters are split further where it costs at most threshold times the cache misses of the input order.
+void OptimizeOverdraw(uint32_t* indices, uint32_t numIndices, const Vertex* vertices, uint32_t numVertices,
+	const uint32_t* clusters, uint32_t numClusters, uint32_t cacheSize, float threshold);
+
+//Reorders the vertices by their first use in the index array and remaps the indices.
+//Vertices that no index references are moved to the end in their original order.
+//Returns the number of referenced vertices.
+uint32_t OptimizeVertexFetch(Vertex* vertices, uint32_t numVertices, uint32_t* indices, uint32_t numIndices);
+
+//Runs OptimizeVertexCache, OptimizeOverdraw and OptimizeVertexFetch with the default settings.
+//The number of vertices doesn't change, so the arrays can be optimized in place inside a larger buffer.
+//If outStats isn't nullptr it receives the vertex cache statistics of the input and output order.
+void OptimizeMesh(Vertex* vertices, uint32_t numVertices, uint32_t* indices, uint32_t numIndices, MeshOptimizationStats* outStats = nullptr);
@@ -0,0 +1,492 @@
+#include <cmath>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+
+#include "SEMeshSimplifier.h"
+#include "SEMeshOptimizer.h"
+
+//Area weighted sum of the squared distances to a set of planes.
+//error(p) = p^T A p + 2 b.p + c, A is symmetric.
+struct Quadric
+{
+	double a00, a01, a02, a11, a12, a22;
+	double b0, b1, b2;
+	double c;
+	double weight;
+};
+
+inline void AddQuadric(Quadric* q, const Quadric* other)
+{
+	q->a00 += other->a00;
+	q->a01 += other->a01;
+	q->a02 += other->a02;
+	q->a11 += other->a11;
+	q->a12 += other->a12;
+	q->a22 += other->a22;
+	q->b0 += other->b0;
+	q->b1 += other->b1;
+	q->b2 += other->b2;
+	q->c += other->c;
+	q->weight += other->weight;
+}
+
+//The plane n.p + d = 0 with unit normal n, weighted by area
+inline Quadric PlaneQuadric(double nx, double ny, double nz, double d, double area)
+{
+	Quadric q;
+	q.a00 = area * nx * nx;
+	q.a01 = area * nx * ny;
+	q.a02 = area * nx * nz;
+	q.a11 = area * ny * ny;
+	q.a12 = area * ny * nz;
+	q.a22 = area * nz * nz;
+	q.b0 = area * nx * d;
+	q.b1 = area * ny * d;
+	q.b2 = area * nz * d;
+	q.c = area * d * d;
+	q.weight = area;
+
+	return q;
+}
+
+inline double QuadricError(const Quadric* q, const float* p)
+{
+	double x = p[0];
+	double y = p[1];
+	double z = p[2];
+
+	double error = q->a00 * x * x + q->a11 * y * y + q->a22 * z * z +
+		2.0 * (q->a01 * x * y + q->a02 * x * z + q->a12 * y * z) +
+		2.0 * (q->b0 * x + q->b1 * y + q->b2 * z) + q->c;
+
+	return (error > 0.0) ? error : 0.0;
+}
+
+//Unnormalized normal of the triangle, its length is twice the area
+inline void TriangleNormal(const float* p0, const float* p1, const float* p2, double* outNormal)
+{
+	double e0[3] = { (double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2] };
+	double e1[3] = { (double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2] };
+
+	outNormal[0] = e0[1] * e1[2] - e0[2] * e1[1];
+	outNormal[1] = e0[2] * e1[0] - e0[0] * e1[2];
+	outNormal[2] = e0[0] * e1[1] - e0[1] * e1[0];
+}
+
+struct EdgeCollapse
+{
+	uint32_t from;
+	uint32_t to;
+	float cost;
+};
+
+int CompareEdgeCollapses(const void* a, const void* b)
+{
+	const EdgeCollapse* collapseA = (const EdgeCollapse*)a;
+	const EdgeCollapse* collapseB = (const EdgeCollapse*)b;
+
+	if (collapseA->cost != collapseB->cost)
+		return (collapseA->cost < collapseB->cost) ? -1 : 1;
+
+	if (collapseA->from != collapseB->from)
+		return (collapseA->from < collapseB->from) ? -1 : 1;
+
+	return (collapseA->to < collapseB->to) ? -1 : ((collapseA->to > collapseB->to) ? 1 : 0);
+}
+
+int CompareUint64(const void* a, const void* b)
+{
+	uint64_t valueA = *(const uint64_t*)a;
+	uint64_t valueB = *(const uint64_t*)b;
+
+	return (valueA < valueB) ? -1 : ((valueA > valueB) ? 1 : 0);
+}
+
+struct Simplifier
+{
+	uint32_t numVertices;
+	float* positions; //3 per vertex
+
+	//The first vertex with the same position. Quadrics, locks and topology use the canonical vertices,
+	//so the copies of a vertex on a uv or normal seam act as one.
+	uint32_t* canonical;
+	bool* locked;
+	Quadric* quadrics;
+
+	uint32_t* indices;
+	uint32_t numIndices;
+
+	//Largest error of a collapse so far, squared
+	double maxError;
+};
+
+inline uint32_t HashPosition(const float* p)
+{
+	uint32_t bits[3];
+	memcpy(bits, p, sizeof(bits));
+
+	return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+}
+
+void CreateSimplifier(Simplifier* simplifier, const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices)
+{
+	uint32_t numTriangles = numIndices / 3;
+	numIndices = numTriangles * 3;
+
+	simplifier->numVertices = numVertices;
+	simplifier->positions = (float*)malloc(((numVertices > 0) ? numVertices : 1) * 3 * sizeof(float));
+	simplifier->canonical = (uint32_t*)malloc(((numVertices > 0) ? numVertices : 1) * sizeof(uint32_t));
+	simplifier->locked = (bool*)calloc((numVertices > 0) ? numVertices : 1, sizeof(bool));
+	simplifier->quadrics = (Quadric*)calloc((numVertices > 0) ? numVertices : 1, sizeof(Quadric));
+	simplifier->indices = (uint32_t*)malloc(((numIndices > 0) ? numIndices : 1) * sizeof(uint32_t));
+	simplifier->numIndices = numIndices;
+	simplifier->maxError = 0.0;
+
+	memcpy(simplifier->indices, indices, numIndices * sizeof(uint32_t));
+
+	for (uint32_t v = 0; v < numVertices; ++v)
+	{
+		simplifier->positions[v * 3] = vertices[v].position.GetX();
+		simplifier->positions[v * 3 + 1] = vertices[v].position.GetY();
+		simplifier->positions[v * 3 + 2] = vertices[v].position.GetZ();
+	}
+
+	//Find the canonical vertices with an open addressing table
+	uint32_t tableSize = 1;
+	while (tableSize < numVertices * 2)
+		tableSize = tableSize * 2;
+
+	uint32_t* table = (uint32_t*)malloc(tableSize * sizeof(uint32_t));
+	memset(table, 0xFF, tableSize * sizeof(uint32_t));
+	for (uint32_t v = 0; v < numVertices; ++v)
+	{
+		const float* p = &simplifier->positions[v * 3];
+		uint32_t slot = HashPosition(p) & (tableSize - 1);
+		while (true)
+		{
+			uint32_t other = table[slot];
+			if (other == 0xFFFFFFFF)
+			{
+				table[slot] = v;
+				simplifier->canonical[v] = v;
+				break;
+			}
+
+			if (memcmp(&simplifier->positions[other * 3], p, 3 * sizeof(float)) == 0)
+			{
+				//A seam, both copies are locked
+				simplifier->canonical[v] = other;
+				simplifier->locked[other] = true;
+				break;
+			}
+
+			slot = (slot + 1) & (tableSize - 1);
+		}
+	}
+	free(table);
+
+	//Edges that aren't shared by exactly two triangles are borders or non-manifold, their vertices are locked
+	uint64_t* edges = (uint64_t*)malloc(((numIndices > 0) ? numIndices : 1) * sizeof(uint64_t));
+	for (uint32_t i = 0; i < numIndices; ++i)
+	{
+		uint32_t a = simplifier->canonical[indices[i]];
+		uint32_t b = simplifier->canonical[indices[(i % 3 == 2) ? i - 2 : i + 1]];
+		edges[i] = (a < b) ? (((uint64_t)a << 32) | b) : (((uint64_t)b << 32) | a);
+	}
+	qsort(edges, numIndices, sizeof(uint64_t), CompareUint64);
+
+	for (uint32_t i = 0; i < numIndices;)
+	{
+		uint32_t count = 1;
+		while (i + count < numIndices && edges[i + count] == edges[i])
+			++count;
+
+		if (count != 2)
+		{
+			simplifier->locked[(uint32_t)(edges[i] >> 32)] = true;
+			simplifier->locked[(uint32_t)(edges[i] & 0xFFFFFFFF)] = true;
+		}
+
+		i = i + count;
+	}
+	free(edges);
+
+	for (uint32_t t = 0; t < numTriangles; ++t)
+	{
+		uint32_t c[3];
+		for (uint32_t j = 0; j < 3; ++j)
+			c[j] = simplifier->canonical[indices[t * 3 + j]];
+
+		const float* p0 = &simplifier->positions[c[0] * 3];
+		double n[3];
+		TriangleNormal(p0, &simplifier->positions[c[1] * 3], &simplifier->positions[c[2] * 3], n);
+
+		double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length == 0.0)
+			continue;
+
+		n[0] = n[0] / length;
+		n[1] = n[1] / length;
+		n[2] = n[2] / length;
+		double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+
+		Quadric q = PlaneQuadric(n[0], n[1], n[2], d, length * 0.5);
+		for (uint32_t j = 0; j < 3; ++j)
+			AddQuadric(&simplifier->quadrics[c[j]], &q);
+	}
+}
+
+void DestroySimplifier(Simplifier* simplifier)
+{
+	free(simplifier->positions);
+	free(simplifier->canonical);
+	free(simplifier->locked);
+	free(simplifier->quadrics);
+	free(simplifier->indices);
+}
+
+//Returns true if moving vertex from onto vertex to flips one of the triangles around from that survive the collapse.
+bool CollapseFlipsTriangle(const Simplifier* simplifier, const uint32_t* adjacencyOffsets, const uint32_t* adjacency, uint32_t from, uint32_t to)
+{
+	const float* target = &simplifier->positions[to * 3];
+	for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a)
+	{
+		const uint32_t* triangle = &simplifier->indices[adjacency[a] * 3];
+
+		uint32_t c[3];
+		for (uint32_t j = 0; j < 3; ++j)
+			c[j] = simplifier->canonical[triangle[j]];
+
+		//Removed by the collapse
+		if (c[0] == to || c[1] == to || c[2] == to)
+			continue;
+
+		const float* p[3];
+		const float* moved[3];
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			p[j] = &simplifier->positions[c[j] * 3];
+			moved[j] = (c[j] == from) ? target : p[j];
+		}
+
+		double before[3];
+		double after[3];
+		TriangleNormal(p[0], p[1], p[2], before);
+		TriangleNormal(moved[0], moved[1], moved[2], after);
+
+		if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0)
+			return true;
+	}
+
+	return false;
+}
+
+//Runs collapse passes until the mesh has at most targetIndexCount indices, the next collapse costs more than maxError
+//or no vertex can be collapsed. Every pass collapses the cheapest edges whose neighbourhoods don't overlap.
+void ReduceSimplifier(Simplifier* simplifier, uint32_t targetIndexCount, double maxError)
+{
+	uint32_t numVertices = simplifier->numVertices;
+	uint32_t* adjacencyOffsets = (uint32_t*)malloc((numVertices + 1) * sizeof(uint32_t));
+	uint32_t* adjacency = (uint32_t*)malloc(((simplifier->numIndices > 0) ? simplifier->numIndices : 1) * sizeof(uint32_t));
+	EdgeCollapse* collapses = (EdgeCollapse*)malloc(((simplifier->numIndices > 0) ? simplifier->numIndices * 2 : 1) * sizeof(EdgeCollapse));
+	uint32_t* collapseTo = (uint32_t*)malloc(((numVertices > 0) ? numVertices : 1) * sizeof(uint32_t));
+	bool* touched = (bool*)malloc((numVertices > 0) ? numVertices : 1);
+
+	while (simplifier->numIndices > targetIndexCount)
+	{
+		uint32_t numIndices = simplifier->numIndices;
+		uint32_t numTriangles = numIndices / 3;
+		const uint32_t* canonical = simplifier->canonical;
+
+		//Canonical vertex to triangle adjacency
+		memset(adjacencyOffsets, 0, (numVertices + 1) * sizeof(uint32_t));
+		for (uint32_t i = 0; i < numIndices; ++i)
+			++adjacencyOffsets[canonical[simplifier->indices[i]] + 1];
+
+		for (uint32_t v = 0; v < numVertices; ++v)
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v + 1] + adjacencyOffsets[v];
+
+		memcpy(collapseTo, adjacencyOffsets, numVertices * sizeof(uint32_t));
+		for (uint32_t i = 0; i < numIndices; ++i)
+		{
+			uint32_t c = canonical[simplifier->indices[i]];
+			adjacency[collapseTo[c]] = i / 3;
+			++collapseTo[c];
+		}
+
+		//Both directions of every edge that starts at an unlocked vertex
+		uint32_t numCollapses = 0;
+		for (uint32_t i = 0; i < numIndices; ++i)
+		{
+			uint32_t from = canonical[simplifier->indices[i]];
+			if (simplifier->locked[from])
+				continue;
+
+			uint32_t triangle = i / 3;
+			uint32_t corner = i % 3;
+			uint32_t neighbours[2] = { simplifier->indices[triangle * 3 + (corner + 1) % 3],
+				simplifier->indices[triangle * 3 + (corner + 2) % 3] };
+
+			//The target is the copy of the neighbour this side of a seam uses, so the attributes stay continuous
+			for (uint32_t k = 0; k < 2; ++k)
+			{
+				uint32_t to = neighbours[k];
+				if (canonical[to] == from)
+					continue;
+
+				const Quadric* qFrom = &simplifier->quadrics[from];
+				const Quadric* qTo = &simplifier->quadrics[canonical[to]];
+				const float* p = &simplifier->positions[to * 3];
+				double weight = qFrom->weight + qTo->weight;
+				double cost = (QuadricError(qFrom, p) + QuadricError(qTo, p)) / ((weight > 0.0) ? weight : 1.0);
+
+				collapses[numCollapses] = EdgeCollapse{ from, to, (float)cost };
+				++numCollapses;
+			}
+		}
+
+		qsort(collapses, numCollapses, sizeof(EdgeCollapse), CompareEdgeCollapses);
+
+		for (uint32_t v = 0; v < numVertices; ++v)
+			collapseTo[v] = v;
+		memset(touched, 0, numVertices);
+
+		uint32_t numCollapsed = 0;
+		uint32_t numRemoved = 0;
+		for (uint32_t i = 0; i < numCollapses; ++i)
+		{
+			const EdgeCollapse* collapse = &collapses[i];
+			if (collapse->cost > maxError)
+				break;
+
+			uint32_t to = canonical[collapse->to];
+			if (touched[collapse->from] || touched[to])
+				continue;
+
+			if (CollapseFlipsTriangle(simplifier, adjacencyOffsets, adjacency, collapse->from, to))
+				continue;
+
+			collapseTo[collapse->from] = collapse->to;
+			AddQuadric(&simplifier->quadrics[to], &simplifier->quadrics[collapse->from]);
+			if (collapse->cost > simplifier->maxError)
+				simplifier->maxError = collapse->cost;
+
+			//The triangles around from change, so none of their vertices can take part in another collapse this pass
+			for (uint32_t a = adjacencyOffsets[collapse->from]; a < adjacencyOffsets[collapse->from + 1]; ++a)
+			{
+				const uint32_t* triangle = &simplifier->indices[adjacency[a] * 3];
+				bool removed = false;
+				for (uint32_t j = 0; j < 3; ++j)
+				{
+					uint32_t c = canonical[triangle[j]];
+					touched[c] = true;
+					removed = removed || (c == to);
+				}
+
+				if (removed)
+					++numRemoved;
+			}
+
+			++numCollapsed;
+			if ((numTriangles - numRemoved) * 3 <= targetIndexCount)
+				break;
+		}
+
+		if (numCollapsed == 0)
+			break;
+
+		//Move the corners of the collapsed vertices and drop the triangles that became degenerate.
+		//An unlocked vertex has no copies, so its canonical vertex is the vertex itself.
+		uint32_t numKept = 0;
+		for (uint32_t t = 0; t < numTriangles; ++t)
+		{
+			uint32_t v[3];
+			for (uint32_t j = 0; j < 3; ++j)
+				v[j] = collapseTo[simplifier->indices[t * 3 + j]];
+
+			uint32_t c0 = canonical[v[0]];
+			uint32_t c1 = canonical[v[1]];
+			uint32_t c2 = canonical[v[2]];
+			if (c0 == c1 || c1 == c2 || c0 == c2)
+				continue;
+
+			simplifier->indices[numKept * 3] = v[0];
+			simplifier->indices[numKept * 3 + 1] = v[1];
+			simplifier->indices[numKept * 3 + 2] = v[2];
+			++numKept;
+		}
+
+		simplifier->numIndices = numKept * 3;
+	}
+
+	free(touched);
+	free(collapseTo);
+	free(collapses);
+	free(adjacency);
+	free(adjacencyOffsets);
+}
+
+uint32_t SimplifyMesh(const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	uint32_t targetIndexCount, float targetError, uint32_t* outIndices, float* outError)
+{
+	Simplifier simplifier{};
+	CreateSimplifier(&simplifier, vertices, numVertices, indices, numIndices);
+
+	ReduceSimplifier(&simplifier, targetIndexCount, (double)targetError * targetError);
+
+	uint32_t result = simplifier.numIndices;
+	memcpy(outIndices, simplifier.indices, result * sizeof(uint32_t));
+	if (outError != nullptr)
+		*outError = (float)sqrt(simplifier.maxError);
+
+	DestroySimplifier(&simplifier);
+
+	return result;
+}
+
+void GenerateMeshLODs(const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	const float* ratios, uint32_t numLODs, uint32_t** lodIndices, MeshLOD* outLODs)
+{
+	Simplifier simplifier{};
+	CreateSimplifier(&simplifier, vertices, numVertices, indices, numIndices);
+
+	uint32_t numTriangles = numIndices / 3;
+	for (uint32_t i = 0; i < numLODs; ++i)
+	{
+		uint32_t targetTriangles = (uint32_t)(ratios[i] * numTriangles);
+		if (targetTriangles < 1)
+			targetTriangles = 1;
+
+		ReduceSimplifier(&simplifier, targetTriangles * 3, DBL_MAX);
+
+		uint32_t offset = (uint32_t)arrlenu(*lodIndices);
+		for (uint32_t j = 0; j < simplifier.numIndices; ++j)
+			arrpush(*lodIndices, simplifier.indices[j]);
+
+		OptimizeVertexCache(*lodIndices + offset, simplifier.numIndices, numVertices, MESH_OPTIMIZER_CACHE_SIZE, nullptr);
+
+		outLODs[i].indexOffset = offset;
+		outLODs[i].indexCount = simplifier.numIndices;
+		outLODs[i].error = (float)sqrt(simplifier.maxError);
+	}
+
+	DestroySimplifier(&simplifier);
+}
+
+uint32_t SelectMeshLOD(const MeshLOD* lods, uint32_t numLODs, float distance, float scale, float fovY, float screenHeight, float maxPixelError)
+{
+	if (numLODs == 0 || distance <= 0.0f)
+		return 0;
+
+	//Size of a world unit in pixels at the distance
+	float pixelsPerUnit = screenHeight / (2.0f * distance * tanf(fovY * 0.5f));
+
+	for (uint32_t i = numLODs - 1; i > 0; --i)
+	{
+		if (lods[i].error * scale * pixelsPerUnit <= maxPixelError)
+			return i;
+	}
+
+	return 0;
+}
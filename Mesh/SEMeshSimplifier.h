@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMesh.h"
+
+#define MAX_MESH_LODS 8
+
+//A level of detail of a mesh. All the levels index the same vertex buffer.
+struct MeshLOD
+{
+	uint32_t indexOffset;
+	uint32_t indexCount;
+
+	//Geometric error of the level in the units of the vertex positions.
+	//It is the root of the largest mean squared distance from a removed vertex to the surface it was merged into.
+	float error;
+};
+
+//Simplifies the triangle list with quadric error metrics until it has at most targetIndexCount indices
+//or the next collapse would have an error larger than targetError.
+//Vertices are only merged into neighbouring vertices, so the result indexes the same vertex buffer.
+//Vertices on uv or normal seams (vertices that share a position) and on open borders never move.
+//outIndices must hold numIndices entries. outError receives the error of the result, can be nullptr.
+//Returns the number of indices written.
+uint32_t SimplifyMesh(const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	uint32_t targetIndexCount, float targetError, uint32_t* outIndices, float* outError);
+
+//Generates a chain of levels of detail in a single simplification run.
+//ratios[i] is the fraction of the triangles kept by level i, for example 1.0, 0.5, 0.25, 0.125.
+//The indices of every level are appended to the stb_ds array lodIndices and optimized for the vertex cache.
+//A level can have more triangles than its ratio asks for if the mesh can't be simplified further.
+void GenerateMeshLODs(const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	const float* ratios, uint32_t numLODs, uint32_t** lodIndices, MeshLOD* outLODs);
+
+//Returns the coarsest level whose error projected to the screen is at most maxPixelError pixels.
+//distance is the distance from the camera to the object, fovY the vertical field of view in radians,
+//screenHeight the height of the viewport in pixels and scale the largest scale of the model matrix.
+uint32_t SelectMeshLOD(const MeshLOD* lods, uint32_t numLODs, float distance, float scale, float fovY, float screenHeight, float maxPixelError);
@@ -0,0 +1,99 @@
+#include <immintrin.h>
+
+#include "SEMeshKernels.h"
+
+//Transposes the 4x4 matrix in each 128-bit lane of the rows
+static inline void Transpose4x4x2AVX2(__m256* rows)
+{
+	__m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+	__m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+	__m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+	__m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+	rows[0] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	rows[1] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	rows[2] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	rows[3] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+//Transposes the SoA x, y, z, w of 8 triangles back to 8 vectors
+static inline void StoreFrames8AVX2(__m256 x, __m256 y, __m256 z, __m256 w, float* out)
+{
+	__m256 rows[4] = { x, y, z, w };
+	Transpose4x4x2AVX2(rows);
+
+	//The low lanes hold triangles 0 to 3, the high lanes 4 to 7
+	for (uint32_t k = 0; k < 4; ++k)
+	{
+		_mm_store_ps(out + 4 * k, _mm256_castps256_ps128(rows[k]));
+		_mm_store_ps(out + 4 * (k + 4), _mm256_extractf128_ps(rows[k], 1));
+	}
+}
+
+void ComputeTriangleFrames8AVX2(const float* const positions[8][3], const float* const texCoords[8][3], float* outNormals, float* outTangents)
+{
+	//p[j] = SoA position of the jth vertex of the 8 triangles. Triangles k and k + 4 share a row.
+	__m256 p[3][4];
+	for (uint32_t j = 0; j < 3; ++j)
+	{
+		for (uint32_t k = 0; k < 4; ++k)
+			p[j][k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(positions[k][j])), _mm_load_ps(positions[k + 4][j]), 1);
+
+		Transpose4x4x2AVX2(p[j]);
+	}
+
+	//e0 = p1 - p0
+	//e1 = p2 - p0
+	__m256 e0x = _mm256_sub_ps(p[1][0], p[0][0]);
+	__m256 e0y = _mm256_sub_ps(p[1][1], p[0][1]);
+	__m256 e0z = _mm256_sub_ps(p[1][2], p[0][2]);
+	__m256 e1x = _mm256_sub_ps(p[2][0], p[0][0]);
+	__m256 e1y = _mm256_sub_ps(p[2][1], p[0][1]);
+	__m256 e1z = _mm256_sub_ps(p[2][2], p[0][2]);
+
+	__m256 zero = _mm256_setzero_ps();
+
+	if (outNormals != nullptr)
+	{
+		//n = normalize(e0 x e1)
+		__m256 nx = _mm256_sub_ps(_mm256_mul_ps(e0y, e1z), _mm256_mul_ps(e0z, e1y));
+		__m256 ny = _mm256_sub_ps(_mm256_mul_ps(e0z, e1x), _mm256_mul_ps(e0x, e1z));
+		__m256 nz = _mm256_sub_ps(_mm256_mul_ps(e0x, e1y), _mm256_mul_ps(e0y, e1x));
+
+		__m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz)));
+		__m256 valid = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+		__m256 invLength = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), length), valid);
+
+		StoreFrames8AVX2(_mm256_mul_ps(nx, invLength), _mm256_mul_ps(ny, invLength), _mm256_mul_ps(nz, invLength), zero, outNormals);
+	}
+
+	if (outTangents != nullptr)
+	{
+		//t[j] = SoA texture coordinates of the jth vertex of the 8 triangles
+		__m256 tu[3];
+		__m256 tv[3];
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			tu[j] = _mm256_setr_ps(texCoords[0][j][0], texCoords[1][j][0], texCoords[2][j][0], texCoords[3][j][0],
+				texCoords[4][j][0], texCoords[5][j][0], texCoords[6][j][0], texCoords[7][j][0]);
+			tv[j] = _mm256_setr_ps(texCoords[0][j][1], texCoords[1][j][1], texCoords[2][j][1], texCoords[3][j][1],
+				texCoords[4][j][1], texCoords[5][j][1], texCoords[6][j][1], texCoords[7][j][1]);
+		}
+
+		__m256 u0 = _mm256_sub_ps(tu[1], tu[0]);
+		__m256 u1 = _mm256_sub_ps(tu[2], tu[0]);
+		__m256 v0 = _mm256_sub_ps(tv[1], tv[0]);
+		__m256 v1 = _mm256_sub_ps(tv[2], tv[0]);
+
+		//f = 1 / (u0 * v1 - u1 * v0), 0 if the uv triangle is degenerate
+		__m256 f = _mm256_sub_ps(_mm256_mul_ps(u0, v1), _mm256_mul_ps(u1, v0));
+		__m256 valid = _mm256_cmp_ps(f, zero, _CMP_NEQ_UQ);
+		f = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), f), valid);
+
+		//t = f * (v1 * e0 - v0 * e1)
+		__m256 tx = _mm256_mul_ps(f, _mm256_sub_ps(_mm256_mul_ps(v1, e0x), _mm256_mul_ps(v0, e1x)));
+		__m256 ty = _mm256_mul_ps(f, _mm256_sub_ps(_mm256_mul_ps(v1, e0y), _mm256_mul_ps(v0, e1y)));
+		__m256 tz = _mm256_mul_ps(f, _mm256_sub_ps(_mm256_mul_ps(v1, e0z), _mm256_mul_ps(v0, e1z)));
+
+		StoreFrames8AVX2(tx, ty, tz, zero, outTangents);
+	}
+}
@@ -0,0 +1,304 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "SEMeshlet.h"
+
+//The meshlet being built
+struct MeshletBuilder
+{
+	uint32_t vertices[MESHLET_MAX_VERTICES];
+	uint32_t numVertices;
+	uint32_t numTriangles;
+	uint32_t indexOffset;
+};
+
+//Appends the meshlet to the table and starts the next one after it
+void FinishMeshlet(const Vertex* vertices, const uint32_t* indices, uint8_t* slots, MeshletBuilder* builder, MeshletTable* table)
+{
+	//Bounding sphere around the center of the bounding box
+	float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+	float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+	for (uint32_t i = 0; i < builder->numVertices; ++i)
+	{
+		const vec4* position = &vertices[builder->vertices[i]].position;
+		float p[3] = { position->GetX(), position->GetY(), position->GetZ() };
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			if (i == 0 || p[k] < boundsMin[k])
+				boundsMin[k] = p[k];
+
+			if (i == 0 || p[k] > boundsMax[k])
+				boundsMax[k] = p[k];
+		}
+	}
+
+	float center[3];
+	for (uint32_t k = 0; k < 3; ++k)
+		center[k] = (boundsMin[k] + boundsMax[k]) * 0.5f;
+
+	float radiusSq = 0.0f;
+	for (uint32_t i = 0; i < builder->numVertices; ++i)
+	{
+		const vec4* position = &vertices[builder->vertices[i]].position;
+		float dx = position->GetX() - center[0];
+		float dy = position->GetY() - center[1];
+		float dz = position->GetZ() - center[2];
+		float distanceSq = dx * dx + dy * dy + dz * dz;
+		if (distanceSq > radiusSq)
+			radiusSq = distanceSq;
+	}
+
+	//The cone axis is the average of the unit triangle normals, the cone contains all of them
+	float normals[MESHLET_MAX_TRIANGLES][3];
+	uint32_t numNormals = 0;
+	float axis[3] = { 0.0f, 0.0f, 0.0f };
+	for (uint32_t t = 0; t < builder->numTriangles; ++t)
+	{
+		const uint32_t* triangle = &indices[builder->indexOffset + t * 3];
+		const vec4* p0 = &vertices[triangle[0]].position;
+		vec4 e0 = vertices[triangle[1]].position - *p0;
+		vec4 e1 = vertices[triangle[2]].position - *p0;
+
+		float n[3] = { e0.GetY() * e1.GetZ() - e0.GetZ() * e1.GetY(),
+			e0.GetZ() * e1.GetX() - e0.GetX() * e1.GetZ(),
+			e0.GetX() * e1.GetY() - e0.GetY() * e1.GetX() };
+
+		float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length == 0.0f)
+			continue;
+
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			normals[numNormals][k] = n[k] / length;
+			axis[k] = axis[k] + normals[numNormals][k];
+		}
+		++numNormals;
+	}
+
+	float cutoff = 1.0f;
+	float axisLength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+	if (axisLength > 0.0f)
+	{
+		axis[0] = axis[0] / axisLength;
+		axis[1] = axis[1] / axisLength;
+		axis[2] = axis[2] / axisLength;
+
+		float minDot = 1.0f;
+		for (uint32_t i = 0; i < numNormals; ++i)
+		{
+			float d = normals[i][0] * axis[0] + normals[i][1] * axis[1] + normals[i][2] * axis[2];
+			if (d < minDot)
+				minDot = d;
+		}
+
+		//Cones wider than ~85 degrees are almost never culled, they are disabled.
+		//Otherwise the cutoff is the sine of the cone angle, the cosine of the backfacing half space around it.
+		if (minDot > 0.1f)
+			cutoff = sqrtf(1.0f - minDot * minDot);
+	}
+
+	arrpush(table->indexOffsets, builder->indexOffset);
+	arrpush(table->indexCounts, builder->numTriangles * 3);
+	arrpush(table->vertexCounts, builder->numVertices);
+	arrpush(table->centerX, center[0]);
+	arrpush(table->centerY, center[1]);
+	arrpush(table->centerZ, center[2]);
+	arrpush(table->radius, sqrtf(radiusSq));
+	arrpush(table->coneAxisX, axis[0]);
+	arrpush(table->coneAxisY, axis[1]);
+	arrpush(table->coneAxisZ, axis[2]);
+	arrpush(table->coneCutoff, cutoff);
+	++table->numMeshlets;
+
+	for (uint32_t i = 0; i < builder->numVertices; ++i)
+		slots[builder->vertices[i]] = MESHLET_MAX_VERTICES;
+
+	builder->indexOffset = builder->indexOffset + builder->numTriangles * 3;
+	builder->numVertices = 0;
+	builder->numTriangles = 0;
+}
+
+void BuildMeshlets(const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	uint32_t* outIndices, MeshletTable* outTable)
+{
+	uint32_t numTriangles = numIndices / 3;
+
+	//Vertex to triangle adjacency
+	uint32_t* adjacencyOffsets = (uint32_t*)calloc(numVertices + 1, sizeof(uint32_t));
+	uint32_t* adjacency = (uint32_t*)malloc(((numIndices > 0) ? numIndices : 1) * sizeof(uint32_t));
+	for (uint32_t i = 0; i < numTriangles * 3; ++i)
+		++adjacencyOffsets[indices[i] + 1];
+
+	for (uint32_t v = 0; v < numVertices; ++v)
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v + 1] + adjacencyOffsets[v];
+
+	//Slot of each vertex in the current meshlet, MESHLET_MAX_VERTICES if it isn't in it
+	uint8_t* slots = (uint8_t*)malloc((numVertices > 0) ? numVertices : 1);
+	memset(slots, MESHLET_MAX_VERTICES, (numVertices > 0) ? numVertices : 1);
+
+	uint32_t* cursors = (uint32_t*)malloc(((numVertices > 0) ? numVertices : 1) * sizeof(uint32_t));
+	memcpy(cursors, adjacencyOffsets, numVertices * sizeof(uint32_t));
+	for (uint32_t i = 0; i < numTriangles * 3; ++i)
+	{
+		adjacency[cursors[indices[i]]] = i / 3;
+		++cursors[indices[i]];
+	}
+	free(cursors);
+
+	//Number of triangles around each vertex that aren't in a meshlet yet
+	uint32_t* live = (uint32_t*)malloc(((numVertices > 0) ? numVertices : 1) * sizeof(uint32_t));
+	for (uint32_t v = 0; v < numVertices; ++v)
+		live[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+
+	bool* emitted = (bool*)calloc((numTriangles > 0) ? numTriangles : 1, sizeof(bool));
+
+	MeshletBuilder builder{};
+	uint32_t numEmitted = 0;
+	uint32_t seed = 0;
+	while (numEmitted < numTriangles)
+	{
+		//The next triangle is the one around the vertices of the meshlet that adds the fewest new vertices
+		int64_t best = -1;
+		uint32_t bestNewVertices = 4;
+		uint32_t bestLiveTriangles = 0;
+		for (uint32_t i = 0; i < builder.numVertices; ++i)
+		{
+			uint32_t v = builder.vertices[i];
+			for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+			{
+				uint32_t t = adjacency[a];
+				if (emitted[t])
+					continue;
+
+				uint32_t newVertices = (slots[indices[t * 3]] == MESHLET_MAX_VERTICES) +
+					(slots[indices[t * 3 + 1]] == MESHLET_MAX_VERTICES) + (slots[indices[t * 3 + 2]] == MESHLET_MAX_VERTICES);
+
+				if (builder.numVertices + newVertices > MESHLET_MAX_VERTICES)
+					continue;
+
+				//Ties go to the triangle whose vertices have the fewest triangles left, which keeps the meshlet compact
+				uint32_t liveTriangles = live[indices[t * 3]] + live[indices[t * 3 + 1]] + live[indices[t * 3 + 2]];
+				if (newVertices < bestNewVertices || (newVertices == bestNewVertices && liveTriangles < bestLiveTriangles))
+				{
+					best = t;
+					bestNewVertices = newVertices;
+					bestLiveTriangles = liveTriangles;
+				}
+			}
+		}
+
+		if (best == -1)
+		{
+			//The meshlet is full or has no neighbours left, start the next one at the first triangle left in input order
+			if (builder.numTriangles > 0)
+				FinishMeshlet(vertices, outIndices, slots, &builder, outTable);
+
+			while (emitted[seed])
+				++seed;
+
+			best = seed;
+		}
+
+		const uint32_t* triangle = &indices[best * 3];
+		for (uint32_t j = 0; j < 3; ++j)
+		{
+			uint32_t v = triangle[j];
+			if (slots[v] == MESHLET_MAX_VERTICES)
+			{
+				slots[v] = (uint8_t)builder.numVertices;
+				builder.vertices[builder.numVertices] = v;
+				++builder.numVertices;
+			}
+
+			outIndices[builder.indexOffset + builder.numTriangles * 3 + j] = v;
+		}
+
+		emitted[best] = true;
+		for (uint32_t j = 0; j < 3; ++j)
+			--live[triangle[j]];
+
+		++builder.numTriangles;
+		++numEmitted;
+
+		if (builder.numTriangles == MESHLET_MAX_TRIANGLES)
+			FinishMeshlet(vertices, outIndices, slots, &builder, outTable);
+	}
+
+	if (builder.numTriangles > 0)
+		FinishMeshlet(vertices, outIndices, slots, &builder, outTable);
+
+	free(emitted);
+	free(live);
+	free(slots);
+	free(adjacency);
+	free(adjacencyOffsets);
+}
+
+void FreeMeshletTable(MeshletTable* table)
+{
+	arrfree(table->indexOffsets);
+	arrfree(table->indexCounts);
+	arrfree(table->vertexCounts);
+	arrfree(table->centerX);
+	arrfree(table->centerY);
+	arrfree(table->centerZ);
+	arrfree(table->radius);
+	arrfree(table->coneAxisX);
+	arrfree(table->coneAxisY);
+	arrfree(table->coneAxisZ);
+	arrfree(table->coneCutoff);
+	table->numMeshlets = 0;
+}
+
+uint32_t CullMeshlets(const MeshletTable* table, const vec4* frustumPlanes, vec3 cameraPosition, MeshletDrawRange* outRanges)
+{
+	float planes[6][4];
+	for (uint32_t p = 0; p < 6; ++p)
+	{
+		planes[p][0] = frustumPlanes[p].GetX();
+		planes[p][1] = frustumPlanes[p].GetY();
+		planes[p][2] = frustumPlanes[p].GetZ();
+		planes[p][3] = frustumPlanes[p].GetW();
+	}
+
+	float cameraX = cameraPosition.GetX();
+	float cameraY = cameraPosition.GetY();
+	float cameraZ = cameraPosition.GetZ();
+
+	uint32_t numRanges = 0;
+	for (uint32_t i = 0; i < table->numMeshlets; ++i)
+	{
+		float x = table->centerX[i];
+		float y = table->centerY[i];
+		float z = table->centerZ[i];
+		float r = table->radius[i];
+
+		bool visible = true;
+		for (uint32_t p = 0; p < 6; ++p)
+			visible = visible && (planes[p][0] * x + planes[p][1] * y + planes[p][2] * z + planes[p][3] >= -r);
+
+		float dx = x - cameraX;
+		float dy = y - cameraY;
+		float dz = z - cameraZ;
+		float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+		float d = dx * table->coneAxisX[i] + dy * table->coneAxisY[i] + dz * table->coneAxisZ[i];
+		visible = visible && (d < table->coneCutoff[i] * distance + r);
+
+		if (!visible)
+			continue;
+
+		if (numRanges > 0 && outRanges[numRanges - 1].indexOffset + outRanges[numRanges - 1].indexCount == table->indexOffsets[i])
+		{
+			outRanges[numRanges - 1].indexCount += table->indexCounts[i];
+		}
+		else
+		{
+			outRanges[numRanges].indexOffset = table->indexOffsets[i];
+			outRanges[numRanges].indexCount = table->indexCounts[i];
+			++numRanges;
+		}
+	}
+
+	return numRanges;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMesh.h"
+
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+
+//Clusters of neighbouring triangles, one entry per meshlet in each stb_ds array.
+//The triangles of meshlet i are indexCounts[i] indices starting at indexOffsets[i] of the index buffer written by BuildMeshlets.
+struct MeshletTable
+{
+	uint32_t numMeshlets;
+
+	uint32_t* indexOffsets;
+	uint32_t* indexCounts;
+	uint32_t* vertexCounts;
+
+	//Bounding spheres
+	float* centerX;
+	float* centerY;
+	float* centerZ;
+	float* radius;
+
+	//Normal cones. Every triangle of the meshlet faces away from a viewer at p if
+	//dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius.
+	//coneCutoff is 1 for meshlets whose normals are spread too far apart, those are never backface culled.
+	float* coneAxisX;
+	float* coneAxisY;
+	float* coneAxisZ;
+	float* coneCutoff;
+};
+
+//A range of indices to draw, neighbouring visible meshlets are merged into a single range.
+struct MeshletDrawRange
+{
+	uint32_t indexOffset;
+	uint32_t indexCount;
+};
+
+//Partitions the triangle list into meshlets of at most MESHLET_MAX_VERTICES vertices and MESHLET_MAX_TRIANGLES triangles.
+//The triangles are written to outIndices grouped by meshlet, outIndices must hold numIndices entries.
+//Meshlets grow through triangles that share vertices with them, so a mesh optimized for the vertex cache gives the tightest clusters.
+void BuildMeshlets(const Vertex* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices,
+	uint32_t* outIndices, MeshletTable* outTable);
+
+//Frees the arrays of the table.
+void FreeMeshletTable(MeshletTable* table);
+
+//Culls the meshlets against the frustum and their normal cones.
+//frustumPlanes are the six planes of the frustum in the space of the mesh with their normals pointing inside, see GetFrustumPlanes.
+//cameraPosition is the position of the camera in the space of the mesh.
+//outRanges must hold numMeshlets entries. Returns the number of ranges written.
+uint32_t CullMeshlets(const MeshletTable* table, const vec4* frustumPlanes, vec3 cameraPosition, MeshletDrawRange* outRanges);
@@ -0,0 +1,203 @@
+#include <cmath>
+#include <cstring>
+
+#include "SEPackedVertex.h"
+
+uint16_t FloatToHalf(float value)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(float));
+
+	uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+	uint32_t magnitude = bits & 0x7FFFFFFF;
+
+	//Inf and NaN
+	if (magnitude >= 0x7F800000)
+		return sign | 0x7C00 | ((magnitude > 0x7F800000) ? 0x0200 : 0);
+
+	//Rounds to a value larger than the largest half
+	if (magnitude >= 0x477FF000)
+		return sign | 0x7C00;
+
+	//Subnormal halfs, adding 0.5 lines up the mantissa so the FPU does the rounding
+	if (magnitude < 0x38800000)
+	{
+		float f = 0.0f;
+		memcpy(&f, &magnitude, sizeof(float));
+		f = f + 0.5f;
+
+		uint32_t rounded = 0;
+		memcpy(&rounded, &f, sizeof(float));
+		return sign | (uint16_t)(rounded - 0x3F000000);
+	}
+
+	//Rebias the exponent and round to nearest even
+	uint32_t mantissaOdd = (magnitude >> 13) & 1;
+	magnitude = magnitude + 0xC8000FFF + mantissaOdd;
+
+	return sign | (uint16_t)(magnitude >> 13);
+}
+
+float HalfToFloat(uint16_t value)
+{
+	uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 0x1F;
+	uint32_t mantissa = value & 0x3FF;
+
+	uint32_t bits = 0;
+	if (exponent == 0)
+	{
+		//Zero and subnormals, mantissa * 2^-24
+		float f = (float)mantissa * (1.0f / 16777216.0f);
+		memcpy(&bits, &f, sizeof(float));
+		bits = bits | sign;
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+
+	float result = 0.0f;
+	memcpy(&result, &bits, sizeof(float));
+
+	return result;
+}
+
+inline int16_t FloatToSnorm16(float value)
+{
+	value = (value > 1.0f) ? 1.0f : ((value < -1.0f) ? -1.0f : value);
+	return (int16_t)lrintf(value * 32767.0f);
+}
+
+inline float Snorm16ToFloat(int16_t value)
+{
+	float result = value / 32767.0f;
+	return (result < -1.0f) ? -1.0f : result;
+}
+
+inline float SignNotZero(float value)
+{
+	return (value >= 0.0f) ? 1.0f : -1.0f;
+}
+
+void EncodeOctahedral(float x, float y, float z, int16_t* out)
+{
+	//Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half over the upper half
+	float l1 = fabsf(x) + fabsf(y) + fabsf(z);
+	if (l1 == 0.0f)
+	{
+		out[0] = 0;
+		out[1] = 0;
+		return;
+	}
+
+	float px = x / l1;
+	float py = y / l1;
+	if (z < 0.0f)
+	{
+		float foldedX = (1.0f - fabsf(py)) * SignNotZero(px);
+		float foldedY = (1.0f - fabsf(px)) * SignNotZero(py);
+		px = foldedX;
+		py = foldedY;
+	}
+
+	out[0] = FloatToSnorm16(px);
+	out[1] = FloatToSnorm16(py);
+}
+
+void DecodeOctahedral(const int16_t* encoded, float* outX, float* outY, float* outZ)
+{
+	float x = Snorm16ToFloat(encoded[0]);
+	float y = Snorm16ToFloat(encoded[1]);
+	float z = 1.0f - fabsf(x) - fabsf(y);
+
+	//Unfold the lower half
+	float t = (-z > 0.0f) ? -z : 0.0f;
+	x = x + ((x >= 0.0f) ? -t : t);
+	y = y + ((y >= 0.0f) ? -t : t);
+
+	float length = sqrtf(x * x + y * y + z * z);
+	*outX = x / length;
+	*outY = y / length;
+	*outZ = z / length;
+}
+
+void ComputeVertexQuantization(const Vertex* vertices, uint32_t numVertices, VertexQuantization* outQuantization)
+{
+	float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+	float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+	for (uint32_t i = 0; i < numVertices; ++i)
+	{
+		float p[3] = { vertices[i].position.GetX(), vertices[i].position.GetY(), vertices[i].position.GetZ() };
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			if (i == 0 || p[k] < boundsMin[k])
+				boundsMin[k] = p[k];
+
+			if (i == 0 || p[k] > boundsMax[k])
+				boundsMax[k] = p[k];
+		}
+	}
+
+	for (uint32_t k = 0; k < 3; ++k)
+	{
+		outQuantization->offset[k] = boundsMin[k];
+		outQuantization->scale[k] = boundsMax[k] - boundsMin[k];
+	}
+}
+
+void PackVertices(const Vertex* vertices, uint32_t numVertices, const VertexQuantization* quantization, PackedVertex* outVertices)
+{
+	float invScale[3];
+	for (uint32_t k = 0; k < 3; ++k)
+		invScale[k] = (quantization->scale[k] > 0.0f) ? 65535.0f / quantization->scale[k] : 0.0f;
+
+	for (uint32_t i = 0; i < numVertices; ++i)
+	{
+		const Vertex* vertex = &vertices[i];
+		PackedVertex* packed = &outVertices[i];
+
+		float p[3] = { vertex->position.GetX(), vertex->position.GetY(), vertex->position.GetZ() };
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			float q = (p[k] - quantization->offset[k]) * invScale[k];
+			q = (q < 0.0f) ? 0.0f : ((q > 65535.0f) ? 65535.0f : q);
+			packed->position[k] = (uint16_t)lrintf(q);
+		}
+		packed->position[3] = (vertex->tangent.GetW() < 0.0f) ? 0 : 0xFFFF;
+
+		EncodeOctahedral(vertex->normal.GetX(), vertex->normal.GetY(), vertex->normal.GetZ(), packed->normal);
+		EncodeOctahedral(vertex->tangent.GetX(), vertex->tangent.GetY(), vertex->tangent.GetZ(), packed->tangent);
+
+		packed->texCoords[0] = FloatToHalf(vertex->texCoords.GetX());
+		packed->texCoords[1] = FloatToHalf(vertex->texCoords.GetY());
+	}
+}
+
+void UnpackVertices(const PackedVertex* vertices, uint32_t numVertices, const VertexQuantization* quantization, Vertex* outVertices)
+{
+	for (uint32_t i = 0; i < numVertices; ++i)
+	{
+		const PackedVertex* packed = &vertices[i];
+		Vertex* vertex = &outVertices[i];
+
+		float p[3];
+		for (uint32_t k = 0; k < 3; ++k)
+			p[k] = quantization->offset[k] + (packed->position[k] / 65535.0f) * quantization->scale[k];
+
+		vertex->position = vec4(p[0], p[1], p[2], 1.0f);
+
+		float x, y, z;
+		DecodeOctahedral(packed->normal, &x, &y, &z);
+		vertex->normal = vec4(x, y, z, 0.0f);
+
+		DecodeOctahedral(packed->tangent, &x, &y, &z);
+		vertex->tangent = vec4(x, y, z, (packed->position[3] == 0) ? -1.0f : 1.0f);
+
+		vertex->texCoords = vec2(HalfToFloat(packed->texCoords[0]), HalfToFloat(packed->texCoords[1]));
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEMesh.h"
+
+//A 20 byte alternative to the 64 byte Vertex.
+//position: R16G16B16A16_UNORM. xyz is the position relative to the bounds of the mesh, see VertexQuantization.
+//          w is the handedness of the tangent frame, 0 for -1 and 1 for +1.
+//normal:   R16G16_SNORM octahedral encoded unit vector.
+//tangent:  R16G16_SNORM octahedral encoded unit vector.
+//texCoords: R16G16_SFLOAT
+struct PackedVertex
+{
+	uint16_t position[4];
+	int16_t normal[2];
+	int16_t tangent[2];
+	uint16_t texCoords[2];
+};
+
+//position = offset + unorm(PackedVertex::position.xyz) * scale
+//offset is the minimum of the bounds of the mesh and scale its size.
+struct VertexQuantization
+{
+	float offset[3];
+	float scale[3];
+};
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+//Octahedral encoding of a unit vector into two snorm16 values and back.
+void EncodeOctahedral(float x, float y, float z, int16_t* out);
+void DecodeOctahedral(const int16_t* encoded, float* outX, float* outY, float* outZ);
+
+//Computes the quantization that covers the positions of the vertices.
+void ComputeVertexQuantization(const Vertex* vertices, uint32_t numVertices, VertexQuantization* outQuantization);
+
+//Converts between the Vertex and PackedVertex layouts.
+//The positions are exact to 1/65535 of the size of the bounds, the normals and tangents to a few hundredths of a degree.
+void PackVertices(const Vertex* vertices, uint32_t numVertices, const VertexQuantization* quantization, PackedVertex* outVertices);
+void UnpackVertices(const PackedVertex* vertices, uint32_t numVertices, const VertexQuantization* quantization, Vertex* outVertices);
@@ -2211,20 +2211,31 @@ void DirectXCreateTexture(const Renderer* const pRenderer, const TextureInfo* co
 	D3D12_RESOURCE_DESC resourceDesc{};
 	TextureDesc texDesc{};
 	uint32_t texType{};
-	if (pInfo->filename != nullptr)
+	if (pInfo->filename != nullptr || pInfo->fileData != nullptr)
 	{
 		uint8_t* bitData = nullptr;
 		uint32_t numBytes = 0;
 		DDS_HEADER ddsHeader{};
 		DDS_HEADER_DXT10 ddsHeader10{};
-		ReadDDSFile(pInfo->filename, &bitData, &numBytes, &ddsHeader, &ddsHeader10);
+		if (pInfo->fileData != nullptr)
+		{
+			bitData = pInfo->fileData->bitData;
+			numBytes = pInfo->fileData->numBytes;
+			ddsHeader = pInfo->fileData->header;
+			ddsHeader10 = pInfo->fileData->header10;
+		}
+		else
+		{
+			ReadDDSFile(pInfo->filename, &bitData, &numBytes, &ddsHeader, &ddsHeader10);
+		}
 
 		int result = RetrieveTextureInfo(&ddsHeader, &ddsHeader10, bitData, numBytes, &texDesc);
 		if (result != SE_SUCCESS)
 		{
 			MessageBox(nullptr, L"Error with function RetrieveTextureInfo in function DirectXCreateTexture. Exiting Program.",
 				L"RetrieveTextureInfo Error", MB_OK);
-			SAFE_FREE(bitData);
+			if (pInfo->fileData == nullptr)
+				SAFE_FREE(bitData);
 			exit(5);
 		}
 
@@ -2267,7 +2278,8 @@ void DirectXCreateTexture(const Renderer* const pRenderer, const TextureInfo* co
 		numBytes = pTexture->dx.allocation->GetSize();
 		DirectXCopyTexture(pRenderer, &texDesc, pTexture, numBytes);
 
-		SAFE_FREE(bitData);
+		if (pInfo->fileData == nullptr)
+			SAFE_FREE(bitData);
 		SAFE_FREE(texDesc.images);
 
 		texType = TEXTURE_TYPE_TEXTURE;
@@ -42,6 +42,29 @@ void UpdateOrthographicProjectionMatrix(Camera* cam)
 	cam->orthographicProjMat.SetRow(3, 0.0f, 0.0f, cam->nearP / nMinusF, 1.0f);
 }
 
+void GetFrustumPlanes(const Camera* cam, vec4* outPlanes)
+{
+	//clip = p * viewProj, so a point is inside when -w <= x <= w, -w <= y <= w and 0 <= z <= w
+	mat4 viewProj = cam->viewMat * cam->perspectiveProjMat;
+	vec4 x = viewProj.GetCol(0);
+	vec4 y = viewProj.GetCol(1);
+	vec4 z = viewProj.GetCol(2);
+	vec4 w = viewProj.GetCol(3);
+
+	outPlanes[0] = w + x;
+	outPlanes[1] = w - x;
+	outPlanes[2] = w + y;
+	outPlanes[3] = w - y;
+	outPlanes[4] = z;
+	outPlanes[5] = w - z;
+
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		vec3 normal(outPlanes[i].GetX(), outPlanes[i].GetY(), outPlanes[i].GetZ());
+		outPlanes[i] = outPlanes[i] * (1.0f / Length(normal));
+	}
+}
+
 void RotateCamera(Camera* cam, quat rot)
 {
 	cam->right = Rotate(rot, cam->right);
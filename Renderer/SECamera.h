@@ -35,6 +35,11 @@ void UpdatePerspectiveProjectionMatrix(Camera* cam);
 //Updates the orthographics projection matrix of the specified camera.
 void UpdateOrthographicProjectionMatrix(Camera* cam);
 
+//Computes the six planes of the view frustum of the perspective projection in world space.
+//The planes are (normal, distance) with unit normals pointing inside the frustum, in the order left, right, bottom, top, near, far.
+//Uses the current view and perspective projection matrices.
+void GetFrustumPlanes(const Camera* cam, vec4* outPlanes);
+
 //Rotates the camera using a rotation quaternion.
 //Updates the cameras axes.
 void RotateCamera(Camera* cam, quat rot);
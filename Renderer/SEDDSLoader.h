@@ -120,6 +120,15 @@ struct TextureDesc
     ImageInfo* images;
 };
 
+//The contents of a DDS file, read ahead of CreateTexture, for example on a loading thread.
+struct DDSFileData
+{
+    uint8_t* bitData;
+    uint32_t numBytes;
+    DDS_HEADER header;
+    DDS_HEADER_DXT10 header10;
+};
+
 inline void ReadDDSFile(const char* filename, uint8_t** bitData, uint32_t* numBytes, DDS_HEADER* ddsHeader, DDS_HEADER_DXT10* ddsHeader10)
 {
     FILE* file = nullptr;
@@ -526,3 +526,28 @@ void NewFrameApi()
 	else
 		ImGui_ImplDX12_NewFrame();
 }
+
+void GetPackedVertexInputInfo(uint32_t binding, VertexInputInfo* pVertexInputInfo)
+{
+	*pVertexInputInfo = VertexInputInfo{};
+	pVertexInputInfo->vertexBinding.binding = binding;
+	pVertexInputInfo->vertexBinding.stride = 20; //sizeof(PackedVertex)
+	pVertexInputInfo->vertexBinding.inputRate = INPUT_RATE_PER_VERTEX;
+
+	const char* semanticNames[4] = { "POSITION", "NORMAL", "TANGENT", "TEXCOORD" };
+	TinyImageFormat formats[4] = { TinyImageFormat_R16G16B16A16_UNORM, TinyImageFormat_R16G16_SNORM,
+		TinyImageFormat_R16G16_SNORM, TinyImageFormat_R16G16_SFLOAT };
+	uint32_t offsets[4] = { 0, 8, 12, 16 };
+
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		pVertexInputInfo->vertexAttributes[i].binding = binding;
+		pVertexInputInfo->vertexAttributes[i].location = i;
+		pVertexInputInfo->vertexAttributes[i].semanticName = semanticNames[i];
+		pVertexInputInfo->vertexAttributes[i].semanticIndex = 0;
+		pVertexInputInfo->vertexAttributes[i].format = formats[i];
+		pVertexInputInfo->vertexAttributes[i].offset = offsets[i];
+	}
+
+	pVertexInputInfo->numVertexAttributes = 4;
+}
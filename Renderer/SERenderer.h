@@ -481,6 +481,10 @@ struct TextureInfo
 {
 	const char* filename;
 
+	//If not nullptr the texture is created from this already read DDS file and filename is ignored.
+	//CreateTexture doesn't free the data.
+	const DDSFileData* fileData;
+
 	//ONLY NEED TO FILL THIS OUT IF FILENAME IS NULLPTR (YOU WANT TO CREATE AN EMPTY TEXTURE)
 	uint32_t width;
 	uint32_t height;
@@ -898,4 +902,8 @@ extern void (*SwapChainResize)(const Renderer* const pRenderer, const SwapChainI
 void InitSE();
 void ExitSE();
 void OnRendererApiSwitch();
-void NewFrameApi();
\ No newline at end of file
+void NewFrameApi();
+
+//Fills the binding and attributes for vertex buffers of PackedVertex (Mesh/SEPackedVertex.h).
+//The shaders decode them with the helpers in ShaderLibrary/*/packedVertex.h.*
+void GetPackedVertexInputInfo(uint32_t binding, VertexInputInfo* pVertexInputInfo);
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "../SEApp.h"
 #include "SERenderer.h"
 #include "../UI/SEUI.h"
+#include "../Loader/SEAsyncLoader.h"
+#include "../Math/SEMathBatch.h"
+#include "../Thread/SEThread.h"
 
 bool gAppPaused = false;
 bool gMinimized = false;
@@ -377,6 +380,9 @@ void OnApiSwitch(App* pApp, Window* pWindow, Timer* timer)
 {
 	pApp->Exit();
 
+	//The resources of the old renderer are gone, Init requests its assets again
+	CancelAllAssetLoads();
+
 	DestroyWindow(pWindow->wndHandle);
 	pWindow->wndHandle = nullptr;
 	ProcessMessages();
@@ -441,6 +447,15 @@ int WindowsMain(App* pApp)
 	InitUserInterface(&window);
 	CreateComponents(&window);
 
+	InitBatchMath();
+#ifdef _DEBUG
+	if (!CrossCheckBatchMathKernels(BATCH_MATH_CHECK_MAX_ULPS, nullptr))
+		MessageBoxA(nullptr, "A batch math kernel doesn't match the scalar kernel. Call CrossCheckBatchMathKernels for the results.", "Batch math error.", MB_OK);
+#endif
+
+	InitJobPool();
+	InitAsyncLoader();
+
 	gApp->Init();
 
 	MSG msg{};
@@ -510,6 +525,9 @@ int WindowsMain(App* pApp)
 				continue;
 			}
 
+			//Finished loads create their GPU resources on the main thread
+			DispatchAssetLoadCallbacks(ASYNC_LOADER_MAX_CALLBACKS_PER_FRAME);
+
 			gApp->Update(deltaTime);
 			gApp->Draw();
 		}
@@ -517,6 +535,8 @@ int WindowsMain(App* pApp)
 	}
 
 	gApp->Exit();
+	ExitAsyncLoader();
+	ExitJobPool();
 	DestroyMainComponent(&gFrameStatsWindow);
 	DestroyMainComponent(&gApiWindow);
 	DestroyUserInterface();
@@ -0,0 +1,23 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+//The transform of a shape drawn with ShapeBatch (Shapes/SEShapeBatch.h).
+//rows are the first three rows of the transposed model matrix.
+//Declare the buffer with the std430 layout so the array has a stride of 16 bytes.
+struct ShapeInstance
+{
+    vec4 rows[3];
+};
+
+vec4 TransformByInstance(ShapeInstance instance, vec4 position)
+{
+    return vec4(dot(instance.rows[0], position), dot(instance.rows[1], position), dot(instance.rows[2], position), position.w);
+}
+
+//Only correct for uniform scales, like multiplying by the model matrix
+vec4 TransformDirectionByInstance(ShapeInstance instance, vec4 direction)
+{
+    return vec4(dot(instance.rows[0].xyz, direction.xyz), dot(instance.rows[1].xyz, direction.xyz), dot(instance.rows[2].xyz, direction.xyz), 0.0f);
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef PACKED_VERTEX_H
+#define PACKED_VERTEX_H
+
+//Decodes the attributes of PackedVertex (Mesh/SEPackedVertex.h).
+//The vertex input already converts the unorm, snorm and half formats to floats.
+//inPos.xyz = position in the bounds of the mesh, inPos.w = handedness (0 or 1)
+//inNormal and inTangent are octahedral encoded.
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    
+    //Unfold the lower half
+    float t = max(-n.z, 0.0f);
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.y += (n.y >= 0.0f) ? -t : t;
+    
+    return normalize(n);
+}
+
+//positionOffset and positionScale are VertexQuantization::offset and VertexQuantization::scale of the mesh.
+vec4 DecodePackedPosition(vec4 inPos, vec3 positionOffset, vec3 positionScale)
+{
+    return vec4(positionOffset + inPos.xyz * positionScale, 1.0f);
+}
+
+vec4 DecodePackedNormal(vec2 inNormal)
+{
+    return vec4(DecodeOctahedral(inNormal), 0.0f);
+}
+
+//w is the handedness of the tangent frame, the same as Vertex::tangent.w
+vec4 DecodePackedTangent(vec2 inTangent, vec4 inPos)
+{
+    return vec4(DecodeOctahedral(inTangent), inPos.w * 2.0f - 1.0f);
+}
+
+#endif
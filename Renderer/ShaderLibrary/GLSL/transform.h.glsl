@@ -0,0 +1,106 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+//The compact transforms of the math library (Math/SEMath.h), with the same layout, for uniform and instance buffers.
+//They are smaller than a mat4 model matrix and need no inverse model matrix for the normals.
+
+//mat3x4, an affine transform. rows are the first three rows of the transposed model matrix.
+struct Matrix3x4
+{
+    vec4 rows[3];
+};
+
+//trs, p * scale rotated by rotation, plus translation. rotation is a unit quaternion (x, y, z, scalar).
+struct TransformTRS
+{
+    vec4 rotation;
+
+    //xyz is the translation, w the uniform scale
+    vec4 translationScale;
+};
+
+//dualquat, a rotation by real, then a translation of 2 * dual * conjugate(real)
+struct DualQuaternion
+{
+    vec4 real;
+    vec4 dual;
+};
+
+vec3 RotateByQuaternion(vec4 q, vec3 v)
+{
+    vec3 t = 2.0f * cross(q.xyz, v);
+    return v + q.w * t + cross(q.xyz, t);
+}
+
+vec3 TransformPointByMatrix3x4(Matrix3x4 mat, vec3 p)
+{
+    vec4 position = vec4(p, 1.0f);
+    return vec3(dot(mat.rows[0], position), dot(mat.rows[1], position), dot(mat.rows[2], position));
+}
+
+vec3 TransformVectorByMatrix3x4(Matrix3x4 mat, vec3 v)
+{
+    return vec3(dot(mat.rows[0].xyz, v), dot(mat.rows[1].xyz, v), dot(mat.rows[2].xyz, v));
+}
+
+//The cofactors of the 3x3 part are its inverse transpose times the determinant, correct for non-uniform scales.
+//Normalize the result.
+vec3 TransformNormalByMatrix3x4(Matrix3x4 mat, vec3 n)
+{
+    return vec3(dot(cross(mat.rows[1].xyz, mat.rows[2].xyz), n),
+        dot(cross(mat.rows[2].xyz, mat.rows[0].xyz), n),
+        dot(cross(mat.rows[0].xyz, mat.rows[1].xyz), n));
+}
+
+vec3 TransformPointByTRS(TransformTRS transform, vec3 p)
+{
+    return RotateByQuaternion(transform.rotation, p * transform.translationScale.w) + transform.translationScale.xyz;
+}
+
+//Also transforms normals, a uniform scale doesn't change their direction. Normalize the result if the scale isn't 1.
+vec3 TransformVectorByTRS(TransformTRS transform, vec3 v)
+{
+    return RotateByQuaternion(transform.rotation, v * transform.translationScale.w);
+}
+
+vec3 GetDualQuaternionTranslation(DualQuaternion dq)
+{
+    vec4 r = dq.real;
+    vec4 d = dq.dual;
+
+    //Vector part of 2 * dual * conjugate(real)
+    return 2.0f * (r.w * d.xyz - d.w * r.xyz + cross(r.xyz, d.xyz));
+}
+
+vec3 TransformPointByDualQuaternion(DualQuaternion dq, vec3 p)
+{
+    return RotateByQuaternion(dq.real, p) + GetDualQuaternionTranslation(dq);
+}
+
+//Also transforms normals
+vec3 TransformVectorByDualQuaternion(DualQuaternion dq, vec3 v)
+{
+    return RotateByQuaternion(dq.real, v);
+}
+
+//Skinning: the weighted sum of four joint transforms, normalized. Quaternions on the other side of the sphere from
+//dq0 are negated so the blend takes the short way.
+DualQuaternion BlendDualQuaternions(DualQuaternion dq0, DualQuaternion dq1, DualQuaternion dq2, DualQuaternion dq3, vec4 weights)
+{
+    weights.y *= (dot(dq0.real, dq1.real) < 0.0f) ? -1.0f : 1.0f;
+    weights.z *= (dot(dq0.real, dq2.real) < 0.0f) ? -1.0f : 1.0f;
+    weights.w *= (dot(dq0.real, dq3.real) < 0.0f) ? -1.0f : 1.0f;
+
+    DualQuaternion result;
+    result.real = weights.x * dq0.real + weights.y * dq1.real + weights.z * dq2.real + weights.w * dq3.real;
+    result.dual = weights.x * dq0.dual + weights.y * dq1.dual + weights.z * dq2.dual + weights.w * dq3.dual;
+
+    float invLength = inversesqrt(dot(result.real, result.real));
+    result.real *= invLength;
+    result.dual *= invLength;
+    result.dual -= result.real * dot(result.real, result.dual);
+
+    return result;
+}
+
+#endif
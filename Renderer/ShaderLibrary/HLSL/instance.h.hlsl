@@ -0,0 +1,22 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+//The transform of a shape drawn with ShapeBatch (Shapes/SEShapeBatch.h).
+//rows are the first three rows of the transposed model matrix.
+struct ShapeInstance
+{
+    float4 rows[3];
+};
+
+float4 TransformByInstance(ShapeInstance instance, float4 position)
+{
+    return float4(dot(instance.rows[0], position), dot(instance.rows[1], position), dot(instance.rows[2], position), position.w);
+}
+
+//Only correct for uniform scales, like multiplying by the model matrix
+float4 TransformDirectionByInstance(ShapeInstance instance, float4 direction)
+{
+    return float4(dot(instance.rows[0].xyz, direction.xyz), dot(instance.rows[1].xyz, direction.xyz), dot(instance.rows[2].xyz, direction.xyz), 0.0f);
+}
+
+#endif
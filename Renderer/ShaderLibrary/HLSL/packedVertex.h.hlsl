@@ -0,0 +1,44 @@
+#ifndef PACKED_VERTEX_H
+#define PACKED_VERTEX_H
+
+//Decodes the attributes of PackedVertex (Mesh/SEPackedVertex.h).
+//The input assembler already converts the unorm, snorm and half formats to floats.
+
+struct PackedVertexInput
+{
+    float4 inPos : POSITION; //xyz = position in the bounds of the mesh, w = handedness (0 or 1)
+    float2 inNormal : NORMAL; //octahedral
+    float2 inTangent : TANGENT; //octahedral
+    float2 inTexCoords : TEXCOORD;
+};
+
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    
+    //Unfold the lower half
+    float t = max(-n.z, 0.0f);
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.y += (n.y >= 0.0f) ? -t : t;
+    
+    return normalize(n);
+}
+
+//positionOffset and positionScale are VertexQuantization::offset and VertexQuantization::scale of the mesh.
+float4 DecodePackedPosition(float4 inPos, float3 positionOffset, float3 positionScale)
+{
+    return float4(positionOffset + inPos.xyz * positionScale, 1.0f);
+}
+
+float4 DecodePackedNormal(float2 inNormal)
+{
+    return float4(DecodeOctahedral(inNormal), 0.0f);
+}
+
+//w is the handedness of the tangent frame, the same as Vertex::tangent.w
+float4 DecodePackedTangent(float2 inTangent, float4 inPos)
+{
+    return float4(DecodeOctahedral(inTangent), inPos.w * 2.0f - 1.0f);
+}
+
+#endif
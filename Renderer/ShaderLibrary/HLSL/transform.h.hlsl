@@ -0,0 +1,106 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+//The compact transforms of the math library (Math/SEMath.h), with the same layout, for uniform and instance buffers.
+//They are smaller than a float4x4 model matrix and need no inverse model matrix for the normals.
+
+//mat3x4, an affine transform. rows are the first three rows of the transposed model matrix.
+struct Matrix3x4
+{
+    float4 rows[3];
+};
+
+//trs, p * scale rotated by rotation, plus translation. rotation is a unit quaternion (x, y, z, scalar).
+struct TransformTRS
+{
+    float4 rotation;
+
+    //xyz is the translation, w the uniform scale
+    float4 translationScale;
+};
+
+//dualquat, a rotation by real, then a translation of 2 * dual * conjugate(real)
+struct DualQuaternion
+{
+    float4 real;
+    float4 dual;
+};
+
+float3 RotateByQuaternion(float4 q, float3 v)
+{
+    float3 t = 2.0f * cross(q.xyz, v);
+    return v + q.w * t + cross(q.xyz, t);
+}
+
+float3 TransformPointByMatrix3x4(Matrix3x4 mat, float3 p)
+{
+    float4 position = float4(p, 1.0f);
+    return float3(dot(mat.rows[0], position), dot(mat.rows[1], position), dot(mat.rows[2], position));
+}
+
+float3 TransformVectorByMatrix3x4(Matrix3x4 mat, float3 v)
+{
+    return float3(dot(mat.rows[0].xyz, v), dot(mat.rows[1].xyz, v), dot(mat.rows[2].xyz, v));
+}
+
+//The cofactors of the 3x3 part are its inverse transpose times the determinant, correct for non-uniform scales.
+//Normalize the result.
+float3 TransformNormalByMatrix3x4(Matrix3x4 mat, float3 n)
+{
+    return float3(dot(cross(mat.rows[1].xyz, mat.rows[2].xyz), n),
+        dot(cross(mat.rows[2].xyz, mat.rows[0].xyz), n),
+        dot(cross(mat.rows[0].xyz, mat.rows[1].xyz), n));
+}
+
+float3 TransformPointByTRS(TransformTRS transform, float3 p)
+{
+    return RotateByQuaternion(transform.rotation, p * transform.translationScale.w) + transform.translationScale.xyz;
+}
+
+//Also transforms normals, a uniform scale doesn't change their direction. Normalize the result if the scale isn't 1.
+float3 TransformVectorByTRS(TransformTRS transform, float3 v)
+{
+    return RotateByQuaternion(transform.rotation, v * transform.translationScale.w);
+}
+
+float3 GetDualQuaternionTranslation(DualQuaternion dq)
+{
+    float4 r = dq.real;
+    float4 d = dq.dual;
+
+    //Vector part of 2 * dual * conjugate(real)
+    return 2.0f * (r.w * d.xyz - d.w * r.xyz + cross(r.xyz, d.xyz));
+}
+
+float3 TransformPointByDualQuaternion(DualQuaternion dq, float3 p)
+{
+    return RotateByQuaternion(dq.real, p) + GetDualQuaternionTranslation(dq);
+}
+
+//Also transforms normals
+float3 TransformVectorByDualQuaternion(DualQuaternion dq, float3 v)
+{
+    return RotateByQuaternion(dq.real, v);
+}
+
+//Skinning: the weighted sum of four joint transforms, normalized. Quaternions on the other side of the sphere from
+//dq0 are negated so the blend takes the short way.
+DualQuaternion BlendDualQuaternions(DualQuaternion dq0, DualQuaternion dq1, DualQuaternion dq2, DualQuaternion dq3, float4 weights)
+{
+    weights.y *= (dot(dq0.real, dq1.real) < 0.0f) ? -1.0f : 1.0f;
+    weights.z *= (dot(dq0.real, dq2.real) < 0.0f) ? -1.0f : 1.0f;
+    weights.w *= (dot(dq0.real, dq3.real) < 0.0f) ? -1.0f : 1.0f;
+
+    DualQuaternion result;
+    result.real = weights.x * dq0.real + weights.y * dq1.real + weights.z * dq2.real + weights.w * dq3.real;
+    result.dual = weights.x * dq0.dual + weights.y * dq1.dual + weights.z * dq2.dual + weights.w * dq3.dual;
+
+    float invLength = rsqrt(dot(result.real, result.real));
+    result.real *= invLength;
+    result.dual *= invLength;
+    result.dual -= result.real * dot(result.real, result.dual);
+
+    return result;
+}
+
+#endif
@@ -1483,8 +1483,9 @@ void VulkanCreateRootSignature(const Renderer* const pRenderer, const RootSignat
 			type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
 			break;
 
+		//A read-only structured buffer, a readonly std430 buffer block in GLSL
 		case DESCRIPTOR_TYPE_BUFFER:
-			type = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+			type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			break;
 
 		case DESCRIPTOR_TYPE_RW_BUFFER:
@@ -2199,10 +2200,7 @@ void VulkanCreateBuffer(const Renderer* const pRenderer, const BufferInfo* const
 	if (pBufferInfo->type & BUFFER_TYPE_UNIFORM)
 		bufferCreateInfo.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 
-	if (pBufferInfo->type & BUFFER_TYPE_BUFFER)
-		bufferCreateInfo.usage |= VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
-
-	if (pBufferInfo->type & BUFFER_TYPE_RW_BUFFER)
+	if (pBufferInfo->type & (BUFFER_TYPE_BUFFER | BUFFER_TYPE_RW_BUFFER))
 		bufferCreateInfo.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
 
 	if(copyData)
@@ -2368,7 +2366,7 @@ void VulkanUpdateDescriptorSet(const Renderer* const pRenderer, const Descriptor
 				break;
 
 			case UPDATE_TYPE_BUFFER:
-				descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+				descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 				break;
 			}
 
@@ -2512,20 +2510,31 @@ void VulkanCreateTexture(const Renderer* const pRenderer, const TextureInfo* pIn
 	TextureDesc texInfo{};
 	VkImageCreateInfo createImageInfo{};
 	bool isDepth = TinyImageFormat_IsDepthOnly(pInfo->format) || TinyImageFormat_IsDepthAndStencil(pInfo->format);
-	if (pInfo->filename != nullptr)
+	if (pInfo->filename != nullptr || pInfo->fileData != nullptr)
 	{
 		uint8_t* bitData = nullptr;
 		uint32_t numBytes = 0;
 		DDS_HEADER ddsHeader{};
 		DDS_HEADER_DXT10 ddsHeader10{};
-		ReadDDSFile(pInfo->filename, &bitData, &numBytes, &ddsHeader, &ddsHeader10);
+		if (pInfo->fileData != nullptr)
+		{
+			bitData = pInfo->fileData->bitData;
+			numBytes = pInfo->fileData->numBytes;
+			ddsHeader = pInfo->fileData->header;
+			ddsHeader10 = pInfo->fileData->header10;
+		}
+		else
+		{
+			ReadDDSFile(pInfo->filename, &bitData, &numBytes, &ddsHeader, &ddsHeader10);
+		}
 
 		int result = RetrieveTextureInfo(&ddsHeader, &ddsHeader10, bitData, numBytes, &texInfo);
 		if (result != SE_SUCCESS)
 		{
 			MessageBox(nullptr, L"Error with function RetrieveTextureInfo in function VulkanCreateTexture. Exiting Program.",
 				L"RetrieveTextureInfo Error", MB_OK);
-			free(bitData);
+			if (pInfo->fileData == nullptr)
+				free(bitData);
 			exit(5);
 		}
 
@@ -2545,7 +2554,8 @@ void VulkanCreateTexture(const Renderer* const pRenderer, const TextureInfo* pIn
 
 		vmaUnmapMemory(pRenderer->vk.allocator, gVulkanCopyEngine.buffer.vk.allocation);
 
-		free(bitData);
+		if (pInfo->fileData == nullptr)
+			free(bitData);
 		free(texInfo.images);
 
 		createImageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
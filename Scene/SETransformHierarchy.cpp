@@ -0,0 +1,371 @@
+#include <immintrin.h>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include "SETransformHierarchy.h"
+#include "../Thread/SEThread.h"
+
+//Scale * Rotation * Translate, built like UpdateModelMatrix
+inline mat4 ComposeLocalMatrix(vec3 position, quat orientation, vec3 scale)
+{
+	mat4 rotation = QuaternionToMatrix(orientation);
+
+	return mat4(rotation.GetRow(0) * scale.GetX(), rotation.GetRow(1) * scale.GetY(), rotation.GetRow(2) * scale.GetZ(),
+		vec4(position.GetX(), position.GetY(), position.GetZ(), 1.0f));
+}
+
+inline void UpdateWorldMatrix(TransformHierarchy* hierarchy, uint32_t node)
+{
+	mat4 local = ComposeLocalMatrix(hierarchy->positions[node], hierarchy->orientations[node], hierarchy->scales[node]);
+	uint32_t parent = hierarchy->parents[node];
+
+	hierarchy->worldMatrices[node] = (parent == TRANSFORM_NO_PARENT) ? local : local * hierarchy->worldMatrices[parent];
+	hierarchy->dirty[node] = 0;
+}
+
+inline void MarkTransformDirty(TransformHierarchy* hierarchy, uint32_t node)
+{
+	if (hierarchy->dirty[node] == 0)
+	{
+		hierarchy->dirty[node] = 1;
+		arrpush(hierarchy->dirtyHandles, hierarchy->handles[node]);
+	}
+}
+
+//Inserts count uninitialized nodes at the index at and fixes the indices of the nodes after them.
+//The subtree sizes of the ancestors are left to the caller.
+void InsertTransformNodes(TransformHierarchy* hierarchy, uint32_t at, uint32_t count)
+{
+	arrinsn(hierarchy->parents, at, count);
+	arrinsn(hierarchy->subtreeSizes, at, count);
+	arrinsn(hierarchy->handles, at, count);
+	arrinsn(hierarchy->positions, at, count);
+	arrinsn(hierarchy->orientations, at, count);
+	arrinsn(hierarchy->scales, at, count);
+	arrinsn(hierarchy->worldMatrices, at, count);
+	arrinsn(hierarchy->dirty, at, count);
+
+	uint32_t numNodes = (uint32_t)arrlenu(hierarchy->parents);
+	for (uint32_t i = at + count; i < numNodes; ++i)
+	{
+		if (hierarchy->parents[i] != TRANSFORM_NO_PARENT && hierarchy->parents[i] >= at)
+			hierarchy->parents[i] += count;
+
+		hierarchy->nodeIndices[hierarchy->handles[i]] = i;
+	}
+}
+
+//Removes the nodes [first, first + count), which must be whole subtrees, and fixes the indices of the nodes after them.
+//The subtree sizes of the ancestors are left to the caller.
+void RemoveTransformNodes(TransformHierarchy* hierarchy, uint32_t first, uint32_t count)
+{
+	arrdeln(hierarchy->parents, first, count);
+	arrdeln(hierarchy->subtreeSizes, first, count);
+	arrdeln(hierarchy->handles, first, count);
+	arrdeln(hierarchy->positions, first, count);
+	arrdeln(hierarchy->orientations, first, count);
+	arrdeln(hierarchy->scales, first, count);
+	arrdeln(hierarchy->worldMatrices, first, count);
+	arrdeln(hierarchy->dirty, first, count);
+
+	uint32_t numNodes = (uint32_t)arrlenu(hierarchy->parents);
+	for (uint32_t i = first; i < numNodes; ++i)
+	{
+		if (hierarchy->parents[i] != TRANSFORM_NO_PARENT && hierarchy->parents[i] >= first)
+			hierarchy->parents[i] -= count;
+
+		hierarchy->nodeIndices[hierarchy->handles[i]] = i;
+	}
+}
+
+//Adds delta to the subtree sizes of the node and its ancestors
+void ResizeTransformSubtrees(TransformHierarchy* hierarchy, uint32_t node, int32_t delta)
+{
+	while (node != TRANSFORM_NO_PARENT)
+	{
+		hierarchy->subtreeSizes[node] += delta;
+		node = hierarchy->parents[node];
+	}
+}
+
+//The index a new child of parent is inserted at, after the subtree of parent
+inline uint32_t GetChildInsertIndex(const TransformHierarchy* hierarchy, uint32_t parent)
+{
+	if (parent == TRANSFORM_NO_PARENT)
+		return (uint32_t)arrlenu(hierarchy->parents);
+
+	return parent + hierarchy->subtreeSizes[parent];
+}
+
+inline uint32_t GetParentNode(const TransformHierarchy* hierarchy, TransformHandle parent)
+{
+	return (parent == TRANSFORM_INVALID_HANDLE) ? TRANSFORM_NO_PARENT : hierarchy->nodeIndices[parent];
+}
+
+void CreateTransformHierarchy(TransformHierarchy* hierarchy)
+{
+	*hierarchy = TransformHierarchy{};
+}
+
+void DestroyTransformHierarchy(TransformHierarchy* hierarchy)
+{
+	arrfree(hierarchy->parents);
+	arrfree(hierarchy->subtreeSizes);
+	arrfree(hierarchy->handles);
+	arrfree(hierarchy->positions);
+	arrfree(hierarchy->orientations);
+	arrfree(hierarchy->scales);
+	arrfree(hierarchy->worldMatrices);
+	arrfree(hierarchy->dirty);
+	arrfree(hierarchy->dirtyHandles);
+	arrfree(hierarchy->nodeIndices);
+	arrfree(hierarchy->freeHandles);
+	arrfree(hierarchy->updatedRanges);
+	arrfree(hierarchy->sortedDirtyNodes);
+	arrfree(hierarchy->workRanges);
+
+	*hierarchy = TransformHierarchy{};
+}
+
+TransformHandle AddTransform(TransformHierarchy* hierarchy, TransformHandle parent, vec3 position, quat orientation, vec3 scale)
+{
+	TransformHandle handle;
+	if (arrlenu(hierarchy->freeHandles) > 0)
+	{
+		handle = arrpop(hierarchy->freeHandles);
+	}
+	else
+	{
+		handle = (TransformHandle)arrlenu(hierarchy->nodeIndices);
+		arrpush(hierarchy->nodeIndices, TRANSFORM_NO_PARENT);
+	}
+
+	uint32_t parentNode = GetParentNode(hierarchy, parent);
+	uint32_t node = GetChildInsertIndex(hierarchy, parentNode);
+	InsertTransformNodes(hierarchy, node, 1);
+	ResizeTransformSubtrees(hierarchy, parentNode, 1);
+
+	hierarchy->parents[node] = parentNode;
+	hierarchy->subtreeSizes[node] = 1;
+	hierarchy->handles[node] = handle;
+	hierarchy->positions[node] = position;
+	hierarchy->orientations[node] = orientation;
+	hierarchy->scales[node] = scale;
+	hierarchy->worldMatrices[node] = mat4::MakeIdentity();
+	hierarchy->dirty[node] = 0;
+	hierarchy->nodeIndices[handle] = node;
+
+	MarkTransformDirty(hierarchy, node);
+
+	return handle;
+}
+
+void RemoveTransform(TransformHierarchy* hierarchy, TransformHandle handle)
+{
+	uint32_t node = hierarchy->nodeIndices[handle];
+	uint32_t count = hierarchy->subtreeSizes[node];
+
+	//The handles may still be in dirtyHandles, UpdateTransformHierarchy skips them if they are still free
+	for (uint32_t i = node; i < node + count; ++i)
+	{
+		hierarchy->nodeIndices[hierarchy->handles[i]] = TRANSFORM_NO_PARENT;
+		arrpush(hierarchy->freeHandles, hierarchy->handles[i]);
+	}
+
+	ResizeTransformSubtrees(hierarchy, hierarchy->parents[node], -(int32_t)count);
+	RemoveTransformNodes(hierarchy, node, count);
+}
+
+void SetTransformParent(TransformHierarchy* hierarchy, TransformHandle handle, TransformHandle newParent)
+{
+	uint32_t node = hierarchy->nodeIndices[handle];
+	uint32_t count = hierarchy->subtreeSizes[node];
+	assert((newParent == TRANSFORM_INVALID_HANDLE || hierarchy->nodeIndices[newParent] - node >= count) && "The new parent is in the subtree");
+
+	//Copy the subtree out, with the parents relative to the first node
+	uint32_t* parents = (uint32_t*)malloc(count * sizeof(uint32_t));
+	uint32_t* subtreeSizes = (uint32_t*)malloc(count * sizeof(uint32_t));
+	TransformHandle* handles = (TransformHandle*)malloc(count * sizeof(TransformHandle));
+	vec3* positions = (vec3*)malloc(count * sizeof(vec3));
+	quat* orientations = (quat*)malloc(count * sizeof(quat));
+	vec3* scales = (vec3*)malloc(count * sizeof(vec3));
+	mat4* worldMatrices = (mat4*)_mm_malloc(count * sizeof(mat4), 16);
+	uint8_t* dirty = (uint8_t*)malloc(count * sizeof(uint8_t));
+
+	for (uint32_t i = 0; i < count; ++i)
+		parents[i] = hierarchy->parents[node + i] - node;
+
+	memcpy(subtreeSizes, hierarchy->subtreeSizes + node, count * sizeof(uint32_t));
+	memcpy(handles, hierarchy->handles + node, count * sizeof(TransformHandle));
+	memcpy(positions, hierarchy->positions + node, count * sizeof(vec3));
+	memcpy(orientations, hierarchy->orientations + node, count * sizeof(quat));
+	memcpy(scales, hierarchy->scales + node, count * sizeof(vec3));
+	memcpy(worldMatrices, hierarchy->worldMatrices + node, count * sizeof(mat4));
+	memcpy(dirty, hierarchy->dirty + node, count * sizeof(uint8_t));
+
+	ResizeTransformSubtrees(hierarchy, hierarchy->parents[node], -(int32_t)count);
+	RemoveTransformNodes(hierarchy, node, count);
+
+	uint32_t parentNode = GetParentNode(hierarchy, newParent);
+	uint32_t newNode = GetChildInsertIndex(hierarchy, parentNode);
+	InsertTransformNodes(hierarchy, newNode, count);
+	ResizeTransformSubtrees(hierarchy, parentNode, (int32_t)count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		hierarchy->parents[newNode + i] = (i == 0) ? parentNode : parents[i] + newNode;
+		hierarchy->nodeIndices[handles[i]] = newNode + i;
+	}
+
+	memcpy(hierarchy->subtreeSizes + newNode, subtreeSizes, count * sizeof(uint32_t));
+	memcpy(hierarchy->handles + newNode, handles, count * sizeof(TransformHandle));
+	memcpy(hierarchy->positions + newNode, positions, count * sizeof(vec3));
+	memcpy(hierarchy->orientations + newNode, orientations, count * sizeof(quat));
+	memcpy(hierarchy->scales + newNode, scales, count * sizeof(vec3));
+	memcpy(hierarchy->worldMatrices + newNode, worldMatrices, count * sizeof(mat4));
+	memcpy(hierarchy->dirty + newNode, dirty, count * sizeof(uint8_t));
+
+	free(parents);
+	free(subtreeSizes);
+	free(handles);
+	free(positions);
+	free(orientations);
+	free(scales);
+	_mm_free(worldMatrices);
+	free(dirty);
+
+	//The world matrices of the subtree are recomputed from its root
+	MarkTransformDirty(hierarchy, newNode);
+}
+
+void SetLocalTransform(TransformHierarchy* hierarchy, TransformHandle handle, vec3 position, quat orientation, vec3 scale)
+{
+	uint32_t node = hierarchy->nodeIndices[handle];
+	hierarchy->positions[node] = position;
+	hierarchy->orientations[node] = orientation;
+	hierarchy->scales[node] = scale;
+
+	MarkTransformDirty(hierarchy, node);
+}
+
+void GetLocalTransform(const TransformHierarchy* hierarchy, TransformHandle handle, vec3* outPosition, quat* outOrientation, vec3* outScale)
+{
+	uint32_t node = hierarchy->nodeIndices[handle];
+	*outPosition = hierarchy->positions[node];
+	*outOrientation = hierarchy->orientations[node];
+	*outScale = hierarchy->scales[node];
+}
+
+const mat4* GetWorldMatrix(const TransformHierarchy* hierarchy, TransformHandle handle)
+{
+	return &hierarchy->worldMatrices[hierarchy->nodeIndices[handle]];
+}
+
+int CompareTransformNodes(const void* a, const void* b)
+{
+	uint32_t nodeA = *(const uint32_t*)a;
+	uint32_t nodeB = *(const uint32_t*)b;
+
+	return (nodeA < nodeB) ? -1 : ((nodeA > nodeB) ? 1 : 0);
+}
+
+//Nodes are in depth first order, so walking a subtree front to back updates every parent before its children
+void UpdateTransformRanges(void* data, uint32_t begin, uint32_t end)
+{
+	TransformHierarchy* hierarchy = (TransformHierarchy*)data;
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		TransformRange range = hierarchy->workRanges[i];
+		for (uint32_t node = range.first; node < range.first + range.count; ++node)
+			UpdateWorldMatrix(hierarchy, node);
+	}
+}
+
+void UpdateTransformHierarchy(TransformHierarchy* hierarchy)
+{
+	arrsetlen(hierarchy->updatedRanges, 0);
+	if (arrlenu(hierarchy->dirtyHandles) == 0)
+		return;
+
+	arrsetlen(hierarchy->sortedDirtyNodes, 0);
+	for (size_t i = 0; i < arrlenu(hierarchy->dirtyHandles); ++i)
+	{
+		uint32_t node = hierarchy->nodeIndices[hierarchy->dirtyHandles[i]];
+		if (node != TRANSFORM_NO_PARENT)
+			arrpush(hierarchy->sortedDirtyNodes, node);
+	}
+	arrsetlen(hierarchy->dirtyHandles, 0);
+
+	//Sorted, a dirty node inside the subtree of an earlier dirty node is covered by it
+	uint32_t numDirtyNodes = (uint32_t)arrlenu(hierarchy->sortedDirtyNodes);
+	qsort(hierarchy->sortedDirtyNodes, numDirtyNodes, sizeof(uint32_t), CompareTransformNodes);
+
+	uint32_t coveredEnd = 0;
+	uint32_t numUpdatedNodes = 0;
+	for (uint32_t i = 0; i < numDirtyNodes; ++i)
+	{
+		uint32_t node = hierarchy->sortedDirtyNodes[i];
+		if (node < coveredEnd)
+			continue;
+
+		TransformRange range{ node, hierarchy->subtreeSizes[node] };
+		arrpush(hierarchy->updatedRanges, range);
+		coveredEnd = range.first + range.count;
+		numUpdatedNodes += range.count;
+	}
+
+	arrsetlen(hierarchy->workRanges, 0);
+	if (numUpdatedNodes < TRANSFORM_PARALLEL_MIN_NODES)
+	{
+		for (size_t i = 0; i < arrlenu(hierarchy->updatedRanges); ++i)
+			arrpush(hierarchy->workRanges, hierarchy->updatedRanges[i]);
+
+		UpdateTransformRanges(hierarchy, 0, (uint32_t)arrlenu(hierarchy->workRanges));
+		return;
+	}
+
+	//A few big subtrees would leave threads idle. Their roots are updated here and their children become the work instead,
+	//until every range is small enough to balance across the threads.
+	uint32_t maxRangeSize = numUpdatedNodes / (GetNumLogicalCores() * 4);
+	maxRangeSize = (maxRangeSize < TRANSFORM_PARALLEL_MIN_NODES / 4) ? TRANSFORM_PARALLEL_MIN_NODES / 4 : maxRangeSize;
+
+	TransformRange* stack = nullptr;
+	for (size_t i = arrlenu(hierarchy->updatedRanges); i > 0; --i)
+		arrpush(stack, hierarchy->updatedRanges[i - 1]);
+
+	while (arrlenu(stack) > 0)
+	{
+		TransformRange range = arrpop(stack);
+		if (range.count <= maxRangeSize)
+		{
+			arrpush(hierarchy->workRanges, range);
+			continue;
+		}
+
+		UpdateWorldMatrix(hierarchy, range.first);
+
+		uint32_t end = range.first + range.count;
+		uint32_t numChildren = 0;
+		for (uint32_t child = range.first + 1; child < end; child += hierarchy->subtreeSizes[child])
+		{
+			TransformRange childRange{ child, hierarchy->subtreeSizes[child] };
+			arrpush(stack, childRange);
+			++numChildren;
+		}
+
+		//Keep the children in order
+		for (uint32_t j = 0; j < numChildren / 2; ++j)
+		{
+			TransformRange temp = stack[arrlenu(stack) - 1 - j];
+			stack[arrlenu(stack) - 1 - j] = stack[arrlenu(stack) - numChildren + j];
+			stack[arrlenu(stack) - numChildren + j] = temp;
+		}
+	}
+	arrfree(stack);
+
+	//Enough ranges per thread to hold about maxRangeSize nodes
+	uint32_t numWorkRanges = (uint32_t)arrlenu(hierarchy->workRanges);
+	uint32_t minRangesPerThread = (uint32_t)(((uint64_t)numWorkRanges * maxRangeSize) / numUpdatedNodes);
+	ParallelFor(numWorkRanges, (minRangesPerThread > 0) ? minRangesPerThread : 1, UpdateTransformRanges, hierarchy);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../Math/SEMath_Header.h"
+#include "../ThirdParty/stb_ds.h"
+
+#define TRANSFORM_INVALID_HANDLE 0xFFFFFFFF
+#define TRANSFORM_NO_PARENT 0xFFFFFFFF
+
+//Dirty subtrees with fewer nodes in total are updated on the calling thread only.
+//Larger updates are split across the persistent workers of ParallelFor, which only costs waking them.
+#define TRANSFORM_PARALLEL_MIN_NODES 4096
+
+//Stays the same when nodes move in the arrays
+typedef uint32_t TransformHandle;
+
+//The nodes [first, first + count)
+struct TransformRange
+{
+	uint32_t first;
+	uint32_t count;
+};
+
+//A forest of transforms stored as flat arrays with one entry per node, sorted depth first.
+//A parent is always before its children and the subtree of node i is [i, i + subtreeSizes[i]),
+//so subtrees are contiguous and every subtree whose parent didn't change can be updated on its own.
+//Every pointer is a stb_ds array.
+struct TransformHierarchy
+{
+	//Index of the parent node, TRANSFORM_NO_PARENT for roots
+	uint32_t* parents;
+	uint32_t* subtreeSizes;
+	TransformHandle* handles;
+
+	//The transform relative to the parent
+	vec3* positions;
+	quat* orientations;
+	vec3* scales;
+
+	//Scale * Rotation * Translate * world matrix of the parent
+	mat4* worldMatrices;
+
+	//1 if the local transform changed since the last update, the handle of the node is in dirtyHandles then
+	uint8_t* dirty;
+	TransformHandle* dirtyHandles;
+
+	//Node index of every handle, TRANSFORM_NO_PARENT for free handles
+	uint32_t* nodeIndices;
+	TransformHandle* freeHandles;
+
+	//The subtrees whose world matrices changed during the last UpdateTransformHierarchy, sorted by first.
+	//Only valid until the hierarchy is changed.
+	TransformRange* updatedRanges;
+
+	//Scratch of UpdateTransformHierarchy
+	uint32_t* sortedDirtyNodes;
+	TransformRange* workRanges;
+};
+
+void CreateTransformHierarchy(TransformHierarchy* hierarchy);
+void DestroyTransformHierarchy(TransformHierarchy* hierarchy);
+
+//Adds a node as the last child of parent, or as a root if parent is TRANSFORM_INVALID_HANDLE.
+//Moves the nodes after the subtree of parent, the world matrix is valid after the next update.
+TransformHandle AddTransform(TransformHierarchy* hierarchy, TransformHandle parent, vec3 position, quat orientation, vec3 scale);
+
+//Removes the node and its whole subtree. Their handles can be returned by AddTransform again.
+void RemoveTransform(TransformHierarchy* hierarchy, TransformHandle handle);
+
+//Moves the subtree of the node under newParent, or to the roots if newParent is TRANSFORM_INVALID_HANDLE.
+//The local transform is kept, so the world matrices of the subtree change with the next update.
+//newParent can't be in the subtree of the node.
+void SetTransformParent(TransformHierarchy* hierarchy, TransformHandle handle, TransformHandle newParent);
+
+//Marks the node dirty. Nodes that are never set cost nothing in UpdateTransformHierarchy.
+void SetLocalTransform(TransformHierarchy* hierarchy, TransformHandle handle, vec3 position, quat orientation, vec3 scale);
+void GetLocalTransform(const TransformHierarchy* hierarchy, TransformHandle handle, vec3* outPosition, quat* outOrientation, vec3* outScale);
+
+//The world matrix as of the last UpdateTransformHierarchy
+const mat4* GetWorldMatrix(const TransformHierarchy* hierarchy, TransformHandle handle);
+
+//Recomputes the world matrices of the subtrees of the dirty nodes and nothing else.
+//The subtrees are independent, so they are split across threads when there are enough dirty nodes,
+//large subtrees are split into the subtrees of their children.
+void UpdateTransformHierarchy(TransformHierarchy* hierarchy);
@@ -0,0 +1,219 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "SEShapeBatch.h"
+
+//Number of arrays of a ShapeBatch. They are allocated as one block in the order of the struct, positionX owns the block.
+#define SHAPE_BATCH_NUM_ARRAYS 10
+
+//The array pointers are consecutive members of ShapeBatch
+inline float** GetShapeBatchArrays(ShapeBatch* batch)
+{
+	return &batch->positionX;
+}
+
+inline float* const* GetShapeBatchArrays(const ShapeBatch* batch)
+{
+	return &batch->positionX;
+}
+
+void AllocateShapeBatchArrays(ShapeBatch* batch, uint32_t capacity)
+{
+	//Multiple of 4 so every array stays 16-byte aligned
+	capacity = (capacity + 3) & ~3u;
+	capacity = (capacity < 4) ? 4 : capacity;
+
+	float* block = (float*)_mm_malloc((size_t)SHAPE_BATCH_NUM_ARRAYS * capacity * sizeof(float), 16);
+
+	float** arrays = GetShapeBatchArrays(batch);
+	for (uint32_t i = 0; i < SHAPE_BATCH_NUM_ARRAYS; ++i)
+	{
+		float* array = block + (size_t)i * capacity;
+		if (arrays[i] != nullptr)
+			memcpy(array, arrays[i], batch->numShapes * sizeof(float));
+
+		arrays[i] = array;
+	}
+
+	batch->capacity = capacity;
+}
+
+void CreateShapeBatch(ShapeBatch* batch, uint32_t capacity)
+{
+	*batch = ShapeBatch{};
+	AllocateShapeBatchArrays(batch, capacity);
+}
+
+void DestroyShapeBatch(ShapeBatch* batch)
+{
+	_mm_free(batch->positionX);
+	*batch = ShapeBatch{};
+}
+
+uint32_t AddShapeToBatch(ShapeBatch* batch, const Shape* shape)
+{
+	if (batch->numShapes == batch->capacity)
+	{
+		float* oldBlock = batch->positionX;
+		AllocateShapeBatchArrays(batch, batch->capacity * 2);
+		_mm_free(oldBlock);
+	}
+
+	uint32_t index = batch->numShapes++;
+	SetShapeBatchTransform(batch, index, shape->position, shape->orientation, shape->scale);
+
+	return index;
+}
+
+void RemoveShapeFromBatch(ShapeBatch* batch, uint32_t index)
+{
+	uint32_t last = --batch->numShapes;
+
+	float** arrays = GetShapeBatchArrays(batch);
+	for (uint32_t i = 0; i < SHAPE_BATCH_NUM_ARRAYS; ++i)
+		arrays[i][index] = arrays[i][last];
+}
+
+void SetShapeBatchTransform(ShapeBatch* batch, uint32_t index, vec3 position, quat orientation, vec3 scale)
+{
+	batch->positionX[index] = position.GetX();
+	batch->positionY[index] = position.GetY();
+	batch->positionZ[index] = position.GetZ();
+
+	batch->orientationX[index] = orientation.GetX();
+	batch->orientationY[index] = orientation.GetY();
+	batch->orientationZ[index] = orientation.GetZ();
+	batch->orientationW[index] = orientation.GetScalar();
+
+	batch->scaleX[index] = scale.GetX();
+	batch->scaleY[index] = scale.GetY();
+	batch->scaleZ[index] = scale.GetZ();
+}
+
+void GetShapeBatchTransform(const ShapeBatch* batch, uint32_t index, Shape* outShape)
+{
+	outShape->position = vec3(batch->positionX[index], batch->positionY[index], batch->positionZ[index]);
+	outShape->orientation = quat(batch->orientationX[index], batch->orientationY[index], batch->orientationZ[index], batch->orientationW[index]);
+	outShape->scale = vec3(batch->scaleX[index], batch->scaleY[index], batch->scaleZ[index]);
+	UpdateModelMatrix(outShape);
+}
+
+//Composes the transposed model matrices of 4 shapes. in holds the SHAPE_BATCH_NUM_ARRAYS arrays in the order of ShapeBatch,
+//one shape per lane. out[3 * i + j] receives row j of ShapeInstance i.
+inline void ComposeShapeInstances(const __m128* in, __m128* out)
+{
+	__m128 one = _mm_set_ps1(1.0f);
+	__m128 two = _mm_set_ps1(2.0f);
+
+	__m128 x = in[3];
+	__m128 y = in[4];
+	__m128 z = in[5];
+	__m128 w = in[6];
+
+	__m128 x2 = _mm_mul_ps(x, two);
+	__m128 y2 = _mm_mul_ps(y, two);
+	__m128 z2 = _mm_mul_ps(z, two);
+
+	__m128 xx = _mm_mul_ps(x, x2);
+	__m128 yy = _mm_mul_ps(y, y2);
+	__m128 zz = _mm_mul_ps(z, z2);
+	__m128 xy = _mm_mul_ps(x, y2);
+	__m128 xz = _mm_mul_ps(x, z2);
+	__m128 yz = _mm_mul_ps(y, z2);
+	__m128 wx = _mm_mul_ps(w, x2);
+	__m128 wy = _mm_mul_ps(w, y2);
+	__m128 wz = _mm_mul_ps(w, z2);
+
+	//The rotation matrix of QuaternionToMatrix, row i is scaled by the scale of axis i
+	__m128 sx = in[7];
+	__m128 sy = in[8];
+	__m128 sz = in[9];
+
+	__m128 m00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_add_ps(yy, zz)));
+	__m128 m01 = _mm_mul_ps(sx, _mm_add_ps(xy, wz));
+	__m128 m02 = _mm_mul_ps(sx, _mm_sub_ps(xz, wy));
+
+	__m128 m10 = _mm_mul_ps(sy, _mm_sub_ps(xy, wz));
+	__m128 m11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_add_ps(xx, zz)));
+	__m128 m12 = _mm_mul_ps(sy, _mm_add_ps(yz, wx));
+
+	__m128 m20 = _mm_mul_ps(sz, _mm_add_ps(xz, wy));
+	__m128 m21 = _mm_mul_ps(sz, _mm_sub_ps(yz, wx));
+	__m128 m22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_add_ps(xx, yy)));
+
+	//Column j of the model matrix is row j of the instance, the translation is the last element
+	__m128 columns[3][4] =
+	{
+		{ m00, m10, m20, in[0] },
+		{ m01, m11, m21, in[1] },
+		{ m02, m12, m22, in[2] }
+	};
+
+	for (uint32_t j = 0; j < 3; ++j)
+	{
+		_MM_TRANSPOSE4_PS(columns[j][0], columns[j][1], columns[j][2], columns[j][3]);
+		for (uint32_t i = 0; i < 4; ++i)
+			out[3 * i + j] = columns[j][i];
+	}
+}
+
+void WriteShapeInstances(const ShapeBatch* batch, uint32_t first, uint32_t count, ShapeInstance* instances)
+{
+	float* const* arrays = GetShapeBatchArrays(batch);
+	bool aligned = ((uintptr_t)instances & 15) == 0;
+	float* dest = (float*)instances;
+
+	__m128 in[SHAPE_BATCH_NUM_ARRAYS];
+	__m128 out[12];
+
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		for (uint32_t j = 0; j < SHAPE_BATCH_NUM_ARRAYS; ++j)
+			in[j] = _mm_loadu_ps(arrays[j] + first + i);
+
+		ComposeShapeInstances(in, out);
+
+		if (aligned == true)
+		{
+			for (uint32_t j = 0; j < 12; ++j)
+				_mm_stream_ps(dest + 4 * j, out[j]);
+		}
+		else
+		{
+			for (uint32_t j = 0; j < 12; ++j)
+				_mm_storeu_ps(dest + 4 * j, out[j]);
+		}
+
+		dest += 48;
+	}
+
+	if (i < count)
+	{
+		//The unused lanes get the identity transform
+		alignas(16) float tail[SHAPE_BATCH_NUM_ARRAYS][4] = {};
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			tail[6][j] = 1.0f;
+			tail[7][j] = 1.0f;
+			tail[8][j] = 1.0f;
+			tail[9][j] = 1.0f;
+		}
+
+		uint32_t numRemaining = count - i;
+		for (uint32_t j = 0; j < SHAPE_BATCH_NUM_ARRAYS; ++j)
+		{
+			memcpy(tail[j], arrays[j] + first + i, numRemaining * sizeof(float));
+			in[j] = _mm_load_ps(tail[j]);
+		}
+
+		ComposeShapeInstances(in, out);
+
+		for (uint32_t j = 0; j < 3 * numRemaining; ++j)
+			_mm_storeu_ps(dest + 4 * j, out[j]);
+	}
+
+	//Streaming stores are weakly ordered, make them visible before the buffer is used
+	if (aligned == true)
+		_mm_sfence();
+}
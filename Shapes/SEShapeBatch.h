@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SEShapes.h"
+
+//The transforms of many shapes that are drawn with one DrawIndexedInstanced.
+//The transforms are stored as structure of arrays, so WriteShapeInstances composes 4 shapes at a time with SSE.
+//Every array has capacity floats and is 16-byte aligned.
+struct ShapeBatch
+{
+	float* positionX;
+	float* positionY;
+	float* positionZ;
+
+	//Unit quaternions
+	float* orientationX;
+	float* orientationY;
+	float* orientationZ;
+	float* orientationW;
+
+	float* scaleX;
+	float* scaleY;
+	float* scaleZ;
+
+	uint32_t numShapes;
+	uint32_t capacity;
+};
+
+//The transposed model matrix of a shape without its last column, which is always (0, 0, 0, 1).
+//The world position is (dot(rows[0], p), dot(rows[1], p), dot(rows[2], p)) with p = float4(position, 1).
+//Read it in the vertex shader with the ShapeInstance helpers of the shader library (instance.h.hlsl and instance.h.glsl)
+//from a BUFFER_TYPE_BUFFER with a stride of sizeof(ShapeInstance), indexed by the instance id.
+struct ShapeInstance
+{
+	vec4 rows[3];
+};
+
+//Allocates the arrays for capacity shapes. The batch is empty.
+void CreateShapeBatch(ShapeBatch* batch, uint32_t capacity);
+
+void DestroyShapeBatch(ShapeBatch* batch);
+
+//Adds a shape with the transform of shape and returns its index.
+//The arrays grow if the batch is full.
+uint32_t AddShapeToBatch(ShapeBatch* batch, const Shape* shape);
+
+//Removes the shape by moving the last shape into its place.
+void RemoveShapeFromBatch(ShapeBatch* batch, uint32_t index);
+
+void SetShapeBatchTransform(ShapeBatch* batch, uint32_t index, vec3 position, quat orientation, vec3 scale);
+void GetShapeBatchTransform(const ShapeBatch* batch, uint32_t index, Shape* outShape);
+
+//Composes the model matrices of count shapes starting at first and writes them to instances.
+//The matrices are built straight from the scale, the rotation of the quaternion and the translation, the same matrix as
+//UpdateModelMatrix without any matrix multiply, and are written transposed, ready for the GPU.
+//instances can be the mapped memory of an instance buffer. If it is 16-byte aligned it is written with streaming stores,
+//which don't read the write-combined memory of upload buffers.
+void WriteShapeInstances(const ShapeBatch* batch, uint32_t first, uint32_t count, ShapeInstance* instances);
@@ -1,6 +1,8 @@
 #include "SEShapes.h"
 #include <cmath>
+#include <cstdlib>
 #include "..\Mesh\SEMesh.h"
+#include "..\Mesh\SEMeshOptimizer.h"
 
 void Reorthogonalize_GramSchmidt(vec4* x, vec4* y, vec4* z)
 {
@@ -15,18 +17,21 @@ void Reorthogonalize_GramSchmidt(vec4* x, vec4* y, vec4* z)
 	*y = vec4(v1.GetX(), v1.GetY(), v1.GetZ(), 0.0f);
 }
 
-void CreateLine(Vertex** vertices)
+void CreateLine(Vertex** vertices, MeshBounds* outBounds)
 {
 	Vertex lineVertices[2];
 	
 	lineVertices[0].position.Set(0.0f, 0.0f, 0.0f, 1.0f);
 	lineVertices[1].position.Set(1.0f, 0.0f, 0.0f, 1.0f);
 
+	if (outBounds != nullptr)
+		ComputeMeshBounds(lineVertices, 2, outBounds);
+
 	arrpush(*vertices, lineVertices[0]);
 	arrpush(*vertices, lineVertices[1]);
 }
 
-void CreateEquilateralTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateEquilateralTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds)
 {
 	Vertex triangleVertices[3]{};
 
@@ -41,17 +46,16 @@ void CreateEquilateralTriangle(Vertex** vertices, uint32_t** indices, uint32_t*
 	Triangle triangle{};
 	CreateTriangle(&triangle, triangleVertices, 0, 1, 2);
 	vec4 normal;
-	vec4 tangent;
 	normal = ComputeNormal(&triangle);
-	tangent = ComputeTangent(&triangle);
 
 	triangleVertices[0].normal = normal;
 	triangleVertices[1].normal = normal;
 	triangleVertices[2].normal = normal;
 
-	triangleVertices[0].tangent = tangent;
-	triangleVertices[1].tangent = tangent;
-	triangleVertices[2].tangent = tangent;
+	ComputeTangentFrames(triangleVertices, 3, &triangle, 1);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(triangleVertices, 3, outBounds);
 
 	arrpush(*vertices, triangleVertices[0]);
 	arrpush(*vertices, triangleVertices[1]);
@@ -75,7 +79,7 @@ void CreateEquilateralTriangle(Vertex** vertices, uint32_t** indices, uint32_t*
 	}
 }
 
-void CreateRightTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateRightTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds)
 {
 	Vertex triangleVertices[3]{};
 
@@ -90,17 +94,16 @@ void CreateRightTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVer
 	Triangle triangle{};
 	CreateTriangle(&triangle, triangleVertices, 0, 1, 2);
 	vec4 normal;
-	vec4 tangent;
 	normal = ComputeNormal(&triangle);
-	tangent = ComputeTangent(&triangle);
 
 	triangleVertices[0].normal = normal;
 	triangleVertices[1].normal = normal;
 	triangleVertices[2].normal = normal;
 
-	triangleVertices[0].tangent = tangent;
-	triangleVertices[1].tangent = tangent;
-	triangleVertices[2].tangent = tangent;
+	ComputeTangentFrames(triangleVertices, 3, &triangle, 1);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(triangleVertices, 3, outBounds);
 
 	arrpush(*vertices, triangleVertices[0]);
 	arrpush(*vertices, triangleVertices[1]);
@@ -124,7 +127,7 @@ void CreateRightTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVer
 	}
 }
 
-void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds)
 {
 	Vertex quadVertices[4]{};
 	Triangle triangles[2]{};
@@ -145,9 +148,7 @@ void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount,
 	for (uint32_t i = 0; i < 2; ++i)
 	{
 		vec4 normal;
-		vec4 tangent;
 		normal = ComputeNormal(&triangles[i]);
-		tangent = ComputeTangent(&triangles[i]);
 
 		uint32_t i0 = triangles[i].i0;
 		uint32_t i1 = triangles[i].i1;
@@ -157,10 +158,6 @@ void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount,
 		quadVertices[i1].normal += normal;
 		quadVertices[i2].normal += normal;
 
-		quadVertices[i0].tangent += tangent;
-		quadVertices[i1].tangent += tangent;
-		quadVertices[i2].tangent += tangent;
-
 		arrpush(*indices, i0);
 		arrpush(*indices, i1);
 		arrpush(*indices, i2);
@@ -169,10 +166,12 @@ void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount,
 	}
 
 	for (uint32_t i = 0; i < 4; ++i)
-	{
 		quadVertices[i].normal = Normalize(quadVertices[i].normal);
-		quadVertices[i].tangent = Normalize(quadVertices[i].tangent);
-	}
+
+	ComputeTangentFrames(quadVertices, 4, triangles, 2);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(quadVertices, 4, outBounds);
 
 	arrpush(*vertices, quadVertices[0]);
 	arrpush(*vertices, quadVertices[1]);
@@ -183,93 +182,263 @@ void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount,
 	*outIndexCount = indexCount;
 }
 
-void CreateCircle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+//Segments and rings of the finest level of detail of a curved shape. Every level halves both.
+struct ShapeLevels
 {
-	//Parameteric equations used to the produce the vertices of a unit circle.
-	//x = cos(angle)
-	//y = sin(angle)
+	uint32_t segments;
+	uint32_t rings;
+	uint32_t numLODs;
+};
 
-	Vertex* vertexList = nullptr;
-	uint32_t vertexCount = 0;
-	uint32_t indexCount = 0;
+//The coarsest level gets at least 3 segments and minRings rings, ringDivisor segments per ring.
+void InitShapeLevels(ShapeLevels* levels, uint32_t tessellation, uint32_t ringDivisor, uint32_t minRings, uint32_t numLODs)
+{
+	numLODs = (numLODs < 1) ? 1 : numLODs;
+	numLODs = (numLODs > MAX_MESH_LODS) ? MAX_MESH_LODS : numLODs;
+	uint32_t scale = 1u << (numLODs - 1);
+
+	uint32_t segments = (tessellation + scale - 1) / scale;
+	segments = (segments < 3) ? 3 : segments;
+	uint32_t rings = segments / ringDivisor;
+	rings = (rings < minRings) ? minRings : rings;
+
+	levels->segments = segments * scale;
+	levels->rings = rings * scale;
+	levels->numLODs = numLODs;
+}
 
-	float stepRate = 4.0f; //degrees
-	float angle = 0.0f;
+//Number of indices of a level of a grid of (segments + 1) * (rings + 1) vertices.
+//The triangles of a pole row are degenerate, so only one triangle of every quad of the row is kept.
+inline uint32_t GetGridIndexCount(const ShapeLevels* levels, uint32_t level, bool topPole, bool bottomPole)
+{
+	uint32_t columns = levels->segments >> level;
+	uint32_t rows = levels->rings >> level;
 
-	//Center vertex
-	Vertex vertex;
-	vertex.position.Set(0.0f, 0.0f, 0.0f, 1.0f);
-	vertex.texCoords.Set(0.5f, 0.5f);
-	arrpush(vertexList, vertex);
+	return 6 * columns * rows - 3 * columns * ((topPole ? 1 : 0) + (bottomPole ? 1 : 0));
+}
 
-	//Compute the vertices and texture coordinates.
-	while (angle <= 360.0f)
+//Writes the triangles of a level of the grid whose vertex (ring, segment) is firstVertex + ring * (segments + 1) + segment.
+//Returns the end of the written indices.
+uint32_t* WriteGridIndices(uint32_t* out, uint32_t firstVertex, const ShapeLevels* levels, uint32_t level, bool topPole, bool bottomPole)
+{
+	uint32_t step = 1u << level;
+	uint32_t numVerticesPerRing = levels->segments + 1;
+	for (uint32_t i = 0; i < levels->rings; i += step)
 	{
-		float rad = angle * (PI / 180.0f);
-		float x = cos(rad);
-		float y = sin(rad);
-		vertex.position.Set(x, y, 0.0f, 1.0f);
+		for (uint32_t j = 0; j < levels->segments; j += step)
+		{
+			//Indices of the vertices that make up a quad
+			uint32_t topLeft = firstVertex + (i * numVerticesPerRing) + j;
+			uint32_t topRight = firstVertex + (i * numVerticesPerRing) + j + step;
+			uint32_t bottomLeft = firstVertex + ((i + step) * numVerticesPerRing) + j;
+			uint32_t bottomRight = firstVertex + ((i + step) * numVerticesPerRing) + j + step;
 
-		//Changing range from [-1, 1] -> [1, 0]
-		float u = (1.0f - x) * 0.5f;
-		float v = (1.0f - y) * 0.5f;
+			if (topPole == false || i > 0)
+			{
+				*out++ = topLeft;
+				*out++ = topRight;
+				*out++ = bottomRight;
+			}
 
-		vertex.texCoords.Set(u, v);
+			if (bottomPole == false || i + step < levels->rings)
+			{
+				*out++ = topLeft;
+				*out++ = bottomRight;
+				*out++ = bottomLeft;
+			}
+		}
+	}
 
-		arrpush(vertexList, vertex);
+	return out;
+}
+
+//Writes the triangle fan of a level of a disk whose rim vertex j is firstRimVertex + j.
+//The triangles are (center, j, j + 1), or (center, j + 1, j) if flip is true.
+uint32_t* WriteFanIndices(uint32_t* out, uint32_t center, uint32_t firstRimVertex, const ShapeLevels* levels, uint32_t level, bool flip)
+{
+	uint32_t step = 1u << level;
+	for (uint32_t j = 0; j < levels->segments; j += step)
+	{
+		*out++ = center;
+		*out++ = firstRimVertex + (flip ? j + step : j);
+		*out++ = firstRimVertex + (flip ? j : j + step);
+	}
 
-		angle += stepRate;
+	return out;
+}
 
-		++vertexCount;
+//Stores the cos and sin of count + 1 evenly spaced angles from 0 to maxAngle.
+//The last angle of a full turn is a copy of the first, so the vertices on both sides of a seam match exactly.
+void ComputeShapeAngles(uint32_t count, float maxAngle, float* outCos, float* outSin)
+{
+	for (uint32_t i = 0; i <= count; ++i)
+	{
+		double angle = (double)maxAngle * i / count;
+		outCos[i] = (float)cos(angle);
+		outSin[i] = (float)sin(angle);
 	}
 
-	//Create the triangles.
-	//Using the triangle fan method, so the number of triangles equals to the number of vertices of the circle.
-	uint32_t numTriangles = arrlenu(vertexList) - 2;
-	for (uint32_t i = 0; i < numTriangles; ++i)
+	if (maxAngle == PI2)
 	{
-		Triangle triangle{};
-		CreateTriangle(&triangle, vertexList, 0, i + 2, i + 1);
+		outCos[count] = outCos[0];
+		outSin[count] = outSin[0];
+	}
+}
 
-		//Compute the normal, tangent and bitangent
-		vec4 normal;
-		vec4 tangent;
-		normal = ComputeNormal(&triangle);
-		tangent = ComputeTangent(&triangle);
+//Stores an analytic vertex. tangent is the unit direction of increasing u and bitangent the direction of increasing v.
+//tangent.w gets the handedness ComputeTangentFrames gives, where w * cross(tangent.xyz, normal.xyz) points along decreasing v.
+inline void SetShapeVertex(Vertex* vertex, vec3 position, vec3 normal, vec3 tangent, vec3 bitangent, float u, float v)
+{
+	float w = (DotProduct(CrossProduct(tangent, normal), bitangent) > 0.0f) ? -1.0f : 1.0f;
 
-		uint32_t i0 = triangle.i0;
-		uint32_t i1 = triangle.i1;
-		uint32_t i2 = triangle.i2;
+	vertex->position = vec4(position.GetX(), position.GetY(), position.GetZ(), 1.0f);
+	vertex->normal = vec4(normal.GetX(), normal.GetY(), normal.GetZ(), 0.0f);
+	vertex->tangent = vec4(tangent.GetX(), tangent.GetY(), tangent.GetZ(), w);
+	vertex->texCoords = vec2(u, v);
+}
 
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
+//Writes the center and the segments + 1 rim vertices of a unit disk in the xz plane at height y, facing along normalY (1 or -1).
+//The texture coordinates are the planar projection used by CreateCircle. Returns the end of the written vertices.
+Vertex* WriteShapeDisk(Vertex* out, uint32_t segments, const float* cosTheta, const float* sinTheta, float y, float normalY)
+{
+	vec3 normal(0.0f, normalY, 0.0f);
 
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
+	//x = 1 - 2u, z = 1 - 2v
+	vec3 tangent(-1.0f, 0.0f, 0.0f);
+	vec3 bitangent(0.0f, 0.0f, -1.0f);
 
-		arrpush(*indices, i0);
-		arrpush(*indices, i1);
-		arrpush(*indices, i2);
+	SetShapeVertex(out++, vec3(0.0f, y, 0.0f), normal, tangent, bitangent, 0.5f, 0.5f);
+	for (uint32_t j = 0; j <= segments; ++j)
+	{
+		float x = cosTheta[j];
+		float z = sinTheta[j];
+		SetShapeVertex(out++, vec3(x, y, z), normal, tangent, bitangent, (1.0f - x) * 0.5f, (1.0f - z) * 0.5f);
+	}
 
-		indexCount += 3;
+	return out;
+}
+
+//Distance from the middle of a chord spanning angle to a circle of the radius.
+inline float ChordError(float radius, float angle)
+{
+	return radius * (1.0f - cosf(angle * 0.5f));
+}
+
+//Appends numVertices vertices and numIndices indices to the stb_ds arrays and returns pointers to the new elements.
+void AppendShape(Vertex** vertices, uint32_t** indices, uint32_t numVertices, uint32_t numIndices, Vertex** outVertices, uint32_t** outIndices)
+{
+	size_t vertexOffset = arrlenu(*vertices);
+	size_t indexOffset = arrlenu(*indices);
+	arrsetlen(*vertices, vertexOffset + numVertices);
+	arrsetlen(*indices, indexOffset + numIndices);
+
+	*outVertices = *vertices + vertexOffset;
+	*outIndices = *indices + indexOffset;
+}
+
+//Optimizes the levels of a shape, which are stored one after the other in shapeIndices, and reports the results.
+//The finest level gets the full OptimizeMesh treatment. The vertices are reordered once over the indices of every level,
+//since all the levels index the same vertices.
+void FinishShape(Vertex* shapeVertices, uint32_t numVertices, uint32_t* shapeIndices, uint32_t indexOffset,
+	const ShapeLevels* levels, const uint32_t* levelIndexCounts, const float* levelErrors,
+	uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds, MeshLOD* outLODs)
+{
+	uint32_t numTriangles = levelIndexCounts[0] / 3;
+	uint32_t* clusters = (uint32_t*)malloc(numTriangles * sizeof(uint32_t));
+	uint32_t numClusters = OptimizeVertexCache(shapeIndices, levelIndexCounts[0], numVertices, MESH_OPTIMIZER_CACHE_SIZE, clusters);
+	OptimizeOverdraw(shapeIndices, levelIndexCounts[0], shapeVertices, numVertices, clusters, numClusters,
+		MESH_OPTIMIZER_CACHE_SIZE, MESH_OPTIMIZER_OVERDRAW_THRESHOLD);
+	free(clusters);
+
+	uint32_t numIndices = levelIndexCounts[0];
+	for (uint32_t i = 1; i < levels->numLODs; ++i)
+	{
+		OptimizeVertexCache(shapeIndices + numIndices, levelIndexCounts[i], numVertices, MESH_OPTIMIZER_CACHE_SIZE, nullptr);
+		numIndices += levelIndexCounts[i];
 	}
 
-	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
+	OptimizeVertexFetch(shapeVertices, numVertices, shapeIndices, numIndices);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(shapeVertices, numVertices, outBounds);
+
+	if (outLODs != nullptr)
 	{
-		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
+		for (uint32_t i = 0; i < levels->numLODs; ++i)
+		{
+			outLODs[i].indexOffset = indexOffset;
+			outLODs[i].indexCount = levelIndexCounts[i];
+			outLODs[i].error = levelErrors[i];
+			indexOffset += levelIndexCounts[i];
+		}
+	}
 
-		arrpush(*vertices, vertexList[i]);
+	if (outVertexCount != nullptr)
+		*outVertexCount = numVertices;
+
+	if (outIndexCount != nullptr)
+		*outIndexCount = levelIndexCounts[0];
+}
+
+void CreateCircle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds,
+	uint32_t tessellation, uint32_t numLODs, MeshLOD* outLODs)
+{
+	//Parameteric equations used to the produce the vertices of a unit circle.
+	//x = cos(angle)
+	//y = sin(angle)
+
+	ShapeLevels levels{};
+	InitShapeLevels(&levels, tessellation, 1, 1, numLODs);
+	uint32_t segments = levels.segments;
+
+	//Center vertex and the rim, the first rim vertex is repeated at the end for the texture coordinates
+	uint32_t numVertices = segments + 2;
+
+	uint32_t levelIndexCounts[MAX_MESH_LODS]{};
+	float levelErrors[MAX_MESH_LODS]{};
+	uint32_t numIndices = 0;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
+	{
+		levelIndexCounts[i] = 3 * (segments >> i);
+		levelErrors[i] = ChordError(1.0f, PI2 * (1u << i) / segments);
+		numIndices += levelIndexCounts[i];
 	}
 
-	*outVertexCount = vertexCount;
-	*outIndexCount = indexCount;
-	arrfree(vertexList);
+	uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+	Vertex* shapeVertices = nullptr;
+	uint32_t* shapeIndices = nullptr;
+	AppendShape(vertices, indices, numVertices, numIndices, &shapeVertices, &shapeIndices);
+
+	float* angles = (float*)malloc(2 * (segments + 1) * sizeof(float));
+	float* cosTheta = angles;
+	float* sinTheta = angles + segments + 1;
+	ComputeShapeAngles(segments, PI2, cosTheta, sinTheta);
+
+	//The triangles are (center, j + 1, j), which faces -z.
+	//Changing range from [-1, 1] -> [1, 0], so x = 1 - 2u and y = 1 - 2v.
+	vec3 normal(0.0f, 0.0f, -1.0f);
+	vec3 tangent(-1.0f, 0.0f, 0.0f);
+	vec3 bitangent(0.0f, -1.0f, 0.0f);
+
+	SetShapeVertex(&shapeVertices[0], vec3(0.0f, 0.0f, 0.0f), normal, tangent, bitangent, 0.5f, 0.5f);
+	for (uint32_t j = 0; j <= segments; ++j)
+	{
+		float x = cosTheta[j];
+		float y = sinTheta[j];
+		SetShapeVertex(&shapeVertices[j + 1], vec3(x, y, 0.0f), normal, tangent, bitangent, (1.0f - x) * 0.5f, (1.0f - y) * 0.5f);
+	}
+
+	uint32_t* cur = shapeIndices;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
+		cur = WriteFanIndices(cur, 0, 1, &levels, i, true);
+
+	free(angles);
+
+	FinishShape(shapeVertices, numVertices, shapeIndices, indexOffset, &levels, levelIndexCounts, levelErrors,
+		outVertexCount, outIndexCount, outBounds, outLODs);
 }
 
-void CreateBox(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateBox(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds)
 {
 	Vertex* vertexList = nullptr;
 	Triangle* triangles = nullptr;
@@ -346,41 +515,29 @@ void CreateBox(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount,
 	CreateTriangle(&triangle, vertexList, 3, 5, 6);
 	arrpush(triangles, triangle);
 
+	//Compute the normal
 	uint32_t numTriangles = arrlenu(triangles);
+	AccumulateTriangleFrames(vertexList, triangles, numTriangles, TRIANGLE_FRAME_FLAGS_NORMAL);
+
 	for (uint32_t i = 0; i < numTriangles; ++i)
 	{
-		//Compute the normal, tangent
-		vec4 normal;
-		vec4 tangent;
-		normal = ComputeNormal(&triangles[i]);
-		tangent = ComputeTangent(&triangles[i]);
-
-		uint32_t i0 = triangles[i].i0;
-		uint32_t i1 = triangles[i].i1;
-		uint32_t i2 = triangles[i].i2;
-
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-
-		arrpush(*indices, i0);
-		arrpush(*indices, i1);
-		arrpush(*indices, i2);
+		arrpush(*indices, triangles[i].i0);
+		arrpush(*indices, triangles[i].i1);
+		arrpush(*indices, triangles[i].i2);
 
 		indexCount += 3;
 	}
 
 	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
-	{
 		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
 
+	ComputeTangentFrames(vertexList, arrlenu(vertexList), triangles, numTriangles);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(vertexList, arrlenu(vertexList), outBounds);
+
+	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
 		arrpush(*vertices, vertexList[i]);
-	}
 
 	*outVertexCount = 8;
 	*outIndexCount = indexCount;
@@ -388,7 +545,7 @@ void CreateBox(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount,
 	arrfree(vertexList);
 }
 
-void CreateSquarePyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateSquarePyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds)
 {
 	Vertex* vertexList = nullptr;
 	Triangle* triangles = nullptr;
@@ -442,41 +599,29 @@ void CreateSquarePyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVer
 	CreateTriangle(&triangle, vertexList, 0, 4, 3);
 	arrpush(triangles, triangle);
 
+	//Compute the normal
 	uint32_t numTriangles = arrlenu(triangles);
+	AccumulateTriangleFrames(vertexList, triangles, numTriangles, TRIANGLE_FRAME_FLAGS_NORMAL);
+
 	for (uint32_t i = 0; i < numTriangles; ++i)
 	{
-		//Compute the normal and tangent
-		vec4 normal;
-		vec4 tangent;
-		normal = ComputeNormal(&triangles[i]);
-		tangent = ComputeTangent(&triangles[i]);
-
-		uint32_t i0 = triangles[i].i0;
-		uint32_t i1 = triangles[i].i1;
-		uint32_t i2 = triangles[i].i2;
-
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-
-		arrpush(*indices, i0);
-		arrpush(*indices, i1);
-		arrpush(*indices, i2);
+		arrpush(*indices, triangles[i].i0);
+		arrpush(*indices, triangles[i].i1);
+		arrpush(*indices, triangles[i].i2);
 
 		indexCount += 3;
 	}
 
 	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
-	{
 		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
 
+	ComputeTangentFrames(vertexList, arrlenu(vertexList), triangles, numTriangles);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(vertexList, arrlenu(vertexList), outBounds);
+
+	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
 		arrpush(*vertices, vertexList[i]);
-	}
 
 	*outVertexCount = 5;
 	*outIndexCount = indexCount;
@@ -484,7 +629,7 @@ void CreateSquarePyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVer
 	arrfree(vertexList);
 }
 
-void CreateFrustrum(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateFrustrum(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds)
 {
 	Vertex* vertexList = nullptr;
 	Triangle* triangles = nullptr;
@@ -570,41 +715,29 @@ void CreateFrustrum(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCo
 	CreateTriangle(&triangle, vertexList, 2, 7, 3);
 	arrpush(triangles, triangle);
 
+	//Compute the normal
 	uint32_t numTriangles = arrlenu(triangles);
+	AccumulateTriangleFrames(vertexList, triangles, numTriangles, TRIANGLE_FRAME_FLAGS_NORMAL);
+
 	for (uint32_t i = 0; i < numTriangles; ++i)
 	{
-		//Compute the normal and tangent
-		vec4 normal;
-		vec4 tangent;
-		normal = ComputeNormal(&triangles[i]);
-		tangent = ComputeTangent(&triangles[i]);
-
-		uint32_t i0 = triangles[i].i0;
-		uint32_t i1 = triangles[i].i1;
-		uint32_t i2 = triangles[i].i2;
-
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-
-		arrpush(*indices, i0);
-		arrpush(*indices, i1);
-		arrpush(*indices, i2);
+		arrpush(*indices, triangles[i].i0);
+		arrpush(*indices, triangles[i].i1);
+		arrpush(*indices, triangles[i].i2);
 
 		indexCount += 3;
 	}
 
 	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
-	{
 		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
 
+	ComputeTangentFrames(vertexList, arrlenu(vertexList), triangles, numTriangles);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(vertexList, arrlenu(vertexList), outBounds);
+
+	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
 		arrpush(*vertices, vertexList[i]);
-	}
 
 	*outVertexCount = 8;
 	*outIndexCount = indexCount;
@@ -612,7 +745,7 @@ void CreateFrustrum(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCo
 	arrfree(vertexList);
 }
 
-void CreateTriangularPyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateTriangularPyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds)
 {
 	Vertex* vertexList = nullptr;
 	Triangle* triangles = nullptr;
@@ -656,42 +789,29 @@ void CreateTriangularPyramid(Vertex** vertices, uint32_t** indices, uint32_t* ou
 	CreateTriangle(&triangle, vertexList, 1, 3, 0);
 	arrpush(triangles, triangle);
 
+	//Compute the normal
 	uint32_t numTriangles = arrlenu(triangles);
+	AccumulateTriangleFrames(vertexList, triangles, numTriangles, TRIANGLE_FRAME_FLAGS_NORMAL);
+
 	for (uint32_t i = 0; i < numTriangles; ++i)
 	{
-		//Compute the normal, tangent and bitangent
-		vec4 normal;
-		vec4 tangent;
-		vec4 bitangent;
-		normal = ComputeNormal(&triangles[i]);
-		tangent = ComputeTangent(&triangles[i]);
-
-		uint32_t i0 = triangles[i].i0;
-		uint32_t i1 = triangles[i].i1;
-		uint32_t i2 = triangles[i].i2;
-
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-
-		arrpush(*indices, i0);
-		arrpush(*indices, i1);
-		arrpush(*indices, i2);
+		arrpush(*indices, triangles[i].i0);
+		arrpush(*indices, triangles[i].i1);
+		arrpush(*indices, triangles[i].i2);
 
 		indexCount += 3;
 	}
 
 	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
-	{
 		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
 
+	ComputeTangentFrames(vertexList, arrlenu(vertexList), triangles, numTriangles);
+
+	if (outBounds != nullptr)
+		ComputeMeshBounds(vertexList, arrlenu(vertexList), outBounds);
+
+	for (uint32_t i = 0; i < arrlenu(vertexList); ++i)
 		arrpush(*vertices, vertexList[i]);
-	}
 
 	*outVertexCount = 4;
 	*outIndexCount = indexCount;
@@ -699,793 +819,366 @@ void CreateTriangularPyramid(Vertex** vertices, uint32_t** indices, uint32_t* ou
 	arrfree(vertexList);
 }
 
-void CreateSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount)
+void CreateSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds,
+	uint32_t tessellation, uint32_t numLODs, MeshLOD* outLODs)
 {
 	//Parameteric equations used to the produce the vertices of a unit sphere.
 	//x = sin(phi) * cos(theta);
 	//y = cos(phi)
 	//z = sin(phi) * sin(theta)
+	//theta = u * 2pi, phi = v * pi
 
-	Vertex* vertexList = nullptr;
-	uint32_t vertexCount = 0;
-	uint32_t indexCount = 0;
-	Vertex vertex;
-
-	float thetaStepRate = 10.0f; //degrees
-	float phiStepRate = 10.0f; //degrees
+	ShapeLevels levels{};
+	InitShapeLevels(&levels, tessellation, 2, 2, numLODs);
+	uint32_t segments = levels.segments;
+	uint32_t rings = levels.rings;
 
-	uint32_t numCircles = (180.0f / phiStepRate) + 1;
-	uint32_t numVerticesPerCircle = (360.0f / thetaStepRate) + 1;
+	uint32_t numVertices = (segments + 1) * (rings + 1);
 
-	float u = 0.0f;
-	float v = 0.0f;
-	float uStep = 1.0f / (numVerticesPerCircle - 1);
-	float vStep = 1.0f / (numCircles - 1);
-
-	//Compute the vertices and texture coordinates.
-	for (uint32_t i = 0; i < numCircles; ++i)
+	uint32_t levelIndexCounts[MAX_MESH_LODS]{};
+	float levelErrors[MAX_MESH_LODS]{};
+	uint32_t numIndices = 0;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle; ++j)
-		{
-			float x = sin(v * PI) * cos(u * PI2);
-			float y = cos(v * PI);
-			float z = sin(v * PI) * sin(u * PI2);
-			vertex.position.Set(x, y, z, 1.0f);
-
-			vertex.texCoords.Set(u, v);
-			vertex.normal.Set(x, y , z, 0.0f);
-
-			/*vec3 tangent = vec3(-sin(v * PI) * sin(u * PI2), 0.0f, sin(v * PI) * cos(u * PI2));
-			vec3 bitangent = vec3(cos(v * PI) * cos(u * PI2), -sin(v * PI), cos(v * PI) * sin(u * PI2));
-			//vec3 normal = CrossProduct(bitangent, tangent);
-
-			//vertex.tangent.Set(-sin(v * PI) * sin(u * PI2), 0.0f, sin(v * PI) * cos(u * PI2), 0.0f);
-			//vertex.bitangent.Set(cos(v * PI) * cos(u * PI2), -sin(v * PI), cos(v * PI) * sin(u * PI2), 0.0f);
-
-			vertex.tangent.Set(tangent.GetX(), tangent.GetY(), tangent.GetZ(), 0.0f);
-			vertex.bitangent.Set(bitangent.GetX(), bitangent.GetY(), bitangent.GetZ(), 0.0f);
-			//vertex.normal.Set(normal.GetX(), normal.GetY(), normal.GetZ(), 0.0f);*/
-
-			arrpush(vertexList, vertex);
-
-			u += uStep;
-
-			++vertexCount;
-		}
-		v += vStep;
-		u = 0.0f;
+		//The middle of a quad is the farthest point from the sphere
+		float thetaError = ChordError(1.0f, PI2 * (1u << i) / segments);
+		float phiError = ChordError(1.0f, PI * (1u << i) / rings);
+		levelIndexCounts[i] = GetGridIndexCount(&levels, i, true, true);
+		levelErrors[i] = 1.0f - (1.0f - thetaError) * (1.0f - phiError);
+		numIndices += levelIndexCounts[i];
 	}
 
-	Triangle* triangleList = nullptr;
-	for (uint32_t i = 0; i < numCircles - 1; ++i)
+	uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+	Vertex* shapeVertices = nullptr;
+	uint32_t* shapeIndices = nullptr;
+	AppendShape(vertices, indices, numVertices, numIndices, &shapeVertices, &shapeIndices);
+
+	float* angles = (float*)malloc(2 * (segments + rings + 2) * sizeof(float));
+	float* cosTheta = angles;
+	float* sinTheta = cosTheta + segments + 1;
+	float* cosPhi = sinTheta + segments + 1;
+	float* sinPhi = cosPhi + rings + 1;
+	ComputeShapeAngles(segments, PI2, cosTheta, sinTheta);
+	ComputeShapeAngles(rings, PI, cosPhi, sinPhi);
+
+	Vertex* vertex = shapeVertices;
+	for (uint32_t i = 0; i <= rings; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle - 1; ++j)
+		for (uint32_t j = 0; j <= segments; ++j)
 		{
-			//Indices of the vertices that make up a quad
-			uint32_t topLeft = (i * numVerticesPerCircle) + j;
-			uint32_t topRight = (i * numVerticesPerCircle) + j + 1;
-			uint32_t bottomLeft = ((i + 1) * numVerticesPerCircle) + j;
-			uint32_t bottomRight = ((i + 1) * numVerticesPerCircle) + j + 1;
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, topRight);
-			arrpush(*indices, bottomRight);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, bottomRight);
-			arrpush(*indices, bottomLeft);
+			vec3 normal(sinPhi[i] * cosTheta[j], cosPhi[i], sinPhi[i] * sinTheta[j]);
 
-			indexCount += 6;
+			//The derivatives by theta and phi. The theta direction is still defined at the poles.
+			vec3 tangent(-sinTheta[j], 0.0f, cosTheta[j]);
+			vec3 bitangent(cosPhi[i] * cosTheta[j], -sinPhi[i], cosPhi[i] * sinTheta[j]);
 
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, topLeft, topRight, bottomRight);
-			arrpush(triangleList, triangle);
-
-			CreateTriangle(&triangle, vertexList, topLeft, bottomRight, bottomLeft);
-			arrpush(triangleList, triangle);
+			SetShapeVertex(vertex++, normal, normal, tangent, bitangent, (float)j / segments, (float)i / rings);
 		}
 	}
 
-	//Compute the normal, tangent and bitangent
-	uint32_t numTriangles = arrlenu(triangleList);
-	for (uint32_t i = 0; i < numTriangles; ++i)
-	{
-		vec4 tangent;
-		tangent = ComputeTangent(&triangleList[i]);
-
-		uint32_t i0 = triangleList[i].i0;
-		uint32_t i1 = triangleList[i].i1;
-		uint32_t i2 = triangleList[i].i2;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-	}
-
-	//The positions of the first and last vertex of each circle are the same, so they must have the same tangent and normal.
-	for (uint32_t i = 0; i < numCircles; ++i)
-	{
-		uint32_t firstVertex = i * numVerticesPerCircle;
-		uint32_t lastVertex = i * numVerticesPerCircle + (numVerticesPerCircle - 1);
-		vec4 normal = vertexList[firstVertex].normal + vertexList[lastVertex].normal;
-		vertexList[firstVertex].normal = normal;
-		vertexList[lastVertex].normal = normal;
-
-		vec4 tangent = vertexList[firstVertex].tangent + vertexList[lastVertex].tangent;
-		vertexList[firstVertex].tangent = tangent;
-		vertexList[lastVertex].tangent = tangent;
-	}
+	uint32_t* cur = shapeIndices;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
+		cur = WriteGridIndices(cur, 0, &levels, i, true, true);
 
-	uint32_t numVertices = arrlenu(vertexList);
-	for (uint32_t i = 0; i < numVertices; ++i)
-	{
-		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
-		arrpush(*vertices, vertexList[i]);
-	}
+	free(angles);
 
-	*outVertexCount = vertexCount;
-	*outIndexCount = indexCount;
-	arrfree(triangleList);
-	arrfree(vertexList);
+	FinishShape(shapeVertices, numVertices, shapeIndices, indexOffset, &levels, levelIndexCounts, levelErrors,
+		outVertexCount, outIndexCount, outBounds, outLODs);
 }
 
-void CreateHemiSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool base)
+void CreateHemiSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool base, MeshBounds* outBounds,
+	uint32_t tessellation, uint32_t numLODs, MeshLOD* outLODs)
 {
 	//Parameteric equations used to the produce the vertices of a unit hemisphere.
 	//x = sin(phi) * cos(theta);
-	//y = cos(phi)
+	//y = cos(phi) - 0.5
 	//z = sin(phi) * sin(theta)
+	//theta = u * 2pi, phi = v * pi / 2
 
-	Vertex* vertexList = nullptr;
-	uint32_t vertexCount = 0;
-	uint32_t indexCount = 0;
-	Vertex vertex;
+	ShapeLevels levels{};
+	InitShapeLevels(&levels, tessellation, 4, 1, numLODs);
+	uint32_t segments = levels.segments;
+	uint32_t rings = levels.rings;
 
-	float thetaStepRate = 10.0f; //degrees
-	float phiStepRate = 10.0f; //degrees
+	//The base has its own rim vertices so it stays flat
+	uint32_t numDomeVertices = (segments + 1) * (rings + 1);
+	uint32_t numVertices = numDomeVertices + ((base == true) ? segments + 2 : 0);
 
-	uint32_t numCircles = (90.0f / phiStepRate) + 1;
-	uint32_t numVerticesPerCircle = (360.0f / thetaStepRate) + 1;
-
-	float u = 0.0f;
-	float v = 0.0f;
-	float uStep = 1.0f / (numVerticesPerCircle - 1);
-	float vStep = 1.0f / (numCircles - 1);
-
-	//Compute the vertices and texture coordinates.
-	for (uint32_t i = 0; i < numCircles; ++i)
+	uint32_t levelIndexCounts[MAX_MESH_LODS]{};
+	float levelErrors[MAX_MESH_LODS]{};
+	uint32_t numIndices = 0;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle; ++j)
-		{
-			float x = sin(v * PI / 2) * cos(u * PI2);
-			float y = cos(v * PI / 2) - 0.5f;
-			float z = sin(v * PI / 2) * sin(u * PI2);
-			vertex.position.Set(x, y, z, 1.0f);
-
-			vertex.texCoords.Set(u, v);
-			vertex.normal.Set(x, y, z, 0.0f);
-
-			arrpush(vertexList, vertex);
-
-			u += uStep;
-
-			++vertexCount;
-		}
-		v += vStep;
-		u = 0.0f;
+		float thetaError = ChordError(1.0f, PI2 * (1u << i) / segments);
+		float phiError = ChordError(1.0f, (PI / 2.0f) * (1u << i) / rings);
+		levelIndexCounts[i] = GetGridIndexCount(&levels, i, true, false) + ((base == true) ? 3 * (segments >> i) : 0);
+		levelErrors[i] = 1.0f - (1.0f - thetaError) * (1.0f - phiError);
+		numIndices += levelIndexCounts[i];
 	}
 
-	Triangle* triangleList = nullptr;
-	for (uint32_t i = 0; i < numCircles - 1; ++i)
+	uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+	Vertex* shapeVertices = nullptr;
+	uint32_t* shapeIndices = nullptr;
+	AppendShape(vertices, indices, numVertices, numIndices, &shapeVertices, &shapeIndices);
+
+	float* angles = (float*)malloc(2 * (segments + rings + 2) * sizeof(float));
+	float* cosTheta = angles;
+	float* sinTheta = cosTheta + segments + 1;
+	float* cosPhi = sinTheta + segments + 1;
+	float* sinPhi = cosPhi + rings + 1;
+	ComputeShapeAngles(segments, PI2, cosTheta, sinTheta);
+	ComputeShapeAngles(rings, PI / 2.0f, cosPhi, sinPhi);
+
+	//The last ring is on the equator
+	sinPhi[rings] = 1.0f;
+	cosPhi[rings] = 0.0f;
+
+	Vertex* vertex = shapeVertices;
+	for (uint32_t i = 0; i <= rings; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle - 1; ++j)
+		for (uint32_t j = 0; j <= segments; ++j)
 		{
-			//Indices of the vertices that make up a quad
-			uint32_t topLeft = (i * numVerticesPerCircle) + j;
-			uint32_t topRight = (i * numVerticesPerCircle) + j + 1;
-			uint32_t bottomLeft = ((i + 1) * numVerticesPerCircle) + j;
-			uint32_t bottomRight = ((i + 1) * numVerticesPerCircle) + j + 1;
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, topRight);
-			arrpush(*indices, bottomRight);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, bottomRight);
-			arrpush(*indices, bottomLeft);
+			vec3 normal(sinPhi[i] * cosTheta[j], cosPhi[i], sinPhi[i] * sinTheta[j]);
+			vec3 position(normal.GetX(), normal.GetY() - 0.5f, normal.GetZ());
+			vec3 tangent(-sinTheta[j], 0.0f, cosTheta[j]);
+			vec3 bitangent(cosPhi[i] * cosTheta[j], -sinPhi[i], cosPhi[i] * sinTheta[j]);
 
-			indexCount += 6;
-
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, topLeft, topRight, bottomRight);
-			arrpush(triangleList, triangle);
-
-			CreateTriangle(&triangle, vertexList, topLeft, bottomRight, bottomLeft);
-			arrpush(triangleList, triangle);
+			SetShapeVertex(vertex++, position, normal, tangent, bitangent, (float)j / segments, (float)i / rings);
 		}
 	}
 
 	if (base == true)
-	{
-		//Center vertex for the base
-		vertex.position.Set(0.0f, -0.25f, 0.0f, 1.0f);
-		vertex.texCoords.Set(0.5f, 0.5f);
-		vertex.normal.Set(0.0f, 0.25f, 0.0f, 0.0f);
-		arrpush(vertexList, vertex);
-
-		uint32_t index = arrlenu(vertexList) - 1; //index of the last vertex
-		uint32_t index2 = index - numVerticesPerCircle; //index of the first vertex of the last circle
-		for (uint32_t i = 0; i < numVerticesPerCircle - 1; ++i)
-		{
-			uint32_t i0 = index;
-			uint32_t i1 = index2 + i;
-			uint32_t i2 = index2 + i + 1;
-
-			arrpush(*indices, index);
-			arrpush(*indices, index2 + i);
-			arrpush(*indices, index2 + i + 1);
-
-			vertexList[i0].normal += vertexList[i1].normal;
-			vertexList[i0].normal += vertexList[i2].normal;
+		vertex = WriteShapeDisk(vertex, segments, cosTheta, sinTheta, -0.5f, -1.0f);
 
-
-			indexCount += 3;
-		}
-	}
-
-	//Compute the normal, tangent and bitangent
-	uint32_t numTriangles = arrlenu(triangleList);
-	for (uint32_t i = 0; i < numTriangles; ++i)
+	uint32_t* cur = shapeIndices;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		vec4 tangent;
-		tangent = ComputeTangent(&triangleList[i]);
-
-		uint32_t i0 = triangleList[i].i0;
-		uint32_t i1 = triangleList[i].i1;
-		uint32_t i2 = triangleList[i].i2;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
+		cur = WriteGridIndices(cur, 0, &levels, i, true, false);
+		if (base == true)
+			cur = WriteFanIndices(cur, numDomeVertices, numDomeVertices + 1, &levels, i, false);
 	}
 
-	//The positions of the first and last vertex of each circle are the same, so they must have the same TBN.
-	for (uint32_t i = 0; i < numCircles; ++i)
-	{
-		uint32_t firstVertex = i * numVerticesPerCircle;
-		uint32_t lastVertex = i * numVerticesPerCircle + (numVerticesPerCircle - 1);
-		vec4 normal = vertexList[firstVertex].normal + vertexList[lastVertex].normal;
-		vertexList[firstVertex].normal = normal;
-		vertexList[lastVertex].normal = normal;
-
-		vec4 tangent = vertexList[firstVertex].tangent + vertexList[lastVertex].tangent;
-		vertexList[firstVertex].tangent = tangent;
-		vertexList[lastVertex].tangent = tangent;
-	}
-
-	uint32_t numVertices = arrlenu(vertexList);
-	for (uint32_t i = 0; i < numVertices; ++i)
-	{
-		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
-
-		arrpush(*vertices, vertexList[i]);
-	}
+	free(angles);
 
-	*outVertexCount = vertexCount;
-	*outIndexCount = indexCount;
-	arrfree(triangleList);
-	arrfree(vertexList);
+	FinishShape(shapeVertices, numVertices, shapeIndices, indexOffset, &levels, levelIndexCounts, levelErrors,
+		outVertexCount, outIndexCount, outBounds, outLODs);
 }
 
 void CreateCylinder(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, 
-	bool topBase, bool bottomBase)
+	bool topBase, bool bottomBase, MeshBounds* outBounds, uint32_t tessellation, uint32_t numLODs, MeshLOD* outLODs)
 {
 	//Parameteric equations used to the produce the vertices of a unit cylinder.
 	//x = cos(theta);
-	//y = h
+	//y = 0.5 - v
 	//z = sin(theta)
-
-	Vertex* vertexList = nullptr;
-	Triangle* triangleList = nullptr;
-	uint32_t vertexCount = 0;
-	uint32_t indexCount = 0;
-	Vertex vertex;
-
-	float thetaStepRate = 10.0f; //degrees
-	float h = 1.0f;
-
-	uint32_t numCircles = 20;
-	uint32_t numVerticesPerCircle = (360.0f / thetaStepRate) + 1;
-
-	float u = 0.0f;
-	float v = 0.0f;
-	float uStep = 1.0f / (numVerticesPerCircle - 1);
-	float vStep = 1.0f / (numCircles - 1);
-
-	//Compute the vertices and texture coordinates.
-	for (uint32_t i = 0; i < numCircles; ++i)
+	//theta = u * 2pi
+
+	ShapeLevels levels{};
+	InitShapeLevels(&levels, tessellation, 2, 1, numLODs);
+	uint32_t segments = levels.segments;
+	uint32_t rings = levels.rings;
+
+	//The bases have their own rim vertices so the edges stay sharp
+	uint32_t numSideVertices = (segments + 1) * (rings + 1);
+	uint32_t topVertex = numSideVertices;
+	uint32_t bottomVertex = topVertex + ((topBase == true) ? segments + 2 : 0);
+	uint32_t numVertices = bottomVertex + ((bottomBase == true) ? segments + 2 : 0);
+
+	uint32_t levelIndexCounts[MAX_MESH_LODS]{};
+	float levelErrors[MAX_MESH_LODS]{};
+	uint32_t numIndices = 0;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle; ++j)
-		{
-			float x = cos(u * PI2);
-			float y = 0.5f - (v * h);
-			float z =  sin(u * PI2);
-			vertex.position.Set(x, y, z, 1.0f);
-
-			vertex.texCoords.Set(u, v);
+		uint32_t numBases = ((topBase == true) ? 1 : 0) + ((bottomBase == true) ? 1 : 0);
+		levelIndexCounts[i] = GetGridIndexCount(&levels, i, false, false) + numBases * 3 * (segments >> i);
+		levelErrors[i] = ChordError(1.0f, PI2 * (1u << i) / segments);
+		numIndices += levelIndexCounts[i];
+	}
 
-			arrpush(vertexList, vertex);
+	uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+	Vertex* shapeVertices = nullptr;
+	uint32_t* shapeIndices = nullptr;
+	AppendShape(vertices, indices, numVertices, numIndices, &shapeVertices, &shapeIndices);
 
-			u += uStep;
+	float* angles = (float*)malloc(2 * (segments + 1) * sizeof(float));
+	float* cosTheta = angles;
+	float* sinTheta = angles + segments + 1;
+	ComputeShapeAngles(segments, PI2, cosTheta, sinTheta);
 
-			++vertexCount;
-		}
-		v += vStep;
-		u = 0.0f;
-	}
+	vec3 bitangent(0.0f, -1.0f, 0.0f);
 
-	//Generate the triangles
-	for (uint32_t i = 0; i < numCircles - 1; ++i)
+	Vertex* vertex = shapeVertices;
+	for (uint32_t i = 0; i <= rings; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle - 1; ++j)
+		float v = (float)i / rings;
+		for (uint32_t j = 0; j <= segments; ++j)
 		{
-			//Indices of the vertices that make up a quad
-			uint32_t topLeft = (i * numVerticesPerCircle) + j;
-			uint32_t topRight = (i * numVerticesPerCircle) + j + 1;
-			uint32_t bottomLeft = ((i + 1) * numVerticesPerCircle) + j;
-			uint32_t bottomRight = ((i + 1) * numVerticesPerCircle) + j + 1;
-
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, topLeft, topRight, bottomRight);
-			arrpush(triangleList, triangle);
-			CreateTriangle(&triangle, vertexList, topLeft, bottomRight, bottomLeft);
-			arrpush(triangleList, triangle);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, topRight);
-			arrpush(*indices, bottomRight);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, bottomRight);
-			arrpush(*indices, bottomLeft);
-
-			indexCount += 6;
-		}
-	}
+			vec3 normal(cosTheta[j], 0.0f, sinTheta[j]);
+			vec3 tangent(-sinTheta[j], 0.0f, cosTheta[j]);
 
-	if (topBase)
-	{
-		//Top Center Vertex
-		vertex.position.Set(0.0f, 0.5f, 0.0f, 1.0f);
-		vertex.texCoords.Set(0.5f, 0.5f);
-		vertex.normal.Set(0.0f, 1.0f, 0.0f, 0.0f);
-		arrpush(vertexList, vertex);
-		uint32_t topIndex = arrlenu(vertexList) - 1;
-
-		uint32_t index = (numCircles - 1) * numVerticesPerCircle; //index of the first vertex of the last circle
-		for (uint32_t i = 0; i < numVerticesPerCircle - 1; ++i)
-		{
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, topIndex, i + 1, i);
-			arrpush(triangleList, triangle);
-			arrpush(*indices, topIndex);
-			arrpush(*indices, triangle.i1);
-			arrpush(*indices, triangle.i2);
-
-			indexCount += 3;
+			SetShapeVertex(vertex++, vec3(cosTheta[j], 0.5f - v, sinTheta[j]), normal, tangent, bitangent, (float)j / segments, v);
 		}
 	}
 
-	if (bottomBase)
-	{
-		//Bottom Center Vertex
-		vertex.position.Set(0.0f, -0.5f, 0.0f, 1.0f);
-		vertex.texCoords.Set(0.5f, 0.5f);
-		vertex.normal.Set(0.0f, -1.0f, 0.0f, 0.0f);
-		arrpush(vertexList, vertex);
-		uint32_t bottomIndex = arrlenu(vertexList) - 1;
-
-		uint32_t index = (numCircles - 1) * numVerticesPerCircle; //index of the first vertex of the last circle
-		for (uint32_t i = 0; i < numVerticesPerCircle - 1; ++i)
-		{
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, bottomIndex, index + i, index + i + 1);
-			arrpush(triangleList, triangle);
-			arrpush(*indices, bottomIndex);
-			arrpush(*indices, triangle.i1);
-			arrpush(*indices, triangle.i2);
-
-			indexCount += 3;
-		}
-	}
+	if (topBase == true)
+		vertex = WriteShapeDisk(vertex, segments, cosTheta, sinTheta, 0.5f, 1.0f);
 
-	//Compute the normal, tangent and bitangent
-	uint32_t numTriangles = arrlenu(triangleList);
-	for (uint32_t i = 0; i < numTriangles; ++i)
-	{
-		vec4 normal;
-		vec4 tangent;
-		vec4 bitangent;
-		normal = ComputeNormal(&triangleList[i]);
-		tangent = ComputeTangent(&triangleList[i]);
-
-		uint32_t i0 = triangleList[i].i0;
-		uint32_t i1 = triangleList[i].i1;
-		uint32_t i2 = triangleList[i].i2;
-
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-	}
+	if (bottomBase == true)
+		vertex = WriteShapeDisk(vertex, segments, cosTheta, sinTheta, -0.5f, -1.0f);
 
-	//The positions of the first and last vertex of each circle are the same, so they must have the same TBN.
-	for (uint32_t i = 0; i < numCircles; ++i)
+	uint32_t* cur = shapeIndices;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		uint32_t firstVertex = i * numVerticesPerCircle;
-		uint32_t lastVertex = i * numVerticesPerCircle + (numVerticesPerCircle - 1);
-		vec4 normal = vertexList[firstVertex].normal + vertexList[lastVertex].normal;
-		vertexList[firstVertex].normal = normal;
-		vertexList[lastVertex].normal = normal;
-
-		vec4 tangent = vertexList[firstVertex].tangent + vertexList[lastVertex].tangent;
-		vertexList[firstVertex].tangent = tangent;
-		vertexList[lastVertex].tangent = tangent;
-	}
+		cur = WriteGridIndices(cur, 0, &levels, i, false, false);
+		if (topBase == true)
+			cur = WriteFanIndices(cur, topVertex, topVertex + 1, &levels, i, true);
 
-	uint32_t numVertices = arrlenu(vertexList);
-	for (uint32_t i = 0; i < numVertices; ++i)
-	{
-		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
-
-		arrpush(*vertices, vertexList[i]);
+		if (bottomBase == true)
+			cur = WriteFanIndices(cur, bottomVertex, bottomVertex + 1, &levels, i, false);
 	}
 
-	*outVertexCount = vertexCount;
-	*outIndexCount = indexCount;
-	arrfree(triangleList);
-	arrfree(vertexList);
+	free(angles);
+
+	FinishShape(shapeVertices, numVertices, shapeIndices, indexOffset, &levels, levelIndexCounts, levelErrors,
+		outVertexCount, outIndexCount, outBounds, outLODs);
 }
 
-void CreateCone(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool bottomBase)
+void CreateCone(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool bottomBase, MeshBounds* outBounds,
+	uint32_t tessellation, uint32_t numLODs, MeshLOD* outLODs)
 {
-	//Parameteric equations used to the produce the vertices of a unit cylinder.
-	//x = rcos(theta);
-	//y = r
-	//z = rsin(theta)
-
-	Vertex* vertexList = nullptr;
-	Triangle* triangleList = nullptr;
-	uint32_t vertexCount = 0;
-	uint32_t indexCount = 0;
-	Vertex vertex;
-
-	float thetaStepRate = 10.0f; //degrees
-	float r = 1.0f;
-
-	uint32_t numCircles = 20;
-	uint32_t numVerticesPerCircle = (360.0f / thetaStepRate) + 1;
-
-	float u = 0.0f;
-	float v = 0.0f;
-	float uStep = 1.0f / (numVerticesPerCircle - 1);
-	float vStep = 1.0f / (numCircles - 1);
-
-	//Compute the vertices and texture coordinates.
-	for (uint32_t i = 0; i < numCircles; ++i)
+	//Parameteric equations used to the produce the vertices of a unit cone.
+	//x = v * cos(theta);
+	//y = 0.5 - v
+	//z = v * sin(theta)
+	//theta = u * 2pi
+
+	ShapeLevels levels{};
+	InitShapeLevels(&levels, tessellation, 2, 1, numLODs);
+	uint32_t segments = levels.segments;
+	uint32_t rings = levels.rings;
+
+	//The first ring is the apex. The base has its own rim vertices so the edge stays sharp.
+	uint32_t numSideVertices = (segments + 1) * (rings + 1);
+	uint32_t numVertices = numSideVertices + ((bottomBase == true) ? segments + 2 : 0);
+
+	uint32_t levelIndexCounts[MAX_MESH_LODS]{};
+	float levelErrors[MAX_MESH_LODS]{};
+	uint32_t numIndices = 0;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle; ++j)
-		{
-			float x = (v * r) * cos(u * PI2);
-			float y = 0.5f - (v * r);
-			float z = (v * r) * sin(u * PI2);
-			vertex.position.Set(x, y, z, 1.0f);
-
-			vertex.texCoords.Set(u, v);
-
-			arrpush(vertexList, vertex);
-
-			u += uStep;
-
-			++vertexCount;
-		}
-		v += vStep;
-		u = 0.0f;
+		levelIndexCounts[i] = GetGridIndexCount(&levels, i, true, false) + ((bottomBase == true) ? 3 * (segments >> i) : 0);
+		levelErrors[i] = ChordError(1.0f, PI2 * (1u << i) / segments);
+		numIndices += levelIndexCounts[i];
 	}
 
-	//The vertices of the first cirlce have the same position. 
-	//Create triangles with the 2nd circle.
-	for (uint32_t i = 0; i < numVerticesPerCircle; ++i)
-	{
-		for (uint32_t j = 0; j < numVerticesPerCircle - 1; ++j)
-		{
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, i, numVerticesPerCircle + j + 1, numVerticesPerCircle + j);
-			arrpush(triangleList, triangle);
+	uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+	Vertex* shapeVertices = nullptr;
+	uint32_t* shapeIndices = nullptr;
+	AppendShape(vertices, indices, numVertices, numIndices, &shapeVertices, &shapeIndices);
 
-			arrpush(*indices, triangle.i0);
-			arrpush(*indices, triangle.i1);
-			arrpush(*indices, triangle.i2);
+	float* angles = (float*)malloc(2 * (segments + 1) * sizeof(float));
+	float* cosTheta = angles;
+	float* sinTheta = angles + segments + 1;
+	ComputeShapeAngles(segments, PI2, cosTheta, sinTheta);
 
-			indexCount += 3;
-		}
-	}
+	//The side rises 1 over a radius of 1, so the normal is 45 degrees above the horizontal.
+	//The apex vertices keep the normal of their segment.
+	const float invSqrt2 = 0.70710678f;
 
-	//Generate the triangles
-	for (uint32_t i = 1; i < numCircles - 1; ++i)
+	Vertex* vertex = shapeVertices;
+	for (uint32_t i = 0; i <= rings; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle - 1; ++j)
+		float v = (float)i / rings;
+		for (uint32_t j = 0; j <= segments; ++j)
 		{
-			//Indices of the vertices that make up a quad
-			uint32_t topLeft = (i * numVerticesPerCircle) + j;
-			uint32_t topRight = (i * numVerticesPerCircle) + j + 1;
-			uint32_t bottomLeft = ((i + 1) * numVerticesPerCircle) + j;
-			uint32_t bottomRight = ((i + 1) * numVerticesPerCircle) + j + 1;
-
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, topLeft, topRight, bottomRight);
-			arrpush(triangleList, triangle);
-			CreateTriangle(&triangle, vertexList, topLeft, bottomRight, bottomLeft);
-			arrpush(triangleList, triangle);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, topRight);
-			arrpush(*indices, bottomRight);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, bottomRight);
-			arrpush(*indices, bottomLeft);
-
-			indexCount += 6;
-		}
-	}
+			vec3 position(v * cosTheta[j], 0.5f - v, v * sinTheta[j]);
+			vec3 normal(cosTheta[j] * invSqrt2, invSqrt2, sinTheta[j] * invSqrt2);
+			vec3 tangent(-sinTheta[j], 0.0f, cosTheta[j]);
+			vec3 bitangent(cosTheta[j], -1.0f, sinTheta[j]);
 
-	if (bottomBase)
-	{
-		//Bottom Center Vertex
-		vertex.position.Set(0.0f, -0.5f, 0.0f, 1.0f);
-		vertex.texCoords.Set(0.5f, 0.5f);
-		vertex.normal.Set(0.0f, -1.0f, 0.0f, 0.0f);
-		arrpush(vertexList, vertex);
-		uint32_t bottomIndex = arrlenu(vertexList) - 1;
-
-		uint32_t index = bottomIndex - numVerticesPerCircle; //index of the first vertex of the last circle
-		for (uint32_t i = 0; i < numVerticesPerCircle - 1; ++i)
-		{
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, bottomIndex, index + i, index + i + 1);
-			arrpush(triangleList, triangle);
-			arrpush(*indices, bottomIndex);
-			arrpush(*indices, triangle.i1);
-			arrpush(*indices, triangle.i2);
-
-			indexCount += 3;
+			SetShapeVertex(vertex++, position, normal, tangent, bitangent, (float)j / segments, v);
 		}
 	}
 
-	//Compute the normals
-	uint32_t numTriangles = arrlenu(triangleList);
-	for (uint32_t i = 0; i < numTriangles; ++i)
-	{
-		vec4 normal;
-		vec4 tangent;
-		vec4 bitangent;
-		normal = ComputeNormal(&triangleList[i]);
-		tangent = ComputeTangent(&triangleList[i]);
-
-		uint32_t i0 = triangleList[i].i0;
-		uint32_t i1 = triangleList[i].i1;
-		uint32_t i2 = triangleList[i].i2;
-
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-	}
-
+	if (bottomBase == true)
+		vertex = WriteShapeDisk(vertex, segments, cosTheta, sinTheta, -0.5f, -1.0f);
 
-	//The positions of the first and last vertex of each circle are the same, so they must have the same normal.
-	for (uint32_t i = 0; i < numCircles; ++i)
+	uint32_t* cur = shapeIndices;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		//The vertices of the first cirlce have the same position, so they must have the same normal.
-		if (i == 0)
-		{
-			vec4 normal;
-			vec4 tangent;
-			vec4 bitangent;
-			for (uint32_t j = 0; j < numVerticesPerCircle; ++j)
-			{
-				normal += vertexList[j].normal;
-				tangent += vertexList[j].tangent;
-			}
-
-			for (uint32_t j = 0; j < numVerticesPerCircle; ++j)
-			{
-				vertexList[j].normal = normal;
-				vertexList[j].tangent = tangent;
-			}
-		}
-		else
-		{
-			uint32_t firstVertex = i * numVerticesPerCircle;
-			uint32_t lastVertex = i * numVerticesPerCircle + (numVerticesPerCircle - 1);
-			vec4 normal = vertexList[firstVertex].normal + vertexList[lastVertex].normal;
-			vertexList[firstVertex].normal = normal;
-			vertexList[lastVertex].normal = normal;
-
-			vec4 tangent = vertexList[firstVertex].tangent + vertexList[lastVertex].tangent;
-			vertexList[firstVertex].tangent = tangent;
-			vertexList[lastVertex].tangent = tangent;
-		}
+		cur = WriteGridIndices(cur, 0, &levels, i, true, false);
+		if (bottomBase == true)
+			cur = WriteFanIndices(cur, numSideVertices, numSideVertices + 1, &levels, i, false);
 	}
 
-	uint32_t numVertices = arrlenu(vertexList);
-	for (uint32_t i = 0; i < numVertices; ++i)
-	{
-		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
-
-		arrpush(*vertices, vertexList[i]);
-	}
+	free(angles);
 
-	*outVertexCount = vertexCount;
-	*outIndexCount = indexCount;
-	arrfree(triangleList);
-	arrfree(vertexList);
+	FinishShape(shapeVertices, numVertices, shapeIndices, indexOffset, &levels, levelIndexCounts, levelErrors,
+		outVertexCount, outIndexCount, outBounds, outLODs);
 }
 
 void CreateTorus(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, 
-	float outerRaidus, float innerRadius)
+	float outerRaidus, float innerRadius, MeshBounds* outBounds, uint32_t tessellation, uint32_t numLODs, MeshLOD* outLODs)
 {
-	//Parameteric equations used to the produce the vertices of a unit cylinder.
+	//Parameteric equations used to the produce the vertices of a torus.
 	//x = (R + rcos(theta)) * cos(phi);
 	//y = rsin(theta)
-	//z = (R + rsin(theta)) * sin(phi)
-
-	Vertex* vertexList = nullptr;
-	Triangle* triangleList = nullptr;
-	uint32_t vertexCount = 0;
-	uint32_t indexCount = 0;
-	Vertex vertex;
-
-	float thetaStepRate = 10.0f; //degrees
-	float phiStepRate = 10.0f;
-	float r = 1.0f;
+	//z = (R + rcos(theta)) * sin(phi)
+	//theta = u * 2pi around the tube, phi = v * 2pi around the y axis
 
-	uint32_t numCircles = (360.0f / phiStepRate) + 1;
-	uint32_t numVerticesPerCircle = (360.0f / thetaStepRate) + 1;
+	ShapeLevels levels{};
+	InitShapeLevels(&levels, tessellation, 1, 3, numLODs);
+	uint32_t segments = levels.segments;
+	uint32_t rings = levels.rings;
 
-	float u = 0.0f;
-	float v = 0.0f;
-	float uStep = 1.0f / (numVerticesPerCircle - 1);
-	float vStep = 1.0f / (numCircles - 1);
+	uint32_t numVertices = (segments + 1) * (rings + 1);
 
-	//Compute the vertices and texture coordinates.
-	for (uint32_t i = 0; i < numCircles; ++i)
+	uint32_t levelIndexCounts[MAX_MESH_LODS]{};
+	float levelErrors[MAX_MESH_LODS]{};
+	uint32_t numIndices = 0;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle; ++j)
-		{
-			float x = (outerRaidus + innerRadius * cos(u * PI2)) * cos(v * PI2);
-			float y = sin(u * PI2);
-			float z = (outerRaidus + innerRadius * cos(u * PI2)) * sin(v * PI2);
-			vertex.position.Set(x, y, z, 1.0f);
-
-			vertex.texCoords.Set(u, v);
-
-			arrpush(vertexList, vertex);
-
-			u += uStep;
-
-			++vertexCount;
-		}
-		v += vStep;
-		u = 0.0f;
+		levelIndexCounts[i] = GetGridIndexCount(&levels, i, false, false);
+		levelErrors[i] = ChordError(innerRadius, PI2 * (1u << i) / segments) + ChordError(outerRaidus + innerRadius, PI2 * (1u << i) / rings);
+		numIndices += levelIndexCounts[i];
 	}
 
-	//Generate the triangles
-	for (uint32_t i = 0; i < numCircles - 1; ++i)
+	uint32_t indexOffset = (uint32_t)arrlenu(*indices);
+	Vertex* shapeVertices = nullptr;
+	uint32_t* shapeIndices = nullptr;
+	AppendShape(vertices, indices, numVertices, numIndices, &shapeVertices, &shapeIndices);
+
+	float* angles = (float*)malloc(2 * (segments + rings + 2) * sizeof(float));
+	float* cosTheta = angles;
+	float* sinTheta = cosTheta + segments + 1;
+	float* cosPhi = sinTheta + segments + 1;
+	float* sinPhi = cosPhi + rings + 1;
+	ComputeShapeAngles(segments, PI2, cosTheta, sinTheta);
+	ComputeShapeAngles(rings, PI2, cosPhi, sinPhi);
+
+	Vertex* vertex = shapeVertices;
+	for (uint32_t i = 0; i <= rings; ++i)
 	{
-		for (uint32_t j = 0; j < numVerticesPerCircle - 1; ++j)
+		for (uint32_t j = 0; j <= segments; ++j)
 		{
-			//Indices of the vertices that make up a quad
-			uint32_t topLeft = (i * numVerticesPerCircle) + j;
-			uint32_t topRight = (i * numVerticesPerCircle) + j + 1;
-			uint32_t bottomLeft = ((i + 1) * numVerticesPerCircle) + j;
-			uint32_t bottomRight = ((i + 1) * numVerticesPerCircle) + j + 1;
-
-			Triangle triangle{};
-			CreateTriangle(&triangle, vertexList, topLeft, topRight, bottomRight);
-			arrpush(triangleList, triangle);
-			CreateTriangle(&triangle, vertexList, topLeft, bottomRight, bottomLeft);
-			arrpush(triangleList, triangle);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, topRight);
-			arrpush(*indices, bottomRight);
-
-			arrpush(*indices, topLeft);
-			arrpush(*indices, bottomRight);
-			arrpush(*indices, bottomLeft);
-
-			indexCount += 6;
-		}
-	}
-
-	//Compute the normals
-	uint32_t numTriangles = arrlenu(triangleList);
-	for (uint32_t i = 0; i < numTriangles; ++i)
-	{
-		vec4 normal;
-		vec4 tangent;
-		vec4 bitangent;
-		normal = ComputeNormal(&triangleList[i]);
-		tangent = ComputeTangent(&triangleList[i]);
-
-		uint32_t i0 = triangleList[i].i0;
-		uint32_t i1 = triangleList[i].i1;
-		uint32_t i2 = triangleList[i].i2;
-
-		vertexList[i0].normal += normal;
-		vertexList[i1].normal += normal;
-		vertexList[i2].normal += normal;
-
-		vertexList[i0].tangent += tangent;
-		vertexList[i1].tangent += tangent;
-		vertexList[i2].tangent += tangent;
-	}
-
-	//The positions of the first and last vertex of each circle are the same, so they must have the same normal.
-	for (uint32_t i = 0; i < numCircles; ++i)
-	{
-		uint32_t firstVertex = i * numCircles; //first vertex of each circle.
-		uint32_t lastVertex = i * numCircles + (numCircles - 1); //last vertex of each circle.
-
-		vec4 normal = vertexList[firstVertex].normal + vertexList[lastVertex].normal;
-		vertexList[firstVertex].normal = normal;
-		vertexList[lastVertex].normal = normal;
-
-		vec4 tangent = vertexList[firstVertex].tangent + vertexList[lastVertex].tangent;
-		vertexList[firstVertex].tangent = tangent;
-		vertexList[lastVertex].tangent = tangent;
-	}
+			float radius = outerRaidus + innerRadius * cosTheta[j];
+			vec3 position(radius * cosPhi[i], innerRadius * sinTheta[j], radius * sinPhi[i]);
+			vec3 normal(cosTheta[j] * cosPhi[i], sinTheta[j], cosTheta[j] * sinPhi[i]);
+			vec3 tangent(-sinTheta[j] * cosPhi[i], cosTheta[j], -sinTheta[j] * sinPhi[i]);
+			vec3 bitangent(-sinPhi[i], 0.0f, cosPhi[i]);
 
-	//The positions of the vertices of the first and last circle are the same, so they must have the same normal.
-	uint32_t numVertices = arrlenu(vertexList);
-	for (uint32_t i = 0; i < numVerticesPerCircle; ++i)
-	{
-		uint32_t firstVertex = i; //vertices of the first circle.
-		uint32_t lastVertex = numVertices - numVerticesPerCircle + i; //vertices of the last circle
-
-		vec4 normal = vertexList[firstVertex].normal + vertexList[lastVertex].normal;
-		vertexList[firstVertex].normal = normal;
-		vertexList[lastVertex].normal = normal;
-
-		vec4 tangent = vertexList[firstVertex].tangent + vertexList[lastVertex].tangent;
-		vertexList[firstVertex].tangent = tangent;
-		vertexList[lastVertex].tangent = tangent;
+			SetShapeVertex(vertex++, position, normal, tangent, bitangent, (float)j / segments, (float)i / rings);
+		}
 	}
 
-	for (uint32_t i = 0; i < numVertices; ++i)
-	{
-		vertexList[i].normal = Normalize(vertexList[i].normal);
-		vertexList[i].tangent = Normalize(vertexList[i].tangent);
-		arrpush(*vertices, vertexList[i]);
-	}
+	uint32_t* cur = shapeIndices;
+	for (uint32_t i = 0; i < levels.numLODs; ++i)
+		cur = WriteGridIndices(cur, 0, &levels, i, false, false);
 
-	*outVertexCount = vertexCount;
-	*outIndexCount = indexCount;
-	arrfree(triangleList);
-	arrfree(vertexList);
+	free(angles);
 
+	FinishShape(shapeVertices, numVertices, shapeIndices, indexOffset, &levels, levelIndexCounts, levelErrors,
+		outVertexCount, outIndexCount, outBounds, outLODs);
 }
 
 void DestroyShape(Vertex** vertices, uint32_t** indices)
@@ -1496,7 +1189,10 @@ void DestroyShape(Vertex** vertices, uint32_t** indices)
 
 void UpdateModelMatrix(Shape* shape)
 {
-	shape->model = mat4::Scale(shape->scale.GetX(), shape->scale.GetY(), shape->scale.GetZ()) *
-		QuaternionToMatrix(shape->orientation) * mat4::Translate(shape->position.GetX(), shape->position.GetY(), shape->position.GetZ());
+	//Scale * Rotation * Translate without the matrix multiplies.
+	//Row i of the rotation is scaled by the scale of axis i and the translation is the last row.
+	mat4 rotation = QuaternionToMatrix(shape->orientation);
+	shape->model = mat4(rotation.GetRow(0) * shape->scale.GetX(), rotation.GetRow(1) * shape->scale.GetY(), rotation.GetRow(2) * shape->scale.GetZ(),
+		vec4(shape->position.GetX(), shape->position.GetY(), shape->position.GetZ(), 1.0f));
 }
 
@@ -3,77 +3,100 @@
 #include "../Math/SEMath_Header.h"
 #include "../ThirdParty/stb_ds.h"
 #include "../Mesh/SEMesh.h"
+#include "../Mesh/SEBounds.h"
+#include "../Mesh/SEMeshSimplifier.h"
+
+//Every Create function stores the bounds of the shape in outBounds if it isn't nullptr.
+
+//The curved shapes (circle, sphere, hemisphere, cylinder, cone and torus) are generated from their parametric equations
+//with analytic normals and tangents, straight into the preallocated arrays.
+//tessellation is the number of segments around the axis. The number of rings along the axis follows from it.
+//numLODs levels of detail, up to MAX_MESH_LODS, can be generated in the same call. Every level halves the segments and rings
+//of the level before it, so all the levels index the same vertices. tessellation is rounded up to a multiple of 2^(numLODs - 1).
+//The indices of the levels are appended one after the other. outLODs receives the offset of every level in the index array,
+//its number of indices and its largest distance to the exact surface, for SelectMeshLOD.
+//outIndexCount receives the number of indices of the finest level.
+
+//Segments of the curved shapes by default, the old 10 degree step. The circle uses a 4 degree step.
+#define SHAPE_DEFAULT_TESSELLATION 36
+#define SHAPE_DEFAULT_CIRCLE_TESSELLATION 90
 
 //Create the vertices for an unit line.
 //Unit meaning its length is one.
 //Stores the vertices in a stb_ds array.
-void CreateLine(Vertex** vertices);
+void CreateLine(Vertex** vertices, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices for an unit equilateral triangle centered around the origin.
 //Unit meaning base = 1 and height = 1.
 //Stores the vertices in a stb_ds array.
-void CreateEquilateralTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateEquilateralTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices for an unit right triangle centered around the origin.
 //Unit meaning base = 1 and height = 1.
 //Stores the vertices in a stb_ds array.
-void CreateRightTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateRightTriangle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices and indices for an unit quad centered around the origin.
 //Unit meaning width = 1 and height = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateQuad(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices and indices for an unit circle centered around the origin.
 //Unit meaning radius = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateCircle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateCircle(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr,
+	uint32_t tessellation = SHAPE_DEFAULT_CIRCLE_TESSELLATION, uint32_t numLODs = 1, MeshLOD* outLODs = nullptr);
 
 //Creates the vertices and indices for an unit box centered around the origin.
 //Unit meaning width = 1, height = 1 and depth = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateBox(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateBox(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices and indices for an unit square pyramid centered around the origin.
 //Unit meaning base area = 1, height = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateSquarePyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateSquarePyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices and indices for a frustrum. 
 //The origin is at the center of the small square.
 //Stores the vertices and indices in a stb_ds array.
-void CreateFrustrum(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateFrustrum(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices and indices for an unit triangular pyramid centered around the origin.
 //Unit meaning base area = 1, height = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateTriangularPyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateTriangularPyramid(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr);
 
 //Creates the vertices and indices for an unit sphere centered around the origin.
 //Unit meaning radius = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount);
+void CreateSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, MeshBounds* outBounds = nullptr,
+	uint32_t tessellation = SHAPE_DEFAULT_TESSELLATION, uint32_t numLODs = 1, MeshLOD* outLODs = nullptr);
 
 //Creates the vertices and indices for an unit hemisphere centered around the origin.
 //Unit meaning radius = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateHemiSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool base);
+void CreateHemiSphere(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool base, MeshBounds* outBounds = nullptr,
+	uint32_t tessellation = SHAPE_DEFAULT_TESSELLATION, uint32_t numLODs = 1, MeshLOD* outLODs = nullptr);
 
 //Creates the vertices and indices for an unit cylinder centered around the origin.
 //Unit meaning radius = 1 and height = 1.
 //Stores the vertices and indices in a stb_ds array.
 void CreateCylinder(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, 
-	bool topBase, bool bottomBase);
+	bool topBase, bool bottomBase, MeshBounds* outBounds = nullptr,
+	uint32_t tessellation = SHAPE_DEFAULT_TESSELLATION, uint32_t numLODs = 1, MeshLOD* outLODs = nullptr);
 
 //Creates the vertices and indices for an unit cone centered around the origin.
 //Unit meaning radius = 1 and height = 1.
 //Stores the vertices and indices in a stb_ds array.
-void CreateCone(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool bottomBase);
+void CreateCone(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, bool bottomBase, MeshBounds* outBounds = nullptr,
+	uint32_t tessellation = SHAPE_DEFAULT_TESSELLATION, uint32_t numLODs = 1, MeshLOD* outLODs = nullptr);
 
 //Creates the vertices and indices for a torus centered around the origin.
 //Stores the vertices and indices in a stb_ds array.
 void CreateTorus(Vertex** vertices, uint32_t** indices, uint32_t* outVertexCount, uint32_t* outIndexCount, 
-	float outerRaidus, float innerRadius);
+	float outerRaidus, float innerRadius, MeshBounds* outBounds = nullptr,
+	uint32_t tessellation = SHAPE_DEFAULT_TESSELLATION, uint32_t numLODs = 1, MeshLOD* outLODs = nullptr);
 
 //Frees the stb_ds array
 void DestroyShape(Vertex** vertices, uint32_t** indices);
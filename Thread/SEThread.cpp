@@ -0,0 +1,250 @@
+#include <Windows.h>
+
+#include "SEThread.h"
+
+DWORD WINAPI ThreadProc(LPVOID param)
+{
+	Thread* thread = (Thread*)param;
+	thread->function(thread->data);
+
+	return 0;
+}
+
+void StartThread(Thread* thread, ThreadFunction function, void* data)
+{
+	thread->function = function;
+	thread->data = data;
+
+	thread->handle = CreateThread(nullptr, 0, ThreadProc, thread, 0, nullptr);
+	if (thread->handle == nullptr)
+	{
+		MessageBoxA(nullptr, "Failed to create a thread. Exiting program.", "Thread error.", MB_OK);
+		exit(-1);
+	}
+}
+
+void JoinThread(Thread* thread)
+{
+	if (thread->handle == nullptr)
+		return;
+
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+	thread->handle = nullptr;
+}
+
+uint32_t GetNumLogicalCores()
+{
+	SYSTEM_INFO info{};
+	GetSystemInfo(&info);
+
+	return info.dwNumberOfProcessors;
+}
+
+
+#define MAX_PARALLEL_FOR_THREADS 64
+
+//The ranges of one ParallelFor call. Lives on the stack of the caller until every range is done.
+struct ParallelForJob
+{
+	//Link of the list of jobs with ranges that haven't started
+	ParallelForJob* next;
+
+	ParallelForFunction function;
+	void* data;
+	uint32_t count;
+	uint32_t numRanges;
+
+	//Only changed with the lock of the job pool held
+	uint32_t nextRange;
+
+	volatile LONG numRangesDone;
+};
+
+//Persistent workers that run the ranges of ParallelFor, so a call doesn't create and join threads.
+//The caller of ParallelFor runs ranges as well, so a range may call ParallelFor without a deadlock.
+struct JobPool
+{
+	Thread threads[MAX_PARALLEL_FOR_THREADS];
+	uint32_t numThreads;
+
+	//Protects jobs, started and quit
+	SRWLOCK lock = SRWLOCK_INIT;
+	CONDITION_VARIABLE jobAvailable = CONDITION_VARIABLE_INIT;
+	CONDITION_VARIABLE jobDone = CONDITION_VARIABLE_INIT;
+
+	//FIFO of the jobs with ranges that haven't started
+	ParallelForJob* jobs;
+	ParallelForJob* lastJob;
+
+	bool started;
+	bool quit;
+};
+
+JobPool gJobPool;
+
+//Must be called with the lock held. Returns false if every range of the job has started.
+//The job leaves the list when its last range is claimed.
+bool ClaimParallelForRange(ParallelForJob* job, uint32_t* outRange)
+{
+	if (job->nextRange == job->numRanges)
+		return false;
+
+	*outRange = job->nextRange++;
+	if (job->nextRange < job->numRanges)
+		return true;
+
+	ParallelForJob* previous = nullptr;
+	for (ParallelForJob* cur = gJobPool.jobs; cur != job; cur = cur->next)
+		previous = cur;
+
+	if (previous != nullptr)
+		previous->next = job->next;
+	else
+		gJobPool.jobs = job->next;
+
+	if (gJobPool.lastJob == job)
+		gJobPool.lastJob = previous;
+
+	return true;
+}
+
+void RunParallelForRange(ParallelForJob* job, uint32_t range)
+{
+	//Read before the range is counted as done, the job may be gone after that
+	uint32_t numRanges = job->numRanges;
+
+	uint32_t begin = (uint32_t)(((uint64_t)job->count * range) / numRanges);
+	uint32_t end = (uint32_t)(((uint64_t)job->count * (range + 1)) / numRanges);
+	job->function(job->data, begin, end);
+
+	if ((uint32_t)InterlockedIncrement(&job->numRangesDone) == numRanges)
+	{
+		AcquireSRWLockExclusive(&gJobPool.lock);
+		ReleaseSRWLockExclusive(&gJobPool.lock);
+		WakeAllConditionVariable(&gJobPool.jobDone);
+	}
+}
+
+void JobPoolThread(void* data)
+{
+	while (true)
+	{
+		ParallelForJob* job = nullptr;
+		uint32_t range = 0;
+
+		AcquireSRWLockExclusive(&gJobPool.lock);
+		while (gJobPool.quit == false && gJobPool.jobs == nullptr)
+			SleepConditionVariableSRW(&gJobPool.jobAvailable, &gJobPool.lock, INFINITE, 0);
+
+		if (gJobPool.quit == false)
+		{
+			job = gJobPool.jobs;
+			ClaimParallelForRange(job, &range);
+		}
+		ReleaseSRWLockExclusive(&gJobPool.lock);
+
+		if (job == nullptr)
+			return;
+
+		RunParallelForRange(job, range);
+	}
+}
+
+void InitJobPool()
+{
+	AcquireSRWLockExclusive(&gJobPool.lock);
+	if (gJobPool.started == false)
+	{
+		//The caller of ParallelFor runs one of the ranges
+		uint32_t numThreads = GetNumLogicalCores();
+		numThreads = (numThreads > 1) ? numThreads - 1 : 1;
+		gJobPool.numThreads = (numThreads < MAX_PARALLEL_FOR_THREADS - 1) ? numThreads : MAX_PARALLEL_FOR_THREADS - 1;
+		gJobPool.quit = false;
+
+		for (uint32_t i = 0; i < gJobPool.numThreads; ++i)
+			StartThread(&gJobPool.threads[i], JobPoolThread, nullptr);
+
+		gJobPool.started = true;
+	}
+	ReleaseSRWLockExclusive(&gJobPool.lock);
+}
+
+void ExitJobPool()
+{
+	AcquireSRWLockExclusive(&gJobPool.lock);
+	bool started = gJobPool.started;
+	gJobPool.quit = true;
+	ReleaseSRWLockExclusive(&gJobPool.lock);
+	WakeAllConditionVariable(&gJobPool.jobAvailable);
+
+	if (started == false)
+		return;
+
+	for (uint32_t i = 0; i < gJobPool.numThreads; ++i)
+		JoinThread(&gJobPool.threads[i]);
+
+	AcquireSRWLockExclusive(&gJobPool.lock);
+	gJobPool.numThreads = 0;
+	gJobPool.started = false;
+	gJobPool.quit = false;
+	ReleaseSRWLockExclusive(&gJobPool.lock);
+}
+
+void ParallelFor(uint32_t count, uint32_t minRangeSize, ParallelForFunction function, void* data)
+{
+	if (count == 0)
+		return;
+
+	uint32_t numRanges = GetNumLogicalCores();
+	if (numRanges > MAX_PARALLEL_FOR_THREADS)
+		numRanges = MAX_PARALLEL_FOR_THREADS;
+
+	uint32_t maxRanges = (minRangeSize > 0) ? count / minRangeSize : count;
+	if (numRanges > maxRanges)
+		numRanges = (maxRanges > 0) ? maxRanges : 1;
+
+	if (numRanges == 1)
+	{
+		function(data, 0, count);
+		return;
+	}
+
+	if (gJobPool.started == false)
+		InitJobPool();
+
+	ParallelForJob job{};
+	job.function = function;
+	job.data = data;
+	job.count = count;
+	job.numRanges = numRanges;
+
+	AcquireSRWLockExclusive(&gJobPool.lock);
+	if (gJobPool.lastJob != nullptr)
+		gJobPool.lastJob->next = &job;
+	else
+		gJobPool.jobs = &job;
+	gJobPool.lastJob = &job;
+	ReleaseSRWLockExclusive(&gJobPool.lock);
+	WakeAllConditionVariable(&gJobPool.jobAvailable);
+
+	//Run ranges until every range has started, then wait for the ones the workers run
+	while (true)
+	{
+		uint32_t range = 0;
+
+		AcquireSRWLockExclusive(&gJobPool.lock);
+		bool claimed = ClaimParallelForRange(&job, &range);
+		ReleaseSRWLockExclusive(&gJobPool.lock);
+
+		if (claimed == false)
+			break;
+
+		RunParallelForRange(&job, range);
+	}
+
+	AcquireSRWLockExclusive(&gJobPool.lock);
+	while ((uint32_t)job.numRangesDone < numRanges)
+		SleepConditionVariableSRW(&gJobPool.jobDone, &gJobPool.lock, INFINITE, 0);
+	ReleaseSRWLockExclusive(&gJobPool.lock);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+typedef void (*ThreadFunction)(void* data);
+
+struct Thread
+{
+	void* handle = nullptr; //HANDLE
+	ThreadFunction function = nullptr;
+	void* data = nullptr;
+};
+
+//Starts a thread that calls function(data).
+//The Thread struct must stay alive until JoinThread is called.
+void StartThread(Thread* thread, ThreadFunction function, void* data);
+
+//Waits for the thread to finish and releases its handle.
+void JoinThread(Thread* thread);
+
+//Returns the number of logical processors of the system.
+uint32_t GetNumLogicalCores();
+
+
+typedef void (*ParallelForFunction)(void* data, uint32_t begin, uint32_t end);
+
+//Starts the persistent worker threads that run the ranges of ParallelFor, one per logical core but one.
+//WindowsMain calls it at startup. ParallelFor calls it if the workers haven't been started.
+void InitJobPool();
+
+//Stops the worker threads. WindowsMain calls it before returning. Must not be called during a ParallelFor call.
+void ExitJobPool();
+
+//Splits [0, count) into one contiguous range per logical core and calls function(data, begin, end) for each range.
+//Every range has at least minRangeSize elements, so small counts run on the calling thread only.
+//The ranges run on the job pool and on the calling thread, so no threads are created per call
+//and a range may call ParallelFor itself. Returns after all ranges are done.
+void ParallelFor(uint32_t count, uint32_t minRangeSize, ParallelForFunction function, void* data);
\ No newline at end of file